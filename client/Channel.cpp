@@ -1,6 +1,9 @@
 #include "Channel.h"
 
+#include <algorithm>
+
 #include <util/Logger.h>
+#include <util/Timer.h>
 
 Channel::Channel(const DWORD channelFlags)
     : handle(BASS_StreamCreate(SV::kFrequency, 1, channelFlags, STREAMPROC_PUSH, nullptr))
@@ -50,8 +53,12 @@ WORD Channel::GetSpeaker() const noexcept
 
 bool Channel::IsActive() const noexcept
 {
+    if (!this->jitterBuffer.IsEmpty()) return true;
+
     const auto bufferSize = BASS_ChannelGetData(this->handle, nullptr, BASS_DATA_AVAILABLE);
-    return bufferSize != -1 && bufferSize != 0;
+    if (bufferSize != -1 && bufferSize != 0) return true;
+
+    return static_cast<DWORD>(Timer::Get()) - this->lastPushTime < SV::kChannelLingerTimeInMs;
 }
 
 void Channel::Reset() noexcept
@@ -64,16 +71,20 @@ void Channel::Reset() noexcept
         this->stopCallback(*this);
 
     this->speaker = SV::kNonePlayer;
-    this->expectedPacketNumber = 0;
+    this->jitterBuffer.Reset();
     this->initialized = false;
     this->playing = false;
 }
 
 void Channel::Push(const DWORD packetNumber, const BYTE* const dataPtr, const DWORD dataSize) noexcept
 {
+    const auto arrivalTime = static_cast<DWORD>(Timer::Get());
+
     if (!this->initialized || packetNumber == NULL)
     {
-        Logger::LogToFile("[sv:dbg:channel:push] : init channel (speaker:%hu)", this->speaker);
+        static Logger::Limiter initLimiter { 1, 10 };
+
+        Logger::LogToFile(initLimiter, "[sv:dbg:channel:push] : init channel (speaker:%hu)", this->speaker);
 
         BASS_ChannelPause(this->handle);
         BASS_ChannelSetPosition(this->handle, 0, BASS_POS_BYTE);
@@ -82,51 +93,43 @@ void Channel::Push(const DWORD packetNumber, const BYTE* const dataPtr, const DW
         if (this->playing && this->stopCallback != nullptr)
             this->stopCallback(*this);
 
+        // New talkspurt starts with the delay measured on previous ones
+        this->jitterBuffer.Restart();
         this->initialized = true;
         this->playing = false;
     }
-    else if (packetNumber < this->expectedPacketNumber)
-    {
-        Logger::LogToFile("[sv:dbg:channel:push] : late packet to channel (speaker:%hu) "
-            "(pack:%u;expPack:%u)", this->speaker, packetNumber, this->expectedPacketNumber);
-
-        return;
-    }
-    else if (packetNumber > this->expectedPacketNumber)
-    {
-        Logger::LogToFile("[sv:dbg:channel:push] : lost packet to channel (speaker:%hu) "
-            "(pack:%u;expPack:%u)", this->speaker, packetNumber, this->expectedPacketNumber);
 
-        if (const int length = opus_decode(this->decoder, dataPtr, dataSize, this->decBuffer.data(),
-            SV::kFrameSizeInSamples, true); length == static_cast<int>(SV::kFrameSizeInSamples))
-        {
-            BASS_StreamPutData(this->handle, this->decBuffer.data(), SV::kFrameSizeInBytes);
-        }
-    }
+    this->lastPushTime = arrivalTime;
 
-    if (const int length = opus_decode(this->decoder, dataPtr, dataSize, this->decBuffer.data(),
-        SV::kFrameSizeInSamples, false); length == static_cast<int>(SV::kFrameSizeInSamples))
+    if (!this->jitterBuffer.Push(packetNumber, arrivalTime, dataPtr, dataSize))
     {
-        BASS_StreamPutData(this->handle, this->decBuffer.data(), SV::kFrameSizeInBytes);
+        static Logger::Limiter lateLimiter { 1, 5 };
+
+        Logger::LogToFile(lateLimiter, "[sv:dbg:channel:push] : late packet to channel "
+            "(speaker:%hu) (pack:%u)", this->speaker, packetNumber);
     }
 
-    const auto channelStatus = BASS_ChannelIsActive(this->handle);
-    const auto bufferSize = BASS_ChannelGetData(this->handle, nullptr, BASS_DATA_AVAILABLE);
+    this->Feed();
+}
 
-    if ((channelStatus == BASS_ACTIVE_PAUSED || channelStatus == BASS_ACTIVE_STOPPED) &&
-        bufferSize != -1 && bufferSize >= SV::kChannelPreBufferFramesCount * SV::kFrameSizeInBytes)
-    {
-        Logger::LogToFile("[sv:dbg:channel:push] : playing channel (speaker:%hu)", this->speaker);
+void Channel::Tick() noexcept
+{
+    if (this->initialized) this->Feed();
+}
 
-        BASS_ChannelPlay(this->handle, FALSE);
+void Channel::PopStats(ReceiverStats& stats) noexcept
+{
+    JitterBuffer::Stats bufferStats;
 
-        if (!this->playing && this->playCallback != nullptr)
-            this->playCallback(*this);
+    this->jitterBuffer.PopStats(bufferStats);
 
-        this->playing = true;
-    }
+    stats.received += bufferStats.received;
+    stats.lost += bufferStats.lost;
+    stats.jitter = std::max<DWORD>(stats.jitter, bufferStats.jitter);
 
-    this->expectedPacketNumber = packetNumber + 1;
+    stats.late += bufferStats.late;
+    stats.underruns += bufferStats.underruns;
+    stats.delay = std::max<DWORD>(stats.delay, bufferStats.delay);
 }
 
 void Channel::SetPlayCallback(PlayCallback playCallback) noexcept
@@ -138,3 +141,54 @@ void Channel::SetStopCallback(StopCallback stopCallback) noexcept
 {
     this->stopCallback = std::move(stopCallback);
 }
+
+void Channel::Feed() noexcept
+{
+    const auto bufferSize = BASS_ChannelGetData(this->handle, nullptr, BASS_DATA_AVAILABLE);
+    if (bufferSize == -1) return;
+
+    const auto curTime = static_cast<DWORD>(Timer::Get());
+    auto queuedTime = static_cast<DWORD>(bufferSize) / (SV::kFrameSizeInBytes / SV::kVoiceRate);
+
+    JitterBuffer::Frame frame;
+
+    while (this->jitterBuffer.Pop(curTime, queuedTime, frame))
+    {
+        // Missing frame is restored from FEC of the following one or concealed by decoder
+        const bool fecStatus = frame.type == JitterBuffer::FrameType::concealed && frame.data != nullptr;
+
+        if (const int length = opus_decode(this->decoder, frame.data, frame.size, this->decBuffer.data(),
+            SV::kFrameSizeInSamples, fecStatus); length == static_cast<int>(SV::kFrameSizeInSamples))
+        {
+            BASS_StreamPutData(this->handle, this->decBuffer.data(), SV::kFrameSizeInBytes);
+        }
+
+        queuedTime += SV::kVoiceRate;
+    }
+
+    if (this->jitterBuffer.IsPlaying() && !this->playing)
+    {
+        static Logger::Limiter playLimiter { 1, 10 };
+
+        Logger::LogToFile(playLimiter, "[sv:dbg:channel:feed] : playing channel (speaker:%hu) (delay:%u)",
+            this->speaker, this->jitterBuffer.GetTargetDelay());
+
+        if (const auto channelStatus = BASS_ChannelIsActive(this->handle);
+            channelStatus == BASS_ACTIVE_PAUSED || channelStatus == BASS_ACTIVE_STOPPED)
+        {
+            BASS_ChannelPlay(this->handle, FALSE);
+        }
+
+        if (this->playCallback != nullptr)
+            this->playCallback(*this);
+
+        this->playing = true;
+    }
+    else if (!this->jitterBuffer.IsPlaying() && this->playing && queuedTime == 0)
+    {
+        if (this->stopCallback != nullptr)
+            this->stopCallback(*this);
+
+        this->playing = false;
+    }
+}
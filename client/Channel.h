@@ -17,6 +17,20 @@
 #include <audio/opus.h>
 
 #include "Header.h"
+#include "JitterBuffer.h"
+
+// Receiver statistics of channels summed by speaker
+struct ReceiverStats {
+
+    DWORD received { 0 };
+    DWORD lost { 0 };
+    DWORD jitter { 0 };
+
+    DWORD late { 0 };
+    DWORD underruns { 0 };
+    DWORD delay { 0 };
+
+};
 
 class Channel {
 
@@ -44,13 +58,24 @@ public:
     bool HasSpeaker() const noexcept;
     WORD GetSpeaker() const noexcept;
 
+    // Channel stays with its speaker for a while after the talkspurt
+    // has been played out, the next one then starts with known delay
     bool IsActive() const noexcept;
     void Reset() noexcept;
     void Push(DWORD packetNumber, const BYTE* dataPtr, DWORD dataSize) noexcept;
+    void Tick() noexcept;
+
+    // Adds counters gathered since the previous call, jitter and delay are the worst ones
+    void PopStats(ReceiverStats& stats) noexcept;
 
     void SetPlayCallback(PlayCallback playCallback) noexcept;
     void SetStopCallback(StopCallback stopCallback) noexcept;
 
+private:
+
+    // Decodes frames the jitter buffer gives out while output runs low
+    void Feed() noexcept;
+
 private:
 
     const HSTREAM handle;
@@ -62,10 +87,13 @@ private:
     OpusDecoder* const decoder;
     std::array<opus_int16, SV::kFrameSizeInSamples> decBuffer;
 
-    DWORD expectedPacketNumber { 0 };
+    JitterBuffer jitterBuffer { SV::kVoiceRate, SV::kChannelFeedTimeInMs, SV::kChannelPreBufferSizeInMs };
+
     bool initialized { false };
     bool playing { false };
 
+    DWORD lastPushTime { 0 };
+
     int opusErrorCode { -1 };
 
 };
@@ -29,9 +29,13 @@ namespace SV
 
     constexpr WORD  kNonePlayer = 0xffff;
 
-    constexpr BYTE  kVersion = 11;
+    constexpr BYTE  kVersion = 12;
     constexpr DWORD kSignature = 0xDeadBeef;
 
+    constexpr DWORD kVoiceAuthKeySize = 16;
+    constexpr DWORD kVoiceAuthTagSize = 8;
+    constexpr DWORD kLowLayerBitrate = 12000;
+
     constexpr DWORD kAudioUpdateThreads = 4;
     constexpr DWORD kAudioUpdatePeriod = 10;
 
@@ -43,6 +47,8 @@ namespace SV
     constexpr DWORD kChannelPreBufferFramesCount = 3;
     constexpr DWORD kChannelPreBufferSizeInMs = kChannelPreBufferFramesCount * kVoiceRate;
     constexpr DWORD kChannelBufferSizeInMs = 3 * kChannelPreBufferSizeInMs;
+    constexpr DWORD kChannelFeedTimeInMs = kVoiceRate / 2;
+    constexpr DWORD kChannelLingerTimeInMs = 2000;
 
     struct ControlPacketType
     {
@@ -79,7 +85,31 @@ namespace SV
             setStreamParameter,
             slideStreamParameter,
             createEffect,
-            deleteEffect
+            deleteEffect,
+
+            // v3.3 added
+            // ---------------------
+
+            receiverReport,
+            setBitrate
+        };
+    };
+
+    struct ConnectFeatureType
+    {
+        enum : BYTE
+        {
+            // v3.2 added
+            // ---------------------
+
+            voiceAuth = 1 << 0,
+
+            // v3.3 added
+            // ---------------------
+
+            compactHeader  = 1 << 1,
+            bitrateControl = 1 << 2,
+            simulcast      = 1 << 3
         };
     };
 
@@ -88,7 +118,22 @@ namespace SV
         enum : BYTE
         {
             keepAlive,
-            voicePacket
+            voicePacket,
+
+            // v3.3 added
+            // ---------------------
+
+            simulcastPacket // upstream only, see SimulcastPacket
+        };
+    };
+
+    // First byte of compact voice packet (v3.3)
+    struct CompactFlagType
+    {
+        enum : BYTE
+        {
+            typeMask    = 0x0f,  // VoicePacketType
+            firstPacket = 1 << 4 // packet starts sequence, its packid is 0
         };
     };
 
@@ -215,5 +260,53 @@ namespace SV
         UINT32 effect;
     };
 
+    // v3.2 added
+    // -----------------------------------
+
+    // Optional byte following ConnectPacket, older servers ignore it
+    struct ConnectFeaturesPacket
+    {
+        UINT8 features;
+    };
+
+    // Received instead of ServerInfoPacket when voice authentication
+    // was negotiated, every voice packet is then followed by tag
+    struct ServerInfoAuthPacket
+    {
+        UINT32 serverKey;
+        UINT16 serverPort;
+        UINT8 authKey[kVoiceAuthKeySize];
+    };
+
+    // v3.3 added
+    // -----------------------------------
+
+    // Optional byte following server info, older servers don't send it
+    struct ServerFeaturesPacket
+    {
+        UINT8 features;
+    };
+
+    // Receiver report is an array of entries, one per heard speaker
+    struct ReceiverReportEntry
+    {
+        UINT16 speaker;
+        UINT8 loss;   // lost packets fraction in 1/255 units
+        UINT16 jitter; // interarrival jitter in ms
+    };
+
+    struct SetBitratePacket
+    {
+        UINT32 bitrate;
+    };
+
+    // Data of simulcast voice packet: main layer encoded at player's bitrate
+    // followed by low layer encoded at kLowLayerBitrate up to the end
+    struct SimulcastPacket
+    {
+        UINT16 mainLength;
+        UINT8 data[];
+    };
+
 #pragma pack(pop)
 }
@@ -0,0 +1,219 @@
+#include "JitterBuffer.h"
+
+#include <algorithm>
+
+JitterBuffer::JitterBuffer(const uint32_t frameTime, const uint32_t feedTime, const uint32_t maxDelay)
+    : frameTime(frameTime), feedTime(feedTime), maxDelay(maxDelay)
+{}
+
+void JitterBuffer::Reset() noexcept
+{
+    this->Restart();
+
+    this->jitter = 0;
+    this->lateDelay = 0;
+
+    this->receivedFrames = 0;
+    this->lostFrames = 0;
+    this->lateFrames = 0;
+    this->underrunsCount = 0;
+}
+
+void JitterBuffer::Restart() noexcept
+{
+    this->Clear();
+
+    this->sequenceStatus = false;
+    this->playing = false;
+    this->drained = false;
+
+    // Sequence restarts, there is nothing to compare arrival with
+    this->arrivalStatus = false;
+}
+
+bool JitterBuffer::Push(const uint32_t sequence, const uint32_t arrivalTime,
+                        const uint8_t* const data, const uint32_t size)
+{
+    // Interarrival jitter as in RFC 3550, frames are sent every frameTime ms
+    if (this->arrivalStatus && sequence > this->lastArrivalSequence)
+    {
+        const auto transit = static_cast<int>(arrivalTime - this->lastArrivalTime) -
+            static_cast<int>((sequence - this->lastArrivalSequence) * this->frameTime);
+        const auto deviation = static_cast<uint32_t>(transit < 0 ? -transit : transit);
+
+        this->jitter += deviation - ((this->jitter + 8) >> 4);
+    }
+
+    if (!this->arrivalStatus || sequence > this->lastArrivalSequence)
+    {
+        this->lastArrivalSequence = sequence;
+        this->lastArrivalTime = arrivalTime;
+        this->arrivalStatus = true;
+    }
+
+    if (!this->sequenceStatus || (this->drained && sequence < this->nextSequence))
+    {
+        // Output has played everything out, lower sequence begins a new talkspurt
+        this->nextSequence = sequence;
+        this->lastSequence = sequence;
+        this->sequenceStatus = true;
+        this->drained = false;
+    }
+    else if (sequence < this->nextSequence)
+    {
+        ++this->lateFrames;
+        this->RaiseDelay();
+
+        return false;
+    }
+    else if (this->drained)
+    {
+        // Output has run dry in the middle of the talkspurt,
+        // frames that have missed their time are skipped
+        ++this->underrunsCount;
+        this->RaiseDelay();
+
+        this->lostFrames += sequence - this->nextSequence;
+        this->nextSequence = sequence;
+        this->lastSequence = sequence;
+        this->drained = false;
+    }
+    else if (sequence - this->nextSequence >= kSlotsCount)
+    {
+        // Frame is too far ahead to wait for the gap, playout jumps to it
+        this->lostFrames += sequence - this->nextSequence - this->framesCount;
+        this->Clear();
+
+        this->nextSequence = sequence;
+        this->lastSequence = sequence;
+        this->playing = false;
+    }
+
+    auto& slot = this->slots[sequence % kSlotsCount];
+
+    if (slot.filled) return false;
+
+    slot.sequence = sequence;
+    slot.filled = true;
+    slot.data.assign(data, data + size);
+
+    if (this->framesCount == 0 && !this->playing)
+        this->bufferingTime = arrivalTime;
+
+    this->lastSequence = std::max(this->lastSequence, sequence);
+    ++this->framesCount;
+    ++this->receivedFrames;
+
+    return true;
+}
+
+bool JitterBuffer::Pop(const uint32_t curTime, const uint32_t queuedTime, Frame& frame) noexcept
+{
+    if (!this->playing)
+    {
+        if (this->framesCount == 0) return false;
+
+        // Frames buffered ahead of the first one count as waited already
+        const auto bufferedTime = (curTime - this->bufferingTime) +
+            (this->lastSequence - this->nextSequence) * this->frameTime;
+
+        if (bufferedTime < this->GetTargetDelay()) return false;
+
+        this->playing = true;
+    }
+
+    if (queuedTime >= this->feedTime) return false;
+
+    if (this->framesCount == 0)
+    {
+        // Either talkspurt is over or the next frame is late
+        if (queuedTime == 0)
+        {
+            this->playing = false;
+            this->drained = true;
+        }
+
+        return false;
+    }
+
+    if (const auto slot = this->FindSlot(this->nextSequence); slot != nullptr)
+    {
+        frame.type = FrameType::normal;
+        frame.data = slot->data.data();
+        frame.size = static_cast<uint32_t>(slot->data.size());
+
+        slot->filled = false;
+        --this->framesCount;
+    }
+    else
+    {
+        frame.type = FrameType::concealed;
+        frame.data = nullptr;
+        frame.size = 0;
+
+        if (const auto nextSlot = this->FindSlot(this->nextSequence + 1); nextSlot != nullptr)
+        {
+            frame.data = nextSlot->data.data();
+            frame.size = static_cast<uint32_t>(nextSlot->data.size());
+        }
+
+        ++this->lostFrames;
+    }
+
+    ++this->nextSequence;
+
+    // Delay added after late frames wears off by a ms per played frame
+    if (this->lateDelay != 0) --this->lateDelay;
+
+    return true;
+}
+
+bool JitterBuffer::IsEmpty() const noexcept
+{
+    return this->framesCount == 0;
+}
+
+bool JitterBuffer::IsPlaying() const noexcept
+{
+    return this->playing;
+}
+
+uint32_t JitterBuffer::GetTargetDelay() const noexcept
+{
+    const auto jitterDelay = (3 * this->jitter + 8) >> 4;
+    return std::min(this->feedTime + jitterDelay + this->lateDelay, this->maxDelay);
+}
+
+void JitterBuffer::PopStats(Stats& stats) noexcept
+{
+    stats.received += this->receivedFrames;
+    stats.lost += this->lostFrames;
+    stats.late += this->lateFrames;
+    stats.underruns += this->underrunsCount;
+    stats.jitter = std::max(stats.jitter, this->jitter >> 4);
+    stats.delay = std::max(stats.delay, this->GetTargetDelay());
+
+    this->receivedFrames = 0;
+    this->lostFrames = 0;
+    this->lateFrames = 0;
+    this->underrunsCount = 0;
+}
+
+JitterBuffer::Slot* JitterBuffer::FindSlot(const uint32_t sequence) noexcept
+{
+    auto& slot = this->slots[sequence % kSlotsCount];
+    return slot.filled && slot.sequence == sequence ? &slot : nullptr;
+}
+
+void JitterBuffer::Clear() noexcept
+{
+    for (auto& slot : this->slots)
+        slot.filled = false;
+
+    this->framesCount = 0;
+}
+
+void JitterBuffer::RaiseDelay() noexcept
+{
+    this->lateDelay = std::min(this->lateDelay + this->frameTime / 2, this->maxDelay);
+}
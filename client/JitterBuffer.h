@@ -0,0 +1,138 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Playout buffer of voice frames of one speaker. Frames are put in order by
+// their sequence numbers and taken out when output runs low, missing frames
+// are concealed then. Every talkspurt starts playing once buffered audio
+// covers the target delay, the delay follows interarrival jitter (as in
+// RFC 3550) and grows after late frames and underruns. Buffer knows nothing
+// of decoding and audio output, times are given in ms by its owner.
+class JitterBuffer {
+
+    JitterBuffer() = delete;
+    JitterBuffer(const JitterBuffer&) = delete;
+    JitterBuffer(JitterBuffer&&) = delete;
+    JitterBuffer& operator=(const JitterBuffer&) = delete;
+    JitterBuffer& operator=(JitterBuffer&&) = delete;
+
+public:
+
+    static constexpr uint32_t kSlotsCount = 16;
+
+    struct FrameType
+    {
+        enum : uint8_t
+        {
+            normal,
+            concealed
+        };
+    };
+
+    // Concealed frame carries data of the following frame when it has
+    // already come (to be decoded with FEC) and nothing otherwise
+    struct Frame
+    {
+        uint8_t type { FrameType::normal };
+        const uint8_t* data { nullptr };
+        uint32_t size { 0 };
+    };
+
+    struct Stats
+    {
+        uint32_t received { 0 };
+        uint32_t lost { 0 };
+        uint32_t late { 0 };
+        uint32_t underruns { 0 };
+        uint32_t jitter { 0 };
+        uint32_t delay { 0 };
+    };
+
+public:
+
+    // 'frameTime' is audio in a frame, frames are given out while output
+    // holds less than 'feedTime', target delay never exceeds 'maxDelay'
+    explicit JitterBuffer(uint32_t frameTime, uint32_t feedTime, uint32_t maxDelay);
+
+    ~JitterBuffer() noexcept = default;
+
+public:
+
+    // Forgets the speaker along with everything measured
+    void Reset() noexcept;
+
+    // Drops frames of the previous talkspurt, measurements are kept
+    void Restart() noexcept;
+
+    // Returns false for late and duplicate frames
+    bool Push(uint32_t sequence, uint32_t arrivalTime, const uint8_t* data, uint32_t size);
+
+    // Gives out the next frame to decode, 'queuedTime' is audio that
+    // output has yet to play. Frame data stays valid until the next Push.
+    bool Pop(uint32_t curTime, uint32_t queuedTime, Frame& frame) noexcept;
+
+    bool IsEmpty() const noexcept;
+    bool IsPlaying() const noexcept;
+
+    uint32_t GetTargetDelay() const noexcept;
+
+    // Adds counters gathered since the previous call, jitter and delay are the worst ones
+    void PopStats(Stats& stats) noexcept;
+
+private:
+
+    struct Slot
+    {
+        uint32_t sequence { 0 };
+        bool filled { false };
+        std::vector<uint8_t> data;
+    };
+
+private:
+
+    Slot* FindSlot(uint32_t sequence) noexcept;
+
+    void Clear() noexcept;
+    void RaiseDelay() noexcept;
+
+private:
+
+    const uint32_t frameTime;
+    const uint32_t feedTime;
+    const uint32_t maxDelay;
+
+    std::array<Slot, kSlotsCount> slots;
+    uint32_t framesCount { 0 };
+
+    uint32_t nextSequence { 0 };
+    uint32_t lastSequence { 0 };
+    bool sequenceStatus { false };
+
+    bool playing { false };
+    bool drained { false };
+    uint32_t bufferingTime { 0 };
+
+    uint32_t lastArrivalSequence { 0 };
+    uint32_t lastArrivalTime { 0 };
+    bool arrivalStatus { false };
+
+    uint32_t jitter { 0 }; // in 1/16 ms
+    uint32_t lateDelay { 0 };
+
+    uint32_t receivedFrames { 0 };
+    uint32_t lostFrames { 0 };
+    uint32_t lateFrames { 0 };
+    uint32_t underrunsCount { 0 };
+
+};
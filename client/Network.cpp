@@ -9,9 +9,13 @@
 
 #include "Network.h"
 
+#include <cstring>
+#include <unordered_map>
+
 #include <util/Logger.h>
 #include <util/RakNet.h>
 #include <util/GameUtil.h>
+#include <util/SipHash.h>
 
 #pragma comment(lib, "Ws2_32.lib")
 
@@ -99,6 +103,11 @@ void Network::Free() noexcept
 
     Network::serverIp.clear();
     Network::serverKey = NULL;
+    Network::voiceAuthStatus = false;
+    SecureZeroMemory(Network::voiceAuthKey, sizeof(Network::voiceAuthKey));
+    Network::compactHeaderStatus = false;
+    Network::bitrateControlStatus = false;
+    Network::simulcastStatus = false;
 
     Network::connectCallbacks.clear();
     Network::svConnectCallbacks.clear();
@@ -143,7 +152,7 @@ bool Network::SendControlPacket(const WORD packet, const LPCVOID dataAddr, const
     return RakNet::Send(&bitStream);
 }
 
-bool Network::SendVoicePacket(const LPCVOID dataAddr, const WORD dataSize) noexcept
+bool Network::SendVoicePacket(const LPCVOID dataAddr, const WORD dataSize, const BYTE packetType) noexcept
 {
     if (dataAddr == nullptr || dataSize == 0 || dataSize > kMaxVoiceDataSize)
         return false;
@@ -151,13 +160,33 @@ bool Network::SendVoicePacket(const LPCVOID dataAddr, const WORD dataSize) noexc
     if (Network::connectionStatus != ConnectionStatus::Connected)
         return false;
 
+    Network::outputVoicePacket->packet = packetType;
     Network::outputVoicePacket->length = dataSize;
     Network::outputVoicePacket->CalcHash();
 
     std::memcpy(Network::outputVoicePacket->data, dataAddr, dataSize);
 
-    const auto voicePacketAddr = reinterpret_cast<PCCH>(&Network::outputVoicePacket);
-    const auto voicePacketSize = static_cast<int>(Network::outputVoicePacket->GetFullSize());
+    auto voicePacketAddr = reinterpret_cast<PCCH>(&Network::outputVoicePacket);
+    auto voicePacketSize = static_cast<int>(Network::outputVoicePacket->GetFullSize());
+
+    if (Network::compactHeaderStatus)
+    {
+        voicePacketAddr = reinterpret_cast<PCCH>(Network::compactVoicePacket);
+        voicePacketSize = Network::outputVoicePacket->WriteCompactUpstream(Network::compactVoicePacket);
+
+        if (Network::voiceAuthStatus)
+        {
+            const UINT64 tag = SipHash::Calc(Network::voiceAuthKey[0], Network::voiceAuthKey[1],
+                Network::compactVoicePacket, voicePacketSize);
+            std::memcpy(Network::compactVoicePacket + voicePacketSize, &tag, sizeof(tag));
+            voicePacketSize += SV::kVoiceAuthTagSize;
+        }
+    }
+    else if (Network::voiceAuthStatus)
+    {
+        Network::outputVoicePacket->CalcAuthTag(Network::voiceAuthKey[0], Network::voiceAuthKey[1]);
+        voicePacketSize += SV::kVoiceAuthTagSize;
+    }
 
     const auto sended = send(Network::socketHandle, voicePacketAddr, voicePacketSize, NULL);
 
@@ -174,6 +203,16 @@ void Network::EndSequence() noexcept
     Network::outputVoicePacket->packid = NULL;
 }
 
+bool Network::HasBitrateControl() noexcept
+{
+    return Network::bitrateControlStatus;
+}
+
+bool Network::HasSimulcast() noexcept
+{
+    return Network::simulcastStatus;
+}
+
 ControlPacketContainerPtr Network::ReceiveControlPacket() noexcept
 {
     if (!Network::initStatus || Network::controlQueue.empty())
@@ -314,10 +353,11 @@ void Network::RemoveDisconnectCallback(const std::size_t callback) noexcept
 
 void Network::VoiceThread() noexcept
 {
-    VoicePacket keepAlivePacket;
+    BYTE keepAliveBuffer[sizeof(VoicePacket) + SV::kVoiceAuthTagSize] {};
     Timer::time_t keepAliveLastTime { NULL };
 
-    ZeroMemory(&keepAlivePacket, sizeof(keepAlivePacket));
+    auto& keepAlivePacket = *reinterpret_cast<VoicePacket*>(keepAliveBuffer);
+    int keepAlivePacketSize = sizeof(keepAlivePacket);
 
     keepAlivePacket.svrkey = Network::serverKey;
     keepAlivePacket.packet = SV::VoicePacketType::keepAlive;
@@ -327,6 +367,35 @@ void Network::VoiceThread() noexcept
     keepAlivePacket.stream = NULL;
     keepAlivePacket.CalcHash();
 
+    BYTE compactKeepAliveBuffer[VoicePacket::kCompactUpstreamHeaderSize + SV::kVoiceAuthTagSize] {};
+    LPCBYTE keepAlivePacketAddr = keepAliveBuffer;
+
+    // Keep-alive identifies our address on the server,
+    // so it's authenticated the same way as voice packets
+    if (Network::compactHeaderStatus)
+    {
+        keepAlivePacketAddr = compactKeepAliveBuffer;
+        keepAlivePacketSize = keepAlivePacket.WriteCompactUpstream(compactKeepAliveBuffer);
+
+        if (Network::voiceAuthStatus)
+        {
+            const UINT64 tag = SipHash::Calc(Network::voiceAuthKey[0], Network::voiceAuthKey[1],
+                compactKeepAliveBuffer, keepAlivePacketSize);
+            std::memcpy(compactKeepAliveBuffer + keepAlivePacketSize, &tag, sizeof(tag));
+            keepAlivePacketSize += SV::kVoiceAuthTagSize;
+        }
+    }
+    else if (Network::voiceAuthStatus)
+    {
+        keepAlivePacket.CalcAuthTag(Network::voiceAuthKey[0], Network::voiceAuthKey[1]);
+        keepAlivePacketSize += SV::kVoiceAuthTagSize;
+    }
+
+    BYTE compactReceiveBuffer[kMaxVoicePacketSize];
+
+    // Restored packid of the last packet of every sender
+    std::unordered_map<WORD, DWORD> lastPackids;
+
     while (true)
     {
         const auto curStatus = Network::connectionStatus;
@@ -340,8 +409,8 @@ void Network::VoiceThread() noexcept
 
         if (curTime - keepAliveLastTime >= kKeepAliveInterval)
         {
-            send(Network::socketHandle, reinterpret_cast<PCCH>(&keepAlivePacket),
-                 sizeof(keepAlivePacket), NULL);
+            send(Network::socketHandle, reinterpret_cast<PCCH>(keepAlivePacketAddr),
+                 keepAlivePacketSize, NULL);
 
             keepAliveLastTime = curTime;
         }
@@ -355,6 +424,40 @@ void Network::VoiceThread() noexcept
             continue;
         }
 
+        if (Network::compactHeaderStatus)
+        {
+            const auto received = recv(Network::socketHandle,
+                reinterpret_cast<PCH>(compactReceiveBuffer), sizeof(compactReceiveBuffer), NULL);
+
+            if (received == SOCKET_ERROR)
+                break;
+
+            if (received < 1) continue;
+            if ((*compactReceiveBuffer & SV::CompactFlagType::typeMask) == SV::VoicePacketType::keepAlive) continue;
+            if (!GameUtil::IsGameActive()) continue;
+
+            // Packet is restored to the full header the rest of plugin works with
+            bool firstStatus { false };
+
+            if (!Network::inputVoicePacket->ReadCompactDownstream(compactReceiveBuffer,
+                received, firstStatus)) continue;
+
+            auto& lastPackid = lastPackids[Network::inputVoicePacket->sender];
+
+            const DWORD packid = firstStatus ? NULL : VoicePacket::RestorePackid
+                (lastPackid, static_cast<UINT16>(Network::inputVoicePacket->packid));
+
+            // Late packets don't move sequence back
+            if (firstStatus || static_cast<INT32>(packid - lastPackid) > 0) lastPackid = packid;
+
+            Network::inputVoicePacket->packid = packid;
+
+            Network::voiceQueue.try_emplace(MakeVoicePacketContainer(&Network::inputVoicePacket,
+                Network::inputVoicePacket->GetFullSize()));
+
+            continue;
+        }
+
         const auto received = recv(Network::socketHandle,
             static_cast<PCH>(Network::inputVoicePacket.GetData()),
             Network::inputVoicePacket.GetSize(), NULL);
@@ -409,6 +512,13 @@ bool Network::OnRaknetRpc(const int id, BitStream& parameters) noexcept
 
     parameters.Write(reinterpret_cast<const char*>(&stData), sizeof(stData));
 
+    SV::ConnectFeaturesPacket stFeatures {};
+
+    stFeatures.features = SV::ConnectFeatureType::voiceAuth | SV::ConnectFeatureType::compactHeader |
+        SV::ConnectFeatureType::bitrateControl | SV::ConnectFeatureType::simulcast;
+
+    parameters.Write(reinterpret_cast<const char*>(&stFeatures), sizeof(stFeatures));
+
     Logger::LogToFile("[sv:dbg:network:connect] : raknet connecting... "
         "(version:%hhu;micro:%hhu)", stData.version, stData.micro);
 
@@ -436,8 +546,22 @@ bool Network::OnRaknetReceive(Packet& packet) noexcept
     {
         case SV::ControlPacketType::serverInfo:
         {
+            // Authenticated variant extends the plain one with session key,
+            // servers since v3.3 follow any of them with accepted features
             const auto& stData = *reinterpret_cast<SV::ServerInfoPacket*>(controlPacketPtr->data);
-            if (controlPacketPtr->length != sizeof(stData)) return false;
+
+            DWORD infoLength = controlPacketPtr->length;
+            BYTE features { NULL };
+
+            if (infoLength == sizeof(SV::ServerInfoPacket) + sizeof(SV::ServerFeaturesPacket) ||
+                infoLength == sizeof(SV::ServerInfoAuthPacket) + sizeof(SV::ServerFeaturesPacket))
+            {
+                infoLength -= sizeof(SV::ServerFeaturesPacket);
+                features = reinterpret_cast<SV::ServerFeaturesPacket*>(controlPacketPtr->data + infoLength)->features;
+            }
+
+            if (infoLength != sizeof(SV::ServerInfoPacket) &&
+                infoLength != sizeof(SV::ServerInfoAuthPacket)) return false;
 
             Logger::LogToFile("[sv:dbg:network:serverInfo] : connecting to voiceserver "
                 "'%s:%hu'...", Network::serverIp.c_str(), stData.serverPort);
@@ -456,6 +580,26 @@ bool Network::OnRaknetReceive(Packet& packet) noexcept
             }
 
             Network::serverKey = stData.serverKey;
+            Network::voiceAuthStatus = infoLength == sizeof(SV::ServerInfoAuthPacket);
+            Network::compactHeaderStatus = features & SV::ConnectFeatureType::compactHeader;
+
+            Network::bitrateControlStatus = features & SV::ConnectFeatureType::bitrateControl;
+            Network::simulcastStatus = features & SV::ConnectFeatureType::simulcast;
+
+            if (Network::compactHeaderStatus)
+                Logger::LogToFile("[sv:dbg:network:serverInfo] : compact header enabled");
+            if (Network::bitrateControlStatus)
+                Logger::LogToFile("[sv:dbg:network:serverInfo] : bitrate control enabled");
+            if (Network::simulcastStatus)
+                Logger::LogToFile("[sv:dbg:network:serverInfo] : simulcast enabled");
+
+            if (Network::voiceAuthStatus)
+            {
+                std::memcpy(Network::voiceAuthKey, reinterpret_cast<SV::ServerInfoAuthPacket*>
+                    (controlPacketPtr->data)->authKey, sizeof(Network::voiceAuthKey));
+
+                Logger::LogToFile("[sv:dbg:network:serverInfo] : voice authentication enabled");
+            }
 
             Network::outputVoicePacket->svrkey = Network::serverKey;
             Network::outputVoicePacket->packet = SV::VoicePacketType::voicePacket;
@@ -515,6 +659,11 @@ void Network::OnRaknetDisconnect() noexcept
 
     Network::serverIp.clear();
     Network::serverKey = NULL;
+    Network::voiceAuthStatus = false;
+    SecureZeroMemory(Network::voiceAuthKey, sizeof(Network::voiceAuthKey));
+    Network::compactHeaderStatus = false;
+    Network::bitrateControlStatus = false;
+    Network::simulcastStatus = false;
 
     ZeroMemory(Network::inputVoicePacket.GetData(),
         Network::inputVoicePacket.GetSize());
@@ -534,6 +683,11 @@ int Network::connectionStatus { ConnectionStatus::Disconnected };
 std::thread Network::voiceThread;
 std::string Network::serverIp;
 DWORD Network::serverKey { NULL };
+bool Network::voiceAuthStatus { false };
+UINT64 Network::voiceAuthKey[2] {};
+bool Network::compactHeaderStatus { false };
+bool Network::bitrateControlStatus { false };
+bool Network::simulcastStatus { false };
 
 std::vector<Network::ConnectCallback> Network::connectCallbacks;
 std::vector<Network::SvConnectCallback> Network::svConnectCallbacks;
@@ -543,5 +697,6 @@ std::vector<Network::DisconnectCallback> Network::disconnectCallbacks;
 SPSCQueue<ControlPacketContainerPtr> Network::controlQueue { 128 };
 SPSCQueue<VoicePacketContainerPtr> Network::voiceQueue { 512 };
 
-VoicePacketContainer Network::inputVoicePacket { kMaxVoiceDataSize };
-VoicePacketContainer Network::outputVoicePacket { kMaxVoiceDataSize };
+VoicePacketContainer Network::inputVoicePacket { kMaxVoicePacketSize };
+VoicePacketContainer Network::outputVoicePacket { kMaxVoiceDataSize + SV::kVoiceAuthTagSize };
+BYTE Network::compactVoicePacket[kMaxVoicePacketSize] {};
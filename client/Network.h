@@ -41,7 +41,7 @@ public:
     static constexpr BYTE kRaknetPacketId = 222;
     static constexpr int kRaknetConnectRcpId = 25;
     static constexpr DWORD kMaxVoicePacketSize = 1400;
-    static constexpr DWORD kMaxVoiceDataSize = kMaxVoicePacketSize - sizeof(VoicePacket);
+    static constexpr DWORD kMaxVoiceDataSize = kMaxVoicePacketSize - sizeof(VoicePacket) - SV::kVoiceAuthTagSize;
     static constexpr DWORD kRecvBufferSize = 2 * 1024 * 1024;
     static constexpr DWORD kSendBufferSize = 64 * 1024;
     static constexpr Timer::time_t kKeepAliveInterval = 2000;
@@ -72,8 +72,11 @@ public:
     static void Free() noexcept;
 
     static bool SendControlPacket(WORD packet, LPCVOID dataAddr = nullptr, WORD dataSize = 0) noexcept;
-    static bool SendVoicePacket(LPCVOID dataAddr, WORD dataSize) noexcept;
+    static bool SendVoicePacket(LPCVOID dataAddr, WORD dataSize,
+        BYTE packetType = SV::VoicePacketType::voicePacket) noexcept;
     static void EndSequence() noexcept;
+    static bool HasBitrateControl() noexcept;
+    static bool HasSimulcast() noexcept;
     static ControlPacketContainerPtr ReceiveControlPacket() noexcept;
     static VoicePacketContainerPtr ReceiveVoicePacket() noexcept;
 
@@ -104,6 +107,11 @@ private:
     static std::thread voiceThread;
     static std::string serverIp;
     static DWORD serverKey;
+    static bool voiceAuthStatus;
+    static UINT64 voiceAuthKey[2];
+    static bool compactHeaderStatus;
+    static bool bitrateControlStatus;
+    static bool simulcastStatus;
 
     static std::vector<ConnectCallback> connectCallbacks;
     static std::vector<SvConnectCallback> svConnectCallbacks;
@@ -115,5 +123,6 @@ private:
 
     static VoicePacketContainer inputVoicePacket;
     static VoicePacketContainer outputVoicePacket;
+    static BYTE compactVoicePacket[kMaxVoicePacketSize];
 
 };
@@ -9,7 +9,9 @@
 
 #include "Plugin.h"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 #include <game/CRadar.h>
 #include <game/CWorld.h>
@@ -190,6 +192,12 @@ void Plugin::MainLoop()
     for (const auto& stream : Plugin::streamTable)
         stream.second->Tick();
 
+    if (Network::HasBitrateControl() && Timer::Get() - Plugin::lastReportTime >= kReceiverReportInterval)
+    {
+        Plugin::SendReceiverReport();
+        Plugin::lastReportTime = Timer::Get();
+    }
+
     Playback::Tick();
     Record::Tick();
 
@@ -251,9 +259,12 @@ void Plugin::MainLoop()
 
     BYTE frameBuffer[Network::kMaxVoiceDataSize];
 
-    if (const auto frameSize = Record::GetFrame(frameBuffer, sizeof(frameBuffer)))
+    bool simulcastFrame { false };
+
+    if (const auto frameSize = Record::GetFrame(frameBuffer, sizeof(frameBuffer), simulcastFrame))
     {
-        if (!Network::SendVoicePacket(frameBuffer, frameSize))
+        if (!Network::SendVoicePacket(frameBuffer, frameSize, simulcastFrame ?
+            SV::VoicePacketType::simulcastPacket : SV::VoicePacketType::voicePacket))
             Logger::LogToFile("[sv:err:plugin] : failed to send voice packet");
 
         if (!Plugin::recordStatus)
@@ -264,6 +275,43 @@ void Plugin::MainLoop()
     }
 }
 
+void Plugin::SendReceiverReport()
+{
+    std::map<WORD, ReceiverStats> speakerStats;
+
+    for (const auto& stream : Plugin::streamTable)
+        stream.second->PopReceiverStats(speakerStats);
+
+    std::vector<SV::ReceiverReportEntry> reportEntries;
+    reportEntries.reserve(speakerStats.size());
+
+    for (const auto& stats : speakerStats)
+    {
+        const DWORD expected = stats.second.received + stats.second.lost;
+        if (expected == 0) continue;
+
+        auto& entry = reportEntries.emplace_back();
+
+        entry.speaker = stats.first;
+        entry.loss = static_cast<BYTE>(stats.second.lost * 255 / expected);
+        entry.jitter = static_cast<WORD>(std::min<DWORD>(stats.second.jitter, 0xffff));
+
+        static Logger::Limiter playoutLimiter { 1, 10 };
+
+        Logger::LogToFile(playoutLimiter, "[sv:dbg:plugin:receiverreport] : playout of speaker %hu "
+            "(lost:%u;late:%u;underruns:%u;jitter:%u;delay:%u)", stats.first, stats.second.lost,
+            stats.second.late, stats.second.underruns, stats.second.jitter, stats.second.delay);
+    }
+
+    if (reportEntries.empty()) return;
+
+    if (!Network::SendControlPacket(SV::ControlPacketType::receiverReport, reportEntries.data(),
+        static_cast<WORD>(reportEntries.size() * sizeof(SV::ReceiverReportEntry))))
+    {
+        Logger::LogToFile("[sv:err:plugin:receiverreport] : failed to send report");
+    }
+}
+
 void Plugin::ConnectHandler(const std::string& serverIp, const WORD serverPort)
 {
     Plugin::blacklistFilePath = static_cast<const std::string&>(Path() /
@@ -291,6 +339,12 @@ bool Plugin::PluginInitHandler(const SV::PluginInitPacket& initPacket)
         Logger::LogToFile("[sv:inf:plugin:packet:init] : failed init record");
     }
 
+    // Record outlives the connection, so the layer follows every new server
+    if (!Record::SetSimulcast(Network::HasSimulcast()))
+    {
+        Logger::LogToFile("[sv:inf:plugin:packet:init] : failed enable simulcast");
+    }
+
     return true;
 }
 
@@ -368,6 +422,15 @@ void Plugin::ControlPacketHandler(const ControlPacket& controlPacket)
 
             KeyFilter::RemoveAllKeys();
         } break;
+        case SV::ControlPacketType::setBitrate:
+        {
+            const auto& stData = *reinterpret_cast<const SV::SetBitratePacket*>(controlPacket.data);
+            if (controlPacket.length != sizeof(stData)) break;
+
+            Logger::LogToFile("[sv:dbg:plugin:setbitrate] : bitrate(%u)", stData.bitrate);
+
+            Record::SetBitrate(stData.bitrate);
+        } break;
         case SV::ControlPacketType::createGStream:
         {
             const auto& stData = *reinterpret_cast<const SV::CreateGStreamPacket*>(controlPacket.data);
@@ -670,6 +733,7 @@ bool Plugin::recordBusy { false };
 std::map<DWORD, StreamPtr> Plugin::streamTable;
 std::string Plugin::blacklistFilePath;
 bool Plugin::gameStatus { false };
+Timer::time_t Plugin::lastReportTime { 0 };
 
 LONG Plugin::origWndProc { NULL };
 HWND Plugin::origWndHandle { NULL };
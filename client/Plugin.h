@@ -20,6 +20,7 @@
 #include <raknet/bitstream.h>
 #include <raknet/rakclient.h>
 #include <util/AddressesBase.h>
+#include <util/Timer.h>
 
 #include "resources/resource.h"
 
@@ -46,6 +47,7 @@ private:
     static void OnExitGame() noexcept;
 
     static void MainLoop();
+    static void SendReceiverReport();
 
     static void ConnectHandler(const std::string& serverIp, WORD serverPort);
     static void PluginConnectHandler(SV::ConnectPacket& connectStruct);
@@ -63,6 +65,10 @@ private:
 
     static void DrawRadarHook();
 
+private:
+
+    static constexpr Timer::time_t kReceiverReportInterval = 1000;
+
 private:
 
     static HMODULE pModuleHandle;
@@ -75,6 +81,7 @@ private:
     static std::map<DWORD, StreamPtr> streamTable;
     static std::string blacklistFilePath;
     static bool gameStatus;
+    static Timer::time_t lastReportTime;
 
     static LONG origWndProc;
     static HWND origWndHandle;
@@ -10,6 +10,7 @@
 #include "Record.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include <util/Logger.h>
 
@@ -262,6 +263,7 @@ void Record::Free() noexcept
     BASS_StreamFree(Record::checkChannel);
 
     opus_encoder_destroy(Record::encoder);
+    Record::SetSimulcast(false);
 
     Record::usedDeviceIndex = -1;
     Record::deviceNumbersList.clear();
@@ -288,7 +290,76 @@ void Record::Tick() noexcept
     }
 }
 
-DWORD Record::GetFrame(BYTE* const bufferPtr, const DWORD bufferSize) noexcept
+bool Record::SetBitrate(const DWORD bitrate) noexcept
+{
+    if (!Record::initStatus)
+        return false;
+
+    if (const auto error = opus_encoder_ctl(Record::encoder,
+        OPUS_SET_BITRATE(bitrate)); error < 0)
+    {
+        Logger::LogToFile("[sv:err:record:setbitrate] : failed to "
+            "set bitrate for encoder (code:%d)", error);
+        return false;
+    }
+
+    Record::bitrate = bitrate;
+
+    return true;
+}
+
+bool Record::SetSimulcast(const bool status) noexcept
+{
+    if (!status)
+    {
+        if (Record::lowEncoder != nullptr)
+        {
+            opus_encoder_destroy(Record::lowEncoder);
+            Record::lowEncoder = nullptr;
+        }
+
+        return true;
+    }
+
+    if (!Record::initStatus)
+        return false;
+
+    if (Record::lowEncoder != nullptr)
+        return true;
+
+    {
+        int opusErrorCode { -1 };
+
+        Record::lowEncoder = opus_encoder_create(SV::kFrequency, 1,
+            OPUS_APPLICATION_VOIP, &opusErrorCode);
+
+        if (Record::lowEncoder == nullptr || opusErrorCode < 0)
+        {
+            Logger::LogToFile("[sv:err:record:setsimulcast] : failed to "
+                "create low layer encoder (code:%d)", opusErrorCode);
+            Record::lowEncoder = nullptr;
+            return false;
+        }
+    }
+
+    if (opus_encoder_ctl(Record::lowEncoder, OPUS_SET_BITRATE(SV::kLowLayerBitrate)) < 0 ||
+        opus_encoder_ctl(Record::lowEncoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)) < 0 ||
+        opus_encoder_ctl(Record::lowEncoder, OPUS_SET_FORCE_CHANNELS(TRUE)) < 0 ||
+        opus_encoder_ctl(Record::lowEncoder, OPUS_SET_INBAND_FEC(TRUE)) < 0 ||
+        opus_encoder_ctl(Record::lowEncoder, OPUS_SET_PACKET_LOSS_PERC(10)) < 0)
+    {
+        Logger::LogToFile("[sv:err:record:setsimulcast] : failed to configure low layer encoder");
+        opus_encoder_destroy(Record::lowEncoder);
+        Record::lowEncoder = nullptr;
+        return false;
+    }
+
+    Logger::LogToFile("[sv:dbg:record:setsimulcast] : low layer encoder created");
+
+    return true;
+}
+
+DWORD Record::GetFrame(BYTE* const bufferPtr, const DWORD bufferSize, bool& simulcastFrame) noexcept
 {
     if (!Record::initStatus || !Record::recordStatus || Record::checkStatus)
         return NULL;
@@ -299,10 +370,39 @@ DWORD Record::GetFrame(BYTE* const bufferPtr, const DWORD bufferSize) noexcept
     if (BASS_ChannelGetData(Record::recordChannel, Record::encBuffer.data(),
         SV::kFrameSizeInBytes) != SV::kFrameSizeInBytes) return NULL;
 
-    const auto encDataLength = opus_encode(Record::encoder, Record::encBuffer.data(),
-        SV::kFrameSizeInSamples, bufferPtr, bufferSize);
+    // Low layer is useless when the main one is already as small
+    simulcastFrame = Record::lowEncoder != nullptr && Record::bitrate > SV::kLowLayerBitrate &&
+        bufferSize > sizeof(SV::SimulcastPacket);
+
+    if (!simulcastFrame)
+    {
+        const auto encDataLength = opus_encode(Record::encoder, Record::encBuffer.data(),
+            SV::kFrameSizeInSamples, bufferPtr, bufferSize);
+
+        return encDataLength > 0 ? static_cast<DWORD>(encDataLength) : NULL;
+    }
+
+    const auto simulcastPacket = reinterpret_cast<SV::SimulcastPacket*>(bufferPtr);
+    const auto layersSize = bufferSize - sizeof(SV::SimulcastPacket);
+
+    const auto mainLength = opus_encode(Record::encoder, Record::encBuffer.data(),
+        SV::kFrameSizeInSamples, simulcastPacket->data, layersSize);
+    if (mainLength <= 0) return NULL;
+
+    const auto lowLength = opus_encode(Record::lowEncoder, Record::encBuffer.data(),
+        SV::kFrameSizeInSamples, simulcastPacket->data + mainLength, layersSize - mainLength);
+
+    if (lowLength <= 0)
+    {
+        std::memmove(bufferPtr, simulcastPacket->data, mainLength);
+        simulcastFrame = false;
+
+        return static_cast<DWORD>(mainLength);
+    }
+
+    simulcastPacket->mainLength = static_cast<UINT16>(mainLength);
 
-    return encDataLength > 0 ? static_cast<DWORD>(encDataLength) : NULL;
+    return sizeof(SV::SimulcastPacket) + static_cast<DWORD>(mainLength + lowLength);
 }
 
 bool Record::HasMicro() noexcept
@@ -354,6 +454,7 @@ void Record::StopRecording() noexcept
 
     BASS_ChannelPause(Record::recordChannel);
     opus_encoder_ctl(Record::encoder, OPUS_RESET_STATE);
+    if (Record::lowEncoder != nullptr) opus_encoder_ctl(Record::lowEncoder, OPUS_RESET_STATE);
 
     Logger::LogToFile("[sv:dbg:record:stoprecording] : channel recording stoped");
 
@@ -496,6 +597,8 @@ bool Record::recordStatus { false };
 
 HRECORD Record::recordChannel { NULL };
 OpusEncoder* Record::encoder { nullptr };
+OpusEncoder* Record::lowEncoder { nullptr };
+DWORD Record::bitrate { NULL };
 
 std::array<opus_int16, SV::kFrameSizeInSamples> Record::encBuffer {};
 
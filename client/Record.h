@@ -33,6 +33,8 @@ public:
     static void Free() noexcept;
 
     static void Tick() noexcept;
+    static bool SetBitrate(DWORD bitrate) noexcept;
+    static bool SetSimulcast(bool status) noexcept;
     static bool HasMicro() noexcept;
 
     static bool StartRecording() noexcept;
@@ -43,7 +45,8 @@ public:
     static bool IsChecking() noexcept;
     static void StopChecking() noexcept;
 
-    static DWORD GetFrame(BYTE* bufferPtr, DWORD bufferSize) noexcept;
+    // Simulcast frame is written in SimulcastPacket layout
+    static DWORD GetFrame(BYTE* bufferPtr, DWORD bufferSize, bool& simulcastFrame) noexcept;
 
     static bool GetMicroEnable() noexcept;
     static int GetMicroVolume() noexcept;
@@ -68,6 +71,8 @@ private:
 
     static HRECORD recordChannel;
     static OpusEncoder* encoder;
+    static OpusEncoder* lowEncoder;
+    static DWORD bitrate;
     static std::array<opus_int16, SV::kFrameSizeInSamples> encBuffer;
     static HSTREAM checkChannel;
 
@@ -1,5 +1,7 @@
 #include "Stream.h"
 
+#include <algorithm>
+
 #include <audio/bass.h>
 #include <util/Logger.h>
 
@@ -21,8 +23,40 @@ void Stream::Tick() noexcept
 {
     for (const auto& channel : this->channels)
     {
-        if (channel->HasSpeaker() && !channel->IsActive())
+        if (!channel->HasSpeaker()) continue;
+
+        channel->Tick();
+
+        if (!channel->IsActive())
+        {
+            // Channel forgets its speaker on reset
+            channel->PopStats(this->receiverStats[channel->GetSpeaker()]);
             channel->Reset();
+        }
+    }
+}
+
+void Stream::PopReceiverStats(std::map<WORD, ReceiverStats>& stats) noexcept
+{
+    for (const auto& speakerStats : this->receiverStats)
+    {
+        auto& statsRef = stats[speakerStats.first];
+
+        statsRef.received += speakerStats.second.received;
+        statsRef.lost += speakerStats.second.lost;
+        statsRef.jitter = std::max(statsRef.jitter, speakerStats.second.jitter);
+
+        statsRef.late += speakerStats.second.late;
+        statsRef.underruns += speakerStats.second.underruns;
+        statsRef.delay = std::max(statsRef.delay, speakerStats.second.delay);
+    }
+
+    this->receiverStats.clear();
+
+    for (const auto& channel : this->channels)
+    {
+        if (channel->HasSpeaker())
+            channel->PopStats(stats[channel->GetSpeaker()]);
     }
 }
 
@@ -45,7 +79,9 @@ void Stream::Push(const VoicePacket& packet)
         {
             if (!channel->HasSpeaker())
             {
-                Logger::LogToFile("[sv:dbg:stream:push] : channel %p was occupied by player %hu "
+                static Logger::Limiter occupyLimiter { 1, 10 };
+
+                Logger::LogToFile(occupyLimiter, "[sv:dbg:stream:push] : channel %p was occupied by player %hu "
                     "(stream:%s)", channel.get(), packet.sender, this->streamInfo.GetName().c_str());
 
                 channel->SetSpeaker(packet.sender);
@@ -63,7 +99,9 @@ void Stream::Push(const VoicePacket& packet)
         channelRef->SetStopCallback(std::bind(&Stream::OnChannelStop, this, std::placeholders::_1));
         channelRef->SetSpeaker(packet.sender);
 
-        Logger::LogToFile("[sv:dbg:stream:push] : channel %p for player %hu created (stream:%s)",
+        static Logger::Limiter createLimiter { 1, 10 };
+
+        Logger::LogToFile(createLimiter, "[sv:dbg:stream:push] : channel %p for player %hu created (stream:%s)",
             channelRef.get(), packet.sender, this->streamInfo.GetName().c_str());
 
         this->OnChannelCreate(*channelRef);
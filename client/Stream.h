@@ -60,6 +60,9 @@ public:
     void RemovePlayCallback(std::size_t callback) noexcept;
     void RemoveStopCallback(std::size_t callback) noexcept;
 
+    // Moves receiver statistics of all channels to the table
+    void PopReceiverStats(std::map<WORD, ReceiverStats>& stats) noexcept;
+
 protected:
 
     virtual void OnChannelCreate(const Channel& channel);
@@ -86,6 +89,8 @@ private:
     std::map<BYTE, ParameterPtr> parameters;
     std::map<DWORD, EffectPtr> effects;
 
+    std::map<WORD, ReceiverStats> receiverStats;
+
 };
 
 using StreamPtr = std::unique_ptr<Stream>;
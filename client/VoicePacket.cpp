@@ -9,6 +9,12 @@
 
 #include "VoicePacket.h"
 
+#include <cstring>
+
+#include <util/SipHash.h>
+
+#include "Header.h"
+
 static DWORD CalcCrc32cHash(LPCBYTE buffer, DWORD length, DWORD crc = 0) noexcept
 {
     crc = ~crc;
@@ -26,6 +32,20 @@ static DWORD CalcCrc32cHash(LPCBYTE buffer, DWORD length, DWORD crc = 0) noexcep
     return ~crc;
 }
 
+static LPCBYTE ReadVarint(LPCBYTE buffer, LPCBYTE const end, DWORD& value) noexcept
+{
+    value = 0;
+
+    for (DWORD shift = 0; buffer != end && shift < 32; shift += 7)
+    {
+        const BYTE byte = *buffer++;
+        value |= static_cast<DWORD>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return buffer;
+    }
+
+    return nullptr;
+}
+
 DWORD VoicePacket::GetFullSize() const noexcept
 {
     return sizeof(*this) + this->length;
@@ -46,3 +66,59 @@ void VoicePacket::CalcHash() noexcept
         sizeof(*this) - sizeof(this->hash)
     );
 }
+
+void VoicePacket::CalcAuthTag(const UINT64 k0, const UINT64 k1) noexcept
+{
+    const UINT64 tag = SipHash::Calc(k0, k1, this, this->GetFullSize());
+    std::memcpy(this->data + this->length, &tag, sizeof(tag));
+}
+
+DWORD VoicePacket::WriteCompactUpstream(const LPBYTE buffer) const noexcept
+{
+    const BYTE flags = (this->packet & SV::CompactFlagType::typeMask) |
+        (this->packid == NULL ? SV::CompactFlagType::firstPacket : NULL);
+    const auto packid = static_cast<UINT16>(this->packid);
+
+    std::memcpy(buffer, &this->svrkey, sizeof(this->svrkey));
+    buffer[sizeof(this->svrkey)] = flags;
+    std::memcpy(buffer + sizeof(this->svrkey) + sizeof(flags), &packid, sizeof(packid));
+    std::memcpy(buffer + kCompactUpstreamHeaderSize, this->data, this->length);
+
+    return kCompactUpstreamHeaderSize + this->length;
+}
+
+bool VoicePacket::ReadCompactDownstream(const LPCBYTE buffer, const DWORD length, bool& firstStatus) noexcept
+{
+    const LPCBYTE end = buffer + length;
+    if (length < 1) return false;
+
+    const BYTE flags = *buffer;
+
+    DWORD stream, sender;
+    auto pointer = ReadVarint(buffer + sizeof(flags), end, stream);
+    if (pointer == nullptr) return false;
+    pointer = ReadVarint(pointer, end, sender);
+    if (pointer == nullptr || end - pointer < static_cast<std::ptrdiff_t>(sizeof(UINT16))) return false;
+
+    UINT16 packid; std::memcpy(&packid, pointer, sizeof(packid));
+    pointer += sizeof(packid);
+
+    this->svrkey = NULL;
+    this->packet = flags & SV::CompactFlagType::typeMask;
+    this->stream = stream;
+    this->sender = static_cast<UINT16>(sender);
+    this->length = static_cast<UINT16>(end - pointer);
+    this->packid = packid;
+
+    std::memcpy(this->data, pointer, this->length);
+
+    firstStatus = flags & SV::CompactFlagType::firstPacket;
+
+    return true;
+}
+
+DWORD VoicePacket::RestorePackid(const DWORD lastPackid, const UINT16 packid) noexcept
+{
+    // Nearest to the previous one, so that reordered packets stay behind it
+    return lastPackid + static_cast<INT16>(packid - static_cast<UINT16>(lastPackid));
+}
@@ -31,6 +31,25 @@ struct VoicePacket
     DWORD GetFullSize() const noexcept;
     bool CheckHeader() const noexcept;
     void CalcHash() noexcept;
+
+    // Tag is placed right after packet data and covers header with data,
+    // container must have kVoiceAuthTagSize spare bytes after the data
+    void CalcAuthTag(UINT64 k0, UINT64 k1) noexcept;
+
+    // Compact header (v3.3) replaces this one when server accepted it:
+    //   upstream:   server key (32 bits), flags, packid (16 bits)
+    //   downstream: flags, varint stream, varint sender, packid (16 bits)
+    // Data length is the rest of datagram (before tag)
+    static constexpr DWORD kCompactUpstreamHeaderSize = 4 + 1 + 2;
+
+    // Buffer must have room for header, data and tag
+    DWORD WriteCompactUpstream(LPBYTE buffer) const noexcept;
+
+    // Container must have room for 'length' bytes, false for malformed packet.
+    // Packid is left as received and should be restored with RestorePackid
+    bool ReadCompactDownstream(LPCBYTE buffer, DWORD length, bool& firstStatus) noexcept;
+
+    static DWORD RestorePackid(DWORD lastPackid, UINT16 packid) noexcept;
 };
 
 #pragma pack(pop)
@@ -9,24 +9,83 @@
 
 #include "Logger.h"
 
+#include <chrono>
+
+Logger::Limiter::Limiter(const DWORD interval, const DWORD burst) noexcept
+    : interval(interval), burst(burst)
+{}
+
+bool Logger::Limiter::Allow(DWORD& suppressedCount) noexcept
+{
+    const auto curTime = Logger::cachedTime.load(std::memory_order_relaxed);
+    auto windowTime = this->windowTime.load(std::memory_order_relaxed);
+
+    if (curTime - windowTime >= this->interval && this->windowTime.compare_exchange_strong
+        (windowTime, curTime, std::memory_order_relaxed, std::memory_order_relaxed))
+    {
+        this->windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (this->windowCount.fetch_add(1, std::memory_order_relaxed) >= this->burst)
+    {
+        this->suppressedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressedCount = this->suppressedCount.exchange(0, std::memory_order_relaxed);
+
+    return true;
+}
+
+Logger::RingOwner::~RingOwner() noexcept
+{
+    if (this->ring != nullptr) this->ring->ownerStatus.store(false, std::memory_order_release);
+}
+
 bool Logger::Init(const char* const fileName) noexcept
 {
-    const std::scoped_lock lock { Logger::logFileMutex };
+    if (Logger::initStatus.load(std::memory_order_acquire))
+        return false;
 
-    if (Logger::logFile != nullptr)
+    if ((Logger::logFile = std::fopen(fileName, "wt")) == nullptr)
         return false;
 
-    Logger::logFile = std::fopen(fileName, "wt");
+    Logger::cachedTime.store(static_cast<DWORD>(std::time(nullptr)), std::memory_order_relaxed);
+    Logger::initStatus.store(true, std::memory_order_release);
+
+    try
+    {
+        Logger::flushBuffer.reserve(kRingSize * kRecordTextSize);
+        Logger::flushThread = std::make_unique<std::thread>(&Logger::FlushThreadFunc);
+    }
+    catch (...)
+    {
+        Logger::initStatus.store(false, std::memory_order_release);
+
+        std::fclose(Logger::logFile);
+        Logger::logFile = nullptr;
 
-    if (Logger::logFile == nullptr)
         return false;
+    }
 
     return true;
 }
 
 bool Logger::Free() noexcept
 {
-    const std::scoped_lock lock { Logger::logFileMutex };
+    if (!Logger::initStatus.exchange(false))
+        return false;
+
+    // Init is called from DllMain, so the flush thread may not have been started
+    // yet if loading fails there, and joining it under the loader lock would hang
+    if (Logger::flushStatus.load())
+        Logger::flushThread->join();
+    else
+        Logger::flushThread->detach();
+
+    Logger::flushThread.reset();
+
+    Logger::Flush();
 
     if (std::fclose(Logger::logFile) == EOF)
         return false;
@@ -36,7 +95,149 @@ bool Logger::Free() noexcept
     return true;
 }
 
+Logger::Ring* Logger::GetThreadRing() noexcept
+{
+    if (Logger::threadRing.ring != nullptr)
+        return Logger::threadRing.ring;
+
+    const std::scoped_lock lock { Logger::ringsMutex };
+
+    // Rings of finished threads are handed over once the flusher drained them
+    for (const auto& ring : Logger::rings)
+    {
+        if (!ring->ownerStatus.load(std::memory_order_acquire) &&
+            ring->readIndex.load(std::memory_order_acquire) == ring->writeIndex.load(std::memory_order_relaxed))
+        {
+            ring->ownerStatus.store(true, std::memory_order_relaxed);
+            return Logger::threadRing.ring = ring.get();
+        }
+    }
+
+    try
+    {
+        Logger::rings.emplace_back(std::make_unique<Ring>());
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+
+    return Logger::threadRing.ring = Logger::rings.back().get();
+}
+
+void Logger::Flush() noexcept
+{
+    Logger::cachedTime.store(static_cast<DWORD>(std::time(nullptr)), std::memory_order_relaxed);
+
+    Logger::flushRings.clear();
+    Logger::flushRecords.clear();
+    Logger::flushBuffer.clear();
+
+    DWORD droppedCount { 0 };
+
+    try
+    {
+        {
+            const std::scoped_lock lock { Logger::ringsMutex };
+
+            for (const auto& ring : Logger::rings)
+            {
+                const auto readIndex = ring->readIndex.load(std::memory_order_relaxed);
+                const auto writeIndex = ring->writeIndex.load(std::memory_order_acquire);
+
+                droppedCount += ring->droppedCount.exchange(0, std::memory_order_relaxed);
+
+                if (readIndex == writeIndex) continue;
+
+                for (auto index = readIndex; index != writeIndex; ++index)
+                    Logger::flushRecords.emplace_back(&ring->records[index % kRingSize]);
+
+                Logger::flushRings.emplace_back(ring.get(), writeIndex);
+            }
+        }
+
+        // Restore the global order of lines written by different threads
+        std::sort(Logger::flushRecords.begin(), Logger::flushRecords.end(),
+            [](const Record* const a, const Record* const b) noexcept
+            { return static_cast<LONG>(a->sequence - b->sequence) < 0; });
+
+        char timeString[16] {};
+        DWORD timeValue { 0 };
+
+        const auto formatTime = [&](const DWORD time) noexcept
+        {
+            if (time == timeValue && timeString[0] != '\0') return;
+
+            const auto cTime = static_cast<std::time_t>(time);
+            const auto timeOfDay = std::localtime(&cTime);
+
+            if (timeOfDay != nullptr) std::snprintf(timeString, sizeof(timeString), "[%.2d:%.2d:%.2d] : ",
+                timeOfDay->tm_hour, timeOfDay->tm_min, timeOfDay->tm_sec);
+
+            timeValue = time;
+        };
+
+        for (const auto record : Logger::flushRecords)
+        {
+            formatTime(record->time);
+
+            Logger::flushBuffer.append(timeString);
+            Logger::flushBuffer.append(record->text, record->length);
+            Logger::flushBuffer.push_back('\n');
+        }
+
+        if (droppedCount != 0)
+        {
+            char droppedString[96];
+
+            formatTime(Logger::cachedTime.load(std::memory_order_relaxed));
+
+            std::snprintf(droppedString, sizeof(droppedString), "[sv:err:logger:flush] : "
+                "%u messages dropped on ring overflow", droppedCount);
+
+            Logger::flushBuffer.append(timeString);
+            Logger::flushBuffer.append(droppedString);
+            Logger::flushBuffer.push_back('\n');
+        }
+    }
+    catch (...) {}
+
+    if (!Logger::flushBuffer.empty())
+    {
+        std::fwrite(Logger::flushBuffer.data(), 1, Logger::flushBuffer.size(), Logger::logFile);
+        std::fflush(Logger::logFile);
+    }
+
+    for (const auto& [ring, writeIndex] : Logger::flushRings)
+        ring->readIndex.store(writeIndex, std::memory_order_release);
+}
+
+void Logger::FlushThreadFunc() noexcept
+{
+    Logger::flushStatus.store(true);
+
+    while (Logger::initStatus.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFlushInterval));
+        Logger::Flush();
+    }
+}
+
 std::FILE* Logger::logFile { nullptr };
 
-std::mutex Logger::logFileMutex;
 std::mutex Logger::logChatMutex;
+
+std::atomic_bool Logger::initStatus { false };
+std::atomic_bool Logger::flushStatus { false };
+std::atomic<DWORD> Logger::sequence { 0 };
+std::atomic<DWORD> Logger::cachedTime { 0 };
+
+std::mutex Logger::ringsMutex;
+std::vector<Logger::RingPtr> Logger::rings;
+
+std::unique_ptr<std::thread> Logger::flushThread { nullptr };
+std::vector<std::pair<Logger::Ring*, DWORD>> Logger::flushRings;
+std::vector<const Logger::Record*> Logger::flushRecords;
+std::string Logger::flushBuffer;
+
+thread_local Logger::RingOwner Logger::threadRing;
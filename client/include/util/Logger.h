@@ -12,7 +12,13 @@
 #include <ctime>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include <array>
 
 #include <d3d9.h>
@@ -39,32 +45,66 @@ class Logger {
     Logger& operator=(const Logger&) = delete;
     Logger& operator=(Logger&&) = delete;
 
+private:
+
+    static constexpr DWORD kRingSize = 512;
+    static constexpr DWORD kRecordTextSize = 256;
+    static constexpr DWORD kFlushInterval = 10;
+
+public:
+
+    // Per call-site rate limiter, declared as a static local next to
+    // noisy log calls. Lets through up to 'burst' messages per 'interval'
+    // seconds, the count of suppressed ones goes with the next message.
+    class Limiter {
+
+        Limiter() = delete;
+        Limiter(const Limiter&) = delete;
+        Limiter(Limiter&&) = delete;
+        Limiter& operator=(const Limiter&) = delete;
+        Limiter& operator=(Limiter&&) = delete;
+
+    public:
+
+        explicit Limiter(DWORD interval, DWORD burst = 1) noexcept;
+
+        ~Limiter() noexcept = default;
+
+    public:
+
+        bool Allow(DWORD& suppressedCount) noexcept;
+
+    private:
+
+        const DWORD interval;
+        const DWORD burst;
+
+        std::atomic<DWORD> windowTime { 0 };
+        std::atomic<DWORD> windowCount { 0 };
+        std::atomic<DWORD> suppressedCount { 0 };
+
+    };
+
 public:
 
     static bool Init(const char* fileName) noexcept;
     static bool Free() noexcept;
 
+    // Formats the message right into the calling thread's ring,
+    // the file is written by the flush thread only
     template<class... ARGS>
     static bool LogToFile(const char* message, ARGS... args) noexcept
     {
-        const std::scoped_lock lock { Logger::logFileMutex };
-
-        if (Logger::logFile == nullptr)
-            return false;
-
-        const auto cTime = std::time(nullptr);
-        const auto timeOfDay = std::localtime(&cTime);
-
-        if (timeOfDay == nullptr)
-            return false;
+        return Logger::Push(NULL, message, args...);
+    }
 
-        std::fprintf(Logger::logFile, "[%.2d:%.2d:%.2d] : ",
-            timeOfDay->tm_hour, timeOfDay->tm_min, timeOfDay->tm_sec);
-        std::fprintf(Logger::logFile, message, args...);
-        std::fputc('\n', Logger::logFile);
-        std::fflush(Logger::logFile);
+    template<class... ARGS>
+    static bool LogToFile(Limiter& limiter, const char* message, ARGS... args) noexcept
+    {
+        DWORD suppressedCount { 0 };
+        if (!limiter.Allow(suppressedCount)) return false;
 
-        return true;
+        return Logger::Push(suppressedCount, message, args...);
     }
 
     template<class... ARGS>
@@ -96,11 +136,106 @@ public:
         Logger::LogToChat(color, message, args...);
     }
 
+private:
+
+    struct Record {
+
+        DWORD sequence;
+        DWORD time;
+        WORD length;
+
+        char text[kRecordTextSize];
+
+    };
+
+    struct Ring {
+
+        std::atomic<DWORD> writeIndex { 0 };
+        std::atomic<DWORD> droppedCount { 0 };
+        std::atomic_bool ownerStatus { true };
+
+        alignas(64) std::atomic<DWORD> readIndex { 0 };
+
+        std::unique_ptr<Record[]> records { std::make_unique<Record[]>(kRingSize) };
+
+    };
+
+    struct RingOwner {
+
+        ~RingOwner() noexcept;
+
+        Ring* ring { nullptr };
+
+    };
+
+    using RingPtr = std::unique_ptr<Ring>;
+
+private:
+
+    template<class... ARGS>
+    static bool Push(const DWORD suppressedCount, const char* message, ARGS... args) noexcept
+    {
+        if (!Logger::initStatus.load(std::memory_order_acquire))
+            return false;
+
+        const auto ring = Logger::GetThreadRing();
+        if (ring == nullptr) return false;
+
+        const auto writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+
+        if (writeIndex - ring->readIndex.load(std::memory_order_acquire) >= kRingSize)
+        {
+            ring->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& record = ring->records[writeIndex % kRingSize];
+
+        auto length = std::snprintf(record.text, sizeof(record.text), message, args...);
+        if (length < 0) return false;
+
+        length = std::min(length, static_cast<int>(sizeof(record.text) - 1));
+
+        if (suppressedCount != 0)
+        {
+            const auto suffixLength = std::snprintf(record.text + length, sizeof(record.text) - length,
+                " (%u similar suppressed)", suppressedCount);
+            if (suffixLength > 0) length = std::min(length + suffixLength, static_cast<int>(sizeof(record.text) - 1));
+        }
+
+        record.sequence = Logger::sequence.fetch_add(1, std::memory_order_relaxed);
+        record.time = Logger::cachedTime.load(std::memory_order_relaxed);
+        record.length = static_cast<WORD>(length);
+
+        ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    static Ring* GetThreadRing() noexcept;
+
+    static void Flush() noexcept;
+    static void FlushThreadFunc() noexcept;
+
 private:
 
     static std::FILE* logFile;
 
-    static std::mutex logFileMutex;
     static std::mutex logChatMutex;
 
+    static std::atomic_bool initStatus;
+    static std::atomic_bool flushStatus;
+    static std::atomic<DWORD> sequence;
+    static std::atomic<DWORD> cachedTime;
+
+    static std::mutex ringsMutex;
+    static std::vector<RingPtr> rings;
+
+    static std::unique_ptr<std::thread> flushThread;
+    static std::vector<std::pair<Ring*, DWORD>> flushRings;
+    static std::vector<const Record*> flushRecords;
+    static std::string flushBuffer;
+
+    static thread_local RingOwner threadRing;
+
 };
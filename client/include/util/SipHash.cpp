@@ -0,0 +1,69 @@
+#include "SipHash.h"
+
+#include <cstring>
+
+#define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND                                                  \
+    do {                                                          \
+        v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32); \
+        v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2;                    \
+        v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0;                    \
+        v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32); \
+    } while (0)
+
+static inline uint64_t ReadLe64(const uint8_t* const bytes) noexcept
+{
+    uint64_t word; std::memcpy(&word, bytes, sizeof(word));
+    return word; // x86 only, little-endian by definition
+}
+
+uint64_t SipHash::Calc(const uint64_t k0, const uint64_t k1, const void* const data, const std::size_t length) noexcept
+{
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    const auto bytes = static_cast<const uint8_t*>(data);
+    const auto end = bytes + (length & ~static_cast<std::size_t>(7));
+
+    for (auto iter = bytes; iter != end; iter += sizeof(uint64_t))
+    {
+        const uint64_t m = ReadLe64(iter);
+
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    uint64_t b = static_cast<uint64_t>(length) << 56;
+
+    switch (length & 7)
+    {
+        case 7: b |= static_cast<uint64_t>(end[6]) << 48;
+        case 6: b |= static_cast<uint64_t>(end[5]) << 40;
+        case 5: b |= static_cast<uint64_t>(end[4]) << 32;
+        case 4: b |= static_cast<uint64_t>(end[3]) << 24;
+        case 3: b |= static_cast<uint64_t>(end[2]) << 16;
+        case 2: b |= static_cast<uint64_t>(end[1]) << 8;
+        case 1: b |= static_cast<uint64_t>(end[0]);
+    }
+
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+#undef SIPROUND
+#undef ROTL
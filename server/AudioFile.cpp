@@ -0,0 +1,524 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "AudioFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <util/logger.h>
+
+#include "VoicePacket.h"
+#include "OggWriter.h"
+#include "Header.h"
+
+AudioFile::~AudioFile() noexcept
+{
+    this->Unmap();
+}
+
+std::shared_ptr<const AudioFile> AudioFile::Load(const std::string& fileName)
+{
+    if (const auto iter = AudioFile::fileCache.find(fileName); iter != AudioFile::fileCache.end())
+    {
+        if (auto file = iter->second.lock()) return file;
+        AudioFile::fileCache.erase(iter);
+    }
+
+    std::shared_ptr<AudioFile> file { new (std::nothrow) AudioFile() };
+    if (file == nullptr) return nullptr;
+
+    if (!file->Map(fileName))
+    {
+        Logger::Log("[sv:err:audiofile:load] : failed to map file (%s)", fileName.c_str());
+        return nullptr;
+    }
+
+    if (!file->Parse(fileName))
+        return nullptr;
+
+    // Mapping is only kept for packets referenced in it
+    if (file->mappedPackets == 0) file->Unmap();
+
+    Logger::Log("[sv:dbg:audiofile:load] : file (%s) loaded (packets:%zu;regrouped:%zu;dropped frames:%u)",
+        fileName.c_str(), file->packets.size(), file->packets.size() - file->mappedPackets, file->droppedFrames);
+
+    AudioFile::fileCache[fileName] = file;
+
+    return file;
+}
+
+const AudioFile::Packet* AudioFile::GetPackets() const noexcept
+{
+    return this->packets.data();
+}
+
+std::size_t AudioFile::GetPacketsCount() const noexcept
+{
+    return this->packets.size();
+}
+
+bool AudioFile::Map(const std::string& fileName) noexcept
+{
+#ifdef _WIN32
+    this->fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (this->fileHandle == INVALID_HANDLE_VALUE)
+    {
+        this->fileHandle = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(this->fileHandle, &fileSize) || fileSize.QuadPart == 0 ||
+        (this->mapHandle = CreateFileMappingA(this->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr ||
+        (this->mapData = static_cast<const uint8_t*>(MapViewOfFile(this->mapHandle, FILE_MAP_READ, 0, 0, 0))) == nullptr)
+    {
+        this->Unmap();
+        return false;
+    }
+
+    this->mapSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor == -1) return false;
+
+    struct stat fileStat;
+
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    const auto mapData = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    close(fileDescriptor);
+
+    if (mapData == MAP_FAILED) return false;
+
+    this->mapData = static_cast<const uint8_t*>(mapData);
+    this->mapSize = static_cast<std::size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+void AudioFile::Unmap() noexcept
+{
+#ifdef _WIN32
+    if (this->mapData != nullptr) UnmapViewOfFile(this->mapData);
+    if (this->mapHandle != nullptr) CloseHandle(this->mapHandle);
+    if (this->fileHandle != nullptr) CloseHandle(this->fileHandle);
+
+    this->mapHandle = nullptr;
+    this->fileHandle = nullptr;
+#else
+    if (this->mapData != nullptr) munmap(const_cast<uint8_t*>(this->mapData), this->mapSize);
+#endif
+
+    this->mapData = nullptr;
+    this->mapSize = 0;
+}
+
+bool AudioFile::Parse(const std::string& fileName)
+{
+    std::vector<uint8_t> spannedPacket;
+    bool spannedStatus { false };
+
+    uint32_t serial { 0 };
+    bool serialStatus { false };
+    uint32_t headerPackets { 0 };
+    bool errorStatus { false };
+
+    const auto handlePacket = [&](const uint8_t* const data, const uint32_t length, const bool mappedStatus)
+    {
+        // Identification and comment headers precede audio packets
+        if (headerPackets == 0)
+        {
+            if (length < 19 || std::memcmp(data, "OpusHead", 8) != 0 || (data[8] & 0xf0) != 0)
+                errorStatus = true;
+        }
+        else if (headerPackets != 1)
+        {
+            this->AddPacket(data, length, mappedStatus);
+        }
+
+        ++headerPackets;
+    };
+
+    for (std::size_t offset { 0 }; offset + 27 <= this->mapSize && !errorStatus;)
+    {
+        const uint8_t* const page = this->mapData + offset;
+
+        if (std::memcmp(page, "OggS", 4) != 0 || page[4] != 0)
+        {
+            errorStatus = true;
+            break;
+        }
+
+        const uint8_t pageFlags = page[5];
+        const uint8_t segmentsCount = page[26];
+
+        uint32_t pageSerial;
+        std::memcpy(&pageSerial, page + 14, sizeof(pageSerial));
+
+        if (offset + 27 + segmentsCount > this->mapSize)
+            break;
+
+        const uint8_t* const segments = page + 27;
+        const uint8_t* const body = segments + segmentsCount;
+
+        std::size_t bodySize { 0 };
+        for (uint8_t i { 0 }; i < segmentsCount; ++i)
+            bodySize += segments[i];
+
+        if (offset + 27 + segmentsCount + bodySize > this->mapSize)
+            break;
+
+        offset += 27 + segmentsCount + bodySize;
+
+        // Only the first logical stream is played
+        if (!serialStatus)
+        {
+            if ((pageFlags & 0x02) == 0)
+            {
+                errorStatus = true;
+                break;
+            }
+
+            serial = pageSerial;
+            serialStatus = true;
+        }
+
+        if (pageSerial != serial) continue;
+
+        // Tail of a packet that started before is useless without its head
+        bool skipStatus = (pageFlags & 0x01) != 0 && !spannedStatus;
+
+        if ((pageFlags & 0x01) == 0)
+        {
+            spannedPacket.clear();
+            spannedStatus = false;
+        }
+
+        std::size_t packetBegin { 0 };
+        std::size_t packetLength { 0 };
+
+        for (uint8_t i { 0 }; i < segmentsCount; ++i)
+        {
+            packetLength += segments[i];
+            if (segments[i] == 255) continue;
+
+            if (skipStatus)
+            {
+                skipStatus = false;
+            }
+            else if (spannedStatus)
+            {
+                spannedPacket.insert(spannedPacket.end(), body + packetBegin, body + packetBegin + packetLength);
+                handlePacket(spannedPacket.data(), spannedPacket.size(), false);
+                spannedPacket.clear();
+                spannedStatus = false;
+            }
+            else
+            {
+                handlePacket(body + packetBegin, packetLength, true);
+            }
+
+            packetBegin += packetLength;
+            packetLength = 0;
+        }
+
+        if (segmentsCount != 0 && segments[segmentsCount - 1] == 255 && !skipStatus)
+        {
+            spannedPacket.insert(spannedPacket.end(), body + packetBegin, body + packetBegin + packetLength);
+            spannedStatus = true;
+        }
+
+        if (pageFlags & 0x04) break;
+    }
+
+    if (errorStatus || headerPackets == 0)
+    {
+        Logger::Log("[sv:err:audiofile:parse] : file (%s) is not ogg opus", fileName.c_str());
+        return false;
+    }
+
+    this->droppedFrames += this->groupSizes.size();
+
+    if (this->packets.empty())
+    {
+        Logger::Log("[sv:err:audiofile:parse] : file (%s) has no packets of supported "
+            "frame durations (up to 20 ms or 100 ms)", fileName.c_str());
+        return false;
+    }
+
+    this->buffer.shrink_to_fit();
+
+    for (const auto& [packet, offset] : this->bufferPackets)
+        this->packets[packet].data = this->buffer.data() + offset;
+
+    this->bufferPackets.clear();
+    this->bufferPackets.shrink_to_fit();
+    this->groupSizes.clear();
+    this->groupSizes.shrink_to_fit();
+    this->groupData.clear();
+    this->groupData.shrink_to_fit();
+
+    return true;
+}
+
+void AudioFile::AddPacket(const uint8_t* const data, const uint32_t length, const bool mappedStatus)
+{
+    if (OggWriter::GetPacketSamples(data, length) != SV::kFrameSizeInSamples)
+    {
+        this->AddFrames(data, length);
+        return;
+    }
+
+    // Frames left from shorter packets can not make a whole packet anymore
+    this->droppedFrames += this->groupSizes.size();
+    this->groupSizes.clear();
+    this->groupData.clear();
+    this->groupSamples = 0;
+
+    if (length > kMaxPacketSize) return;
+
+    if (mappedStatus)
+    {
+        this->packets.push_back({ data, static_cast<uint16_t>(length) });
+        ++this->mappedPackets;
+    }
+    else
+    {
+        this->bufferPackets.emplace_back(this->packets.size(), this->buffer.size());
+        this->packets.push_back({ nullptr, static_cast<uint16_t>(length) });
+        this->buffer.insert(this->buffer.end(), data, data + length);
+    }
+}
+
+void AudioFile::AddFrames(const uint8_t* const data, const uint32_t length)
+{
+    const uint8_t* frames[kMaxFramesCount];
+    uint16_t sizes[kMaxFramesCount];
+    uint32_t framesCount;
+
+    const auto samples = OggWriter::GetPacketSamples(data, length);
+
+    if (samples == 0 || !AudioFile::SplitPacket(data, length, frames, sizes, framesCount))
+        return;
+
+    // Frames of one packet share configuration and stereo flag of TOC
+    const uint8_t toc = data[0] & 0xfc;
+    const uint32_t frameSamples = samples / framesCount;
+
+    for (uint32_t i { 0 }; i < framesCount; ++i)
+    {
+        if (this->groupSamples != 0 && toc != this->groupToc)
+        {
+            this->droppedFrames += this->groupSizes.size();
+            this->groupSizes.clear();
+            this->groupData.clear();
+            this->groupSamples = 0;
+        }
+
+        this->groupToc = toc;
+        this->groupSizes.emplace_back(sizes[i]);
+        this->groupData.insert(this->groupData.end(), frames[i], frames[i] + sizes[i]);
+        this->groupSamples += frameSamples;
+
+        if (this->groupSamples >= SV::kFrameSizeInSamples)
+            this->FlushFrames();
+    }
+}
+
+void AudioFile::FlushFrames()
+{
+    const auto framesCount = this->groupSizes.size();
+    const auto offset = this->buffer.size();
+
+    // Frames that overshoot the duration (40 and 60 ms) can not be regrouped
+    if (this->groupSamples == SV::kFrameSizeInSamples && framesCount <= kMaxFramesCount)
+    {
+        const bool cbrStatus = std::all_of(this->groupSizes.begin(), this->groupSizes.end(),
+            [this](const uint16_t size) { return size == this->groupSizes.front(); });
+
+        // Code 3 packet (RFC 6716, 3.2.5) without padding
+        this->buffer.emplace_back(this->groupToc | 0x03);
+        this->buffer.emplace_back((cbrStatus ? 0x00 : 0x80) | framesCount);
+
+        if (!cbrStatus)
+        {
+            for (std::size_t i { 0 }; i + 1 < framesCount; ++i)
+            {
+                const auto size = this->groupSizes[i];
+
+                if (size < 252)
+                {
+                    this->buffer.emplace_back(size);
+                }
+                else
+                {
+                    const uint8_t firstByte = 252 + (size & 0x03);
+
+                    this->buffer.emplace_back(firstByte);
+                    this->buffer.emplace_back((size - firstByte) >> 2);
+                }
+            }
+        }
+
+        this->buffer.insert(this->buffer.end(), this->groupData.begin(), this->groupData.end());
+
+        if (const auto length = this->buffer.size() - offset; length <= kMaxPacketSize)
+        {
+            this->bufferPackets.emplace_back(this->packets.size(), offset);
+            this->packets.push_back({ nullptr, static_cast<uint16_t>(length) });
+        }
+        else
+        {
+            this->buffer.resize(offset);
+            this->droppedFrames += framesCount;
+        }
+    }
+    else
+    {
+        this->droppedFrames += framesCount;
+    }
+
+    this->groupSizes.clear();
+    this->groupData.clear();
+    this->groupSamples = 0;
+}
+
+bool AudioFile::SplitPacket(const uint8_t* const data, const uint32_t length, const uint8_t** const frames,
+                            uint16_t* const sizes, uint32_t& framesCount) noexcept
+{
+    if (length == 0) return false;
+
+    const uint8_t* iter = data + 1;
+    uint32_t left = length - 1;
+
+    const auto readSize = [&iter, &left](uint16_t& size) noexcept -> bool
+    {
+        if (left < 1) return false;
+
+        if (iter[0] < 252)
+        {
+            size = iter[0];
+            iter += 1; left -= 1;
+            return true;
+        }
+
+        if (left < 2) return false;
+
+        size = iter[0] + 4 * iter[1];
+        iter += 2; left -= 2;
+        return true;
+    };
+
+    switch (data[0] & 0x03)
+    {
+        case 0:
+        {
+            framesCount = 1;
+            sizes[0] = left;
+            break;
+        }
+        case 1:
+        {
+            if (left % 2 != 0) return false;
+
+            framesCount = 2;
+            sizes[0] = sizes[1] = left / 2;
+            break;
+        }
+        case 2:
+        {
+            if (!readSize(sizes[0]) || sizes[0] > left) return false;
+
+            framesCount = 2;
+            sizes[1] = left - sizes[0];
+            break;
+        }
+        default:
+        {
+            if (left < 1) return false;
+
+            const uint8_t countByte = *iter++; --left;
+
+            framesCount = countByte & 0x3f;
+            if (framesCount == 0 || framesCount > kMaxFramesCount) return false;
+
+            // Padding is placed after frames
+            if (countByte & 0x40)
+            {
+                uint32_t paddingSize { 0 };
+                uint8_t paddingByte;
+
+                do
+                {
+                    if (left < 1) return false;
+
+                    paddingByte = *iter++; --left;
+                    paddingSize += paddingByte == 255 ? 254 : paddingByte;
+                }
+                while (paddingByte == 255);
+
+                if (paddingSize > left) return false;
+
+                left -= paddingSize;
+            }
+
+            if (countByte & 0x80)
+            {
+                uint32_t totalSize { 0 };
+
+                for (uint32_t i { 0 }; i + 1 < framesCount; ++i)
+                {
+                    if (!readSize(sizes[i])) return false;
+                    totalSize += sizes[i];
+                }
+
+                if (totalSize > left) return false;
+
+                sizes[framesCount - 1] = left - totalSize;
+            }
+            else
+            {
+                if (left % framesCount != 0) return false;
+
+                std::fill_n(sizes, framesCount, left / framesCount);
+            }
+        }
+    }
+
+    for (uint32_t i { 0 }; i < framesCount; ++i)
+    {
+        if (sizes[i] > 1275) return false;
+
+        frames[i] = iter;
+        iter += sizes[i];
+    }
+
+    return true;
+}
+
+std::map<std::string, std::weak_ptr<const AudioFile>> AudioFile::fileCache;
@@ -0,0 +1,108 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "VoicePacket.h"
+
+// Pre-encoded Ogg Opus file mapped into memory and split into packets of
+// protocol frame duration. Packets of that duration are referenced in the
+// mapping as is, shorter ones (20 ms of opusenc by default) are regrouped
+// into 100 ms packets once on loading. File is immutable after loading and
+// shared by all sources playing it.
+class AudioFile {
+
+    AudioFile(const AudioFile&) = delete;
+    AudioFile(AudioFile&&) = delete;
+    AudioFile& operator=(const AudioFile&) = delete;
+    AudioFile& operator=(AudioFile&&) = delete;
+
+private:
+
+    // Network drops bigger datagrams anyway
+    static constexpr uint32_t kMaxPacketSize = 1400 - sizeof(VoicePacket);
+    static constexpr uint32_t kMaxFramesCount = 48;
+
+public:
+
+    struct Packet {
+
+        const uint8_t* data { nullptr };
+        uint16_t length { 0 };
+
+    };
+
+private:
+
+    AudioFile() noexcept = default;
+
+public:
+
+    ~AudioFile() noexcept;
+
+public:
+
+    // Files are cached by name while any source holds them
+    static std::shared_ptr<const AudioFile> Load(const std::string& fileName);
+
+    const Packet* GetPackets() const noexcept;
+    std::size_t GetPacketsCount() const noexcept;
+
+private:
+
+    bool Map(const std::string& fileName) noexcept;
+    void Unmap() noexcept;
+
+    bool Parse(const std::string& fileName);
+    void AddPacket(const uint8_t* data, uint32_t length, bool mappedStatus);
+    void AddFrames(const uint8_t* data, uint32_t length);
+    void FlushFrames();
+
+    // Splits opus packet into frames (RFC 6716, 3.2), false for malformed packet
+    static bool SplitPacket(const uint8_t* data, uint32_t length, const uint8_t** frames,
+                            uint16_t* sizes, uint32_t& framesCount) noexcept;
+
+private:
+
+    const uint8_t* mapData { nullptr };
+    std::size_t mapSize { 0 };
+
+#ifdef _WIN32
+    void* fileHandle { nullptr };
+    void* mapHandle { nullptr };
+#endif
+
+    std::vector<Packet> packets;
+    std::vector<uint8_t> buffer;
+
+    // Regrouped packets point to buffer only when it stops growing
+    std::vector<std::pair<std::size_t, uint32_t>> bufferPackets;
+
+    // Frames waiting to fill a packet, all of them have the same TOC
+    uint8_t groupToc { 0 };
+    uint32_t groupSamples { 0 };
+    std::vector<uint16_t> groupSizes;
+    std::vector<uint8_t> groupData;
+
+    uint32_t mappedPackets { 0 };
+    uint32_t droppedFrames { 0 };
+
+private:
+
+    static std::map<std::string, std::weak_ptr<const AudioFile>> fileCache;
+
+};
@@ -0,0 +1,133 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "AudioSource.h"
+
+#include <array>
+#include <cstring>
+
+#include <util/logger.h>
+
+#include "SourcePool.h"
+#include "Federation.h"
+#include "Stream.h"
+#include "Metrics.h"
+#include "Header.h"
+
+AudioSource::AudioSource(std::shared_ptr<const AudioFile> file)
+    : handle(AudioSource::sourceTable.Insert(this))
+    , sender(AudioSource::MakeSender(this->handle))
+    , file(std::move(file))
+{
+    if (this->sender == SV::kNonePlayer)
+        Logger::Log("[sv:err:audiosource:init] : sources limit reached");
+}
+
+AudioSource::~AudioSource() noexcept
+{
+    this->Stop();
+
+    AudioSource::sourceTable.Remove(this->handle);
+}
+
+uint32_t AudioSource::GetHandle() const noexcept
+{
+    return this->handle;
+}
+
+uint16_t AudioSource::GetSender() const noexcept
+{
+    return this->sender;
+}
+
+AudioSource* AudioSource::FromHandle(const uint32_t handle) noexcept
+{
+    return AudioSource::sourceTable.Get(handle);
+}
+
+std::size_t AudioSource::GetSourcesCount() noexcept
+{
+    return AudioSource::sourceTable.GetCount();
+}
+
+void AudioSource::Play(Stream* const stream, const bool loop)
+{
+    this->Stop();
+
+    this->stream = stream;
+    this->loopStatus = loop;
+    this->position = 0;
+
+    // Client restarts its channel on the first packet number
+    this->packid = 0;
+
+    this->playStatus.store(true, std::memory_order_relaxed);
+
+    SourcePool::Register(this);
+}
+
+void AudioSource::Stop() noexcept
+{
+    SourcePool::Unregister(this);
+
+    this->playStatus.store(false, std::memory_order_relaxed);
+    this->stream = nullptr;
+}
+
+bool AudioSource::IsPlaying() const noexcept
+{
+    return this->playStatus.load(std::memory_order_relaxed);
+}
+
+void AudioSource::Tick() noexcept
+{
+    if (!this->playStatus.load(std::memory_order_relaxed))
+        return;
+
+    if (this->position >= this->file->GetPacketsCount())
+    {
+        // Finished source stays registered until it is stopped or played again
+        if (!this->loopStatus)
+        {
+            this->playStatus.store(false, std::memory_order_relaxed);
+            return;
+        }
+
+        this->position = 0;
+    }
+
+    const auto& packet = this->file->GetPackets()[this->position++];
+
+    static thread_local std::array<uint8_t, 1400> buffer;
+
+    auto& voicePacket = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+    voicePacket.svrkey = NULL;
+    voicePacket.packet = SV::VoicePacketType::voicePacket;
+    voicePacket.sender = this->sender;
+    voicePacket.length = packet.length;
+    voicePacket.packid = this->packid++;
+
+    std::memcpy(voicePacket.data, packet.data, packet.length);
+
+    this->stream->SendVoicePacket(voicePacket);
+
+    Metrics::Add(StatType::sourceFramesSent);
+}
+
+uint16_t AudioSource::MakeSender(const uint32_t handle) noexcept
+{
+    if (handle == SlotMap<AudioSource>::kInvalidHandle) return SV::kNonePlayer;
+
+    // Ids of remote speakers and mixer player are reserved
+    const uint32_t sender = kMinSender + SlotMap<AudioSource>::GetIndex(handle);
+    return sender < Federation::kMinSender ? sender : SV::kNonePlayer;
+}
+
+SlotMap<AudioSource> AudioSource::sourceTable;
@@ -0,0 +1,89 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <ysf/structs.h>
+
+#include "AudioFile.h"
+#include "SlotMap.h"
+
+class Stream;
+
+// Server side speaker playing audio file into a stream (radio stations,
+// announcements). Packets are sent on behalf of a virtual player id above
+// MAX_PLAYERS, so that clients play every source in its own channel.
+// Sources are paced by the single thread of SourcePool.
+class AudioSource {
+
+    AudioSource() = delete;
+    AudioSource(const AudioSource&) = delete;
+    AudioSource(AudioSource&&) = delete;
+    AudioSource& operator=(const AudioSource&) = delete;
+    AudioSource& operator=(AudioSource&&) = delete;
+
+public:
+
+    static constexpr uint16_t kMinSender = MAX_PLAYERS;
+
+public:
+
+    explicit AudioSource(std::shared_ptr<const AudioFile> file);
+
+    ~AudioSource() noexcept;
+
+public:
+
+    uint32_t GetHandle() const noexcept;
+
+    // SV::kNonePlayer if sources limit is reached, such source is never played
+    uint16_t GetSender() const noexcept;
+
+    // Returns nullptr for handles of deleted sources
+    static AudioSource* FromHandle(uint32_t handle) noexcept;
+    static std::size_t GetSourcesCount() noexcept;
+
+    // Starts file from the beginning, source plays into one stream at a time
+    void Play(Stream* stream, bool loop);
+    void Stop() noexcept;
+    bool IsPlaying() const noexcept;
+
+    // Called by source thread once per voice frame
+    void Tick() noexcept;
+
+private:
+
+    friend class SourcePool;
+
+    static uint16_t MakeSender(uint32_t handle) noexcept;
+
+private:
+
+    const uint32_t handle;
+    const uint16_t sender;
+    const std::shared_ptr<const AudioFile> file;
+
+    // Changed only while source is not registered in pool
+    Stream* stream { nullptr };
+    bool loopStatus { false };
+    std::size_t position { 0 };
+    uint32_t packid { 0 };
+
+    std::atomic_bool playStatus { false };
+
+private:
+
+    static SlotMap<AudioSource> sourceTable;
+
+};
@@ -0,0 +1,203 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "BitrateController.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <util/logger.h>
+
+#include "ControlPacket.h"
+#include "Network.h"
+#include "Metrics.h"
+#include "Stream.h"
+
+void BitrateController::SetBaseBitrate(const uint32_t bitrate) noexcept
+{
+    BitrateController::baseBitrate = std::clamp(bitrate, kLowestBitrate, kHighestBitrate);
+}
+
+void BitrateController::SetLimits(const uint32_t minBitrate, const uint32_t maxBitrate) noexcept
+{
+    BitrateController::minBitrate = std::clamp(minBitrate, kLowestBitrate, kHighestBitrate);
+    BitrateController::maxBitrate = maxBitrate != 0 ? std::clamp(maxBitrate, kLowestBitrate, kHighestBitrate) : 0;
+}
+
+void BitrateController::ResetPlayer(const uint16_t playerId) noexcept
+{
+    assert(playerId >= 0 && playerId < MAX_PLAYERS);
+
+    auto& speaker = BitrateController::speakers[playerId];
+
+    // Client starts with the bitrate of init packet
+    speaker.bitrate = 0;
+    speaker.losses.clear();
+    speaker.jitters.clear();
+    speaker.reporters.fill(0);
+
+    // Newcomer with the same id gives its own samples
+    for (auto& iSpeaker : BitrateController::speakers)
+        PlayerBitset::Reset(iSpeaker.reporters, playerId);
+
+    BitrateController::lastReportTimes[playerId] = 0;
+
+    BitrateController::congestedListeners[playerId] = false;
+    Stream::SetListenerCongestion(playerId, false);
+}
+
+void BitrateController::AddReport(const uint16_t listenerId, const SV::ReceiverReportEntry* const entries, const std::size_t count) noexcept
+{
+    if (listenerId >= MAX_PLAYERS) return;
+
+    const auto curTime = Timer::Get();
+
+    if (curTime - BitrateController::lastReportTimes[listenerId] < kMinReportInterval) return;
+    BitrateController::lastReportTimes[listenerId] = curTime;
+
+    Metrics::Add(StatType::receiverReportsReceived);
+
+    PlayerBitset::Words heardSpeakers;
+    Stream::GetHeardSpeakers(listenerId, heardSpeakers);
+
+    uint32_t lossSum { 0 };
+
+    for (std::size_t i { 0 }; i < count; ++i)
+    {
+        lossSum += entries[i].loss;
+
+        const uint16_t speakerId = entries[i].speaker;
+
+        // Server sources and mixer don't encode on client side
+        if (speakerId >= MAX_PLAYERS || speakerId == listenerId) continue;
+
+        // Listener speaks only for speakers it hears and only once per interval,
+        // so that a single client can't outweigh the rest of the audience
+        if (!PlayerBitset::Test(heardSpeakers, speakerId)) continue;
+
+        auto& speaker = BitrateController::speakers[speakerId];
+
+        if (PlayerBitset::Test(speaker.reporters, listenerId)) continue;
+        PlayerBitset::Set(speaker.reporters, listenerId);
+
+        speaker.losses.push_back(entries[i].loss);
+        speaker.jitters.push_back(entries[i].jitter);
+    }
+
+    if (count == 0) return;
+
+    // Loss on every heard speaker at once points to the listener's own downlink
+    const auto loss = lossSum / count;
+    auto& congestionStatus = BitrateController::congestedListeners[listenerId];
+
+    if (!congestionStatus && loss >= kHighLoss) congestionStatus = true;
+    else if (congestionStatus && loss <= kLowLoss) congestionStatus = false;
+    else return;
+
+    Logger::Log("[sv:dbg:bitrate:addreport] : listener (%hu) congestion status changed (%hhu)",
+        listenerId, congestionStatus);
+
+    Stream::SetListenerCongestion(listenerId, congestionStatus);
+}
+
+void BitrateController::Tick() noexcept
+{
+    const auto curTime = Timer::Get();
+
+    if (curTime - BitrateController::lastDecisionTime < kDecisionInterval) return;
+    BitrateController::lastDecisionTime = curTime;
+
+    for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+    {
+        auto& speaker = BitrateController::speakers[iPlayerId];
+
+        if (!Network::HasBitrateControl(iPlayerId))
+        {
+            speaker.losses.clear();
+            speaker.jitters.clear();
+            speaker.reporters.fill(0);
+            continue;
+        }
+
+        const uint32_t curBitrate = speaker.bitrate != 0 ? speaker.bitrate : BitrateController::baseBitrate;
+        const uint32_t newBitrate = BitrateController::Decide(curBitrate, speaker.losses, speaker.jitters);
+
+        speaker.losses.clear();
+        speaker.jitters.clear();
+        speaker.reporters.fill(0);
+
+        if (newBitrate == curBitrate) continue;
+
+        ControlPacket* controlPacket { nullptr };
+
+        PackAlloca(controlPacket, SV::ControlPacketType::setBitrate, sizeof(SV::SetBitratePacket));
+        PackGetStruct(controlPacket, SV::SetBitratePacket)->bitrate = newBitrate;
+
+        if (!Network::SendControlPacket(iPlayerId, *controlPacket))
+        {
+            Logger::Log("[sv:err:bitrate:tick] : failed to send bitrate to player (%hu)", iPlayerId);
+            continue;
+        }
+
+        Logger::Log("[sv:dbg:bitrate:tick] : player (%hu) bitrate changed (%u -> %u)",
+            iPlayerId, curBitrate, newBitrate);
+
+        Metrics::Add(StatType::bitrateChangesSent);
+
+        speaker.bitrate = newBitrate;
+    }
+}
+
+uint32_t BitrateController::GetPlayerBitrate(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return NULL;
+
+    const auto bitrate = BitrateController::speakers[playerId].bitrate;
+    return bitrate != 0 ? bitrate : BitrateController::baseBitrate;
+}
+
+uint32_t BitrateController::GetMaxBitrate() noexcept
+{
+    const auto maxBitrate = BitrateController::maxBitrate != 0
+        ? BitrateController::maxBitrate : BitrateController::baseBitrate;
+
+    return std::max(maxBitrate, BitrateController::minBitrate);
+}
+
+uint32_t BitrateController::Decide(const uint32_t bitrate, std::vector<uint8_t>& losses, std::vector<uint16_t>& jitters) noexcept
+{
+    auto newBitrate = bitrate;
+
+    if (!losses.empty())
+    {
+        const std::size_t index = (losses.size() - 1) * kAudiencePercentile / 100;
+
+        std::nth_element(losses.begin(), losses.begin() + index, losses.end());
+        std::nth_element(jitters.begin(), jitters.begin() + index, jitters.end());
+
+        const auto loss = losses[index];
+        const auto jitter = jitters[index];
+
+        if (loss >= kHighLoss) newBitrate = bitrate * kDecreasePercent / 100;
+        else if (loss <= kLowLoss && jitter < kHighJitter) newBitrate = bitrate + kIncreaseStep;
+    }
+
+    // Limits could be changed since the last decision
+    return std::clamp(newBitrate, BitrateController::minBitrate, BitrateController::GetMaxBitrate());
+}
+
+uint32_t BitrateController::baseBitrate { SV::kDefaultBitrate };
+uint32_t BitrateController::minBitrate { kDefaultMinBitrate };
+uint32_t BitrateController::maxBitrate { 0 };
+
+Timer::time_t BitrateController::lastDecisionTime { 0 };
+
+std::array<BitrateController::Speaker, MAX_PLAYERS> BitrateController::speakers;
+std::array<Timer::time_t, MAX_PLAYERS> BitrateController::lastReportTimes {};
+std::array<bool, MAX_PLAYERS> BitrateController::congestedListeners {};
@@ -0,0 +1,100 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <util/timer.h>
+#include <ysf/structs.h>
+
+#include "Header.h"
+#include "PlayerBitset.h"
+
+// Adapts encoder bitrate of every speaker to the link quality of its audience.
+// Listeners report loss and jitter per heard speaker, the controller takes
+// a percentile of the reports so that a single bad link doesn't degrade
+// everyone, and applies AIMD step once per decision interval.
+// All methods are called from the main thread.
+class BitrateController {
+
+    BitrateController() = delete;
+    ~BitrateController() = delete;
+    BitrateController(const BitrateController&) = delete;
+    BitrateController(BitrateController&&) = delete;
+    BitrateController& operator=(const BitrateController&) = delete;
+    BitrateController& operator=(BitrateController&&) = delete;
+
+private:
+
+    static constexpr uint32_t kDefaultMinBitrate = 8000;
+    static constexpr uint32_t kLowestBitrate = 6000;
+    static constexpr uint32_t kHighestBitrate = 128000;
+    static constexpr Timer::time_t kDecisionInterval = 2000;
+    static constexpr Timer::time_t kMinReportInterval = 500;
+    static constexpr uint32_t kAudiencePercentile = 75;
+    static constexpr uint8_t kHighLoss = 26; // ~10%
+    static constexpr uint8_t kLowLoss = 5;   // ~2%
+    static constexpr uint16_t kHighJitter = 60;
+    static constexpr uint32_t kIncreaseStep = 2000;
+    static constexpr uint32_t kDecreasePercent = 75;
+
+public:
+
+    // Bitrate that clients receive on init, upper limit by default
+    static void SetBaseBitrate(uint32_t bitrate) noexcept;
+
+    // Zero max bitrate means base bitrate
+    static void SetLimits(uint32_t minBitrate, uint32_t maxBitrate) noexcept;
+    static void ResetPlayer(uint16_t playerId) noexcept;
+
+    // Reports more frequent than the minimal interval are ignored, listener
+    // gives one sample per decision interval for each speaker it hears
+    static void AddReport(uint16_t listenerId, const SV::ReceiverReportEntry* entries, std::size_t count) noexcept;
+
+    // Sends target bitrate to speakers whose bitrate was changed
+    static void Tick() noexcept;
+
+    static uint32_t GetPlayerBitrate(uint16_t playerId) noexcept;
+
+private:
+
+    static uint32_t GetMaxBitrate() noexcept;
+    static uint32_t Decide(uint32_t bitrate, std::vector<uint8_t>& losses, std::vector<uint16_t>& jitters) noexcept;
+
+private:
+
+    struct Speaker {
+
+        uint32_t bitrate { 0 };
+
+        std::vector<uint8_t> losses;
+        std::vector<uint16_t> jitters;
+
+        // Listeners that have given their sample in this interval
+        PlayerBitset::Words reporters {};
+
+    };
+
+private:
+
+    static uint32_t baseBitrate;
+    static uint32_t minBitrate;
+    static uint32_t maxBitrate;
+
+    static Timer::time_t lastDecisionTime;
+
+    static std::array<Speaker, MAX_PLAYERS> speakers;
+    static std::array<Timer::time_t, MAX_PLAYERS> lastReportTimes;
+    static std::array<bool, MAX_PLAYERS> congestedListeners;
+
+};
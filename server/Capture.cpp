@@ -0,0 +1,256 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Capture.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <util/logger.h>
+
+#include "Tracer.h"
+#include "World.h"
+
+bool Capture::Start(const std::string& captureFile)
+{
+    if (Capture::enableStatus.load(std::memory_order_relaxed))
+        return false;
+
+    if (Capture::recordQueue == nullptr)
+    {
+        Capture::recordQueue = std::make_unique<MPMCQueue<Record>>(kQueueSize);
+        Capture::playerPositions = std::make_unique<CVector[]>(MAX_PLAYERS);
+        Capture::vehiclePositions = std::make_unique<CVector[]>(MAX_VEHICLES);
+        Capture::objectPositions = std::make_unique<CVector[]>(MAX_OBJECTS);
+    }
+
+    Capture::captureFile = std::fopen(captureFile.c_str(), "wb");
+
+    if (Capture::captureFile == nullptr)
+    {
+        Logger::Log("[sv:err:capture:start] : failed to open capture file (%s)", captureFile.c_str());
+        return false;
+    }
+
+    std::setvbuf(Capture::captureFile, nullptr, _IOFBF, 1 << 20);
+
+    // Records pushed by producers that were late for previous stop
+    {
+        static Record staleRecord;
+        while (Capture::recordQueue->try_pop(staleRecord));
+    }
+
+    // Every entity is recorded at first sample
+    std::fill_n(Capture::playerPositions.get(), MAX_PLAYERS, CVector { 1e9f, 1e9f, 1e9f });
+    std::fill_n(Capture::vehiclePositions.get(), MAX_VEHICLES, CVector { 1e9f, 1e9f, 1e9f });
+    std::fill_n(Capture::objectPositions.get(), MAX_OBJECTS, CVector { 1e9f, 1e9f, 1e9f });
+
+    const FileHeader fileHeader { kSignature, kVersion, NULL, std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count() };
+
+    std::fwrite(&fileHeader, sizeof(fileHeader), 1, Capture::captureFile);
+
+    Capture::droppedRecords.store(0, std::memory_order_relaxed);
+    Capture::startTime = Latency::Now();
+    Capture::lastSampleTime = 0;
+
+    Capture::enableStatus.store(true, std::memory_order_release);
+    Capture::writerThread = std::make_unique<std::thread>(Capture::WriterThread);
+
+    Logger::Log("[sv:dbg:capture:start] : capture to (%s) started", captureFile.c_str());
+
+    return true;
+}
+
+bool Capture::Stop() noexcept
+{
+    if (!Capture::enableStatus.exchange(false, std::memory_order_acq_rel))
+        return false;
+
+    // Writer drains the queue before exit
+    Capture::writerThread->join();
+    Capture::writerThread.reset();
+
+    std::fclose(Capture::captureFile);
+    Capture::captureFile = nullptr;
+
+    Logger::Log("[sv:dbg:capture:stop] : capture stopped (dropped records:%llu)",
+        Capture::droppedRecords.load(std::memory_order_relaxed));
+
+    return true;
+}
+
+void Capture::RecordConnect(const uint16_t playerId, const uint32_t address,
+                            const SV::ConnectPacket& connectStruct, const uint8_t features) noexcept
+{
+    if (!Capture::IsEnabled()) return;
+
+    const ConnectRecord connectRecord { address, connectStruct.version, connectStruct.micro, features };
+
+    Capture::Push(RecordType::connect, playerId, &connectRecord, sizeof(connectRecord), Latency::Now());
+}
+
+void Capture::RecordDisconnect(const uint16_t playerId) noexcept
+{
+    if (!Capture::IsEnabled()) return;
+
+    Capture::Push(RecordType::disconnect, playerId, nullptr, 0, Latency::Now());
+}
+
+void Capture::RecordControlPacket(const uint16_t playerId, const void* const packet, const uint32_t packetSize) noexcept
+{
+    if (!Capture::IsEnabled()) return;
+
+    Capture::Push(RecordType::controlPacket, playerId, packet, packetSize, Latency::Now());
+}
+
+void Capture::RecordVoicePacket(const uint16_t playerId, const void* const packet,
+                                const uint32_t packetSize, const Latency::tsc_t receiveTime) noexcept
+{
+    if (!Capture::IsEnabled()) return;
+
+    Capture::Push(RecordType::voicePacket, playerId, packet, packetSize, receiveTime);
+}
+
+void Capture::RecordNative(const char* const name, const std::initializer_list<NativeArg> args, const NativeArg result) noexcept
+{
+    if (!Capture::IsEnabled()) return;
+
+    uint8_t data[kMaxRecordSize];
+    uint32_t length { 0 };
+
+    const auto writeBytes = [&](const void* const bytes, const uint32_t size) noexcept -> bool
+    {
+        if (length + size > sizeof(data)) return false;
+        std::memcpy(data + length, bytes, size);
+        length += size;
+        return true;
+    };
+
+    const uint8_t nameLength = std::min<std::size_t>(std::strlen(name), UINT8_MAX);
+    const uint8_t argsCount = std::min<std::size_t>(args.size(), UINT8_MAX);
+
+    writeBytes(&nameLength, sizeof(nameLength));
+    writeBytes(name, nameLength);
+    writeBytes(&result.type, sizeof(result.type));
+    writeBytes(&result.value, sizeof(result.value));
+    writeBytes(&argsCount, sizeof(argsCount));
+
+    for (const auto& arg : args)
+    {
+        if (!writeBytes(&arg.type, sizeof(arg.type))) return;
+
+        if (arg.type == ArgType::string)
+        {
+            const uint16_t stringLength = std::min<std::size_t>(arg.string->size(), UINT16_MAX);
+            if (!writeBytes(&stringLength, sizeof(stringLength)) ||
+                !writeBytes(arg.string->data(), stringLength)) return;
+        }
+        else if (!writeBytes(&arg.value, sizeof(arg.value))) return;
+    }
+
+    Capture::Push(RecordType::native, NULL, data, length, Latency::Now());
+}
+
+void Capture::SamplePositions() noexcept
+{
+    if (!Capture::IsEnabled() || !World::IsReady()) return;
+
+    const auto curTime = Timer::Get();
+    if (curTime - Capture::lastSampleTime < kSampleInterval) return;
+    Capture::lastSampleTime = curTime;
+
+    CVector position;
+
+    const auto playerPoolSize = World::GetPlayerPoolSize();
+
+    for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
+    {
+        if (World::GetPlayerPosition(iPlayerId, position)) Capture::SampleEntity(RecordType::playerPosition,
+            iPlayerId, position, Capture::playerPositions[iPlayerId]);
+    }
+
+    for (uint16_t iVehicleId { 0 }; iVehicleId < MAX_VEHICLES; ++iVehicleId)
+    {
+        if (World::GetVehiclePosition(iVehicleId, position)) Capture::SampleEntity(RecordType::vehiclePosition,
+            iVehicleId, position, Capture::vehiclePositions[iVehicleId]);
+    }
+
+    for (uint16_t iObjectId { 0 }; iObjectId < MAX_OBJECTS; ++iObjectId)
+    {
+        if (World::GetObjectPosition(iObjectId, position)) Capture::SampleEntity(RecordType::objectPosition,
+            iObjectId, position, Capture::objectPositions[iObjectId]);
+    }
+}
+
+void Capture::Push(const uint8_t type, const uint16_t id, const void* const data,
+                   const uint32_t length, const Latency::tsc_t time) noexcept
+{
+    if (length > kMaxRecordSize || !Capture::recordQueue->try_emplace(type, id, data, length, time))
+        Capture::droppedRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Capture::SampleEntity(const uint8_t type, const uint16_t id, const CVector& position, CVector& lastPosition) noexcept
+{
+    if ((position - lastPosition).Length() < kSampleThreshold) return;
+
+    lastPosition = position;
+
+    Capture::Push(type, id, &position, sizeof(position), Latency::Now());
+}
+
+void Capture::WriterThread() noexcept
+{
+    Tracer::SetThreadName("sv-capture");
+
+    const double ticksPerMicrosecond = 1000.0 * Latency::GetTicksPerNanosecond();
+
+    static Record record;
+    uint64_t lastTime { 0 };
+
+    while (true)
+    {
+        if (!Capture::recordQueue->try_pop(record))
+        {
+            if (!Capture::enableStatus.load(std::memory_order_acquire)) break;
+
+            SleepForMilliseconds(1);
+            continue;
+        }
+
+        // Records of worker threads may come slightly out of order
+        const uint64_t recordTime = record.time > Capture::startTime
+            ? static_cast<uint64_t>((record.time - Capture::startTime) / ticksPerMicrosecond) : 0;
+        const uint64_t deltaTime = recordTime > lastTime ? recordTime - lastTime : 0;
+
+        lastTime += deltaTime;
+
+        const RecordHeader recordHeader { record.type, NULL, record.id,
+            static_cast<uint32_t>(std::min<uint64_t>(deltaTime, UINT32_MAX)), record.length };
+
+        std::fwrite(&recordHeader, sizeof(recordHeader), 1, Capture::captureFile);
+        std::fwrite(record.data, record.length, 1, Capture::captureFile);
+    }
+
+    std::fflush(Capture::captureFile);
+}
+
+std::atomic_bool Capture::enableStatus { false };
+std::atomic<uint64_t> Capture::droppedRecords { 0 };
+
+std::FILE* Capture::captureFile { nullptr };
+Latency::tsc_t Capture::startTime { 0 };
+Timer::time_t Capture::lastSampleTime { 0 };
+
+std::unique_ptr<MPMCQueue<Capture::Record>> Capture::recordQueue { nullptr };
+std::unique_ptr<std::thread> Capture::writerThread { nullptr };
+
+std::unique_ptr<CVector[]> Capture::playerPositions { nullptr };
+std::unique_ptr<CVector[]> Capture::vehiclePositions { nullptr };
+std::unique_ptr<CVector[]> Capture::objectPositions { nullptr };
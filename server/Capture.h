@@ -0,0 +1,217 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <MPMCQueue.h>
+#include <util/timer.h>
+#include <ysf/structs.h>
+
+#include "Header.h"
+#include "Latency.h"
+
+// Records incoming voice traffic and the events that shape its routing
+// (connects, script calls, positions) into a compact binary file that
+// fakehost can replay. Producers only copy the record into a queue,
+// the file is written by a dedicated thread.
+class Capture {
+
+    Capture() = delete;
+    ~Capture() = delete;
+    Capture(const Capture&) = delete;
+    Capture(Capture&&) = delete;
+    Capture& operator=(const Capture&) = delete;
+    Capture& operator=(Capture&&) = delete;
+
+public:
+
+    static constexpr uint32_t kSignature = 0x50435653; // "SVCP"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kMaxRecordSize = 1536;
+
+private:
+
+    static constexpr uint32_t kQueueSize = 4096;
+    static constexpr uint32_t kSampleInterval = 100;
+    static constexpr float kSampleThreshold = 0.25f;
+
+public:
+
+    struct RecordType
+    {
+        enum : uint8_t
+        {
+            connect,          // ConnectRecord
+            disconnect,       // no data
+            controlPacket,    // control packet as received from client
+            voicePacket,      // accepted voice packet without auth tag
+            native,           // NativeRecord
+            playerPosition,   // CVector
+            vehiclePosition,  // CVector, id is vehicle id
+            objectPosition    // CVector, id is object id
+        };
+    };
+
+    struct ArgType
+    {
+        enum : uint8_t
+        {
+            value,
+            handle,
+            string
+        };
+    };
+
+#pragma pack(push, 1)
+
+    struct FileHeader
+    {
+        uint32_t signature;
+        uint16_t version;
+        uint16_t reserved;
+        int64_t startTime; // unix time in milliseconds
+    };
+
+    // Time is a delta in microseconds from the previous record
+    struct RecordHeader
+    {
+        uint8_t type;
+        uint8_t reserved;
+        uint16_t id;
+        uint32_t deltaTime;
+        uint16_t length;
+    };
+
+    struct ConnectRecord
+    {
+        uint32_t address;
+        uint8_t version;
+        uint8_t micro;
+        uint8_t features;
+    };
+
+    // Native record data is laid out as: name length (uint8), name,
+    // result (ArgType + uint32), arguments count (uint8), arguments.
+    // Argument is ArgType followed by uint32 value or, for strings,
+    // by uint16 length and characters.
+
+#pragma pack(pop)
+
+    struct NativeArg
+    {
+        uint8_t type;
+        uint32_t value;
+        const std::string* string;
+    };
+
+public:
+
+    static bool Start(const std::string& captureFile);
+    static bool Stop() noexcept;
+
+    static inline bool IsEnabled() noexcept
+    {
+        return Capture::enableStatus.load(std::memory_order_relaxed);
+    }
+
+    static void RecordConnect(uint16_t playerId, uint32_t address, const SV::ConnectPacket& connectStruct, uint8_t features) noexcept;
+    static void RecordDisconnect(uint16_t playerId) noexcept;
+    static void RecordControlPacket(uint16_t playerId, const void* packet, uint32_t packetSize) noexcept;
+    static void RecordVoicePacket(uint16_t playerId, const void* packet, uint32_t packetSize, Latency::tsc_t receiveTime) noexcept;
+    static void RecordNative(const char* name, std::initializer_list<NativeArg> args,
+        NativeArg result = { ArgType::value, NULL, nullptr }) noexcept;
+
+    // Called every tick, records positions of moved entities once per sample interval
+    static void SamplePositions() noexcept;
+
+    static inline NativeArg Value(const uint32_t value) noexcept
+    {
+        return { ArgType::value, value, nullptr };
+    }
+
+    static inline NativeArg Float(const float value) noexcept
+    {
+        uint32_t bits; std::memcpy(&bits, &value, sizeof(bits));
+        return { ArgType::value, bits, nullptr };
+    }
+
+    static inline NativeArg Handle(const uint32_t handle) noexcept
+    {
+        return { ArgType::handle, handle, nullptr };
+    }
+
+    static inline NativeArg String(const std::string& string) noexcept
+    {
+        return { ArgType::string, NULL, &string };
+    }
+
+private:
+
+    struct Record {
+
+        Record() noexcept = default;
+        Record(const Record&) noexcept = default;
+        Record(Record&&) noexcept = default;
+        Record& operator=(const Record&) noexcept = default;
+        Record& operator=(Record&&) noexcept = default;
+
+    public:
+
+        explicit Record(const uint8_t type, const uint16_t id, const void* const data,
+                        const uint16_t length, const Latency::tsc_t time) noexcept
+            : type(type), id(id), length(length), time(time)
+        {
+            if (length != 0) std::memcpy(this->data, data, length);
+        }
+
+        ~Record() noexcept = default;
+
+    public:
+
+        uint8_t type { NULL };
+        uint16_t id { NULL };
+        uint16_t length { NULL };
+        Latency::tsc_t time { 0 };
+        uint8_t data[kMaxRecordSize];
+
+    };
+
+private:
+
+    static void Push(uint8_t type, uint16_t id, const void* data, uint32_t length, Latency::tsc_t time) noexcept;
+    static void SampleEntity(uint8_t type, uint16_t id, const CVector& position, CVector& lastPosition) noexcept;
+
+    static void WriterThread() noexcept;
+
+private:
+
+    static std::atomic_bool enableStatus;
+    static std::atomic<uint64_t> droppedRecords;
+
+    static std::FILE* captureFile;
+    static Latency::tsc_t startTime;
+    static Timer::time_t lastSampleTime;
+
+    static std::unique_ptr<MPMCQueue<Record>> recordQueue;
+    static std::unique_ptr<std::thread> writerThread;
+
+    static std::unique_ptr<CVector[]> playerPositions;
+    static std::unique_ptr<CVector[]> vehiclePositions;
+    static std::unique_ptr<CVector[]> objectPositions;
+
+};
@@ -0,0 +1,115 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Config.h"
+
+#include <cstdlib>
+#include <fstream>
+
+#include <util/logger.h>
+
+static inline std::string TrimString(const std::string& string)
+{
+    const auto begin = string.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return std::string();
+
+    const auto end = string.find_last_not_of(" \t\r\n");
+    return string.substr(begin, end - begin + 1);
+}
+
+bool Config::Load(const char* const fileName)
+{
+    std::ifstream configFile { fileName };
+
+    if (!configFile.is_open())
+    {
+        Logger::Log("[sv:dbg:config:load] : config file (%s) not found, using defaults", fileName);
+        return false;
+    }
+
+    Config::values.clear();
+
+    std::string line;
+    uint32_t lineNumber { 0 };
+
+    while (std::getline(configFile, line))
+    {
+        ++lineNumber;
+
+        line = TrimString(line);
+        if (line.empty() || line.front() == '#' || line.front() == ';')
+            continue;
+
+        const auto delimiter = line.find('=');
+
+        if (delimiter == std::string::npos)
+        {
+            Logger::Log("[sv:err:config:load] : invalid line (%u) in config file (%s)", lineNumber, fileName);
+            continue;
+        }
+
+        auto key = TrimString(line.substr(0, delimiter));
+        auto value = TrimString(line.substr(delimiter + 1));
+
+        if (key.empty()) continue;
+
+        Logger::Log("[sv:dbg:config:load] : %s = %s", key.c_str(), value.c_str());
+
+        Config::values[std::move(key)] = std::move(value);
+    }
+
+    return true;
+}
+
+void Config::Free() noexcept
+{
+    Config::values.clear();
+}
+
+bool Config::Has(const std::string& key) noexcept
+{
+    return Config::values.find(key) != Config::values.end();
+}
+
+std::string Config::GetString(const std::string& key, const std::string& defaultValue)
+{
+    const auto iter = Config::values.find(key);
+    if (iter == Config::values.end()) return defaultValue;
+
+    return iter->second;
+}
+
+int64_t Config::GetInt(const std::string& key, const int64_t defaultValue) noexcept
+{
+    const auto iter = Config::values.find(key);
+    if (iter == Config::values.end()) return defaultValue;
+
+    const char* const valueBegin = iter->second.c_str();
+    char* valueEnd { nullptr };
+
+    const auto value = std::strtoll(valueBegin, &valueEnd, 0);
+    if (valueEnd == valueBegin || *valueEnd != '\0') return defaultValue;
+
+    return value;
+}
+
+bool Config::GetBool(const std::string& key, const bool defaultValue) noexcept
+{
+    const auto iter = Config::values.find(key);
+    if (iter == Config::values.end()) return defaultValue;
+
+    const auto& value = iter->second;
+
+    if (value == "1" || value == "true" || value == "yes" || value == "on") return true;
+    if (value == "0" || value == "false" || value == "no" || value == "off") return false;
+
+    return defaultValue;
+}
+
+std::map<std::string, std::string> Config::values;
@@ -0,0 +1,42 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Plain 'key = value' file, lines starting with '#' or ';' are comments.
+// Absent file or key is not an error, getters return default value then.
+class Config {
+
+    Config() = delete;
+    ~Config() = delete;
+    Config(const Config&) = delete;
+    Config(Config&&) = delete;
+    Config& operator=(const Config&) = delete;
+    Config& operator=(Config&&) = delete;
+
+public:
+
+    static bool Load(const char* fileName);
+    static void Free() noexcept;
+
+    static bool Has(const std::string& key) noexcept;
+
+    static std::string GetString(const std::string& key, const std::string& defaultValue = std::string());
+    static int64_t GetInt(const std::string& key, int64_t defaultValue) noexcept;
+    static bool GetBool(const std::string& key, bool defaultValue) noexcept;
+
+private:
+
+    static std::map<std::string, std::string> values;
+
+};
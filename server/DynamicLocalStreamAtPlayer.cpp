@@ -12,12 +12,12 @@
 #include <cassert>
 #include <cstring>
 
-#include <ysf/globals.h>
 #include <util/memory.hpp>
 #include <util/logger.h>
 
 #include "ControlPacket.h"
 #include "PlayerStore.h"
+#include "World.h"
 #include "Header.h"
 
 DynamicLocalStreamAtPlayer::DynamicLocalStreamAtPlayer(
@@ -28,39 +28,35 @@ DynamicLocalStreamAtPlayer::DynamicLocalStreamAtPlayer(
     : LocalStream(distance)
     , DynamicStream(distance, maxPlayers)
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     const auto nameString = name.c_str();
     const auto nameLength = name.size() + 1;
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLStreamAtPlayer, sizeof(SV::CreateLStreamAtPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target = playerId;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->color = color;
 
-    if (pNetGame->pPlayerPool->pPlayer[playerId] != nullptr)
+    CVector streamPosition;
+
+    if (World::GetPlayerPosition(playerId, streamPosition))
     {
         PlayerSortList playerList;
 
-        const CVector& streamPosition = pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition;
-
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        if (World::GetConnectedPlayersCount() != 0)
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            const auto playerPoolSize = World::GetPlayerPoolSize();
 
             for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
             {
-                const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+                CVector playerPosition;
                 float distanceToPlayer;
 
-                if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
-                    ipPlayer->byteStreamedIn[playerId] && iPlayerId != playerId &&
-                    (distanceToPlayer = (ipPlayer->vecPosition - streamPosition).Length()) <= distance)
+                if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                    World::IsPlayerStreamedIn(playerId, iPlayerId) && iPlayerId != playerId &&
+                    (distanceToPlayer = (playerPosition - streamPosition).Length()) <= distance)
                 {
                     playerList.emplace(distanceToPlayer, iPlayerId);
                 }
@@ -73,42 +69,44 @@ DynamicLocalStreamAtPlayer::DynamicLocalStreamAtPlayer(
                 break;
 
             this->Stream::AttachListener(playerInfo.playerId);
+            this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, distance);
         }
     }
 }
 
 void DynamicLocalStreamAtPlayer::Tick()
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     const auto playerId = PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target;
 
-    if (pNetGame->pPlayerPool->pPlayer[playerId] != nullptr)
+    CVector streamPosition;
+
+    if (World::GetPlayerPosition(playerId, streamPosition))
     {
         PlayerSortList playerList;
 
-        const CVector& streamPosition = pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition;
         const float streamDistance = PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->distance;
 
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        if (World::GetConnectedPlayersCount() != 0)
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            const auto playerPoolSize = World::GetPlayerPoolSize();
 
             for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
             {
-                const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+                CVector playerPosition;
                 float distanceToPlayer;
 
-                if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
-                    ipPlayer->byteStreamedIn[playerId] && iPlayerId != playerId &&
-                    (distanceToPlayer = (ipPlayer->vecPosition - streamPosition).Length()) <= streamDistance)
+                if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                    World::IsPlayerStreamedIn(playerId, iPlayerId) && iPlayerId != playerId &&
+                    (distanceToPlayer = (playerPosition - streamPosition).Length()) <= streamDistance)
                 {
                     if (!this->HasListener(iPlayerId))
                     {
                         playerList.emplace(distanceToPlayer, iPlayerId);
                     }
+                    else
+                    {
+                        this->UpdateListenerLayer(iPlayerId, distanceToPlayer, streamDistance);
+                    }
                 }
                 else if (this->HasListener(iPlayerId))
                 {
@@ -123,6 +121,7 @@ void DynamicLocalStreamAtPlayer::Tick()
                 break;
 
             this->Stream::AttachListener(playerInfo.playerId);
+            this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, streamDistance);
         }
     }
 }
@@ -12,12 +12,12 @@
 #include <cassert>
 #include <cstring>
 
-#include <ysf/globals.h>
 #include <util/memory.hpp>
 #include <util/logger.h>
 
 #include "ControlPacket.h"
 #include "PlayerStore.h"
+#include "World.h"
 #include "Header.h"
 
 DynamicLocalStreamAtPoint::DynamicLocalStreamAtPoint(
@@ -29,15 +29,12 @@ DynamicLocalStreamAtPoint::DynamicLocalStreamAtPoint(
     , DynamicStream(distance, maxPlayers)
     , PointStream(distance, position)
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     const auto nameString = name.c_str();
     const auto nameLength = name.size() + 1;
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLPStream, sizeof(SV::CreateLPStreamPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->position = position;
@@ -45,18 +42,17 @@ DynamicLocalStreamAtPoint::DynamicLocalStreamAtPoint(
 
     PlayerSortList playerList;
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    if (World::GetConnectedPlayersCount() != 0)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        const auto playerPoolSize = World::GetPlayerPoolSize();
 
         for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
         {
-            const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+            CVector playerPosition;
             float distanceToPlayer;
 
-            if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
-                (distanceToPlayer = (ipPlayer->vecPosition - position).Length()) <= distance)
+            if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                (distanceToPlayer = (playerPosition - position).Length()) <= distance)
             {
                 playerList.emplace(distanceToPlayer, iPlayerId);
             }
@@ -69,36 +65,37 @@ DynamicLocalStreamAtPoint::DynamicLocalStreamAtPoint(
             break;
 
         this->Stream::AttachListener(playerInfo.playerId);
+        this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, distance);
     }
 }
 
 void DynamicLocalStreamAtPoint::Tick()
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     PlayerSortList playerList;
 
     const CVector& streamPosition = PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->position;
     const float streamDistance = PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->distance;
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    if (World::GetConnectedPlayersCount() != 0)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        const auto playerPoolSize = World::GetPlayerPoolSize();
 
         for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
         {
-            const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+            CVector playerPosition;
             float distanceToPlayer;
 
-            if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
-                (distanceToPlayer = (ipPlayer->vecPosition - streamPosition).Length()) <= streamDistance)
+            if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                (distanceToPlayer = (playerPosition - streamPosition).Length()) <= streamDistance)
             {
                 if (!this->HasListener(iPlayerId))
                 {
                     playerList.emplace(distanceToPlayer, iPlayerId);
                 }
+                else
+                {
+                    this->UpdateListenerLayer(iPlayerId, distanceToPlayer, streamDistance);
+                }
             }
             else if (this->HasListener(iPlayerId))
             {
@@ -113,5 +110,6 @@ void DynamicLocalStreamAtPoint::Tick()
             break;
 
         this->Stream::AttachListener(playerInfo.playerId);
+        this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, streamDistance);
     }
 }
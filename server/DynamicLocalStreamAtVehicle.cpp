@@ -12,12 +12,12 @@
 #include <cassert>
 #include <cstring>
 
-#include <ysf/globals.h>
 #include <util/memory.hpp>
 #include <util/logger.h>
 
 #include "ControlPacket.h"
 #include "PlayerStore.h"
+#include "World.h"
 #include "Header.h"
 
 DynamicLocalStreamAtVehicle::DynamicLocalStreamAtVehicle(
@@ -28,39 +28,34 @@ DynamicLocalStreamAtVehicle::DynamicLocalStreamAtVehicle(
     : LocalStream(distance)
     , DynamicStream(distance, maxPlayers)
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-    assert(pNetGame->pVehiclePool != nullptr);
-
     const auto nameString = name.c_str();
     const auto nameLength = name.size() + 1;
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLStreamAtVehicle, sizeof(SV::CreateLStreamAtPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target = vehicleId;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->color = color;
 
-    if (pNetGame->pVehiclePool->pVehicle[vehicleId] != nullptr)
+    CVector streamPosition;
+
+    if (World::GetVehiclePosition(vehicleId, streamPosition))
     {
         PlayerSortList playerList;
 
-        const CVector& streamPosition = pNetGame->pVehiclePool->pVehicle[vehicleId]->vecPosition;
-
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        if (World::GetConnectedPlayersCount() != 0)
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            const auto playerPoolSize = World::GetPlayerPoolSize();
 
             for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
             {
-                const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+                CVector playerPosition;
                 float distanceToPlayer;
 
-                if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) && ipPlayer->byteVehicleStreamedIn[vehicleId] &&
-                    (distanceToPlayer = (ipPlayer->vecPosition - streamPosition).Length()) <= distance)
+                if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                    World::IsVehicleStreamedIn(vehicleId, iPlayerId) && (distanceToPlayer = (playerPosition - streamPosition).Length()) <= distance)
                 {
                     playerList.emplace(distanceToPlayer, iPlayerId);
                 }
@@ -73,42 +68,43 @@ DynamicLocalStreamAtVehicle::DynamicLocalStreamAtVehicle(
                 break;
 
             this->Stream::AttachListener(playerInfo.playerId);
+            this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, distance);
         }
     }
 }
 
 void DynamicLocalStreamAtVehicle::Tick()
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-    assert(pNetGame->pVehiclePool != nullptr);
-
     const auto vehicleId = PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target;
 
-    if (pNetGame->pVehiclePool->pVehicle[vehicleId] != nullptr)
+    CVector streamPosition;
+
+    if (World::GetVehiclePosition(vehicleId, streamPosition))
     {
         PlayerSortList playerList;
 
-        const CVector& streamPosition = pNetGame->pVehiclePool->pVehicle[vehicleId]->vecPosition;
         const float streamDistance = PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->distance;
 
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        if (World::GetConnectedPlayersCount() != 0)
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            const auto playerPoolSize = World::GetPlayerPoolSize();
 
             for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
             {
-                const auto ipPlayer = pNetGame->pPlayerPool->pPlayer[iPlayerId];
-
+                CVector playerPosition;
                 float distanceToPlayer;
 
-                if (ipPlayer != nullptr && PlayerStore::IsPlayerHasPlugin(iPlayerId) && ipPlayer->byteVehicleStreamedIn[vehicleId] &&
-                    (distanceToPlayer = (ipPlayer->vecPosition - streamPosition).Length()) <= streamDistance)
+                if (World::GetPlayerPosition(iPlayerId, playerPosition) && PlayerStore::IsPlayerHasPlugin(iPlayerId) &&
+                    World::IsVehicleStreamedIn(vehicleId, iPlayerId) && (distanceToPlayer = (playerPosition - streamPosition).Length()) <= streamDistance)
                 {
                     if (!this->HasListener(iPlayerId))
                     {
                         playerList.emplace(distanceToPlayer, iPlayerId);
                     }
+                    else
+                    {
+                        this->UpdateListenerLayer(iPlayerId, distanceToPlayer, streamDistance);
+                    }
                 }
                 else if (this->HasListener(iPlayerId))
                 {
@@ -123,6 +119,7 @@ void DynamicLocalStreamAtVehicle::Tick()
                 break;
 
             this->Stream::AttachListener(playerInfo.playerId);
+            this->UpdateListenerLayer(playerInfo.playerId, playerInfo.distance, streamDistance);
         }
     }
 }
@@ -19,3 +19,8 @@ std::vector<uint16_t> DynamicStream::DetachAllListeners() noexcept
 {
     return std::vector<uint16_t>();
 }
+
+void DynamicStream::UpdateListenerLayer(const uint16_t playerId, const float distance, const float streamDistance) noexcept
+{
+    this->SetLowLayerReason(playerId, LowLayerReason::distance, distance > streamDistance * kLowLayerDistanceRatio);
+}
@@ -39,6 +39,13 @@ public:
     bool DetachListener(uint16_t playerId) noexcept override;
     std::vector<uint16_t> DetachAllListeners() noexcept override;
 
+protected:
+
+    // Listeners in the outer part of the stream range hear the low layer
+    static constexpr float kLowLayerDistanceRatio = 0.5f;
+
+    void UpdateListenerLayer(uint16_t playerId, float distance, float streamDistance) noexcept;
+
 protected:
 
     const uint32_t maxPlayers;
@@ -27,10 +27,22 @@ Effect::~Effect()
         }
 
         PackGetStruct(&*this->packetDeleteEffect, SV::DeleteEffectPacket)->stream
-            = reinterpret_cast<uint32_t>(stream);
+            = stream->GetHandle();
 
         stream->SendControlPacket(*&*this->packetDeleteEffect);
     }
+
+    Effect::effectTable.Remove(this->handle);
+}
+
+uint32_t Effect::GetHandle() const noexcept
+{
+    return this->handle;
+}
+
+Effect* Effect::FromHandle(const uint32_t handle) noexcept
+{
+    return Effect::effectTable.Get(handle);
 }
 
 void Effect::AttachStream(Stream* const stream)
@@ -46,7 +58,7 @@ void Effect::AttachStream(Stream* const stream)
                 this, std::placeholders::_1));
 
         PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->stream
-            = reinterpret_cast<uint32_t>(stream);
+            = stream->GetHandle();
 
         stream->SendControlPacket(*&*this->packetCreateEffect);
     }
@@ -75,7 +87,7 @@ void Effect::DetachStream(Stream* const stream)
         }
 
         PackGetStruct(&*this->packetDeleteEffect, SV::DeleteEffectPacket)->stream
-            = reinterpret_cast<uint32_t>(stream);
+            = stream->GetHandle();
 
         stream->SendControlPacket(*&*this->packetDeleteEffect);
     }
@@ -84,7 +96,7 @@ void Effect::DetachStream(Stream* const stream)
 void Effect::PlayerCallback(Stream* const stream, const uint16_t player)
 {
     PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->stream
-        = reinterpret_cast<uint32_t>(stream);
+        = stream->GetHandle();
 
     Network::SendControlPacket(player, *&*this->packetCreateEffect);
 }
@@ -96,3 +108,5 @@ void Effect::DeleteCallback(Stream* const stream)
     this->streamPlayerCallbacks.erase(stream);
     this->streamDeleteCallbacks.erase(stream);
 }
+
+SlotMap<Effect> Effect::effectTable;
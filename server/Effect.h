@@ -6,6 +6,7 @@
 
 #include "ControlPacket.h"
 #include "Header.h"
+#include "SlotMap.h"
 
 struct ChorusParameters
 {
@@ -106,23 +107,29 @@ public:
 
     template<class ParametersType>
     explicit Effect(const uint32_t number, const int priority, const ParametersType& parameters)
+        : handle(Effect::effectTable.Insert(this))
     {
         PackWrap(this->packetCreateEffect, SV::ControlPacketType::createEffect, sizeof(SV::CreateEffectPacket) + sizeof(parameters));
 
-        PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->effect = reinterpret_cast<uint32_t>(this);
+        PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->effect = this->handle;
         std::memcpy(PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->params, &parameters, sizeof(parameters));
         PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->priority = priority;
         PackGetStruct(&*this->packetCreateEffect, SV::CreateEffectPacket)->number = number;
 
         PackWrap(this->packetDeleteEffect, SV::ControlPacketType::deleteEffect, sizeof(SV::DeleteEffectPacket));
 
-        PackGetStruct(&*this->packetDeleteEffect, SV::DeleteEffectPacket)->effect = reinterpret_cast<uint32_t>(this);
+        PackGetStruct(&*this->packetDeleteEffect, SV::DeleteEffectPacket)->effect = this->handle;
     }
 
     virtual ~Effect();
 
 public:
 
+    uint32_t GetHandle() const noexcept;
+
+    // Returns nullptr for handles of deleted effects
+    static Effect* FromHandle(uint32_t handle) noexcept;
+
     void AttachStream(class Stream* stream);
     void DetachStream(class Stream* stream);
 
@@ -133,6 +140,8 @@ private:
 
 private:
 
+    const uint32_t handle;
+
     std::unordered_set<class Stream*> attachedStreams;
 
     std::unordered_map<class Stream*, std::size_t> streamPlayerCallbacks;
@@ -141,4 +150,8 @@ private:
     ControlPacketContainerPtr packetCreateEffect { nullptr };
     ControlPacketContainerPtr packetDeleteEffect { nullptr };
 
+private:
+
+    static SlotMap<Effect> effectTable;
+
 };
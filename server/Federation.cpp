@@ -0,0 +1,486 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Federation.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/select.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#endif
+
+#include <util/logger.h>
+
+#include "Stream.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "Header.h"
+
+#ifdef _WIN32
+#define GetNetError() WSAGetLastError()
+#else
+#define GetNetError() errno
+#define closesocket(sock) close(sock)
+#define INVALID_SOCKET -1
+#define SOCKET_ERROR -1
+#endif
+
+bool Federation::Open(const uint16_t port, const uint32_t flushInterval) noexcept
+{
+    if (Federation::initStatus) return false;
+
+#ifdef _WIN32
+    if (const int error = WSAStartup(MAKEWORD(2, 2), &WSADATA()))
+    {
+        Logger::Log("[sv:err:federation:open] : wsastartup error (code:%d)", error);
+        return false;
+    }
+#endif
+
+    if ((Federation::socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) == INVALID_SOCKET)
+    {
+        Logger::Log("[sv:err:federation:open] : socket error (code:%d)", GetNetError());
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    {
+        const auto sendBufferSize { kSendBufferSize }, recvBufferSize { kRecvBufferSize };
+
+        sockaddr_in bindAddr {};
+
+        bindAddr.sin_family = AF_INET;
+        bindAddr.sin_addr.s_addr = INADDR_ANY;
+        bindAddr.sin_port = htons(port);
+
+        if (setsockopt(Federation::socketHandle, SOL_SOCKET, SO_SNDBUF, (char*)(&sendBufferSize), sizeof(sendBufferSize)) == SOCKET_ERROR ||
+            setsockopt(Federation::socketHandle, SOL_SOCKET, SO_RCVBUF, (char*)(&recvBufferSize), sizeof(recvBufferSize)) == SOCKET_ERROR ||
+            bind(Federation::socketHandle, (sockaddr*)(&bindAddr), sizeof(bindAddr)) == SOCKET_ERROR)
+        {
+            Logger::Log("[sv:err:federation:open] : bind error (code:%d)", GetNetError());
+            closesocket(Federation::socketHandle);
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            return false;
+        }
+    }
+
+    Federation::flushInterval = flushInterval != 0 ? flushInterval : 1;
+
+    Federation::status.store(true);
+    Federation::thread = std::thread(Federation::ThreadFunc);
+
+    Logger::Log("[sv:dbg:federation:open] : trunk running on port %hu", port);
+
+    Federation::initStatus = true;
+
+    return true;
+}
+
+void Federation::Close() noexcept
+{
+    if (!Federation::initStatus) return;
+
+    Federation::status.store(false);
+
+    if (Federation::thread.joinable())
+        Federation::thread.join();
+
+    closesocket(Federation::socketHandle);
+    Federation::socketHandle = INVALID_SOCKET;
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    Federation::initStatus = false;
+}
+
+int Federation::AddPeer(const std::string& host, const uint16_t port, const uint32_t key) noexcept
+{
+    const auto address = inet_addr(host.c_str());
+
+    if (address == INADDR_NONE || port == NULL)
+    {
+        Logger::Log("[sv:err:federation:addpeer] : invalid peer address (%s:%hu)", host.c_str(), port);
+        return -1;
+    }
+
+    const std::unique_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    for (uint32_t iPeer { 0 }; iPeer < kMaxPeers; ++iPeer)
+    {
+        auto& peer = Federation::peers[iPeer];
+
+        if (peer.status) continue;
+
+        peer.address = {};
+        peer.address.sin_family = AF_INET;
+        peer.address.sin_addr.s_addr = address;
+        peer.address.sin_port = htons(port);
+        peer.key = key;
+
+        peer.batchSize = 0;
+        peer.batchCount = 0;
+        peer.sendSequence = 0;
+
+        peer.receiveStatus = false;
+        peer.senders.clear();
+        peer.imports.clear();
+
+        peer.status = true;
+
+        Logger::Log("[sv:dbg:federation:addpeer] : peer (%u) added (%s:%hu)", iPeer, host.c_str(), port);
+
+        return static_cast<int>(iPeer);
+    }
+
+    Logger::Log("[sv:err:federation:addpeer] : peers limit reached");
+
+    return -1;
+}
+
+bool Federation::RemovePeer(const int peer) noexcept
+{
+    if (peer < 0 || peer >= static_cast<int>(kMaxPeers)) return false;
+
+    const std::unique_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    auto& peerRef = Federation::peers[peer];
+
+    if (!peerRef.status) return false;
+
+    peerRef.status = false;
+    peerRef.senders.clear();
+    peerRef.imports.clear();
+
+    for (auto iter = Federation::exports.begin(); iter != Federation::exports.end();)
+    {
+        if (iter->second.first != static_cast<uint32_t>(peer))
+        {
+            ++iter;
+            continue;
+        }
+
+        const auto streamHandle = iter->first;
+
+        iter = Federation::exports.erase(iter);
+
+        if (const auto stream = Stream::FromHandle(streamHandle); stream != nullptr)
+        {
+            stream->exportStatus.store(Federation::exports.count(streamHandle) != 0, std::memory_order_relaxed);
+            stream->UpdateRelayStatus();
+        }
+    }
+
+    Logger::Log("[sv:dbg:federation:removepeer] : peer (%d) removed", peer);
+
+    return true;
+}
+
+bool Federation::ExportStream(Stream* const stream, const int peer, const uint16_t channel) noexcept
+{
+    if (peer < 0 || peer >= static_cast<int>(kMaxPeers)) return false;
+
+    const std::unique_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    if (!Federation::peers[peer].status) return false;
+
+    const auto range = Federation::exports.equal_range(stream->GetHandle());
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (iter->second == std::make_pair(static_cast<uint32_t>(peer), channel))
+            return false;
+    }
+
+    Federation::exports.emplace(stream->GetHandle(), std::make_pair(static_cast<uint32_t>(peer), channel));
+    stream->exportStatus.store(true, std::memory_order_relaxed);
+    stream->UpdateRelayStatus();
+
+    return true;
+}
+
+bool Federation::ImportStream(Stream* const stream, const int peer, const uint16_t channel) noexcept
+{
+    if (peer < 0 || peer >= static_cast<int>(kMaxPeers)) return false;
+
+    const std::unique_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    auto& peerRef = Federation::peers[peer];
+
+    if (!peerRef.status) return false;
+
+    return peerRef.imports.emplace(channel, stream).second;
+}
+
+void Federation::DetachStream(Stream* const stream) noexcept
+{
+    const std::unique_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    Federation::exports.erase(stream->GetHandle());
+    stream->exportStatus.store(false, std::memory_order_relaxed);
+    stream->UpdateRelayStatus();
+
+    for (auto& peer : Federation::peers)
+    {
+        for (auto iter = peer.imports.begin(); iter != peer.imports.end();)
+        {
+            if (iter->second == stream) iter = peer.imports.erase(iter);
+            else ++iter;
+        }
+    }
+}
+
+void Federation::Push(const uint32_t streamHandle, const VoicePacket& voicePacket) noexcept
+{
+    // Frames of remote speakers stay on this server
+    if (voicePacket.sender >= kMinSender && voicePacket.sender < kMinSender + kMaxPeers * kSendersPerPeer)
+        return;
+
+    if (voicePacket.length > kMaxFrameDataSize)
+    {
+        Metrics::Add(StatType::trunkFramesDropped);
+        return;
+    }
+
+    const uint32_t frameSize = sizeof(TrunkFrame) + voicePacket.length;
+
+    const std::shared_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    const auto range = Federation::exports.equal_range(streamHandle);
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        const auto peerIndex = iter->second.first;
+        auto& peer = Federation::peers[peerIndex];
+
+        const std::lock_guard<std::mutex> batchLock { peer.batchMutex };
+
+        if (peer.batchSize + frameSize > kMaxDatagramSize || peer.batchCount == UINT8_MAX)
+            Federation::Flush(peerIndex);
+
+        if (peer.batchCount == 0)
+        {
+            peer.batchSize = sizeof(TrunkHeader);
+            peer.batchTime = Latency::Now();
+        }
+
+        const auto frame = reinterpret_cast<TrunkFrame*>(peer.batch.data() + peer.batchSize);
+
+        frame->channel = iter->second.second;
+        frame->sender = voicePacket.sender;
+        frame->packid = voicePacket.packid;
+        frame->packet = voicePacket.packet;
+        frame->length = voicePacket.length;
+        std::memcpy(frame->data, voicePacket.data, voicePacket.length);
+
+        peer.batchSize += frameSize;
+        ++peer.batchCount;
+
+        Metrics::Add(StatType::trunkFramesSent);
+    }
+}
+
+void Federation::ThreadFunc() noexcept
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto flushInterval = std::chrono::milliseconds(Federation::flushInterval);
+
+    Tracer::SetThreadName("sv-federation");
+
+    auto flushTime = Clock::now() + flushInterval;
+
+    while (Federation::status.load(std::memory_order_relaxed))
+    {
+        const auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(flushTime - Clock::now());
+
+        // Datagrams are awaited until the next flush
+        if (waitTime.count() > 0)
+        {
+            fd_set readSet;
+
+            FD_ZERO(&readSet);
+            FD_SET(Federation::socketHandle, &readSet);
+
+            timeval timeout { static_cast<long>(waitTime.count() / 1000000),
+                static_cast<long>(waitTime.count() % 1000000) };
+
+            if (select(static_cast<int>(Federation::socketHandle) + 1, &readSet, nullptr, nullptr, &timeout) > 0)
+            {
+                Federation::ReceiveDatagram();
+                continue;
+            }
+        }
+
+        flushTime = Clock::now() + flushInterval;
+
+        const Tracer::Span span { "Federation::Flush" };
+
+        const std::shared_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+        for (uint32_t iPeer { 0 }; iPeer < kMaxPeers; ++iPeer)
+        {
+            if (!Federation::peers[iPeer].status) continue;
+
+            const std::lock_guard<std::mutex> batchLock { Federation::peers[iPeer].batchMutex };
+
+            Federation::Flush(iPeer);
+        }
+    }
+}
+
+void Federation::Flush(const uint32_t peer) noexcept
+{
+    auto& peerRef = Federation::peers[peer];
+
+    if (peerRef.batchCount == 0) return;
+
+    const auto header = reinterpret_cast<TrunkHeader*>(peerRef.batch.data());
+
+    header->signature = kTrunkSignature;
+    header->key = peerRef.key;
+    header->sequence = peerRef.sendSequence++;
+    header->batchTime = peerRef.batchTime;
+    header->count = peerRef.batchCount;
+
+    if (sendto(Federation::socketHandle, (char*)(peerRef.batch.data()), peerRef.batchSize, NULL,
+        (sockaddr*)(&peerRef.address), sizeof(peerRef.address)) == static_cast<int>(peerRef.batchSize))
+    {
+        Metrics::Add(StatType::trunkDatagramsSent);
+        Metrics::Add(StatType::trunkBytesSent, peerRef.batchSize);
+    }
+    else Metrics::Add(StatType::trunkSendErrors);
+
+    peerRef.batchSize = 0;
+    peerRef.batchCount = 0;
+}
+
+void Federation::ReceiveDatagram() noexcept
+{
+    sockaddr_in peerAddr {};
+    int addrLen { sizeof(peerAddr) };
+    uint8_t datagram[kMaxDatagramSize];
+
+    const auto length = recvfrom(Federation::socketHandle, (char*)(datagram),
+        sizeof(datagram), NULL, reinterpret_cast<sockaddr*>(&peerAddr), &addrLen);
+
+    if (length < static_cast<int>(sizeof(TrunkHeader))) return;
+
+    const auto receiveTime = Latency::Now();
+    const auto& header = *reinterpret_cast<const TrunkHeader*>(datagram);
+
+    if (header.signature != kTrunkSignature) return;
+
+    const std::shared_lock<std::shared_mutex> lock { Federation::peersMutex };
+
+    uint32_t peerIndex { 0 };
+
+    for (; peerIndex < kMaxPeers; ++peerIndex)
+    {
+        const auto& peer = Federation::peers[peerIndex];
+
+        if (peer.status && peer.key == header.key &&
+            peer.address.sin_addr.s_addr == peerAddr.sin_addr.s_addr &&
+            peer.address.sin_port == peerAddr.sin_port) break;
+    }
+
+    if (peerIndex == kMaxPeers) return;
+
+    auto& peer = Federation::peers[peerIndex];
+
+    Metrics::Add(StatType::trunkDatagramsReceived);
+
+    // Reordered datagrams are still played, only gaps are counted
+    if (peer.receiveStatus && static_cast<int32_t>(header.sequence - peer.receiveSequence) > 0)
+        Metrics::Add(StatType::trunkDatagramsLost, header.sequence - peer.receiveSequence);
+
+    if (!peer.receiveStatus || static_cast<int32_t>(header.sequence - peer.receiveSequence) >= 0)
+        peer.receiveSequence = header.sequence + 1;
+
+    peer.receiveStatus = true;
+
+    if (receiveTime > header.batchTime)
+        Latency::Record(LatencyType::trunk, receiveTime - header.batchTime);
+
+    static thread_local std::array<uint8_t, sizeof(VoicePacket) + kMaxFrameDataSize> packetBuffer;
+
+    auto& voicePacket = *reinterpret_cast<VoicePacket*>(packetBuffer.data());
+
+    uint32_t offset = sizeof(TrunkHeader);
+
+    for (uint8_t i { 0 }; i < header.count; ++i)
+    {
+        if (offset + sizeof(TrunkFrame) > static_cast<uint32_t>(length)) break;
+
+        const auto& frame = *reinterpret_cast<const TrunkFrame*>(datagram + offset);
+
+        if (offset + sizeof(TrunkFrame) + frame.length > static_cast<uint32_t>(length)) break;
+
+        offset += sizeof(TrunkFrame) + frame.length;
+
+        Metrics::Add(StatType::trunkFramesReceived);
+
+        const auto importIter = peer.imports.find(frame.channel);
+
+        if (importIter == peer.imports.end())
+        {
+            Metrics::Add(StatType::trunkFramesDropped);
+            continue;
+        }
+
+        // Remote speakers get local ids in the range of their peer
+        auto senderIter = peer.senders.find(frame.sender);
+
+        if (senderIter == peer.senders.end())
+        {
+            if (peer.senders.size() >= kSendersPerPeer)
+            {
+                Metrics::Add(StatType::trunkFramesDropped);
+                continue;
+            }
+
+            const auto sender = static_cast<uint16_t>(kMinSender +
+                peerIndex * kSendersPerPeer + peer.senders.size());
+
+            senderIter = peer.senders.emplace(frame.sender, sender).first;
+        }
+
+        voicePacket.svrkey = NULL;
+        voicePacket.packet = frame.packet;
+        voicePacket.sender = senderIter->second;
+        voicePacket.length = frame.length;
+        voicePacket.packid = frame.packid;
+
+        std::memcpy(voicePacket.data, frame.data, frame.length);
+
+        importIter->second->SendVoicePacket(voicePacket);
+    }
+}
+
+bool Federation::initStatus { false };
+
+SOCKET Federation::socketHandle { INVALID_SOCKET };
+uint32_t Federation::flushInterval { kDefaultFlushInterval };
+
+std::atomic_bool Federation::status { false };
+std::thread Federation::thread;
+
+std::shared_mutex Federation::peersMutex;
+std::array<Federation::Peer, Federation::kMaxPeers> Federation::peers;
+
+std::multimap<uint32_t, std::pair<uint32_t, uint16_t>> Federation::exports;
@@ -0,0 +1,167 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+#ifndef _WIN32
+#define SOCKET int
+#endif
+
+#include "Latency.h"
+#include "VoicePacket.h"
+
+class Stream;
+
+// Voice trunks between servers. Frames of an exported stream are sent to
+// the peer server on a channel number, the peer re-sends frames of the channel
+// into its imported stream on behalf of remapped sender ids. Frames going
+// to one peer are batched into a datagram that is flushed every flush interval
+// or as soon as it's full. Imported frames are not exported again, so trunks
+// don't make loops. The trunk socket isn't authenticated beyond the link key,
+// it should only be reachable by peer servers.
+class Federation {
+
+    Federation() = delete;
+    ~Federation() = delete;
+    Federation(const Federation&) = delete;
+    Federation(Federation&&) = delete;
+    Federation& operator=(const Federation&) = delete;
+    Federation& operator=(Federation&&) = delete;
+
+public:
+
+    static constexpr uint32_t kMaxPeers = 16;
+    static constexpr uint32_t kSendersPerPeer = 1024;
+
+    // Remote speakers of peer N get ids from kMinSender + N * kSendersPerPeer
+    static constexpr uint16_t kMinSender = 0x8000;
+
+private:
+
+    static constexpr uint32_t kTrunkSignature = 0x54525653; // "SVRT"
+    static constexpr uint32_t kMaxDatagramSize = 1400;
+    static constexpr uint32_t kSendBufferSize = 4 * 1024 * 1024;
+    static constexpr uint32_t kRecvBufferSize = 4 * 1024 * 1024;
+    static constexpr uint32_t kDefaultFlushInterval = 5;
+
+#pragma pack(push, 1)
+
+    struct TrunkHeader
+    {
+        uint32_t signature;
+        uint32_t key;
+        uint32_t sequence;
+        uint64_t batchTime; // TSC of the first frame, comparable on one host only
+        uint8_t count;
+    };
+
+    struct TrunkFrame
+    {
+        uint16_t channel;
+        uint16_t sender;
+        uint32_t packid;
+        uint8_t packet;
+        uint16_t length;
+        uint8_t data[];
+    };
+
+#pragma pack(pop)
+
+    static constexpr uint32_t kMaxFrameDataSize = kMaxDatagramSize - sizeof(TrunkHeader) - sizeof(TrunkFrame);
+
+public:
+
+    // Opens trunk socket on the port, flush interval is in milliseconds
+    static bool Open(uint16_t port, uint32_t flushInterval = kDefaultFlushInterval) noexcept;
+    static void Close() noexcept;
+
+    // Both servers of a link add each other with the same key,
+    // returns peer index or -1 if address is invalid or peers limit is reached
+    static int AddPeer(const std::string& host, uint16_t port, uint32_t key) noexcept;
+    static bool RemovePeer(int peer) noexcept;
+
+    // Stream may be exported to several peers and channels, but only
+    // one stream may be imported from a channel of a peer
+    static bool ExportStream(Stream* stream, int peer, uint16_t channel) noexcept;
+    static bool ImportStream(Stream* stream, int peer, uint16_t channel) noexcept;
+
+    // Removes exports and imports of stream, waits until its frames are re-sent
+    static void DetachStream(Stream* stream) noexcept;
+
+    // Called by workers and sources for every frame of exported stream
+    static void Push(uint32_t streamHandle, const VoicePacket& voicePacket) noexcept;
+
+private:
+
+    static void ThreadFunc() noexcept;
+
+    static void Flush(uint32_t peer) noexcept;
+    static void ReceiveDatagram() noexcept;
+
+private:
+
+    struct Peer {
+
+        bool status { false };
+
+        sockaddr_in address {};
+        uint32_t key { NULL };
+
+        // Filled by workers, flushed by trunk thread or by the worker that filled it up
+        std::mutex batchMutex;
+        std::array<uint8_t, kMaxDatagramSize> batch {};
+        uint32_t batchSize { 0 };
+        uint8_t batchCount { 0 };
+        Latency::tsc_t batchTime { 0 };
+        uint32_t sendSequence { 0 };
+
+        // Used by trunk thread only
+        bool receiveStatus { false };
+        uint32_t receiveSequence { 0 };
+        std::unordered_map<uint16_t, uint16_t> senders;
+
+        std::map<uint16_t, Stream*> imports;
+
+    };
+
+private:
+
+    static bool initStatus;
+
+    static SOCKET socketHandle;
+    static uint32_t flushInterval;
+
+    static std::atomic_bool status;
+    static std::thread thread;
+
+    // Unique access changes peers and streams, shared access sends and receives frames
+    static std::shared_mutex peersMutex;
+    static std::array<Peer, kMaxPeers> peers;
+
+    // Stream handle to its peer and channel
+    static std::multimap<uint32_t, std::pair<uint32_t, uint16_t>> exports;
+
+};
@@ -0,0 +1,395 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Group.h"
+
+#include <cassert>
+
+#include <util/logger.h>
+
+#include "DynamicStream.h"
+#include "PlayerStore.h"
+#include "World.h"
+
+Group::Group(std::string name)
+    : handle(Group::groupTable.Insert(this)), name(std::move(name))
+    , operation(Operation::none), operands { NULL, NULL }
+    , version(++Group::changesCount)
+{
+    if (this->handle == SlotMap<Group>::kInvalidHandle)
+        Logger::Log("[sv:err:group:init] : groups limit reached");
+}
+
+Group::Group(const uint8_t operation, const uint32_t firstGroup, const uint32_t secondGroup, std::string name)
+    : handle(Group::groupTable.Insert(this)), name(std::move(name))
+    , operation(operation), operands { firstGroup, secondGroup }
+    , version(++Group::changesCount)
+{
+    if (this->handle == SlotMap<Group>::kInvalidHandle)
+        Logger::Log("[sv:err:group:init] : groups limit reached");
+
+    // Operands exist before the group, so composition never makes a cycle
+    this->Update();
+}
+
+Group::~Group() noexcept
+{
+    // Bound streams and groups composed of this one see it empty
+    Group::groupTable.Remove(this->handle);
+    ++Group::changesCount;
+}
+
+uint32_t Group::GetHandle() const noexcept
+{
+    return this->handle;
+}
+
+const std::string& Group::GetName() const noexcept
+{
+    return this->name;
+}
+
+Group* Group::FromHandle(const uint32_t handle) noexcept
+{
+    return Group::groupTable.Get(handle);
+}
+
+bool Group::IsComposed() const noexcept
+{
+    return this->operation != Operation::none;
+}
+
+bool Group::AddPlayer(const uint16_t playerId) noexcept
+{
+    if (this->IsComposed() || playerId >= MAX_PLAYERS) return false;
+    if (!World::IsReady() || !PlayerStore::IsPlayerConnected(playerId)) return false;
+
+    // Player could take the id of one that has left since the last tick
+    Group::DropGonePlayers();
+
+    if (PlayerBitset::Test(this->members, playerId)) return false;
+
+    PlayerBitset::Set(this->members, playerId);
+
+    this->version = ++Group::changesCount;
+
+    return true;
+}
+
+bool Group::RemovePlayer(const uint16_t playerId) noexcept
+{
+    if (this->IsComposed() || playerId >= MAX_PLAYERS) return false;
+    if (!PlayerBitset::Test(this->members, playerId)) return false;
+
+    PlayerBitset::Reset(this->members, playerId);
+
+    this->version = ++Group::changesCount;
+
+    return true;
+}
+
+bool Group::Clear() noexcept
+{
+    if (this->IsComposed()) return false;
+
+    this->SetMembers({});
+
+    return true;
+}
+
+bool Group::HasPlayer(const uint16_t playerId) noexcept
+{
+    return playerId < MAX_PLAYERS && PlayerBitset::Test(this->GetMembers(), playerId);
+}
+
+uint32_t Group::GetPlayersCount() noexcept
+{
+    return PlayerBitset::Count(this->GetMembers());
+}
+
+const PlayerBitset::Words& Group::GetMembers() noexcept
+{
+    this->Update();
+
+    return this->members;
+}
+
+bool Group::BindListeners(Stream* const stream, Group* const group)
+{
+    assert(stream != nullptr);
+
+    if (group != nullptr && dynamic_cast<DynamicStream*>(stream) != nullptr)
+        return false;
+
+    auto& binding = Group::streamBindings[stream->GetHandle()].listeners;
+
+    binding.group = group != nullptr ? group->GetHandle() : NULL;
+    binding.version = 0;
+
+    ++Group::changesCount;
+
+    return true;
+}
+
+bool Group::BindSpeakers(Stream* const stream, Group* const group)
+{
+    assert(stream != nullptr);
+
+    auto& binding = Group::streamBindings[stream->GetHandle()].speakers;
+
+    binding.group = group != nullptr ? group->GetHandle() : NULL;
+    binding.version = 0;
+
+    ++Group::changesCount;
+
+    return true;
+}
+
+void Group::DetachStream(Stream* const stream) noexcept
+{
+    // Players have already been detached along with the stream
+    Group::streamBindings.erase(stream->GetHandle());
+}
+
+void Group::DropPlayer(const uint16_t playerId) noexcept
+{
+    assert(playerId < MAX_PLAYERS);
+
+    Group::gonePlayers[PlayerBitset::GetWord(playerId)].fetch_or
+        (PlayerBitset::GetMask(playerId), std::memory_order_relaxed);
+    Group::goneStatus.store(true, std::memory_order_release);
+}
+
+void Group::MarkPlayer(const uint16_t playerId) noexcept
+{
+    assert(playerId < MAX_PLAYERS);
+
+    Group::resetPlayers[PlayerBitset::GetWord(playerId)].fetch_or
+        (PlayerBitset::GetMask(playerId), std::memory_order_relaxed);
+    Group::resetStatus.store(true, std::memory_order_release);
+}
+
+void Group::Process()
+{
+    Group::DropGonePlayers();
+    Group::ResetPlayers();
+
+    if (Group::appliedChanges == Group::changesCount) return;
+    Group::appliedChanges = Group::changesCount;
+
+    for (auto iter = Group::streamBindings.begin(); iter != Group::streamBindings.end();)
+    {
+        const auto stream = Stream::FromHandle(iter->first);
+
+        if (stream != nullptr)
+        {
+            Group::ApplyBinding(stream, iter->second.listeners, true);
+            Group::ApplyBinding(stream, iter->second.speakers, false);
+
+            if (iter->second.listeners.group != NULL || iter->second.speakers.group != NULL)
+            {
+                ++iter;
+                continue;
+            }
+        }
+
+        iter = Group::streamBindings.erase(iter);
+    }
+}
+
+uint64_t Group::Update() noexcept
+{
+    if (!this->IsComposed()) return this->version;
+
+    uint64_t operandVersions[2];
+    Group* operandGroups[2];
+
+    for (std::size_t i { 0 }; i < 2; ++i)
+    {
+        // Deleted operand is taken as an empty group
+        operandGroups[i] = Group::FromHandle(this->operands[i]);
+        operandVersions[i] = operandGroups[i] != nullptr ? operandGroups[i]->Update() : 0;
+    }
+
+    if (operandVersions[0] == this->operandVersions[0] &&
+        operandVersions[1] == this->operandVersions[1])
+        return this->version;
+
+    this->operandVersions[0] = operandVersions[0];
+    this->operandVersions[1] = operandVersions[1];
+
+    static const PlayerBitset::Words kEmptyMembers {};
+
+    const auto& firstMembers = operandGroups[0] != nullptr ? operandGroups[0]->members : kEmptyMembers;
+    const auto& secondMembers = operandGroups[1] != nullptr ? operandGroups[1]->members : kEmptyMembers;
+
+    PlayerBitset::Words members {};
+
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+    {
+        switch (this->operation)
+        {
+            case Operation::unite: members[iWord] = firstMembers[iWord] | secondMembers[iWord]; break;
+            case Operation::intersect: members[iWord] = firstMembers[iWord] & secondMembers[iWord]; break;
+            case Operation::subtract: members[iWord] = firstMembers[iWord] & ~secondMembers[iWord]; break;
+        }
+    }
+
+    this->SetMembers(members);
+
+    return this->version;
+}
+
+void Group::SetMembers(const PlayerBitset::Words& members) noexcept
+{
+    if (members == this->members) return;
+
+    this->members = members;
+    this->version = ++Group::changesCount;
+}
+
+void Group::ApplyBinding(Stream* const stream, Binding& binding, const bool listenerStatus)
+{
+    static const PlayerBitset::Words kEmptyMembers {};
+
+    const auto group = Group::FromHandle(binding.group);
+
+    if (group != nullptr)
+    {
+        const auto version = group->Update();
+        if (version == binding.version) return;
+        binding.version = version;
+    }
+    else binding.group = NULL;
+
+    const auto& members = group != nullptr ? group->members : kEmptyMembers;
+
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+    {
+        const auto target = members[iWord] & Group::voicePlayers[iWord];
+        const auto applied = binding.applied[iWord];
+
+        if (target == applied) continue;
+
+        binding.applied[iWord] = target;
+
+        // Players are recorded in PlayerStore the same way attach natives do it
+        PlayerBitset::ForEach(target & ~applied, iWord, [=](const uint16_t iPlayerId)
+        {
+            if (listenerStatus)
+            {
+                const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(iPlayerId);
+                if (pPlayerInfo != nullptr) pPlayerInfo->listenerStreams.insert(stream);
+                PlayerStore::ReleasePlayerWithSharedAccess(iPlayerId);
+
+                stream->AttachListener(iPlayerId);
+            }
+            else
+            {
+                const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(iPlayerId);
+                if (pPlayerInfo != nullptr) pPlayerInfo->speakerStreams.insert(stream);
+                PlayerStore::ReleasePlayerWithUniqueAccess(iPlayerId);
+
+                stream->AttachSpeaker(iPlayerId);
+            }
+        });
+
+        PlayerBitset::ForEach(applied & ~target, iWord, [=](const uint16_t iPlayerId)
+        {
+            if (listenerStatus)
+            {
+                const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(iPlayerId);
+                if (pPlayerInfo != nullptr) pPlayerInfo->listenerStreams.erase(stream);
+                PlayerStore::ReleasePlayerWithSharedAccess(iPlayerId);
+
+                stream->DetachListener(iPlayerId);
+            }
+            else
+            {
+                const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(iPlayerId);
+                if (pPlayerInfo != nullptr) pPlayerInfo->speakerStreams.erase(stream);
+                PlayerStore::ReleasePlayerWithUniqueAccess(iPlayerId);
+
+                stream->DetachSpeaker(iPlayerId);
+            }
+        });
+    }
+}
+
+void Group::DropGonePlayers() noexcept
+{
+    if (!Group::goneStatus.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    PlayerBitset::Words gonePlayers;
+
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+        gonePlayers[iWord] = Group::gonePlayers[iWord].exchange(0, std::memory_order_relaxed);
+
+    // Id of the player that has left may be taken by another one
+    Group::groupTable.ForEach([&](Group* const group)
+    {
+        if (group->IsComposed()) return;
+
+        auto members = group->members;
+
+        for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+            members[iWord] &= ~gonePlayers[iWord];
+
+        group->SetMembers(members);
+    });
+}
+
+void Group::ResetPlayers() noexcept
+{
+    if (!Group::resetStatus.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+    {
+        const auto resetPlayers = Group::resetPlayers[iWord].exchange(0, std::memory_order_relaxed);
+        if (resetPlayers == 0) continue;
+
+        PlayerBitset::ForEach(resetPlayers, iWord, [](const uint16_t iPlayerId)
+        {
+            if (PlayerStore::IsPlayerHasPlugin(iPlayerId)) PlayerBitset::Set(Group::voicePlayers, iPlayerId);
+            else PlayerBitset::Reset(Group::voicePlayers, iPlayerId);
+        });
+
+        // Streams have dropped these players, bindings attach them anew
+        for (auto& streamBindings : Group::streamBindings)
+        {
+            streamBindings.second.listeners.applied[iWord] &= ~resetPlayers;
+            streamBindings.second.speakers.applied[iWord] &= ~resetPlayers;
+        }
+    }
+
+    ++Group::changesCount;
+
+    for (auto& streamBindings : Group::streamBindings)
+    {
+        streamBindings.second.listeners.version = 0;
+        streamBindings.second.speakers.version = 0;
+    }
+}
+
+SlotMap<Group> Group::groupTable;
+
+uint64_t Group::changesCount { 0 };
+uint64_t Group::appliedChanges { 0 };
+
+std::unordered_map<uint32_t, Group::StreamBindings> Group::streamBindings;
+
+PlayerBitset::Words Group::voicePlayers {};
+
+std::atomic_bool Group::goneStatus { false };
+std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> Group::gonePlayers {};
+
+std::atomic_bool Group::resetStatus { false };
+std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> Group::resetPlayers {};
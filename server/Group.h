@@ -0,0 +1,155 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "PlayerBitset.h"
+#include "SlotMap.h"
+#include "Stream.h"
+
+// Named set of players that streams take as their listeners or speakers.
+// Base group is filled by script, composed group is union, intersection or
+// difference of two other groups and is evaluated word-wise when its operands
+// have changed. Bound streams follow their groups in Group::Process once a
+// tick, only players that entered or left the group are attached or detached.
+// Groups are used from the main thread only.
+class Group {
+
+    Group() = delete;
+    Group(const Group&) = delete;
+    Group(Group&&) = delete;
+    Group& operator=(const Group&) = delete;
+    Group& operator=(Group&&) = delete;
+
+public:
+
+    struct Operation
+    {
+        enum : uint8_t
+        {
+            none,
+            unite,
+            intersect,
+            subtract
+        };
+    };
+
+public:
+
+    explicit Group(std::string name);
+    explicit Group(uint8_t operation, uint32_t firstGroup, uint32_t secondGroup, std::string name);
+
+    ~Group() noexcept;
+
+public:
+
+    uint32_t GetHandle() const noexcept;
+    const std::string& GetName() const noexcept;
+
+    // Returns nullptr for handles of deleted groups
+    static Group* FromHandle(uint32_t handle) noexcept;
+
+    bool IsComposed() const noexcept;
+
+    // Members of composed groups are only changed through their operands.
+    // Player has to be connected, members leaving the server are removed.
+    bool AddPlayer(uint16_t playerId) noexcept;
+    bool RemovePlayer(uint16_t playerId) noexcept;
+    bool Clear() noexcept;
+
+    bool HasPlayer(uint16_t playerId) noexcept;
+    uint32_t GetPlayersCount() noexcept;
+
+    const PlayerBitset::Words& GetMembers() noexcept;
+
+    // Stream takes members with plugin as listeners or speakers, nullptr
+    // group unbinds it. Dynamic streams choose their listeners themselves.
+    static bool BindListeners(Stream* stream, Group* group);
+    static bool BindSpeakers(Stream* stream, Group* group);
+
+    static void DetachStream(Stream* stream) noexcept;
+
+    // Called when the player leaves the server, base groups forget
+    // the player before anyone else can take the same id
+    static void DropPlayer(uint16_t playerId) noexcept;
+
+    // Called when voice connection of the player opens or closes,
+    // streams have already dropped the player at that moment
+    static void MarkPlayer(uint16_t playerId) noexcept;
+
+    static void Process();
+
+private:
+
+    struct Binding
+    {
+        uint32_t group { NULL };
+        uint64_t version { 0 };
+
+        // Players attached on behalf of the group
+        PlayerBitset::Words applied {};
+    };
+
+    struct StreamBindings
+    {
+        Binding listeners;
+        Binding speakers;
+    };
+
+private:
+
+    // Re-evaluates composed group if any operand has changed, returns its version
+    uint64_t Update() noexcept;
+
+    void SetMembers(const PlayerBitset::Words& members) noexcept;
+
+    static void ApplyBinding(Stream* stream, Binding& binding, bool listenerStatus);
+
+    static void DropGonePlayers() noexcept;
+    static void ResetPlayers() noexcept;
+
+private:
+
+    const uint32_t handle;
+    const std::string name;
+
+    const uint8_t operation;
+    const uint32_t operands[2];
+
+    PlayerBitset::Words members {};
+
+    // Bumped on every change of members, composed group remembers
+    // versions of its operands that it has been evaluated from
+    uint64_t version { 0 };
+    uint64_t operandVersions[2] {};
+
+private:
+
+    static SlotMap<Group> groupTable;
+
+    static uint64_t changesCount;
+    static uint64_t appliedChanges;
+
+    static std::unordered_map<uint32_t, StreamBindings> streamBindings;
+
+    static PlayerBitset::Words voicePlayers;
+
+    static std::atomic_bool goneStatus;
+    static std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> gonePlayers;
+
+    static std::atomic_bool resetStatus;
+    static std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> resetPlayers;
+
+};
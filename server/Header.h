@@ -22,15 +22,27 @@ namespace SV
     // Constants
     // --------------------------------------------
 
-    constexpr const char* kLogFileName       = "svlog.txt";
-    constexpr uint32_t    kFrequency         = 48000;
-    constexpr uint16_t    kNonePlayer        = 0xffff;
-    constexpr uint32_t    kVoiceThreadsCount = 8;
-    constexpr uint32_t    kDefaultBitrate    = 24000;
-    constexpr uint8_t     kVersion           = 11;
-    constexpr uint32_t    kSignature         = 0xDeadBeef;
-    constexpr const char* kSignaturePattern  = "\xef\xbe\xad\xde";
-    constexpr const char* kSignatureMask     = "xxxx";
+    constexpr const char* kLogFileName        = "svlog.txt";
+    constexpr const char* kConfigFileName     = "sampvoice.cfg";
+    constexpr const char* kTraceFileName      = "svtrace.json";
+    constexpr const char* kCaptureFileName    = "svcapture.bin";
+    constexpr const char* kRelayShmName       = "/sampvoice-relay";
+    constexpr const char* kRelaySocketName    = "/tmp/sampvoice-relay.sock";
+    constexpr const char* kMirrorShmName      = "/sampvoice-state";
+    constexpr uint32_t    kFrequency          = 48000;
+    constexpr uint16_t    kNonePlayer         = 0xffff;
+    constexpr uint16_t    kMixPlayer          = 0xfffe;
+    constexpr uint32_t    kVoiceThreadsCount  = 8;
+    constexpr uint32_t    kDefaultBitrate     = 24000;
+    constexpr uint32_t    kVoiceRate          = 100;
+    constexpr uint32_t    kFrameSizeInSamples = (kFrequency / 1000) * kVoiceRate;
+    constexpr uint8_t     kVersion            = 12;
+    constexpr uint32_t    kSignature          = 0xDeadBeef;
+    constexpr const char* kSignaturePattern   = "\xef\xbe\xad\xde";
+    constexpr const char* kSignatureMask      = "xxxx";
+    constexpr uint32_t    kVoiceAuthKeySize   = 16;
+    constexpr uint32_t    kVoiceAuthTagSize   = 8;
+    constexpr uint32_t    kLowLayerBitrate    = 12000;
 
     // Types
     // --------------------------------------------
@@ -70,7 +82,31 @@ namespace SV
             setStreamParameter,
             slideStreamParameter,
             createEffect,
-            deleteEffect
+            deleteEffect,
+
+            // v3.3 added
+            // ---------------------
+
+            receiverReport,
+            setBitrate
+        };
+    };
+
+    struct ConnectFeatureType
+    {
+        enum : uint8_t
+        {
+            // v3.2 added
+            // ---------------------
+
+            voiceAuth = 1 << 0,
+
+            // v3.3 added
+            // ---------------------
+
+            compactHeader  = 1 << 1,
+            bitrateControl = 1 << 2,
+            simulcast      = 1 << 3
         };
     };
 
@@ -79,7 +115,22 @@ namespace SV
         enum : uint8_t
         {
             keepAlive,
-            voicePacket
+            voicePacket,
+
+            // v3.3 added
+            // ---------------------
+
+            simulcastPacket // upstream only, see SimulcastPacket
+        };
+    };
+
+    // First byte of compact voice packet (v3.3)
+    struct CompactFlagType
+    {
+        enum : uint8_t
+        {
+            typeMask    = 0x0f,  // VoicePacketType
+            firstPacket = 1 << 4 // packet starts sequence, its packid is 0
         };
     };
 
@@ -234,5 +285,54 @@ namespace SV
         uint32_t effect;
     };
 
+    // v3.2 added
+    // -----------------------------------
+
+    // Optional byte following ConnectPacket, older clients don't send it
+    struct ConnectFeaturesPacket
+    {
+        uint8_t features;
+    };
+
+    // Sent instead of ServerInfoPacket when voice authentication
+    // was negotiated, every voice packet is then followed by tag
+    struct ServerInfoAuthPacket
+    {
+        uint32_t serverKey;
+        uint16_t serverPort;
+        uint8_t authKey[kVoiceAuthKeySize];
+    };
+
+    // v3.3 added
+    // -----------------------------------
+
+    // Optional byte following server info, it's sent only to clients
+    // that requested features and holds the ones that were accepted
+    struct ServerFeaturesPacket
+    {
+        uint8_t features;
+    };
+
+    // Receiver report is an array of entries, one per heard speaker
+    struct ReceiverReportEntry
+    {
+        uint16_t speaker;
+        uint8_t loss;   // lost packets fraction in 1/255 units
+        uint16_t jitter; // interarrival jitter in ms
+    };
+
+    struct SetBitratePacket
+    {
+        uint32_t bitrate;
+    };
+
+    // Data of simulcast voice packet: main layer encoded at player's bitrate
+    // followed by low layer encoded at kLowLayerBitrate up to the end
+    struct SimulcastPacket
+    {
+        uint16_t mainLength;
+        uint8_t data[];
+    };
+
 #pragma pack(pop)
 }
@@ -0,0 +1,68 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Histogram.h"
+
+#include <cmath>
+
+uint64_t Histogram::Snapshot::GetPercentile(const double percentile) const noexcept
+{
+    if (this->count == 0) return 0;
+
+    auto targetCount = static_cast<uint64_t>(std::ceil(this->count * (percentile / 100.0)));
+    if (targetCount == 0) targetCount = 1;
+
+    uint64_t curCount { 0 };
+
+    for (uint32_t iBucket { 0 }; iBucket < kBucketsCount; ++iBucket)
+    {
+        if ((curCount += this->buckets[iBucket]) >= targetCount)
+        {
+            const auto value = Histogram::GetBucketValue(iBucket);
+            return value < this->max ? value : this->max;
+        }
+    }
+
+    return this->max;
+}
+
+void Histogram::MergeTo(Snapshot& snapshot) const noexcept
+{
+    for (uint32_t iBucket { 0 }; iBucket < kBucketsCount; ++iBucket)
+    {
+        const auto bucketCount = this->buckets[iBucket].load(std::memory_order_relaxed);
+
+        snapshot.buckets[iBucket] += bucketCount;
+        snapshot.count += bucketCount;
+    }
+
+    const auto curMax = this->max.load(std::memory_order_relaxed);
+    if (curMax > snapshot.max) snapshot.max = curMax;
+}
+
+void Histogram::Reset() noexcept
+{
+    for (auto& bucket : this->buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    this->max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::GetBucketValue(const uint32_t index) noexcept
+{
+    if (index < kSubBucketsCount) return index;
+
+    const uint32_t exponent = index / kSubBucketsCount + kSubBucketBits - 1;
+    const uint64_t subBucket = index % kSubBucketsCount;
+
+    const uint64_t width = static_cast<uint64_t>(1) << (exponent - kSubBucketBits);
+    const uint64_t lowerBound = (static_cast<uint64_t>(1) << exponent) | (subBucket << (exponent - kSubBucketBits));
+
+    return lowerBound + width / 2;
+}
@@ -0,0 +1,103 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Log-bucketed histogram in the manner of HdrHistogram: every power of two
+// range is split into kSubBucketsCount linear sub-buckets, so that relative
+// error of any recorded value stays below 1/kSubBucketsCount
+class Histogram {
+
+    Histogram(const Histogram&) = delete;
+    Histogram(Histogram&&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+    Histogram& operator=(Histogram&&) = delete;
+
+public:
+
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketsCount = 1 << kSubBucketBits;
+    static constexpr uint32_t kMaxValueBits = 48;
+    static constexpr uint32_t kBucketsCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketsCount;
+
+public:
+
+    struct Snapshot {
+
+        uint64_t GetPercentile(double percentile) const noexcept;
+
+        uint64_t count { 0 };
+        uint64_t max { 0 };
+        std::array<uint64_t, kBucketsCount> buckets {};
+
+    };
+
+public:
+
+    Histogram() noexcept = default;
+    ~Histogram() noexcept = default;
+
+public:
+
+    // Lock-free, may be called from any thread
+    inline void Record(const uint64_t value) noexcept
+    {
+        this->buckets[Histogram::GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+        auto curMax = this->max.load(std::memory_order_relaxed);
+        while (value > curMax && !this->max.compare_exchange_weak(curMax, value, std::memory_order_relaxed));
+    }
+
+    void MergeTo(Snapshot& snapshot) const noexcept;
+    void Reset() noexcept;
+
+public:
+
+    static inline uint32_t GetBucketIndex(uint64_t value) noexcept
+    {
+        if (value < kSubBucketsCount) return static_cast<uint32_t>(value);
+        if (value >> kMaxValueBits) value = (static_cast<uint64_t>(1) << kMaxValueBits) - 1;
+
+        const uint32_t exponent = Histogram::GetHighestBit(value);
+        const uint32_t subBucket = static_cast<uint32_t>(value >> (exponent - kSubBucketBits)) & (kSubBucketsCount - 1);
+
+        return (exponent - kSubBucketBits + 1) * kSubBucketsCount + subBucket;
+    }
+
+    // Returns middle of values range covered by the bucket
+    static uint64_t GetBucketValue(uint32_t index) noexcept;
+
+private:
+
+    static inline uint32_t GetHighestBit(const uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#ifdef _WIN64
+        _BitScanReverse64(&index, value);
+#else
+        if (value >> 32) { _BitScanReverse(&index, static_cast<unsigned long>(value >> 32)); index += 32; }
+        else _BitScanReverse(&index, static_cast<unsigned long>(value));
+#endif
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+private:
+
+    std::atomic<uint64_t> max { 0 };
+    std::array<std::atomic<uint64_t>, kBucketsCount> buckets {};
+
+};
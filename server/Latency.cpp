@@ -0,0 +1,147 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Latency.h"
+
+#include <chrono>
+#include <memory>
+
+#include <util/logger.h>
+
+#include "Header.h"
+
+static constexpr const char* kLatencyNames[LatencyType::count]
+{
+    "forward",
+    "forward_gstream",
+    "forward_lpstream",
+    "forward_lstream_at_vehicle",
+    "forward_lstream_at_player",
+    "forward_lstream_at_object",
+    "tick",
+    "trunk"
+};
+
+static inline int64_t GetSteadyTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t Latency::GetStreamLatencyType(const uint16_t createPacketType) noexcept
+{
+    switch (createPacketType)
+    {
+        case SV::ControlPacketType::createGStream: return LatencyType::forwardGStream;
+        case SV::ControlPacketType::createLPStream: return LatencyType::forwardLPStream;
+        case SV::ControlPacketType::createLStreamAtVehicle: return LatencyType::forwardLStreamAtVehicle;
+        case SV::ControlPacketType::createLStreamAtPlayer: return LatencyType::forwardLStreamAtPlayer;
+        case SV::ControlPacketType::createLStreamAtObject: return LatencyType::forwardLStreamAtObject;
+    }
+
+    return LatencyType::forward;
+}
+
+uint64_t Latency::GetPercentile(const uint32_t type, const double percentile) noexcept
+{
+    if (type >= LatencyType::count) return 0;
+
+    const auto snapshot = std::make_unique<Histogram::Snapshot>();
+    if (snapshot == nullptr) return 0;
+
+    Latency::Merge(type, *snapshot);
+
+    return static_cast<uint64_t>(snapshot->GetPercentile(percentile) / Latency::GetTicksPerNanosecond());
+}
+
+void Latency::Reset() noexcept
+{
+    for (auto& shard : Latency::shards)
+    {
+        for (auto& histogram : shard.histograms)
+            histogram.Reset();
+    }
+}
+
+void Latency::Dump(FILE* const file) noexcept
+{
+    const auto snapshot = std::make_unique<Histogram::Snapshot>();
+    if (snapshot == nullptr) return;
+
+    const auto ticksPerNanosecond = Latency::GetTicksPerNanosecond();
+
+    std::fputc('{', file);
+
+    for (uint32_t iType { 0 }; iType < LatencyType::count; ++iType)
+    {
+        *snapshot = {};
+        Latency::Merge(iType, *snapshot);
+
+        std::fprintf(file, "%s\"%s\":{\"count\":%llu,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+            iType != 0 ? "," : "", kLatencyNames[iType], static_cast<unsigned long long>(snapshot->count),
+            static_cast<unsigned long long>(snapshot->GetPercentile(50.0) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->GetPercentile(99.0) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->GetPercentile(99.9) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->max / ticksPerNanosecond));
+    }
+
+    std::fputc('}', file);
+}
+
+void Latency::DumpToLog() noexcept
+{
+    const auto snapshot = std::make_unique<Histogram::Snapshot>();
+    if (snapshot == nullptr) return;
+
+    const auto ticksPerNanosecond = Latency::GetTicksPerNanosecond();
+
+    for (uint32_t iType { 0 }; iType < LatencyType::count; ++iType)
+    {
+        *snapshot = {};
+        Latency::Merge(iType, *snapshot);
+
+        Logger::Log("[sv:dbg:latency:dump] : %s (count:%llu;p50:%lluns;p99:%lluns;p999:%lluns;max:%lluns)",
+            kLatencyNames[iType], static_cast<unsigned long long>(snapshot->count),
+            static_cast<unsigned long long>(snapshot->GetPercentile(50.0) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->GetPercentile(99.0) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->GetPercentile(99.9) / ticksPerNanosecond),
+            static_cast<unsigned long long>(snapshot->max / ticksPerNanosecond));
+    }
+}
+
+const char* Latency::GetName(const uint32_t type) noexcept
+{
+    if (type >= LatencyType::count) return nullptr;
+
+    return kLatencyNames[type];
+}
+
+void Latency::Merge(const uint32_t type, Histogram::Snapshot& snapshot) noexcept
+{
+    for (const auto& shard : Latency::shards)
+        shard.histograms[type].MergeTo(snapshot);
+}
+
+double Latency::GetTicksPerNanosecond() noexcept
+{
+    // TSC is invariant on all CPUs we run on, so the rate measured
+    // over the whole uptime is more precise than a short calibration
+    const auto elapsedTicks = Latency::Now() - Latency::initTicks;
+    const auto elapsedTime = GetSteadyTime() - Latency::initTime;
+
+    if (elapsedTime <= 0 || elapsedTicks == 0) return 1.0;
+
+    return static_cast<double>(elapsedTicks) / static_cast<double>(elapsedTime);
+}
+
+std::atomic<uint32_t> Latency::nextShardIndex { 0 };
+std::array<Latency::Shard, Latency::kShardsCount> Latency::shards;
+
+Latency::tsc_t Latency::initTicks { Latency::Now() };
+int64_t Latency::initTime { GetSteadyTime() };
@@ -0,0 +1,118 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "Histogram.h"
+
+struct LatencyType
+{
+    enum : uint32_t
+    {
+        forward,                // from recvfrom returning to the last sendto of fan-out
+        forwardGStream,
+        forwardLPStream,
+        forwardLStreamAtVehicle,
+        forwardLStreamAtPlayer,
+        forwardLStreamAtObject,
+        tick,                   // SV::Tick duration on the main thread
+        trunk,                  // from batching the first frame on peer to receiving its datagram,
+                                // only meaningful for peers sharing the host
+
+        count
+    };
+};
+
+// Latencies are recorded in TSC ticks into per-thread histogram shards
+// and converted to nanoseconds only when shards are merged for reading
+class Latency {
+
+    Latency() = delete;
+    ~Latency() = delete;
+    Latency(const Latency&) = delete;
+    Latency(Latency&&) = delete;
+    Latency& operator=(const Latency&) = delete;
+    Latency& operator=(Latency&&) = delete;
+
+private:
+
+    static constexpr uint32_t kShardsCount = 16;
+
+public:
+
+    using tsc_t = uint64_t;
+
+public:
+
+    static inline tsc_t Now() noexcept
+    {
+        return __rdtsc();
+    }
+
+    static inline void Record(const uint32_t type, const tsc_t ticks) noexcept
+    {
+        Latency::shards[Latency::GetShardIndex()].histograms[type].Record(ticks);
+    }
+
+    // Maps stream's create packet type to its forward histogram
+    static uint32_t GetStreamLatencyType(uint16_t createPacketType) noexcept;
+
+    // Percentile of merged shards in nanoseconds
+    static uint64_t GetPercentile(uint32_t type, double percentile) noexcept;
+
+    static void Reset() noexcept;
+
+    // Writes JSON object with count, p50, p99, p999 and max of every histogram
+    static void Dump(FILE* file) noexcept;
+    static void DumpToLog() noexcept;
+
+    static const char* GetName(uint32_t type) noexcept;
+
+    static double GetTicksPerNanosecond() noexcept;
+
+private:
+
+    static void Merge(uint32_t type, Histogram::Snapshot& snapshot) noexcept;
+
+    static inline uint32_t GetShardIndex() noexcept
+    {
+        static thread_local const uint32_t shardIndex = Latency::nextShardIndex.fetch_add
+            (1, std::memory_order_relaxed) % kShardsCount;
+
+        return shardIndex;
+    }
+
+private:
+
+    struct Shard {
+
+        std::array<Histogram, LatencyType::count> histograms;
+
+    };
+
+private:
+
+    static std::atomic<uint32_t> nextShardIndex;
+    static std::array<Shard, kShardsCount> shards;
+
+    static tsc_t initTicks;
+    static int64_t initTime;
+
+};
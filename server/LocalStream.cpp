@@ -11,30 +11,29 @@
 
 #include <cassert>
 
-#include <ysf/globals.h>
-
 #include "Network.h"
 #include "PlayerStore.h"
+#include "StateMirror.h"
+#include "World.h"
 #include "Header.h"
 
 LocalStream::LocalStream(const float distance)
 {
     PackWrap(this->packetStreamUpdateDistance, SV::ControlPacketType::updateLStreamDistance, sizeof(SV::UpdateLStreamDistancePacket));
 
-    PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->stream = this->GetHandle();
     PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->distance = distance;
 }
 
 void LocalStream::UpdateDistance(const float distance)
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     PackGetStruct(&*this->packetStreamUpdateDistance, SV::UpdateLStreamDistancePacket)->distance = distance;
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    StateMirror::MarkStream(this->GetHandle());
+
+    if (World::GetConnectedPlayersCount() != 0)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        const auto playerPoolSize = World::GetPlayerPoolSize();
 
         for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
         {
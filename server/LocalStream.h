@@ -14,6 +14,8 @@
 
 class LocalStream : public Stream {
 
+    friend class StateMirror;
+
     LocalStream() = delete;
     LocalStream(const LocalStream&) = delete;
     LocalStream(LocalStream&&) = delete;
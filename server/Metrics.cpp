@@ -0,0 +1,159 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Metrics.h"
+
+#include <chrono>
+
+#include <util/logger.h>
+
+#include "Latency.h"
+#include "Header.h"
+
+static constexpr const char* kStatNames[StatType::statsCount]
+{
+    "voice_packets_received",
+    "voice_bytes_received",
+    "voice_packets_dropped_size",
+    "voice_packets_dropped_hash",
+    "voice_packets_dropped_key",
+    "voice_packets_dropped_auth",
+    "voice_packets_dropped_throttle",
+    "voice_packets_accepted",
+    "keepalive_packets_received",
+    "keepalive_packets_sent",
+    "voice_packets_forwarded",
+    "voice_bytes_forwarded",
+    "voice_packets_send_errors",
+    "control_packets_received",
+    "control_packets_dropped",
+    "control_packets_sent",
+    "control_packets_send_errors",
+    "raknet_messages_flushed",
+    "ticks_count",
+    "mixer_frames_decoded",
+    "mixer_frames_encoded",
+    "source_frames_sent",
+    "receiver_reports_received",
+    "bitrate_changes_sent",
+    "low_layer_packets_forwarded",
+    "trunk_frames_sent",
+    "trunk_datagrams_sent",
+    "trunk_bytes_sent",
+    "trunk_send_errors",
+    "trunk_datagrams_received",
+    "trunk_datagrams_lost",
+    "trunk_frames_received",
+    "trunk_frames_dropped",
+
+    "control_queue_depth",
+    "raknet_queue_depth",
+    "workers_count",
+    "workers_utilization",
+    "streams_count"
+};
+
+bool Metrics::Init(const std::string& statsFile, const uint32_t dumpInterval)
+{
+    if (statsFile.empty() || dumpInterval == 0)
+        return false;
+
+    if (Metrics::dumpStatus.exchange(true, std::memory_order_acq_rel))
+        return false;
+
+    Logger::Log("[sv:dbg:metrics:init] : writing stats to (%s) every %u ms", statsFile.c_str(), dumpInterval);
+
+    Metrics::dumpThread = std::thread(Metrics::DumpThread, statsFile, dumpInterval);
+
+    return true;
+}
+
+void Metrics::Free() noexcept
+{
+    Metrics::dumpStatus.store(false, std::memory_order_release);
+
+    if (Metrics::dumpThread.joinable())
+        Metrics::dumpThread.join();
+}
+
+int64_t Metrics::Get(const uint32_t stat) noexcept
+{
+    if (stat >= StatType::statsCount) return NULL;
+
+    if (stat >= StatType::countersCount)
+        return Metrics::gauges[stat - StatType::countersCount].load(std::memory_order_relaxed);
+
+    uint64_t value { 0 };
+
+    for (const auto& shard : Metrics::shards)
+        value += shard.counters[stat].load(std::memory_order_relaxed);
+
+    return static_cast<int64_t>(value);
+}
+
+const char* Metrics::GetName(const uint32_t stat) noexcept
+{
+    if (stat >= StatType::statsCount) return nullptr;
+
+    return kStatNames[stat];
+}
+
+void Metrics::Dump(FILE* const file) noexcept
+{
+    const auto curTime = std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::fprintf(file, "{\"time\":%lld", static_cast<long long>(curTime));
+
+    for (uint32_t iStat { 0 }; iStat < StatType::statsCount; ++iStat)
+        std::fprintf(file, ",\"%s\":%lld", kStatNames[iStat], static_cast<long long>(Metrics::Get(iStat)));
+
+    std::fputs(",\"latency\":", file);
+    Latency::Dump(file);
+
+    std::fputs("}\n", file);
+}
+
+void Metrics::DumpThread(const std::string statsFile, const uint32_t dumpInterval) noexcept
+{
+    auto lastDumpTime = std::chrono::steady_clock::now();
+
+    while (Metrics::dumpStatus.load(std::memory_order_acquire))
+    {
+        SleepForMilliseconds(kDumpSleepTime);
+
+        const auto curTime = std::chrono::steady_clock::now();
+
+        if (curTime - lastDumpTime < std::chrono::milliseconds(dumpInterval))
+            continue;
+
+        lastDumpTime = curTime;
+
+        // File is reopened every time so that it can be rotated externally
+        const auto file = std::fopen(statsFile.c_str(), "a");
+
+        if (file == nullptr)
+        {
+            Logger::Log("[sv:err:metrics:dump] : failed to open stats file (%s)", statsFile.c_str());
+            continue;
+        }
+
+        Metrics::Dump(file);
+
+        std::fclose(file);
+    }
+}
+
+std::atomic<uint32_t> Metrics::nextShardIndex { 0 };
+
+std::array<Metrics::Shard, Metrics::kShardsCount> Metrics::shards;
+std::array<std::atomic<int64_t>, Metrics::kGaugesCount> Metrics::gauges {};
+
+std::atomic_bool Metrics::dumpStatus { false };
+std::thread Metrics::dumpThread;
@@ -0,0 +1,143 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+struct StatType
+{
+    enum : uint32_t
+    {
+        // Counters
+        // ---------------------
+
+        voicePacketsReceived,
+        voiceBytesReceived,
+        voicePacketsDroppedSize,
+        voicePacketsDroppedHash,
+        voicePacketsDroppedKey,
+        voicePacketsDroppedAuth,
+        voicePacketsDroppedThrottle,
+        voicePacketsAccepted,
+        keepAlivePacketsReceived,
+        keepAlivePacketsSent,
+        voicePacketsForwarded,
+        voiceBytesForwarded,
+        voicePacketsSendErrors,
+        controlPacketsReceived,
+        controlPacketsDropped,
+        controlPacketsSent,
+        controlPacketsSendErrors,
+        raknetMessagesFlushed,
+        ticksCount,
+        mixerFramesDecoded,
+        mixerFramesEncoded,
+        sourceFramesSent,
+        receiverReportsReceived,
+        bitrateChangesSent,
+        lowLayerPacketsForwarded,
+        trunkFramesSent,
+        trunkDatagramsSent,
+        trunkBytesSent,
+        trunkSendErrors,
+        trunkDatagramsReceived,
+        trunkDatagramsLost,
+        trunkFramesReceived,
+        trunkFramesDropped,
+
+        countersCount,
+
+        // Gauges
+        // ---------------------
+
+        controlQueueDepth = countersCount,
+        raknetQueueDepth,
+        workersCount,
+        workersUtilization,
+        streamsCount,
+
+        statsCount
+    };
+};
+
+// Counters are sharded per thread so that hot paths touch only their own
+// cache lines, reading a counter sums all shards. Gauges hold last value.
+class Metrics {
+
+    Metrics() = delete;
+    ~Metrics() = delete;
+    Metrics(const Metrics&) = delete;
+    Metrics(Metrics&&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+    Metrics& operator=(Metrics&&) = delete;
+
+private:
+
+    static constexpr uint32_t kShardsCount = 32;
+    static constexpr uint32_t kGaugesCount = StatType::statsCount - StatType::countersCount;
+    static constexpr uint32_t kDumpSleepTime = 100;
+
+public:
+
+    static bool Init(const std::string& statsFile, uint32_t dumpInterval);
+    static void Free() noexcept;
+
+    static inline void Add(const uint32_t counter, const uint64_t value = 1) noexcept
+    {
+        Metrics::shards[Metrics::GetShardIndex()].counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    static inline void Set(const uint32_t gauge, const int64_t value) noexcept
+    {
+        Metrics::gauges[gauge - StatType::countersCount].store(value, std::memory_order_relaxed);
+    }
+
+    static int64_t Get(uint32_t stat) noexcept;
+    static const char* GetName(uint32_t stat) noexcept;
+
+    // Writes one JSON object line with all stats and latency histograms
+    static void Dump(FILE* file) noexcept;
+
+private:
+
+    static inline uint32_t GetShardIndex() noexcept
+    {
+        static thread_local const uint32_t shardIndex = Metrics::nextShardIndex.fetch_add
+            (1, std::memory_order_relaxed) % kShardsCount;
+
+        return shardIndex;
+    }
+
+    static void DumpThread(std::string statsFile, uint32_t dumpInterval) noexcept;
+
+private:
+
+    struct alignas(64) Shard {
+
+        std::array<std::atomic<uint64_t>, StatType::countersCount> counters {};
+
+    };
+
+private:
+
+    static std::atomic<uint32_t> nextShardIndex;
+
+    static std::array<Shard, kShardsCount> shards;
+    static std::array<std::atomic<int64_t>, kGaugesCount> gauges;
+
+    static std::atomic_bool dumpStatus;
+    static std::thread dumpThread;
+
+};
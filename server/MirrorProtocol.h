@@ -0,0 +1,169 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Format of the state mirror, a shared memory segment where plugin keeps a copy
+// of players (their plugin status, keys and voice addresses) and of streams (their
+// listeners, speakers and positions) for external processes such as recorders or
+// monitors to read without Pawn and without syscalls. Every record has its own
+// sequence lock: plugin main thread is the only writer, readers copy a record
+// and retry if it was being changed meanwhile.
+namespace Mirror
+{
+    constexpr uint32_t kSignature = 0x4d525653; // "SVRM"
+    constexpr uint32_t kVersion = 1;
+
+    constexpr uint32_t kMaxPlayers = 1000;
+    constexpr uint32_t kMaxStreams = 4096;
+
+    constexpr uint32_t kPlayerWords = (kMaxPlayers + 63) / 64;
+    constexpr uint32_t kKeyWords = 256 / 64;
+
+    // Plugin is considered gone if it didn't update its heartbeat for this time
+    constexpr int64_t kHeartbeatInterval = 100;
+    constexpr int64_t kHeartbeatTimeout = 2000;
+
+    // Reader gives up on a record that kept changing for this many copies
+    constexpr uint32_t kMaxReadAttempts = 64;
+
+    constexpr uint32_t kNoneTarget = UINT32_MAX;
+
+    // Stream occupies slot of its handle's index, see SlotMap,
+    // streams with indexes beyond kMaxStreams are not mirrored
+    constexpr uint32_t GetStreamSlot(const uint32_t handle) noexcept
+    {
+        return handle & 0xffff;
+    }
+
+    inline bool TestBit(const uint64_t* const words, const uint32_t bit) noexcept
+    {
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    inline void SetBit(uint64_t* const words, const uint32_t bit) noexcept
+    {
+        words[bit / 64] |= uint64_t { 1 } << (bit % 64);
+    }
+
+    struct PlayerRecord
+    {
+        // Player is connected and has plugin, other fields are zero otherwise
+        uint8_t status;
+        uint8_t pluginVersion;
+        uint8_t microStatus;
+        uint8_t muteStatus;
+        uint8_t recordStatus;
+        uint8_t reserved[3];
+
+        // Voice address in network byte order, zero until player's first packet
+        uint32_t address;
+        uint16_t port;
+        uint16_t reserved2;
+
+        uint64_t keys[kKeyWords];
+    };
+
+    struct StreamRecord
+    {
+        // Zero if slot is free
+        uint32_t handle;
+
+        // SV::ControlPacketType of the stream's create packet
+        uint16_t type;
+        uint8_t mixMode;
+        uint8_t recordStatus;
+
+        // Set for local streams, position for the ones at point, target
+        // is player, vehicle or object for the ones attached to entity
+        float distance;
+        float position[3];
+        uint32_t target;
+
+        uint32_t listenersCount;
+        uint32_t speakersCount;
+
+        uint64_t listeners[kPlayerWords];
+        uint64_t speakers[kPlayerWords];
+    };
+
+    template <class RecordType>
+    struct alignas(64) Slot
+    {
+        // Odd while writer is changing the record
+        std::atomic<uint32_t> sequence;
+        RecordType record;
+
+        // Single writer only
+        void Store(const RecordType& newRecord) noexcept
+        {
+            const auto curSequence = this->sequence.load(std::memory_order_relaxed);
+
+            this->sequence.store(curSequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::memcpy(&this->record, &newRecord, sizeof(newRecord));
+
+            this->sequence.store(curSequence + 2, std::memory_order_release);
+        }
+
+        // Returns false if the record kept changing, 'recordSequence'
+        // is the version of the copy, equal ones mean equal records
+        bool Load(RecordType& outRecord, uint32_t* const recordSequence = nullptr) const noexcept
+        {
+            for (uint32_t attempt = 0; attempt < kMaxReadAttempts; ++attempt)
+            {
+                const auto beginSequence = this->sequence.load(std::memory_order_acquire);
+                if (beginSequence & 1) continue;
+
+                std::memcpy(&outRecord, &this->record, sizeof(outRecord));
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (this->sequence.load(std::memory_order_relaxed) != beginSequence) continue;
+
+                if (recordSequence != nullptr) *recordSequence = beginSequence;
+                return true;
+            }
+
+            return false;
+        }
+
+        uint32_t GetSequence() const noexcept
+        {
+            return this->sequence.load(std::memory_order_acquire);
+        }
+    };
+
+    struct Shared
+    {
+        uint32_t signature;
+        uint32_t version;
+
+        uint32_t maxPlayers;
+        uint32_t maxStreams;
+
+        // Bumped after every batch of changed records, readers that
+        // see the same value may keep what they have read before
+        std::atomic<uint64_t> changes;
+
+        // Slots from this one on have never been used
+        std::atomic<uint32_t> streamsLimit;
+
+        // Milliseconds of CLOCK_MONOTONIC, shared by processes of one host
+        std::atomic<int64_t> pluginHeartbeat;
+        std::atomic<uint8_t> pluginClosed;
+
+        Slot<PlayerRecord> players[kMaxPlayers];
+        Slot<StreamRecord> streams[kMaxStreams];
+    };
+}
@@ -0,0 +1,502 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Mixer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SV_MIXER_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SV_MCU
+#include <opus.h>
+#endif
+
+#include <util/logger.h>
+
+#include "MixerPool.h"
+#include "Network.h"
+#include "PlayerStore.h"
+#include "Recorder.h"
+#include "Stream.h"
+#include "World.h"
+#include "Metrics.h"
+#include "Tracer.h"
+
+Mixer::Mixer(const Stream& stream) noexcept
+    : stream(stream)
+{
+    MixerPool::Register(this);
+}
+
+Mixer::~Mixer() noexcept
+{
+    MixerPool::Unregister(this);
+
+    Mixer::DestroyEncoder(this->sharedEncoder);
+}
+
+Mixer::Speaker::~Speaker() noexcept
+{
+    Mixer::DestroyDecoder(this->decoder);
+    Mixer::DestroyEncoder(this->encoder);
+}
+
+bool Mixer::IsAvailable() noexcept
+{
+#ifdef SV_MCU
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Mixer::SetBitrate(const uint32_t bitrate) noexcept
+{
+    Mixer::bitrate.store(bitrate, std::memory_order_relaxed);
+}
+
+uint8_t Mixer::GetMode() const noexcept
+{
+    return this->mode.load(std::memory_order_relaxed);
+}
+
+void Mixer::SetMode(const uint8_t mode) noexcept
+{
+    this->mode.store(mode, std::memory_order_relaxed);
+}
+
+bool Mixer::IsRecording() const noexcept
+{
+    return this->recordStatus.load(std::memory_order_relaxed);
+}
+
+void Mixer::SetRecording(const bool recordStatus) noexcept
+{
+    this->recordStatus.store(recordStatus, std::memory_order_relaxed);
+}
+
+void Mixer::Push(const VoicePacket& voicePacket) noexcept
+{
+    if (voicePacket.length == 0 || voicePacket.length > kMaxFrameSize)
+        return;
+
+    const std::lock_guard<std::mutex> lock { this->inputMutex };
+
+    auto& frame = this->input.emplace_back();
+
+    frame.sender = voicePacket.sender;
+    frame.length = voicePacket.length;
+    std::memcpy(frame.data.data(), voicePacket.data, voicePacket.length);
+}
+
+void Mixer::Tick() noexcept
+{
+    const Tracer::Span span { "Mixer::Tick" };
+
+    {
+        const std::lock_guard<std::mutex> lock { this->inputMutex };
+        this->input.swap(this->pending);
+    }
+
+    const auto mode = this->mode.load(std::memory_order_relaxed);
+    const auto recordStatus = this->recordStatus.load(std::memory_order_relaxed);
+
+    if (mode == Mode::disabled && !recordStatus)
+    {
+        this->pending.clear();
+        this->speakers.clear();
+        return;
+    }
+
+    for (auto& frame : this->pending)
+    {
+        auto& speaker = this->speakers[frame.sender];
+
+        if (speaker == nullptr) speaker = std::make_unique<Speaker>();
+        if (speaker->decoder == nullptr && (speaker->decoder = Mixer::CreateDecoder()) == nullptr)
+            continue;
+
+        if (speaker->frames.size() >= kMaxQueuedFrames)
+            speaker->frames.pop_front();
+
+        speaker->frames.emplace_back(frame);
+    }
+
+    this->pending.clear();
+
+    // Every speaker contributes one frame per tick, frames that arrived
+    // early wait in its queue and a missing one is concealed by decoder
+    this->activeSpeakers.clear();
+
+    for (auto iter = this->speakers.begin(); iter != this->speakers.end();)
+    {
+        auto& speaker = *iter->second;
+
+        speaker.activeStatus = false;
+
+        if (!speaker.frames.empty())
+        {
+            speaker.activeStatus = Mixer::Decode(speaker.decoder, &speaker.frames.front(), speaker.pcm.data());
+            speaker.frames.pop_front();
+            speaker.lostFrames = 0;
+        }
+        else if (speaker.lostFrames < kMaxLostFrames)
+        {
+            speaker.activeStatus = Mixer::Decode(speaker.decoder, nullptr, speaker.pcm.data());
+            ++speaker.lostFrames;
+        }
+
+        if (speaker.activeStatus)
+        {
+            speaker.energy = Mixer::Energy(speaker.pcm.data(), speaker.pcm.size());
+            speaker.idleTicks = 0;
+
+            this->activeSpeakers.emplace_back(&speaker);
+        }
+        else if (++speaker.idleTicks >= kSpeakerTimeout)
+        {
+            iter = this->speakers.erase(iter);
+            continue;
+        }
+
+        ++iter;
+    }
+
+    if (this->activeSpeakers.empty()) return;
+
+    Metrics::Add(StatType::mixerFramesDecoded, this->activeSpeakers.size());
+
+    // Only the loudest speakers get into the mix, that bounds both the number
+    // of own mixes to encode and the noise summed from open microphones
+    if (this->activeSpeakers.size() > kMaxMixedSpeakers)
+    {
+        std::nth_element(this->activeSpeakers.begin(), this->activeSpeakers.begin() + kMaxMixedSpeakers,
+            this->activeSpeakers.end(), [](const Speaker* const a, const Speaker* const b) { return a->energy > b->energy; });
+
+        for (auto iter = this->activeSpeakers.begin() + kMaxMixedSpeakers; iter != this->activeSpeakers.end(); ++iter)
+            (*iter)->activeStatus = false;
+
+        this->activeSpeakers.resize(kMaxMixedSpeakers);
+    }
+
+    std::fill(this->mix.begin(), this->mix.end(), 0);
+
+    for (const auto speaker : this->activeSpeakers)
+        Mixer::Accumulate(this->mix.data(), speaker->pcm.data(), this->mix.size());
+
+    const auto activeSpeakers = this->activeSpeakers.size();
+
+    // Packet numbers are common for all listeners so that client sees
+    // continuous sequence when switching between shared and own mix
+    ++this->packid;
+
+    const VoicePacket* sharedPacket { nullptr };
+    bool sharedStatus { false };
+
+    // Shared mix is encoded once by whoever needs it first
+    const auto getSharedPacket = [&]() noexcept -> const VoicePacket*
+    {
+        if (!sharedStatus)
+        {
+            sharedStatus = true;
+
+            if (this->sharedEncoder == nullptr)
+                this->sharedEncoder = Mixer::CreateEncoder();
+
+            if (this->sharedEncoder != nullptr)
+            {
+                Mixer::Saturate(this->output.data(), this->mix.data(), this->output.size());
+                sharedPacket = this->EncodePacket(this->sharedEncoder, this->output.data(), this->sharedBuffer);
+            }
+        }
+
+        return sharedPacket;
+    };
+
+    if (recordStatus)
+    {
+        if (const auto packet = getSharedPacket(); packet != nullptr)
+            Recorder::Push(this->stream.GetHandle(), *packet);
+    }
+
+    if (mode == Mode::disabled || World::GetConnectedPlayersCount() == 0)
+        return;
+
+    const auto playerPoolSize = World::GetPlayerPoolSize();
+
+    uint32_t sendedPackets { 0 };
+    uint32_t sendedBytes { 0 };
+    uint32_t failedPackets { 0 };
+
+    for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
+    {
+        if (!this->stream.HasListener(iPlayerId) || !PlayerStore::IsPlayerConnected(iPlayerId))
+            continue;
+
+        Speaker* ownSpeaker { nullptr };
+
+        if (const auto iter = this->speakers.find(iPlayerId); iter != this->speakers.end() && iter->second->activeStatus)
+            ownSpeaker = iter->second.get();
+
+        // Mix would contain listener's own voice only
+        if (ownSpeaker != nullptr && activeSpeakers == 1)
+            continue;
+
+        const VoicePacket* packet { nullptr };
+
+        if (ownSpeaker != nullptr && mode == Mode::perListener)
+        {
+            if (ownSpeaker->encoder == nullptr && (ownSpeaker->encoder = Mixer::CreateEncoder()) == nullptr)
+                continue;
+
+            Mixer::SaturateWithout(this->output.data(), this->mix.data(), ownSpeaker->pcm.data(), this->output.size());
+            packet = this->EncodePacket(ownSpeaker->encoder, this->output.data(), this->listenerBuffer);
+        }
+        else
+        {
+            packet = getSharedPacket();
+        }
+
+        if (packet == nullptr) continue;
+
+        if (Network::SendVoicePacket(iPlayerId, *packet))
+        {
+            sendedBytes += packet->GetFullSize();
+            ++sendedPackets;
+        }
+        else
+        {
+            ++failedPackets;
+        }
+    }
+
+    if (sendedPackets != 0)
+    {
+        Metrics::Add(StatType::voicePacketsForwarded, sendedPackets);
+        Metrics::Add(StatType::voiceBytesForwarded, sendedBytes);
+    }
+
+    if (failedPackets != 0)
+        Metrics::Add(StatType::voicePacketsSendErrors, failedPackets);
+}
+
+void Mixer::Accumulate(int32_t* const mix, const int16_t* const frame, const std::size_t count) noexcept
+{
+    std::size_t i { 0 };
+
+#ifdef SV_MIXER_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+
+        // Sign extension: sample goes to upper half and is shifted back
+        const auto samplesLo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const auto samplesHi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        const auto mixLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i));
+        const auto mixHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i + 4));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mix + i), _mm_add_epi32(mixLo, samplesLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mix + i + 4), _mm_add_epi32(mixHi, samplesHi));
+    }
+#endif
+
+    for (; i < count; ++i)
+        mix[i] += frame[i];
+}
+
+uint64_t Mixer::Energy(const int16_t* const frame, const std::size_t count) noexcept
+{
+    uint64_t energy { 0 };
+
+    for (std::size_t i { 0 }; i < count; ++i)
+        energy += static_cast<int32_t>(frame[i]) * frame[i];
+
+    return energy;
+}
+
+void Mixer::Saturate(int16_t* const output, const int32_t* const mix, const std::size_t count) noexcept
+{
+    std::size_t i { 0 };
+
+#ifdef SV_MIXER_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto mixLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i));
+        const auto mixHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i + 4));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(mixLo, mixHi));
+    }
+#endif
+
+    for (; i < count; ++i)
+        output[i] = static_cast<int16_t>(std::clamp<int32_t>(mix[i], INT16_MIN, INT16_MAX));
+}
+
+void Mixer::SaturateWithout(int16_t* const output, const int32_t* const mix,
+                            const int16_t* const frame, const std::size_t count) noexcept
+{
+    std::size_t i { 0 };
+
+#ifdef SV_MIXER_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+
+        const auto samplesLo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const auto samplesHi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        const auto mixLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i));
+        const auto mixHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mix + i + 4));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32
+            (_mm_sub_epi32(mixLo, samplesLo), _mm_sub_epi32(mixHi, samplesHi)));
+    }
+#endif
+
+    for (; i < count; ++i)
+        output[i] = static_cast<int16_t>(std::clamp<int32_t>(mix[i] - frame[i], INT16_MIN, INT16_MAX));
+}
+
+VoicePacket* Mixer::EncodePacket(OpusEncoder* const encoder, const int16_t* const pcm,
+                                 std::vector<uint8_t>& buffer) noexcept
+{
+    buffer.resize(sizeof(VoicePacket) + kMaxFrameSize);
+
+    auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+    const auto length = Mixer::Encode(encoder, pcm, packet.data);
+    if (length == 0) return nullptr;
+
+    packet.svrkey = NULL;
+    packet.packet = SV::VoicePacketType::voicePacket;
+    packet.stream = this->stream.GetHandle();
+    packet.sender = SV::kMixPlayer;
+    packet.length = length;
+    packet.packid = this->packid;
+
+    packet.CalcHash();
+
+    Metrics::Add(StatType::mixerFramesEncoded);
+
+    return &packet;
+}
+
+OpusDecoder* Mixer::CreateDecoder() noexcept
+{
+#ifdef SV_MCU
+    static Logger::Limiter errorLimiter { 1, 5 };
+
+    int opusErrorCode { -1 };
+
+    const auto decoder = opus_decoder_create(SV::kFrequency, 1, &opusErrorCode);
+
+    if (decoder == nullptr || opusErrorCode < 0)
+    {
+        Logger::Log(errorLimiter, "[sv:err:mixer:createdecoder] : failed to "
+            "create decoder (code:%d)", opusErrorCode);
+        return nullptr;
+    }
+
+    return decoder;
+#else
+    return nullptr;
+#endif
+}
+
+OpusEncoder* Mixer::CreateEncoder() noexcept
+{
+#ifdef SV_MCU
+    static Logger::Limiter errorLimiter { 1, 5 };
+
+    int opusErrorCode { -1 };
+
+    const auto encoder = opus_encoder_create(SV::kFrequency, 1, OPUS_APPLICATION_VOIP, &opusErrorCode);
+
+    if (encoder == nullptr || opusErrorCode < 0)
+    {
+        Logger::Log(errorLimiter, "[sv:err:mixer:createencoder] : failed to "
+            "create encoder (code:%d)", opusErrorCode);
+        return nullptr;
+    }
+
+    if (const auto error = opus_encoder_ctl(encoder, OPUS_SET_BITRATE(static_cast
+        <opus_int32>(Mixer::bitrate.load(std::memory_order_relaxed)))); error < 0)
+    {
+        Logger::Log(errorLimiter, "[sv:err:mixer:createencoder] : failed to "
+            "set bitrate for encoder (code:%d)", error);
+        opus_encoder_destroy(encoder);
+        return nullptr;
+    }
+
+    if (const auto error = opus_encoder_ctl(encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)); error < 0)
+    {
+        Logger::Log(errorLimiter, "[sv:err:mixer:createencoder] : failed to "
+            "set audiosignal type for encoder (code:%d)", error);
+        opus_encoder_destroy(encoder);
+        return nullptr;
+    }
+
+    // Server encodes a frame per active speaker, so complexity is lower than clients use
+    if (const auto error = opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(kEncoderComplexity)); error < 0)
+    {
+        Logger::Log(errorLimiter, "[sv:err:mixer:createencoder] : failed to "
+            "set complexity for encoder (code:%d)", error);
+        opus_encoder_destroy(encoder);
+        return nullptr;
+    }
+
+    return encoder;
+#else
+    return nullptr;
+#endif
+}
+
+void Mixer::DestroyDecoder(OpusDecoder* const decoder) noexcept
+{
+#ifdef SV_MCU
+    if (decoder != nullptr) opus_decoder_destroy(decoder);
+#endif
+}
+
+void Mixer::DestroyEncoder(OpusEncoder* const encoder) noexcept
+{
+#ifdef SV_MCU
+    if (encoder != nullptr) opus_encoder_destroy(encoder);
+#endif
+}
+
+bool Mixer::Decode(OpusDecoder* const decoder, const Frame* const frame, int16_t* const pcm) noexcept
+{
+#ifdef SV_MCU
+    const int length = opus_decode(decoder, frame != nullptr ? frame->data.data() : nullptr,
+        frame != nullptr ? frame->length : 0, pcm, SV::kFrameSizeInSamples, false);
+
+    return length == static_cast<int>(SV::kFrameSizeInSamples);
+#else
+    return false;
+#endif
+}
+
+uint16_t Mixer::Encode(OpusEncoder* const encoder, const int16_t* const pcm, uint8_t* const data) noexcept
+{
+#ifdef SV_MCU
+    const auto length = opus_encode(encoder, pcm, SV::kFrameSizeInSamples, data, kMaxFrameSize);
+
+    return length > 0 ? static_cast<uint16_t>(length) : 0;
+#else
+    return 0;
+#endif
+}
+
+std::atomic<uint32_t> Mixer::bitrate { SV::kDefaultBitrate };
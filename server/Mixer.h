@@ -0,0 +1,182 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "VoicePacket.h"
+#include "Header.h"
+
+struct OpusDecoder;
+struct OpusEncoder;
+
+class Stream;
+
+// Server side mixing of stream speakers (MCU): speakers' frames are decoded,
+// summed and encoded again once per voice frame, so that listeners receive
+// one packet per frame instead of one per speaker. Mixed packets are sent
+// on behalf of SV::kMixPlayer. Codec is only present in builds with SV_MCU.
+class Mixer {
+
+    Mixer() = delete;
+    Mixer(const Mixer&) = delete;
+    Mixer(Mixer&&) = delete;
+    Mixer& operator=(const Mixer&) = delete;
+    Mixer& operator=(Mixer&&) = delete;
+
+private:
+
+    // Network drops bigger datagrams anyway
+    static constexpr uint32_t kMaxFrameSize = 1400 - sizeof(VoicePacket);
+
+    // Frames that arrived ahead of mixer tick, older ones are dropped
+    static constexpr uint32_t kMaxQueuedFrames = 3;
+    // Missing frames concealed by decoder before speaker goes silent
+    static constexpr uint32_t kMaxLostFrames = 1;
+    // Codec state of silent speaker is released after that many ticks
+    static constexpr uint32_t kSpeakerTimeout = 50;
+    // Loudest speakers mixed in one tick, others are not heard in it
+    static constexpr uint32_t kMaxMixedSpeakers = 8;
+
+    static constexpr int kEncoderComplexity = 5;
+
+public:
+
+    struct Mode
+    {
+        enum : uint8_t
+        {
+            disabled,    // speakers' packets are forwarded as is
+            shared,      // everyone receives the same mix
+            perListener  // active speakers receive the mix without their own voice
+        };
+    };
+
+public:
+
+    explicit Mixer(const Stream& stream) noexcept;
+
+    ~Mixer() noexcept;
+
+public:
+
+    // False if plugin is built without codec
+    static bool IsAvailable() noexcept;
+    static void SetBitrate(uint32_t bitrate) noexcept;
+
+    uint8_t GetMode() const noexcept;
+    void SetMode(uint8_t mode) noexcept;
+
+    // Mix is passed to recorder, in disabled mode packets are still forwarded
+    bool IsRecording() const noexcept;
+    void SetRecording(bool recordStatus) noexcept;
+
+    // Called by workers instead of forwarding, frame is mixed on the next tick
+    void Push(const VoicePacket& voicePacket) noexcept;
+
+    // Called by mixer thread once per voice frame
+    void Tick() noexcept;
+
+public:
+
+    // Mixing kernels, 'count' is any number of samples
+    static void Accumulate(int32_t* mix, const int16_t* frame, std::size_t count) noexcept;
+    static uint64_t Energy(const int16_t* frame, std::size_t count) noexcept;
+    static void Saturate(int16_t* output, const int32_t* mix, std::size_t count) noexcept;
+    static void SaturateWithout(int16_t* output, const int32_t* mix, const int16_t* frame, std::size_t count) noexcept;
+
+private:
+
+    struct Frame {
+
+        uint16_t sender { NULL };
+        uint16_t length { NULL };
+        std::array<uint8_t, kMaxFrameSize> data;
+
+    };
+
+    struct Speaker {
+
+        Speaker() noexcept = default;
+        Speaker(const Speaker&) = delete;
+        Speaker(Speaker&&) = delete;
+        Speaker& operator=(const Speaker&) = delete;
+        Speaker& operator=(Speaker&&) = delete;
+
+        ~Speaker() noexcept;
+
+    public:
+
+        OpusDecoder* decoder { nullptr };
+        OpusEncoder* encoder { nullptr };
+
+        std::deque<Frame> frames;
+        std::array<int16_t, SV::kFrameSizeInSamples> pcm {};
+
+        uint32_t lostFrames { kMaxLostFrames };
+        uint32_t idleTicks { 0 };
+        uint64_t energy { 0 };
+
+        // Speaker is heard in the current tick's mix
+        bool activeStatus { false };
+
+    };
+
+private:
+
+    static OpusDecoder* CreateDecoder() noexcept;
+    static OpusEncoder* CreateEncoder() noexcept;
+    static void DestroyDecoder(OpusDecoder* decoder) noexcept;
+    static void DestroyEncoder(OpusEncoder* encoder) noexcept;
+
+    // Null frame requests loss concealment
+    static bool Decode(OpusDecoder* decoder, const Frame* frame, int16_t* pcm) noexcept;
+    static uint16_t Encode(OpusEncoder* encoder, const int16_t* pcm, uint8_t* data) noexcept;
+
+    // Prepares mixed packet in buffer, returns nullptr if encoding failed
+    VoicePacket* EncodePacket(OpusEncoder* encoder, const int16_t* pcm, std::vector<uint8_t>& buffer) noexcept;
+
+private:
+
+    const Stream& stream;
+
+    std::atomic<uint8_t> mode { Mode::disabled };
+    std::atomic_bool recordStatus { false };
+
+    std::mutex inputMutex;
+    std::vector<Frame> input;
+    std::vector<Frame> pending;
+
+    std::unordered_map<uint16_t, std::unique_ptr<Speaker>> speakers;
+    std::vector<Speaker*> activeSpeakers;
+
+    OpusEncoder* sharedEncoder { nullptr };
+
+    std::array<int32_t, SV::kFrameSizeInSamples> mix {};
+    std::array<int16_t, SV::kFrameSizeInSamples> output {};
+
+    std::vector<uint8_t> sharedBuffer;
+    std::vector<uint8_t> listenerBuffer;
+
+    uint32_t packid { 0 };
+
+private:
+
+    static std::atomic<uint32_t> bitrate;
+
+};
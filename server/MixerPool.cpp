@@ -0,0 +1,111 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "MixerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+#include <util/logger.h>
+
+#include "PacedTicker.h"
+#include "Tracer.h"
+#include "Header.h"
+
+bool MixerPool::Init(uint32_t threadsCount)
+{
+    if (MixerPool::initStatus) return false;
+
+    if (threadsCount == 0) threadsCount = 1;
+
+    Logger::Log("[sv:dbg:mixerpool:init] : creating pool (threads:%u)...", threadsCount);
+
+    MixerPool::status.store(true);
+
+    for (uint32_t i { 0 }; i < threadsCount; ++i)
+        MixerPool::threads.emplace_back(MixerPool::ThreadFunc, i, threadsCount);
+
+    MixerPool::initStatus = true;
+
+    return true;
+}
+
+void MixerPool::Free() noexcept
+{
+    if (!MixerPool::initStatus) return;
+
+    MixerPool::status.store(false);
+
+    for (auto& thread : MixerPool::threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+
+    MixerPool::threads.clear();
+
+    MixerPool::initStatus = false;
+}
+
+void MixerPool::Register(Mixer* const mixer)
+{
+    const std::unique_lock<std::shared_mutex> lock { MixerPool::mixersMutex };
+
+    MixerPool::mixers.emplace_back(mixer);
+}
+
+void MixerPool::Unregister(Mixer* const mixer) noexcept
+{
+    const std::unique_lock<std::shared_mutex> lock { MixerPool::mixersMutex };
+
+    const auto iter = std::find(MixerPool::mixers.begin(), MixerPool::mixers.end(), mixer);
+    if (iter != MixerPool::mixers.end()) MixerPool::mixers.erase(iter);
+}
+
+uint32_t MixerPool::GetThreadsCount() noexcept
+{
+    return static_cast<uint32_t>(MixerPool::threads.size());
+}
+
+uint32_t MixerPool::GetMixersCount() noexcept
+{
+    const std::shared_lock<std::shared_mutex> lock { MixerPool::mixersMutex };
+
+    return static_cast<uint32_t>(MixerPool::mixers.size());
+}
+
+void MixerPool::ThreadFunc(const uint32_t index, const uint32_t threadsCount) noexcept
+{
+    {
+        char threadName[16];
+        std::snprintf(threadName, sizeof(threadName), "sv-mixer-%u", index);
+        Tracer::SetThreadName(threadName);
+    }
+
+    PacedTicker ticker { std::chrono::milliseconds(SV::kVoiceRate) };
+
+    while (MixerPool::status.load(std::memory_order_relaxed))
+    {
+        ticker.Wait();
+
+        const std::shared_lock<std::shared_mutex> lock { MixerPool::mixersMutex };
+
+        for (std::size_t i { index }; i < MixerPool::mixers.size(); i += threadsCount)
+            MixerPool::mixers[i]->Tick();
+    }
+}
+
+bool MixerPool::initStatus { false };
+
+std::atomic_bool MixerPool::status { false };
+std::vector<std::thread> MixerPool::threads;
+
+std::shared_mutex MixerPool::mixersMutex;
+std::vector<Mixer*> MixerPool::mixers;
@@ -0,0 +1,57 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "Mixer.h"
+
+// Threads ticking stream mixers once per voice frame, kept apart from
+// workers so that codec work does not delay forwarding of other streams
+class MixerPool {
+
+    MixerPool() = delete;
+    ~MixerPool() = delete;
+    MixerPool(const MixerPool&) = delete;
+    MixerPool(MixerPool&&) = delete;
+    MixerPool& operator=(const MixerPool&) = delete;
+    MixerPool& operator=(MixerPool&&) = delete;
+
+public:
+
+    static bool Init(uint32_t threadsCount);
+    static void Free() noexcept;
+
+    // Unregister waits until current tick of the mixer is finished
+    static void Register(Mixer* mixer);
+    static void Unregister(Mixer* mixer) noexcept;
+
+    static uint32_t GetThreadsCount() noexcept;
+    static uint32_t GetMixersCount() noexcept;
+
+private:
+
+    static void ThreadFunc(uint32_t index, uint32_t threadsCount) noexcept;
+
+private:
+
+    static bool initStatus;
+
+    static std::atomic_bool status;
+    static std::vector<std::thread> threads;
+
+    static std::shared_mutex mixersMutex;
+    static std::vector<Mixer*> mixers;
+
+};
@@ -9,6 +9,7 @@
 
 #include "Network.h"
 
+#include <cstring>
 #include <random>
 
 #ifndef _WIN32
@@ -24,6 +25,14 @@
 
 #include <util/logger.h>
 #include <util/memory.hpp>
+#include <util/siphash.h>
+
+#include "RateLimiter.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "Capture.h"
+#include "RelayLink.h"
+#include "StateMirror.h"
 
 #ifdef _WIN32
 #define GetNetError() WSAGetLastError()
@@ -75,23 +84,33 @@ void Network::Free() noexcept
 
     if (Network::bindStatus)
     {
-        closesocket(Network::socketHandle);
+        Network::keepAliveStatus.store(false, std::memory_order_release);
+        if (Network::keepAliveThread.joinable())
+            Network::keepAliveThread.join();
 
-        Network::socketHandle = NULL;
-        Network::serverPort = NULL;
+        if (!RelayLink::IsEnabled())
+        {
+            closesocket(Network::socketHandle);
 
 #ifdef _WIN32
-        WSACleanup();
+            WSACleanup();
 #endif
+        }
+
+        Network::socketHandle = NULL;
+        Network::serverPort = NULL;
 
         {
             const std::unique_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
             Network::playerKeyToPlayerIdTable.clear();
+            Network::playerAuthTable.fill({});
         }
 
         for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
         {
             Network::playerStatusTable[iPlayerId].store(false, std::memory_order_release);
+            Network::playerCompactTable[iPlayerId].store(false, std::memory_order_relaxed);
+            Network::playerBitrateTable[iPlayerId].store(false, std::memory_order_relaxed);
             std::atomic_store(&Network::playerAddrTable[iPlayerId], { nullptr });
         }
 
@@ -118,6 +137,18 @@ bool Network::Bind() noexcept
     if (Network::bindStatus) return true;
     if (!RakNet::IsLoaded()) return false;
 
+    // Socket belongs to relay, clients are sent to its port
+    if (RelayLink::IsEnabled())
+    {
+        Network::serverPort = RelayLink::GetPort();
+
+        Logger::Log("[sv:dbg:network:bind] : voice is served by relay on port %hu", Network::serverPort);
+
+        Network::bindStatus = true;
+
+        return true;
+    }
+
 #ifdef _WIN32
     if (const int error = WSAStartup(MAKEWORD(2, 2), &WSADATA()))
     {
@@ -189,54 +220,49 @@ bool Network::Bind() noexcept
 
     Network::bindStatus = true;
 
+    Network::keepAliveStatus.store(true, std::memory_order_release);
+    Network::keepAliveThread = std::thread(Network::KeepAliveThread);
+
     return true;
 }
 
 void Network::Process() noexcept
 {
-    static Timer::time_t lastTime { 0 };
-
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     if (!Network::initStatus) return;
 
-    RakNet::Process();
+    const Tracer::Span span { "Network::Process" };
 
-    if (!Network::bindStatus) return;
+    std::size_t flushedMessages { 0 };
 
-    const auto curTime = Timer::Get();
+    {
+        const Tracer::Span span { "RakNet::Process" };
+        flushedMessages = RakNet::Process();
+    }
 
-    if (curTime - lastTime >= kKeepAliveInterval)
+    Metrics::Add(StatType::raknetMessagesFlushed, flushedMessages);
+    Metrics::Set(StatType::raknetQueueDepth, flushedMessages);
+
+    if (RelayLink::IsEnabled())
     {
-        VoicePacket keepAlivePacket;
+        RelayLink::Process();
 
-        keepAlivePacket.packet = SV::VoicePacketType::keepAlive;
-        keepAlivePacket.length = NULL;
-        keepAlivePacket.packid = NULL;
-        keepAlivePacket.sender = NULL;
-        keepAlivePacket.stream = NULL;
-        keepAlivePacket.svrkey = NULL;
-        keepAlivePacket.CalcHash();
+        uint16_t playerId; uint32_t address; uint16_t port;
 
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        while (RelayLink::PopIdentifiedPlayer(playerId, address, port))
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            // Event may come from the previous session of this player id
+            if (!Network::playerStatusTable[playerId].load(std::memory_order_acquire) ||
+                static_cast<uint32_t>(Network::playerKeyTable[playerId] >> 32) != address)
+                continue;
 
-            for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
-            {
-                if (!Network::playerStatusTable[iPlayerId].load(std::memory_order_acquire))
-                    continue;
+            sockaddr_in playerAddr {};
 
-                const auto playerAddr = std::atomic_load(&Network::playerAddrTable[iPlayerId]);
-                if (playerAddr == nullptr) continue;
+            playerAddr.sin_family = AF_INET;
+            playerAddr.sin_addr.s_addr = address;
+            playerAddr.sin_port = port;
 
-                sendto(Network::socketHandle, reinterpret_cast<char*>(&keepAlivePacket), sizeof(keepAlivePacket),
-                    NULL, reinterpret_cast<sockaddr*>(playerAddr.get()), sizeof(*playerAddr));
-            }
+            Network::IdentifyPlayer(playerId, playerAddr);
         }
-
-        lastTime = curTime;
     }
 }
 
@@ -244,7 +270,15 @@ bool Network::SendControlPacket(const uint16_t playerId, const ControlPacket& co
 {
     if (!Network::initStatus) return false;
 
-    return RakNet::SendPacket(kRaknetPacketId, playerId, &controlPacket, controlPacket.GetFullSize());
+    if (!RakNet::SendPacket(kRaknetPacketId, playerId, &controlPacket, controlPacket.GetFullSize()))
+    {
+        Metrics::Add(StatType::controlPacketsSendErrors);
+        return false;
+    }
+
+    Metrics::Add(StatType::controlPacketsSent);
+
+    return true;
 }
 
 bool Network::SendVoicePacket(const uint16_t playerId, const VoicePacket& voicePacket)
@@ -254,11 +288,51 @@ bool Network::SendVoicePacket(const uint16_t playerId, const VoicePacket& voiceP
     if (!Network::playerStatusTable[playerId].load(std::memory_order_acquire))
         return false;
 
+    if (RelayLink::IsEnabled())
+        return RelayLink::SendVoicePacket(playerId, voicePacket);
+
     const auto playerAddr = std::atomic_load(&Network::playerAddrTable[playerId]);
     if (playerAddr == nullptr) return false;
 
-    return sendto(Network::socketHandle, (char*)(&voicePacket), voicePacket.GetFullSize(),
-        NULL, (sockaddr*)(playerAddr.get()), sizeof(*playerAddr)) == voicePacket.GetFullSize();
+    // Outgoing voice keeps player's NAT mapping alive as well as keep-alive does
+    Network::playerActivityTable[playerId].store(Timer::Get(), std::memory_order_relaxed);
+
+    if (!Network::playerCompactTable[playerId].load(std::memory_order_relaxed))
+    {
+        return sendto(Network::socketHandle, (char*)(&voicePacket), voicePacket.GetFullSize(),
+            NULL, (sockaddr*)(playerAddr.get()), sizeof(*playerAddr)) == voicePacket.GetFullSize();
+    }
+
+    // Header is rebuilt for every listener, data is sent from the packet as is
+    uint8_t compactHeader[VoicePacket::kMaxCompactHeaderSize];
+    const uint32_t compactHeaderSize = voicePacket.WriteCompactHeader(compactHeader);
+    const uint32_t compactPacketSize = compactHeaderSize + voicePacket.length;
+
+#ifdef _WIN32
+    WSABUF buffers[2] {
+        { compactHeaderSize, (CHAR*)(compactHeader) },
+        { voicePacket.length, (CHAR*)(voicePacket.data) }
+    };
+
+    DWORD sended { NULL };
+
+    return WSASendTo(Network::socketHandle, buffers, 2, &sended, NULL, (sockaddr*)(playerAddr.get()),
+        sizeof(*playerAddr), nullptr, nullptr) == NULL && sended == compactPacketSize;
+#else
+    iovec buffers[2] {
+        { compactHeader, compactHeaderSize },
+        { (void*)(voicePacket.data), voicePacket.length }
+    };
+
+    msghdr message {};
+
+    message.msg_name = playerAddr.get();
+    message.msg_namelen = sizeof(*playerAddr);
+    message.msg_iov = buffers;
+    message.msg_iovlen = 2;
+
+    return sendmsg(Network::socketHandle, &message, NULL) == compactPacketSize;
+#endif
 }
 
 ControlPacketContainerPtr Network::ReceiveControlPacket(uint16_t& sender) noexcept
@@ -274,11 +348,15 @@ ControlPacketContainerPtr Network::ReceiveControlPacket(uint16_t& sender) noexce
     return std::move(packetInfo.packet);
 }
 
-VoicePacketContainerPtr Network::ReceiveVoicePacket()
+VoicePacketContainerPtr Network::ReceiveVoicePacket(Latency::tsc_t& receiveTime)
 {
     if (!Network::bindStatus)
         return nullptr;
 
+    // Relay has already checked and accepted these
+    if (RelayLink::IsEnabled())
+        return RelayLink::ReceiveVoicePacket(receiveTime);
+
     sockaddr_in playerAddr {};
     int addrLen { sizeof(playerAddr) };
     char packetBuffer[kMaxVoicePacketSize];
@@ -286,70 +364,220 @@ VoicePacketContainerPtr Network::ReceiveVoicePacket()
     const auto length = recvfrom(Network::socketHandle, packetBuffer,
         sizeof(packetBuffer), NULL, reinterpret_cast<sockaddr*>(&playerAddr), &addrLen);
 
-    if (length < static_cast<decltype(length)>(sizeof(VoicePacket)))
-        return nullptr;
+    if (length < 0) return nullptr;
 
-    const auto voicePacketPtr = reinterpret_cast<VoicePacket*>(packetBuffer);
-    if (!voicePacketPtr->CheckHeader()) return nullptr;
-
-    const auto voicePacketSize = voicePacketPtr->GetFullSize();
-    if (length != voicePacketSize) return nullptr;
+    receiveTime = Latency::Now();
 
-    const auto playerKey = MakeQword(playerAddr.sin_addr.s_addr, voicePacketPtr->svrkey);
+    Metrics::Add(StatType::voicePacketsReceived);
+    Metrics::Add(StatType::voiceBytesReceived, length);
 
     uint16_t playerId { SV::kNonePlayer };
+    VoiceAuthKey authKey;
+
+    // Compact packets start with player key while legacy ones start with
+    // header hash, so key of compact player is looked up first
+    bool compactStatus { false };
 
+    if (length >= static_cast<decltype(length)>(VoicePacket::kCompactUpstreamHeaderSize))
     {
+        uint32_t svrkey; std::memcpy(&svrkey, packetBuffer, sizeof(svrkey));
+
         const std::shared_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
 
-        const auto iter = Network::playerKeyToPlayerIdTable.find(playerKey);
-        if (iter == Network::playerKeyToPlayerIdTable.end()) return nullptr;
+        const auto iter = Network::playerKeyToPlayerIdTable.find(MakeQword(playerAddr.sin_addr.s_addr, svrkey));
 
-        playerId = iter->second;
+        if (iter != Network::playerKeyToPlayerIdTable.end() &&
+            Network::playerCompactTable[iter->second].load(std::memory_order_relaxed))
+        {
+            playerId = iter->second;
+            authKey = Network::playerAuthTable[playerId];
+            compactStatus = true;
+        }
     }
 
-    if (!Network::playerStatusTable[playerId].load(std::memory_order_acquire))
-        return nullptr;
+    const auto voicePacketPtr = reinterpret_cast<VoicePacket*>(packetBuffer);
 
-    if (!std::atomic_load(&Network::playerAddrTable[playerId]))
+    // Size of packet without tag
+    uint32_t voicePacketSize { NULL };
+    bool authStatus { false };
+
+    if (compactStatus)
     {
-        const auto playerAddrPtr = std::make_shared<sockaddr_in>(playerAddr);
-        if (playerAddrPtr == nullptr) return nullptr;
+        voicePacketSize = authKey.status ? length - SV::kVoiceAuthTagSize : length;
+
+        if (authKey.status)
+        {
+            if (length < static_cast<decltype(length)>(VoicePacket::kCompactUpstreamHeaderSize + SV::kVoiceAuthTagSize))
+            {
+                Metrics::Add(StatType::voicePacketsDroppedSize);
+                return nullptr;
+            }
+
+            uint64_t tag; std::memcpy(&tag, packetBuffer + voicePacketSize, sizeof(tag));
+
+            authStatus = tag == SipHash::Calc(authKey.k0, authKey.k1, packetBuffer, voicePacketSize);
+        }
+        else
+        {
+            authStatus = Network::voiceAuthMode.load(std::memory_order_relaxed) != VoiceAuthMode::required;
+        }
+    }
+    else
+    {
+        if (length < static_cast<decltype(length)>(sizeof(VoicePacket)))
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return nullptr;
+        }
+
+        if (!voicePacketPtr->CheckHeader())
+        {
+            Metrics::Add(StatType::voicePacketsDroppedHash);
+            return nullptr;
+        }
+
+        voicePacketSize = voicePacketPtr->GetFullSize();
+
+        if (length != voicePacketSize && length != voicePacketSize + SV::kVoiceAuthTagSize)
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return nullptr;
+        }
+
+        const auto playerKey = MakeQword(playerAddr.sin_addr.s_addr, voicePacketPtr->svrkey);
 
-        std::shared_ptr<sockaddr_in> expAddrPtr { nullptr };
-        if (std::atomic_compare_exchange_strong(&Network::playerAddrTable[playerId], &expAddrPtr, playerAddrPtr))
         {
-            Logger::Log("[sv:dbg:network:receive] : player (%hu) identified (port:%hu)", playerId, ntohs(playerAddr.sin_port));
+            const std::shared_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
 
-            ControlPacket* controlPacket { nullptr };
-            PackAlloca(controlPacket, SV::ControlPacketType::pluginInit, sizeof(SV::PluginInitPacket));
-            PackGetStruct(controlPacket, SV::PluginInitPacket)->bitrate = SV::kDefaultBitrate;
-            PackGetStruct(controlPacket, SV::PluginInitPacket)->mute = false;
+            const auto iter = Network::playerKeyToPlayerIdTable.find(playerKey);
 
-            for (const auto& playerInitCallback : Network::playerInitCallbacks)
+            if (iter == Network::playerKeyToPlayerIdTable.end())
             {
-                if (playerInitCallback != nullptr) playerInitCallback(playerId, *PackGetStruct(controlPacket, SV::PluginInitPacket));
+                Metrics::Add(StatType::voicePacketsDroppedKey);
+                return nullptr;
             }
 
-            if (!Network::SendControlPacket(playerId, *controlPacket))
-                Logger::Log("[sv:err:network:receive] : failed to send player (%hu) plugin init packet", playerId);
+            playerId = iter->second;
+            authKey = Network::playerAuthTable[playerId];
         }
+
+        // Verified before rate limiting so that forged packets
+        // can't spend the budget of the player they impersonate
+        authStatus = authKey.status
+            ? length == voicePacketSize + SV::kVoiceAuthTagSize && voicePacketPtr->CheckAuthTag(authKey.k0, authKey.k1)
+            : length == voicePacketSize && Network::voiceAuthMode.load(std::memory_order_relaxed) != VoiceAuthMode::required;
     }
 
-    if (voicePacketPtr->packet == SV::VoicePacketType::keepAlive)
+    if (!authStatus)
+    {
+        Metrics::Add(StatType::voicePacketsDroppedAuth);
         return nullptr;
+    }
 
-    auto voicePacket = MakeVoicePacketContainer(voicePacketPtr, voicePacketSize);
-    if (voicePacket == nullptr) return nullptr;
+    if (!RateLimiter::CheckPacket(playerId, voicePacketSize))
+    {
+        Metrics::Add(StatType::voicePacketsDroppedThrottle);
+        return nullptr;
+    }
+
+    if (!Network::playerStatusTable[playerId].load(std::memory_order_acquire))
+    {
+        Metrics::Add(StatType::voicePacketsDroppedKey);
+        return nullptr;
+    }
+
+    if (!std::atomic_load(&Network::playerAddrTable[playerId]))
+        Network::IdentifyPlayer(playerId, playerAddr);
+
+    VoicePacketContainerPtr voicePacket { nullptr };
+
+    if (compactStatus)
+    {
+        // Rest of server works with full header, so packet is restored here
+        const auto packetType = packetBuffer[sizeof(uint32_t)] & SV::CompactFlagType::typeMask;
+
+        if (packetType == SV::VoicePacketType::keepAlive)
+        {
+            Metrics::Add(StatType::keepAlivePacketsReceived);
+            return nullptr;
+        }
+
+        voicePacket = MakeVoicePacketContainer(voicePacketSize - VoicePacket::kCompactUpstreamHeaderSize);
+        if (voicePacket == nullptr) return nullptr;
+
+        auto& lastPackid = Network::playerPackidTable[playerId];
+        auto& voicePacketRef = *voicePacket;
+
+        const auto lastPackidValue = lastPackid.load(std::memory_order_relaxed);
+
+        voicePacketRef->ReadCompactUpstream(reinterpret_cast<uint8_t*>(packetBuffer),
+            voicePacketSize, lastPackidValue);
+
+        // Late packets don't move sequence back
+        if (voicePacketRef->packid == NULL || static_cast<int32_t>(voicePacketRef->packid - lastPackidValue) > 0)
+            lastPackid.store(voicePacketRef->packid, std::memory_order_relaxed);
+    }
+    else
+    {
+        if (voicePacketPtr->packet == SV::VoicePacketType::keepAlive)
+        {
+            Metrics::Add(StatType::keepAlivePacketsReceived);
+            return nullptr;
+        }
+
+        voicePacket = MakeVoicePacketContainer(voicePacketPtr, voicePacketSize);
+        if (voicePacket == nullptr) return nullptr;
+    }
+
+    Metrics::Add(StatType::voicePacketsAccepted);
 
     auto& voicePacketRef = *voicePacket;
 
+    Capture::RecordVoicePacket(playerId, &voicePacketRef, voicePacketRef->GetFullSize(), receiveTime);
+
     voicePacketRef->sender = playerId;
     voicePacketRef->svrkey = NULL;
 
     return voicePacket;
 }
 
+void Network::SetVoiceAuthMode(const uint8_t mode) noexcept
+{
+    if (mode > VoiceAuthMode::required) return;
+
+    Network::voiceAuthMode.store(mode, std::memory_order_relaxed);
+
+    RelayLink::PublishVoiceAuthMode(mode);
+}
+
+void Network::SetSimulcast(const bool status) noexcept
+{
+    Network::simulcastStatus.store(status, std::memory_order_relaxed);
+}
+
+bool Network::HasVoiceAuth(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return false;
+
+    const std::shared_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
+
+    return Network::playerAuthTable[playerId].status;
+}
+
+bool Network::HasCompactHeader(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return false;
+
+    return Network::playerCompactTable[playerId].load(std::memory_order_relaxed);
+}
+
+bool Network::HasBitrateControl(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return false;
+
+    return Network::playerBitrateTable[playerId].load(std::memory_order_relaxed);
+}
+
 std::size_t Network::AddConnectCallback(ConnectCallback callback) noexcept
 {
     if (!Network::initStatus) return -1;
@@ -445,6 +673,11 @@ bool Network::ConnectHandler(const uint16_t playerId, RPCParameters& rpc)
     if (connectStruct == nullptr || connectStructEndPointer > connectPacketEndPointer)
         return true;
 
+    uint8_t connectFeatures { NULL };
+
+    if (connectStructEndPointer + sizeof(SV::ConnectFeaturesPacket) <= connectPacketEndPointer)
+        connectFeatures = ((SV::ConnectFeaturesPacket*)(connectStructEndPointer))->features;
+
     const uint32_t playerAddr = RakNet::GetPlayerIdFromIndex(playerId).binaryAddress;
     if (playerAddr == NULL || playerAddr == UNASSIGNED_PLAYER_ID.binaryAddress) return true;
 
@@ -459,6 +692,8 @@ bool Network::ConnectHandler(const uint16_t playerId, RPCParameters& rpc)
     Logger::Log("[sv:dbg:network:connect] : connecting player (%hu) with address (%s) ...",
         playerId, inet_ntoa(*(in_addr*)(&playerAddr)));
 
+    Capture::RecordConnect(playerId, playerAddr, *connectStruct, connectFeatures);
+
     std::mt19937 genRandomNumber(clock());
     uint32_t randomNumber; uint64_t playerKey;
 
@@ -468,17 +703,66 @@ bool Network::ConnectHandler(const uint16_t playerId, RPCParameters& rpc)
 
     Logger::Log("[sv:dbg:network:connect] : player (%hu) assigned key (%llx)", playerId, playerKey);
 
+    VoiceAuthKey authKey;
+    uint8_t authKeyBytes[SV::kVoiceAuthKeySize] {};
+
+    if (Network::voiceAuthMode.load(std::memory_order_relaxed) != VoiceAuthMode::disabled &&
+        (connectFeatures & SV::ConnectFeatureType::voiceAuth))
+    {
+        std::random_device genSecretNumber;
+
+        for (std::size_t i { 0 }; i < sizeof(authKeyBytes); i += sizeof(uint32_t))
+        {
+            const uint32_t secretNumber = genSecretNumber();
+            std::memcpy(authKeyBytes + i, &secretNumber, sizeof(secretNumber));
+        }
+
+        std::memcpy(&authKey.k0, authKeyBytes, sizeof(authKey.k0));
+        std::memcpy(&authKey.k1, authKeyBytes + sizeof(authKey.k0), sizeof(authKey.k1));
+        authKey.status = true;
+
+        Logger::Log("[sv:dbg:network:connect] : player (%hu) negotiated voice authentication", playerId);
+    }
+    else if (Network::voiceAuthMode.load(std::memory_order_relaxed) == VoiceAuthMode::required)
+    {
+        Logger::Log("[sv:dbg:network:connect] : player (%hu) doesn't support voice authentication, "
+            "voice packets will be dropped", playerId);
+    }
+
+    const bool compactStatus = connectFeatures & SV::ConnectFeatureType::compactHeader;
+
+    if (compactStatus)
+        Logger::Log("[sv:dbg:network:connect] : player (%hu) negotiated compact header", playerId);
+
+    const bool bitrateStatus = connectFeatures & SV::ConnectFeatureType::bitrateControl;
+
+    if (bitrateStatus)
+        Logger::Log("[sv:dbg:network:connect] : player (%hu) negotiated bitrate control", playerId);
+
+    const bool simulcastStatus = (connectFeatures & SV::ConnectFeatureType::simulcast) &&
+        Network::simulcastStatus.load(std::memory_order_relaxed);
+
+    if (simulcastStatus)
+        Logger::Log("[sv:dbg:network:connect] : player (%hu) negotiated simulcast", playerId);
+
     std::atomic_store(&Network::playerAddrTable[playerId], { nullptr });
+    Network::playerActivityTable[playerId].store(NULL, std::memory_order_relaxed);
+    Network::playerPackidTable[playerId].store(NULL, std::memory_order_relaxed);
+    Network::playerBitrateTable[playerId].store(bitrateStatus, std::memory_order_relaxed);
 
     {
         const std::unique_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
 
         Network::playerKeyToPlayerIdTable.erase(Network::playerKeyTable[playerId]);
         Network::playerKeyToPlayerIdTable[playerKey] = playerId;
+        Network::playerAuthTable[playerId] = authKey;
+        Network::playerCompactTable[playerId].store(compactStatus, std::memory_order_relaxed);
     }
 
     Network::playerKeyTable[playerId] = playerKey;
 
+    RelayLink::PublishPlayer(playerId);
+
     for (const auto& connectCallback : Network::connectCallbacks)
     {
         if (connectCallback != nullptr) connectCallback(playerId, *connectStruct);
@@ -487,9 +771,39 @@ bool Network::ConnectHandler(const uint16_t playerId, RPCParameters& rpc)
     Network::playerStatusTable[playerId].store(true, std::memory_order_release);
 
     ControlPacket* controlPacket { nullptr };
-    PackAlloca(controlPacket, SV::ControlPacketType::serverInfo, sizeof(SV::ServerInfoPacket));
-    PackGetStruct(controlPacket, SV::ServerInfoPacket)->serverPort = Network::serverPort;
-    PackGetStruct(controlPacket, SV::ServerInfoPacket)->serverKey = randomNumber;
+
+    // Features byte is only understood by clients that requested any of v3.3 features
+    const uint32_t featuresSize = connectFeatures & (SV::ConnectFeatureType::compactHeader |
+        SV::ConnectFeatureType::bitrateControl | SV::ConnectFeatureType::simulcast)
+        ? sizeof(SV::ServerFeaturesPacket) : 0;
+
+    if (authKey.status)
+    {
+        PackAlloca(controlPacket, SV::ControlPacketType::serverInfo, sizeof(SV::ServerInfoAuthPacket) + featuresSize);
+        PackGetStruct(controlPacket, SV::ServerInfoAuthPacket)->serverPort = Network::serverPort;
+        PackGetStruct(controlPacket, SV::ServerInfoAuthPacket)->serverKey = randomNumber;
+        std::memcpy(PackGetStruct(controlPacket, SV::ServerInfoAuthPacket)->authKey, authKeyBytes, sizeof(authKeyBytes));
+    }
+    else
+    {
+        PackAlloca(controlPacket, SV::ControlPacketType::serverInfo, sizeof(SV::ServerInfoPacket) + featuresSize);
+        PackGetStruct(controlPacket, SV::ServerInfoPacket)->serverPort = Network::serverPort;
+        PackGetStruct(controlPacket, SV::ServerInfoPacket)->serverKey = randomNumber;
+    }
+
+    if (featuresSize != 0)
+    {
+        const auto featuresPacket = reinterpret_cast<SV::ServerFeaturesPacket*>
+            (controlPacket->data + controlPacket->length - featuresSize);
+
+        featuresPacket->features = NULL;
+
+        if (authKey.status) featuresPacket->features |= SV::ConnectFeatureType::voiceAuth;
+        if (compactStatus) featuresPacket->features |= SV::ConnectFeatureType::compactHeader;
+        if (bitrateStatus) featuresPacket->features |= SV::ConnectFeatureType::bitrateControl;
+        if (simulcastStatus) featuresPacket->features |= SV::ConnectFeatureType::simulcast;
+    }
+
     if (!Network::SendControlPacket(playerId, *controlPacket))
         Logger::Log("[sv:err:network:connect] : failed to send server info packet to player (%hu)", playerId);
 
@@ -508,7 +822,12 @@ bool Network::PacketHandler(const uint16_t playerId, Packet& packet)
 
     if (controlPacketSize != controlPacketPtr->GetFullSize()) return false;
 
-    Network::controlQueue.try_emplace(MakeControlPacketContainer(controlPacketPtr, controlPacketSize), playerId);
+    Metrics::Add(StatType::controlPacketsReceived);
+
+    Capture::RecordControlPacket(playerId, controlPacketPtr, controlPacketSize);
+
+    if (!Network::controlQueue.try_emplace(MakeControlPacketContainer(controlPacketPtr, controlPacketSize), playerId))
+        Metrics::Add(StatType::controlPacketsDropped);
 
     return false;
 }
@@ -522,21 +841,171 @@ void Network::DisconnectHandler(const uint16_t playerId)
 
     Logger::Log("[sv:dbg:network:connect] : disconnecting player (%hu) ...", playerId);
 
+    Capture::RecordDisconnect(playerId);
+
     std::atomic_store(&Network::playerAddrTable[playerId], { nullptr });
 
     {
         const std::unique_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
         Network::playerKeyToPlayerIdTable.erase(Network::playerKeyTable[playerId]);
+        Network::playerAuthTable[playerId] = {};
+        Network::playerCompactTable[playerId].store(false, std::memory_order_relaxed);
     }
 
+    Network::playerBitrateTable[playerId].store(false, std::memory_order_relaxed);
     Network::playerKeyTable[playerId] = NULL;
 
+    RelayLink::PublishPlayerDisconnect(playerId);
+
     for (const auto& disconnectCallback : Network::disconnectCallbacks)
     {
         if (disconnectCallback != nullptr) disconnectCallback(playerId);
     }
 }
 
+void Network::IdentifyPlayer(const uint16_t playerId, const sockaddr_in& playerAddr)
+{
+    const auto playerAddrPtr = std::make_shared<sockaddr_in>(playerAddr);
+    if (playerAddrPtr == nullptr) return;
+
+    std::shared_ptr<sockaddr_in> expAddrPtr { nullptr };
+    if (std::atomic_compare_exchange_strong(&Network::playerAddrTable[playerId], &expAddrPtr, playerAddrPtr))
+    {
+        static Logger::Limiter identifyLimiter { 1, 20 };
+
+        Logger::Log(identifyLimiter, "[sv:dbg:network:receive] : player (%hu) identified (port:%hu)", playerId, ntohs(playerAddr.sin_port));
+
+        StateMirror::MarkPlayer(playerId);
+
+        ControlPacket* controlPacket { nullptr };
+        PackAlloca(controlPacket, SV::ControlPacketType::pluginInit, sizeof(SV::PluginInitPacket));
+        PackGetStruct(controlPacket, SV::PluginInitPacket)->bitrate = SV::kDefaultBitrate;
+        PackGetStruct(controlPacket, SV::PluginInitPacket)->mute = false;
+
+        for (const auto& playerInitCallback : Network::playerInitCallbacks)
+        {
+            if (playerInitCallback != nullptr) playerInitCallback(playerId, *PackGetStruct(controlPacket, SV::PluginInitPacket));
+        }
+
+        if (!Network::SendControlPacket(playerId, *controlPacket))
+            Logger::Log("[sv:err:network:receive] : failed to send player (%hu) plugin init packet", playerId);
+    }
+}
+
+void Network::KeepAliveThread() noexcept
+{
+    // Players are spread over the wheel by their ids, so every tick
+    // handles only 1/kKeepAliveWheelSize of pool with a single batch
+    const auto tickInterval = std::chrono::milliseconds(kKeepAliveInterval / kKeepAliveWheelSize);
+
+    Tracer::SetThreadName("sv-keepalive");
+
+    VoicePacket keepAlivePacket;
+
+    keepAlivePacket.packet = SV::VoicePacketType::keepAlive;
+    keepAlivePacket.length = NULL;
+    keepAlivePacket.packid = NULL;
+    keepAlivePacket.sender = NULL;
+    keepAlivePacket.stream = NULL;
+    keepAlivePacket.svrkey = NULL;
+    keepAlivePacket.CalcHash();
+
+    // Compact keep-alive is a single flags byte
+    uint8_t compactKeepAlivePacket { SV::VoicePacketType::keepAlive };
+
+    std::array<sockaddr_in, kKeepAliveBatchSize> batchAddrs {};
+    std::array<bool, kKeepAliveBatchSize> batchCompacts {};
+
+#ifndef _WIN32
+    std::array<mmsghdr, kKeepAliveBatchSize> batchMessages {};
+
+    iovec keepAliveBuffer {};
+
+    keepAliveBuffer.iov_base = &keepAlivePacket;
+    keepAliveBuffer.iov_len = sizeof(keepAlivePacket);
+
+    iovec compactKeepAliveBuffer {};
+
+    compactKeepAliveBuffer.iov_base = &compactKeepAlivePacket;
+    compactKeepAliveBuffer.iov_len = sizeof(compactKeepAlivePacket);
+
+    for (std::size_t i { 0 }; i < kKeepAliveBatchSize; ++i)
+    {
+        batchMessages[i].msg_hdr.msg_name = &batchAddrs[i];
+        batchMessages[i].msg_hdr.msg_namelen = sizeof(batchAddrs[i]);
+        batchMessages[i].msg_hdr.msg_iov = &keepAliveBuffer;
+        batchMessages[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+
+    uint32_t wheelSlot { 0 };
+    auto nextTickTime = std::chrono::steady_clock::now();
+
+    while (Network::keepAliveStatus.load(std::memory_order_acquire))
+    {
+        const Tracer::Span span { "Network::KeepAlive" };
+
+        const auto curTime = Timer::Get();
+
+        uint32_t batchSize { 0 };
+
+        for (uint32_t iPlayerId { wheelSlot }; iPlayerId < MAX_PLAYERS; iPlayerId += kKeepAliveWheelSize)
+        {
+            if (!Network::playerStatusTable[iPlayerId].load(std::memory_order_acquire))
+                continue;
+
+            if (curTime - Network::playerActivityTable[iPlayerId].load(std::memory_order_relaxed) < kKeepAliveInterval)
+                continue;
+
+            const auto playerAddr = std::atomic_load(&Network::playerAddrTable[iPlayerId]);
+            if (playerAddr == nullptr) continue;
+
+            batchCompacts[batchSize] = Network::playerCompactTable[iPlayerId].load(std::memory_order_relaxed);
+            batchAddrs[batchSize++] = *playerAddr;
+        }
+
+        if (batchSize != 0)
+        {
+            Metrics::Add(StatType::keepAlivePacketsSent, batchSize);
+
+#ifdef _WIN32
+            for (uint32_t i { 0 }; i < batchSize; ++i)
+            {
+                if (batchCompacts[i])
+                {
+                    sendto(Network::socketHandle, reinterpret_cast<char*>(&compactKeepAlivePacket), sizeof(compactKeepAlivePacket),
+                        NULL, reinterpret_cast<sockaddr*>(&batchAddrs[i]), sizeof(batchAddrs[i]));
+                }
+                else
+                {
+                    sendto(Network::socketHandle, reinterpret_cast<char*>(&keepAlivePacket), sizeof(keepAlivePacket),
+                        NULL, reinterpret_cast<sockaddr*>(&batchAddrs[i]), sizeof(batchAddrs[i]));
+                }
+            }
+#else
+            for (uint32_t i { 0 }; i < batchSize; ++i)
+            {
+                batchMessages[i].msg_hdr.msg_iov = batchCompacts[i]
+                    ? &compactKeepAliveBuffer : &keepAliveBuffer;
+            }
+
+            for (uint32_t sended { 0 }; sended < batchSize;)
+            {
+                const int result = sendmmsg(Network::socketHandle, batchMessages.data() + sended, batchSize - sended, NULL);
+                if (result <= 0) break;
+
+                sended += result;
+            }
+#endif
+        }
+
+        wheelSlot = (wheelSlot + 1) % kKeepAliveWheelSize;
+
+        nextTickTime += tickInterval;
+        std::this_thread::sleep_until(nextTickTime);
+    }
+}
+
 bool Network::initStatus { false };
 bool Network::bindStatus { false };
 
@@ -546,9 +1015,22 @@ uint16_t Network::serverPort { NULL };
 std::array<std::atomic_bool, MAX_PLAYERS> Network::playerStatusTable {};
 std::array<std::shared_ptr<sockaddr_in>, MAX_PLAYERS> Network::playerAddrTable {};
 std::array<uint64_t, MAX_PLAYERS> Network::playerKeyTable {};
+std::array<std::atomic<Timer::time_t>, MAX_PLAYERS> Network::playerActivityTable {};
+
+std::atomic_bool Network::keepAliveStatus { false };
+std::thread Network::keepAliveThread;
+
+std::atomic<uint8_t> Network::voiceAuthMode { Network::VoiceAuthMode::disabled };
+
+std::array<std::atomic_bool, MAX_PLAYERS> Network::playerCompactTable {};
+std::array<std::atomic<uint32_t>, MAX_PLAYERS> Network::playerPackidTable {};
+std::array<std::atomic_bool, MAX_PLAYERS> Network::playerBitrateTable {};
+
+std::atomic_bool Network::simulcastStatus { false };
 
 std::shared_mutex Network::playerKeyToPlayerIdTableMutex;
 std::map<uint64_t, uint16_t> Network::playerKeyToPlayerIdTable;
+std::array<Network::VoiceAuthKey, MAX_PLAYERS> Network::playerAuthTable {};
 
 std::vector<Network::ConnectCallback> Network::connectCallbacks;
 std::vector<Network::PlayerInitCallback> Network::playerInitCallbacks;
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <functional>
 #include <shared_mutex>
+#include <thread>
 
 #ifdef _WIN32
 #include <WinSock2.h>
@@ -31,11 +32,15 @@
 #include <util/timer.h>
 
 #include "ControlPacket.h"
+#include "Latency.h"
 #include "VoicePacket.h"
 #include "Header.h"
 
 class Network {
 
+    friend class RelayLink;
+    friend class StateMirror;
+
     Network() = delete;
     ~Network() = delete;
     Network(const Network&) = delete;
@@ -51,6 +56,8 @@ private:
     static constexpr uint32_t kSendBufferSize = 16 * 1024 * 1024;
     static constexpr uint32_t kRecvBufferSize = 32 * 1024 * 1024;
     static constexpr Timer::time_t kKeepAliveInterval = 10000;
+    static constexpr uint32_t kKeepAliveWheelSize = 100;
+    static constexpr uint32_t kKeepAliveBatchSize = (MAX_PLAYERS + kKeepAliveWheelSize - 1) / kKeepAliveWheelSize;
 
 private:
 
@@ -58,6 +65,18 @@ private:
     using PlayerInitCallback = std::function<void(uint16_t, SV::PluginInitPacket&)>;
     using DisconnectCallback = std::function<void(uint16_t)>;
 
+public:
+
+    struct VoiceAuthMode
+    {
+        enum : uint8_t
+        {
+            disabled, // all clients send untagged packets
+            optional, // tags are negotiated with capable clients
+            required  // untagged packets are dropped
+        };
+    };
+
 public:
 
     static bool Init(const void* serverBaseAddress) noexcept;
@@ -69,7 +88,17 @@ public:
     static bool SendControlPacket(uint16_t playerId, const ControlPacket& controlPacket);
     static bool SendVoicePacket(uint16_t playerId, const VoicePacket& voicePacket);
     static ControlPacketContainerPtr ReceiveControlPacket(uint16_t& sender) noexcept;
-    static VoicePacketContainerPtr ReceiveVoicePacket();
+    static VoicePacketContainerPtr ReceiveVoicePacket(Latency::tsc_t& receiveTime);
+
+    // Mode applies to players connected after the call, but 'required'
+    // mode also starts dropping untagged packets of connected players
+    static void SetVoiceAuthMode(uint8_t mode) noexcept;
+    static bool HasVoiceAuth(uint16_t playerId) noexcept;
+    static bool HasCompactHeader(uint16_t playerId) noexcept;
+    static bool HasBitrateControl(uint16_t playerId) noexcept;
+
+    // Applies to players connected after the call
+    static void SetSimulcast(bool status) noexcept;
 
     static std::size_t AddConnectCallback(ConnectCallback callback) noexcept;
     static std::size_t AddPlayerInitCallback(PlayerInitCallback callback) noexcept;
@@ -84,6 +113,21 @@ private:
     static bool PacketHandler(uint16_t playerId, Packet& packet);
     static void DisconnectHandler(uint16_t playerId);
 
+    // Player's voice address is learnt from the first packet with its key
+    static void IdentifyPlayer(uint16_t playerId, const sockaddr_in& playerAddr);
+
+    static void KeepAliveThread() noexcept;
+
+private:
+
+    struct VoiceAuthKey {
+
+        bool status { false };
+        uint64_t k0 { NULL };
+        uint64_t k1 { NULL };
+
+    };
+
 private:
 
     static bool initStatus;
@@ -99,9 +143,28 @@ private:
     static std::array<std::atomic_bool, MAX_PLAYERS> playerStatusTable;
     static std::array<std::shared_ptr<sockaddr_in>, MAX_PLAYERS> playerAddrTable;
     static std::array<uint64_t, MAX_PLAYERS> playerKeyTable;
+    static std::array<std::atomic<Timer::time_t>, MAX_PLAYERS> playerActivityTable;
+
+    static std::atomic_bool keepAliveStatus;
+    static std::thread keepAliveThread;
+
+    static std::atomic<uint8_t> voiceAuthMode;
+
+    // Header format is fixed for the session, packid is the last restored one
+    static std::array<std::atomic_bool, MAX_PLAYERS> playerCompactTable;
+    static std::array<std::atomic<uint32_t>, MAX_PLAYERS> playerPackidTable;
+
+    // Client sends receiver reports and accepts target bitrate
+    static std::array<std::atomic_bool, MAX_PLAYERS> playerBitrateTable;
+
+    // Clients send both layers only when server asked them to
+    static std::atomic_bool simulcastStatus;
 
+    // Auth keys are guarded by the same mutex as key table so that
+    // worker never verifies a packet with the previous session's key
     static std::shared_mutex playerKeyToPlayerIdTableMutex;
     static std::map<uint64_t, uint16_t> playerKeyToPlayerIdTable;
+    static std::array<VoiceAuthKey, MAX_PLAYERS> playerAuthTable;
 
 private:
 
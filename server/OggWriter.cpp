@@ -0,0 +1,230 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "OggWriter.h"
+
+#include <array>
+#include <cstring>
+
+#include "Header.h"
+
+OggWriter::OggWriter(std::FILE* const file, const uint32_t serial) noexcept
+    : file(file), serial(serial)
+{
+    this->pageSegments.reserve(kMaxPageSegments);
+    this->pageData.reserve(kMaxPageSize);
+}
+
+OggWriter::~OggWriter() noexcept
+{
+    // Last page carries end of stream flag even if it has no packets
+    this->WritePage(0x04);
+
+    std::fclose(this->file);
+}
+
+bool OggWriter::WriteHeaders(const std::vector<std::string>& comments) noexcept
+{
+#pragma pack(push, 1)
+
+    struct OpusHead
+    {
+        char signature[8];
+        uint8_t version;
+        uint8_t channels;
+        uint16_t preSkip;
+        uint32_t sampleRate;
+        int16_t outputGain;
+        uint8_t mappingFamily;
+    };
+
+#pragma pack(pop)
+
+    const OpusHead opusHead { { 'O', 'p', 'u', 's', 'H', 'e', 'a', 'd' },
+        1, 1, kPreSkip, SV::kFrequency, 0, 0 };
+
+    const auto putData = [this](const void* const data, const std::size_t size)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        this->pageData.insert(this->pageData.end(), bytes, bytes + size);
+    };
+
+    const auto putString = [&putData](const char* const string, const uint32_t length)
+    {
+        putData(&length, sizeof(length));
+        putData(string, length);
+    };
+
+    // Identification header must be alone on the first page
+    putData(&opusHead, sizeof(opusHead));
+    this->pageSegments.emplace_back(sizeof(opusHead));
+    if (!this->WritePage(0x02)) return false;
+
+    static constexpr char kVendor[] = "sampvoice";
+    static constexpr char kTagsSignature[] = "OpusTags";
+
+    putData(kTagsSignature, sizeof(kTagsSignature) - 1);
+    putString(kVendor, sizeof(kVendor) - 1);
+
+    const uint32_t commentsCount = comments.size();
+    putData(&commentsCount, sizeof(commentsCount));
+
+    for (const auto& comment : comments)
+        putString(comment.data(), comment.size());
+
+    // Comment header may span pages, audio starts on a fresh one
+    for (std::size_t length { this->pageData.size() };; length -= 255)
+    {
+        this->pageSegments.emplace_back(length < 255 ? length : 255);
+        if (length < 255) break;
+    }
+
+    if (this->pageSegments.size() > kMaxPageSegments)
+        return false;
+
+    return this->WritePage(0x00);
+}
+
+bool OggWriter::WritePacket(const uint8_t* const data, const uint32_t length, const uint32_t samples) noexcept
+{
+    const std::size_t segmentsCount = length / 255 + 1;
+
+    if (segmentsCount > kMaxPageSegments) return false;
+
+    if (this->pageSegments.size() + segmentsCount > kMaxPageSegments ||
+        this->pageData.size() + length > kMaxPageSize)
+    {
+        if (!this->WritePage(0x00)) return false;
+    }
+
+    this->pageSegments.insert(this->pageSegments.end(), segmentsCount - 1, 255);
+    this->pageSegments.emplace_back(length % 255);
+    this->pageData.insert(this->pageData.end(), data, data + length);
+
+    this->granule += samples;
+
+    if (++this->pagePackets >= kMaxPagePackets)
+        return this->WritePage(0x00);
+
+    return !this->errorStatus;
+}
+
+bool OggWriter::Flush() noexcept
+{
+    if (this->pagePackets != 0 && !this->WritePage(0x00))
+        return false;
+
+    return std::fflush(this->file) == 0;
+}
+
+uint64_t OggWriter::GetGranule() const noexcept
+{
+    return this->granule;
+}
+
+uint32_t OggWriter::GetPacketSamples(const uint8_t* const data, const uint32_t length) noexcept
+{
+    if (length == 0) return 0;
+
+    // Frame duration by TOC configuration (RFC 6716, 3.1) in 1/400 s
+    static constexpr uint8_t kFrameDurations[32] {
+        4, 8, 16, 24, 4, 8, 16, 24, 4, 8, 16, 24, // SILK 10/20/40/60 ms
+        4, 8, 4, 8,                               // Hybrid 10/20 ms
+        1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8 // CELT 2.5/5/10/20 ms
+    };
+
+    uint32_t framesCount;
+
+    switch (data[0] & 0x03)
+    {
+        case 0: framesCount = 1; break;
+        case 1:
+        case 2: framesCount = 2; break;
+        default:
+        {
+            if (length < 2) return 0;
+            framesCount = data[1] & 0x3f;
+        }
+    }
+
+    return framesCount * kFrameDurations[data[0] >> 3] * (SV::kFrequency / 400);
+}
+
+bool OggWriter::WritePage(const uint8_t flags) noexcept
+{
+    if (this->errorStatus) return false;
+
+#pragma pack(push, 1)
+
+    struct PageHeader
+    {
+        char signature[4];
+        uint8_t version;
+        uint8_t flags;
+        uint64_t granule;
+        uint32_t serial;
+        uint32_t sequence;
+        uint32_t crc;
+        uint8_t segmentsCount;
+    };
+
+#pragma pack(pop)
+
+    PageHeader pageHeader { { 'O', 'g', 'g', 'S' }, 0, flags, this->granule, this->serial,
+        this->sequence++, 0, static_cast<uint8_t>(this->pageSegments.size()) };
+
+    uint32_t crc { 0 };
+
+    crc = OggWriter::CalcCrc(reinterpret_cast<const uint8_t*>(&pageHeader), sizeof(pageHeader), crc);
+    crc = OggWriter::CalcCrc(this->pageSegments.data(), this->pageSegments.size(), crc);
+    crc = OggWriter::CalcCrc(this->pageData.data(), this->pageData.size(), crc);
+
+    pageHeader.crc = crc;
+
+    if (std::fwrite(&pageHeader, sizeof(pageHeader), 1, this->file) != 1 ||
+        std::fwrite(this->pageSegments.data(), 1, this->pageSegments.size(), this->file) != this->pageSegments.size() ||
+        std::fwrite(this->pageData.data(), 1, this->pageData.size(), this->file) != this->pageData.size())
+    {
+        this->errorStatus = true;
+    }
+
+    this->pageSegments.clear();
+    this->pageData.clear();
+    this->pagePackets = 0;
+
+    return !this->errorStatus;
+}
+
+uint32_t OggWriter::CalcCrc(const uint8_t* const data, const std::size_t size, uint32_t crc) noexcept
+{
+    // Direct CRC-32 with polynomial 0x04c11db7 as specified by Ogg
+    static const auto crcTable = []
+    {
+        std::array<uint32_t, 256> table {};
+
+        for (uint32_t i { 0 }; i < table.size(); ++i)
+        {
+            uint32_t value { i << 24 };
+
+            for (int bit { 0 }; bit < 8; ++bit)
+                value = (value & 0x80000000) ? (value << 1) ^ 0x04c11db7 : value << 1;
+
+            table[i] = value;
+        }
+
+        return table;
+    }();
+
+    for (std::size_t i { 0 }; i < size; ++i)
+        crc = (crc << 8) ^ crcTable[(crc >> 24) ^ data[i]];
+
+    return crc;
+}
+
+constexpr uint8_t OggWriter::kSilenceFrame[];
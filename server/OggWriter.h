@@ -0,0 +1,81 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Ogg Opus (RFC 7845) muxer for mono 48 kHz packets as clients encode them,
+// packets are gathered into pages of up to a second and written on flush
+class OggWriter {
+
+    OggWriter() = delete;
+    OggWriter(const OggWriter&) = delete;
+    OggWriter(OggWriter&&) = delete;
+    OggWriter& operator=(const OggWriter&) = delete;
+    OggWriter& operator=(OggWriter&&) = delete;
+
+private:
+
+    static constexpr uint32_t kMaxPagePackets = 10;
+    static constexpr uint32_t kMaxPageSize = 8192;
+    static constexpr uint32_t kMaxPageSegments = 255;
+
+    // Encoder delay of libopus at 48 kHz
+    static constexpr uint16_t kPreSkip = 312;
+
+public:
+
+    // 100 ms of digital silence: CELT 20 ms frames of two bytes packed by five
+    static constexpr uint8_t kSilenceFrame[] { 0xfb, 0x05, 0xff, 0xfe, 0xff, 0xfe, 0xff, 0xfe, 0xff, 0xfe, 0xff, 0xfe };
+
+public:
+
+    // Takes ownership of file, it is closed with the last page
+    explicit OggWriter(std::FILE* file, uint32_t serial) noexcept;
+
+    ~OggWriter() noexcept;
+
+public:
+
+    // Comments are "KEY=value" strings of OpusTags header
+    bool WriteHeaders(const std::vector<std::string>& comments) noexcept;
+    bool WritePacket(const uint8_t* data, uint32_t length, uint32_t samples) noexcept;
+
+    // Completes current page, file is flushed as well
+    bool Flush() noexcept;
+
+    uint64_t GetGranule() const noexcept;
+
+    // Duration of packet by its TOC byte, zero for malformed packet
+    static uint32_t GetPacketSamples(const uint8_t* data, uint32_t length) noexcept;
+
+private:
+
+    bool WritePage(uint8_t flags) noexcept;
+
+    static uint32_t CalcCrc(const uint8_t* data, std::size_t size, uint32_t crc) noexcept;
+
+private:
+
+    std::FILE* const file;
+    const uint32_t serial;
+
+    uint32_t sequence { 0 };
+    uint64_t granule { 0 };
+    bool errorStatus { false };
+
+    uint32_t pagePackets { 0 };
+    std::vector<uint8_t> pageSegments;
+    std::vector<uint8_t> pageData;
+
+};
@@ -0,0 +1,55 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+// Paces threads that send a frame per tick (mixers and audio sources):
+// every Wait returns one interval after the previous tick was due.
+class PacedTicker {
+
+    PacedTicker() = delete;
+    PacedTicker(const PacedTicker&) = delete;
+    PacedTicker(PacedTicker&&) = delete;
+    PacedTicker& operator=(const PacedTicker&) = delete;
+    PacedTicker& operator=(PacedTicker&&) = delete;
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+public:
+
+    explicit PacedTicker(const Clock::duration interval) noexcept
+        : interval(interval), tickTime(Clock::now())
+    {}
+
+    ~PacedTicker() noexcept = default;
+
+public:
+
+    void Wait() noexcept
+    {
+        this->tickTime += this->interval;
+
+        // After a stall ticks are not caught up, it would only burst packets
+        if (const auto curTime = Clock::now(); curTime > this->tickTime + this->interval)
+            this->tickTime = curTime;
+
+        std::this_thread::sleep_until(this->tickTime);
+    }
+
+private:
+
+    const Clock::duration interval;
+    Clock::time_point tickTime;
+
+};
@@ -27,6 +27,7 @@ void Pawn::Free() noexcept
 
     Pawn::callbacksOnPlayerActivationKeyPress.clear();
     Pawn::callbacksOnPlayerActivationKeyRelease.clear();
+    Pawn::callbacksOnPlayerVoiceThrottle.clear();
 
     Logger::LogToFile("[sv:dbg:pawn:free] : module released");
 
@@ -82,6 +83,10 @@ void Pawn::RegisterScript(AMX* const amx)
         DefineNativeFunction(SvStreamParameterSlideFromTo),
         DefineNativeFunction(SvStreamParameterSlideTo),
         DefineNativeFunction(SvStreamParameterSlide),
+        DefineNativeFunction(SvStreamSetMixMode),
+        DefineNativeFunction(SvStreamGetMixMode),
+        DefineNativeFunction(SvStreamRecordStart),
+        DefineNativeFunction(SvStreamRecordStop),
         DefineNativeFunction(SvDeleteStream),
 
         DefineNativeFunction(SvEffectCreateChorus),
@@ -95,7 +100,60 @@ void Pawn::RegisterScript(AMX* const amx)
         DefineNativeFunction(SvEffectCreateReverb),
         DefineNativeFunction(SvEffectAttachStream),
         DefineNativeFunction(SvEffectDetachStream),
-        DefineNativeFunction(SvEffectDelete)
+        DefineNativeFunction(SvEffectDelete),
+
+        DefineNativeFunction(SvSourceCreate),
+        DefineNativeFunction(SvSourcePlay),
+        DefineNativeFunction(SvSourceStop),
+        DefineNativeFunction(SvSourceIsPlaying),
+        DefineNativeFunction(SvSourceDelete),
+
+        DefineNativeFunction(SvGroupCreate),
+        DefineNativeFunction(SvGroupCreateUnion),
+        DefineNativeFunction(SvGroupCreateIntersection),
+        DefineNativeFunction(SvGroupCreateDifference),
+        DefineNativeFunction(SvGroupAddPlayer),
+        DefineNativeFunction(SvGroupRemovePlayer),
+        DefineNativeFunction(SvGroupHasPlayer),
+        DefineNativeFunction(SvGroupClear),
+        DefineNativeFunction(SvGroupGetPlayersCount),
+        DefineNativeFunction(SvGroupDelete),
+        DefineNativeFunction(SvStreamSetListenerGroup),
+        DefineNativeFunction(SvStreamSetSpeakerGroup),
+
+        DefineNativeFunction(SvSetVoiceRateLimit),
+        DefineNativeFunction(SvGetPlayerThrottledPackets),
+        DefineNativeFunction(SvGetPlayerThrottledBytes),
+
+        DefineNativeFunction(SvSetVoiceAuthMode),
+        DefineNativeFunction(SvHasVoiceAuth),
+        DefineNativeFunction(SvHasCompactHeader),
+
+        DefineNativeFunction(SvSetBitrateLimits),
+        DefineNativeFunction(SvGetPlayerBitrate),
+
+        DefineNativeFunction(SvSetSimulcast),
+
+        DefineNativeFunction(SvFederationOpen),
+        DefineNativeFunction(SvFederationClose),
+        DefineNativeFunction(SvFederationAddPeer),
+        DefineNativeFunction(SvFederationRemovePeer),
+        DefineNativeFunction(SvFederationExportStream),
+        DefineNativeFunction(SvFederationImportStream),
+        DefineNativeFunction(SvFederationDetachStream),
+
+        DefineNativeFunction(SvSetWorkerLimits),
+        DefineNativeFunction(SvGetWorkersCount),
+
+        DefineNativeFunction(SvGetStat),
+        DefineNativeFunction(SvGetLatency),
+        DefineNativeFunction(SvDumpLatency),
+        DefineNativeFunction(SvResetLatency),
+
+        DefineNativeFunction(SvTraceStart),
+        DefineNativeFunction(SvTraceStop),
+        DefineNativeFunction(SvCaptureStart),
+        DefineNativeFunction(SvCaptureStop)
 
 #undef  DefineNativeFunction
     };
@@ -119,6 +177,14 @@ void Pawn::RegisterScript(AMX* const amx)
         Logger::LogToFile("[sv:dbg:pawn:register] : finded 'OnPlayerActivationKeyRelease' callback function (index:%d)", tmpIndex);
         Pawn::callbacksOnPlayerActivationKeyRelease.emplace_back(amx, tmpIndex);
     }
+
+    Logger::LogToFile("[sv:dbg:pawn:register] : finding 'OnPlayerVoiceThrottle' callback function...");
+
+    if (amx_FindPublic(amx, "OnPlayerVoiceThrottle", &tmpIndex) == 0 && tmpIndex >= 0)
+    {
+        Logger::LogToFile("[sv:dbg:pawn:register] : finded 'OnPlayerVoiceThrottle' callback function (index:%d)", tmpIndex);
+        Pawn::callbacksOnPlayerVoiceThrottle.emplace_back(amx, tmpIndex);
+    }
 }
 
 void Pawn::OnPlayerActivationKeyPressForAll(const uint16_t playerid, const uint8_t keyid) noexcept
@@ -137,6 +203,14 @@ void Pawn::OnPlayerActivationKeyReleaseForAll(const uint16_t playerid, const uin
         iCallback.Call(keyid, playerid);
 }
 
+void Pawn::OnPlayerVoiceThrottleForAll(const uint16_t playerid, const uint32_t droppedpackets) noexcept
+{
+    if (Pawn::pInterface == nullptr) return;
+
+    for (const auto& iCallback : Pawn::callbacksOnPlayerVoiceThrottle)
+        iCallback.Call(droppedpackets, playerid);
+}
+
 cell AMX_NATIVE_CALL Pawn::n_SvDebug(AMX* const amx, cell* const params)
 {
     if (Pawn::pInterface == nullptr) return NULL;
@@ -374,7 +448,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateGStream(AMX* const amx, cell* const params)
         color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtPoint(AMX* const amx, cell* const params)
@@ -401,7 +475,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtPoint(AMX* const amx, cell* const
         distance, posx, posy, posz, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtVehicle(AMX* const amx, cell* const params)
@@ -426,7 +500,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtVehicle(AMX* const amx, cell* con
         distance, vehicleid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtPlayer(AMX* const amx, cell* const params)
@@ -451,7 +525,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtPlayer(AMX* const amx, cell* cons
         distance, playerid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtObject(AMX* const amx, cell* const params)
@@ -476,7 +550,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateSLStreamAtObject(AMX* const amx, cell* cons
         distance, objectid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtPoint(AMX* const amx, cell* const params)
@@ -504,7 +578,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtPoint(AMX* const amx, cell* const
         distance, maxplayers, posx, posy, posz, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtVehicle(AMX* const amx, cell* const params)
@@ -530,7 +604,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtVehicle(AMX* const amx, cell* con
         distance, maxplayers, vehicleid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtPlayer(AMX* const amx, cell* const params)
@@ -556,7 +630,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtPlayer(AMX* const amx, cell* cons
         distance, maxplayers, playerid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtObject(AMX* const amx, cell* const params)
@@ -582,7 +656,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvCreateDLStreamAtObject(AMX* const amx, cell* cons
         distance, maxplayers, objectid, color, name.c_str(), result
     );
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvUpdateDistanceForLStream(AMX* const amx, cell* const params)
@@ -590,7 +664,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvUpdateDistanceForLStream(AMX* const amx, cell* co
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto lstream = dynamic_cast<LocalStream*>(reinterpret_cast<Stream*>(params[1]));
+    const auto lstream = dynamic_cast<LocalStream*>(Pawn::GetStream(params[1], "SvUpdateDistanceForLStream"));
     if (!lstream) return NULL;
 
     const auto distance = amx_ctof(params[2]);
@@ -609,7 +683,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvUpdatePositionForLPStream(AMX* const amx, cell* c
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 4 * sizeof(cell)) return NULL;
 
-    const auto lpstream = dynamic_cast<PointStream*>(reinterpret_cast<Stream*>(params[1]));
+    const auto lpstream = dynamic_cast<PointStream*>(Pawn::GetStream(params[1], "SvUpdatePositionForLPStream"));
     if (!lpstream) return NULL;
 
     const auto posx = amx_ctof(params[2]);
@@ -630,7 +704,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvAttachListenerToStream(AMX* const amx, cell* cons
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvAttachListenerToStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvAttachListenerToStream(stream, playerid);
@@ -648,7 +723,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvHasListenerInStream(AMX* const amx, cell* const p
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvHasListenerInStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvHasListenerInStream(stream, playerid);
@@ -666,7 +742,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvDetachListenerFromStream(AMX* const amx, cell* co
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvDetachListenerFromStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvDetachListenerFromStream(stream, playerid);
@@ -684,7 +761,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvDetachAllListenersFromStream(AMX* const amx, cell
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 1 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvDetachAllListenersFromStream");
+    if (stream == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log(
         "[sv:dbg:pawn:SvDetachAllListenersFromStream] : stream(%p)",
@@ -700,7 +778,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvAttachSpeakerToStream(AMX* const amx, cell* const
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvAttachSpeakerToStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvAttachSpeakerToStream(stream, playerid);
@@ -718,7 +797,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvHasSpeakerInStream(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvHasSpeakerInStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvHasSpeakerInStream(stream, playerid);
@@ -736,7 +816,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvDetachSpeakerFromStream(AMX* const amx, cell* con
     if (Pawn::pInterface == nullptr) return false;
     if (params[0] != 2 * sizeof(cell)) return false;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvDetachSpeakerFromStream");
+    if (stream == nullptr) return false;
     const auto playerid = static_cast<uint16_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvDetachSpeakerFromStream(stream, playerid);
@@ -754,7 +835,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvDetachAllSpeakersFromStream(AMX* const amx, cell*
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 1 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvDetachAllSpeakersFromStream");
+    if (stream == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log(
         "[sv:dbg:pawn:SvDetachAllSpeakersFromStream] : stream(%p)",
@@ -770,7 +852,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterSet(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 3 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterSet");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
     const auto value = amx_ctof(params[3]);
 
@@ -786,7 +869,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterReset(AMX* const amx, cell* const
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterReset");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
 
     if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvStreamParameterReset] : "
@@ -801,7 +885,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterHas(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterHas");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvStreamParameterHas(stream, parameter);
@@ -817,7 +902,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterGet(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterGet");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
 
     const auto result = Pawn::pInterface->SvStreamParameterGet(stream, parameter);
@@ -833,7 +919,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterSlideFromTo(AMX* const amx, cell*
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 5 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterSlideFromTo");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
     const auto startvalue = amx_ctof(params[3]);
     const auto endvalue = amx_ctof(params[4]);
@@ -852,7 +939,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterSlideTo(AMX* const amx, cell* cons
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 4 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterSlideTo");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
     const auto endvalue = amx_ctof(params[4]);
     const auto time = static_cast<uint32_t>(params[5]);
@@ -870,7 +958,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterSlide(AMX* const amx, cell* const
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 4 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvStreamParameterSlide");
+    if (stream == nullptr) return NULL;
     const auto parameter = static_cast<uint8_t>(params[2]);
     const auto deltavalue = amx_ctof(params[4]);
     const auto time = static_cast<uint32_t>(params[5]);
@@ -883,12 +972,86 @@ cell AMX_NATIVE_CALL Pawn::n_SvStreamParameterSlide(AMX* const amx, cell* const
     return NULL;
 }
 
+cell AMX_NATIVE_CALL Pawn::n_SvStreamSetMixMode(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamSetMixMode");
+    if (stream == nullptr) return false;
+    const auto mode = static_cast<uint8_t>(params[2]);
+
+    const auto result = Pawn::pInterface->SvStreamSetMixMode(stream, mode);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvStreamSetMixMode] : "
+        "stream(%p), mode(%hhu) : return(%hhu)", stream, mode, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvStreamGetMixMode(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamGetMixMode");
+    if (stream == nullptr) return NULL;
+
+    const auto result = Pawn::pInterface->SvStreamGetMixMode(stream);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvStreamGetMixMode] : "
+        "stream(%p) : return(%hhu)", stream, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvStreamRecordStart(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 3 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamRecordStart");
+    if (stream == nullptr) return false;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[2], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return false;
+    std::string filename(tmp_len + 1, '\0');
+    if (amx_GetString(filename.data(), phys_addr, false, tmp_len + 1)) return false;
+    filename.resize(tmp_len);
+
+    const auto perspeaker = static_cast<bool>(params[3]);
+
+    const auto result = Pawn::pInterface->SvStreamRecordStart(stream, filename, perspeaker);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvStreamRecordStart] : "
+        "stream(%p), filename(%s), perspeaker(%hhu) : return(%hhu)", stream, filename.c_str(), perspeaker, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvStreamRecordStop(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamRecordStop");
+    if (stream == nullptr) return false;
+
+    const auto result = Pawn::pInterface->SvStreamRecordStop(stream);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvStreamRecordStop] : "
+        "stream(%p) : return(%hhu)", stream, result);
+
+    return result;
+}
+
 cell AMX_NATIVE_CALL Pawn::n_SvDeleteStream(AMX* const amx, cell* const params)
 {
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 1 * sizeof(cell)) return NULL;
 
-    const auto stream = reinterpret_cast<Stream*>(params[1]);
+    const auto stream = Pawn::GetStream(params[1], "SvDeleteStream");
+    if (stream == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log(
         "[sv:dbg:pawn:SvDeleteStream] : stream(%p)",
@@ -919,7 +1082,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateChorus(AMX* const amx, cell* const pa
         "priority(%d), wetdrymix(%.2f), depth(%.2f), feedback(%.2f), frequency(%.2f), waveform(%u), delay(%.2f), phase(%u) : return(%p)",
         priority, wetdrymix, depth, feedback, frequency, waveform, delay, phase, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 
 }
 
@@ -942,7 +1105,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateCompressor(AMX* const amx, cell* cons
         "priority(%d), gain(%.2f), attack(%.2f), release(%.2f), threshold(%.2f), ratio(%.2f), predelay(%.2f) : return(%p)",
         priority, gain, attack, release, threshold, ratio, predelay, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateDistortion(AMX* const amx, cell* const params)
@@ -963,7 +1126,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateDistortion(AMX* const amx, cell* cons
         "priority(%d), gain(%.2f), edge(%.2f), posteqcenterfrequency(%.2f), posteqbandwidth(%.2f), prelowpasscutoff(%.2f) : return(%p)",
         priority, gain, edge, posteqcenterfrequency, posteqbandwidth, prelowpasscutoff, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateEcho(AMX* const amx, cell* const params)
@@ -984,7 +1147,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateEcho(AMX* const amx, cell* const para
         "priority(%d), wetdrymix(%.2f), feedback(%.2f), leftdelay(%.2f), rightdelay(%.2f), pandelay(%hhu) : return(%p)",
         priority, wetdrymix, feedback, leftdelay, rightdelay, pandelay, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateFlanger(AMX* const amx, cell* const params)
@@ -1007,7 +1170,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateFlanger(AMX* const amx, cell* const p
         "priority(%d), wetdrymix(%.2f), depth(%.2f), feedback(%.2f), frequency(%.2f), waveform(%u), delay(%.2f), phase(%u) : return(%p)",
         priority, wetdrymix, depth, feedback, frequency, waveform, delay, phase, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateGargle(AMX* const amx, cell* const params)
@@ -1025,7 +1188,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateGargle(AMX* const amx, cell* const pa
         "priority(%d), ratehz(%u), waveshape(%u) : return(%p)",
         priority, ratehz, waveshape, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateI3dl2reverb(AMX* const amx, cell* const params)
@@ -1059,7 +1222,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateI3dl2reverb(AMX* const amx, cell* con
         priority, room, roomhf, roomrollofffactor, decaytime, decayhfratio, reflections,
         reflectionsdelay, reverb, reverbdelay, diffusion, density, hfreference, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateParameq(AMX* const amx, cell* const params)
@@ -1078,7 +1241,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateParameq(AMX* const amx, cell* const p
         "priority(%d), center(%.2f), bandwidth(%.2f), gain(%.2f) : return(%p)",
         priority, center, bandwidth, gain, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateReverb(AMX* const amx, cell* const params)
@@ -1098,7 +1261,7 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectCreateReverb(AMX* const amx, cell* const pa
         "priority(%d), ingain(%.2f), reverbmix(%.2f), reverbtime(%.2f), highfreqrtratio(%.2f) : return(%p)",
         priority, ingain, reverbmix, reverbtime, highfreqrtratio, result);
 
-    return reinterpret_cast<cell>(result);
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
 }
 
 cell AMX_NATIVE_CALL Pawn::n_SvEffectAttachStream(AMX* const amx, cell* const params)
@@ -1106,8 +1269,9 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectAttachStream(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto effect = reinterpret_cast<Effect*>(params[1]);
-    const auto stream = reinterpret_cast<Stream*>(params[2]);
+    const auto effect = Pawn::GetEffect(params[1], "SvEffectAttachStream");
+    const auto stream = Pawn::GetStream(params[2], "SvEffectAttachStream");
+    if (effect == nullptr || stream == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvEffectAttachStream] : "
         "effect(%p), stream(%p)", effect, stream);
@@ -1121,8 +1285,9 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectDetachStream(AMX* const amx, cell* const pa
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 2 * sizeof(cell)) return NULL;
 
-    const auto effect = reinterpret_cast<Effect*>(params[1]);
-    const auto stream = reinterpret_cast<Stream*>(params[2]);
+    const auto effect = Pawn::GetEffect(params[1], "SvEffectDetachStream");
+    const auto stream = Pawn::GetStream(params[2], "SvEffectDetachStream");
+    if (effect == nullptr || stream == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvEffectDetachStream] : "
         "effect(%p), stream(%p)", effect, stream);
@@ -1136,7 +1301,8 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectDelete(AMX* const amx, cell* const params)
     if (Pawn::pInterface == nullptr) return NULL;
     if (params[0] != 1 * sizeof(cell)) return NULL;
 
-    const auto effect = reinterpret_cast<Effect*>(params[1]);
+    const auto effect = Pawn::GetEffect(params[1], "SvEffectDelete");
+    if (effect == nullptr) return NULL;
 
     if (Pawn::debugStatus) Logger::Log(
         "[sv:dbg:pawn:SvEffectDelete] : effect(%p)",
@@ -1147,9 +1313,827 @@ cell AMX_NATIVE_CALL Pawn::n_SvEffectDelete(AMX* const amx, cell* const params)
     return NULL;
 }
 
+cell AMX_NATIVE_CALL Pawn::n_SvSourceCreate(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[1], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string filename(tmp_len + 1, '\0');
+    if (amx_GetString(filename.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    filename.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvSourceCreate(filename);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvSourceCreate] : "
+        "filename(%s) : return(%p)", filename.c_str(), result);
+
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSourcePlay(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 3 * sizeof(cell)) return NULL;
+
+    const auto source = Pawn::GetSource(params[1], "SvSourcePlay");
+    const auto stream = Pawn::GetStream(params[2], "SvSourcePlay");
+    if (source == nullptr || stream == nullptr) return NULL;
+    const auto loop = static_cast<bool>(params[3]);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvSourcePlay] : "
+        "source(%p), stream(%p), loop(%hhu)", source, stream, loop);
+
+    Pawn::pInterface->SvSourcePlay(source, stream, loop);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSourceStop(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto source = Pawn::GetSource(params[1], "SvSourceStop");
+    if (source == nullptr) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvSourceStop] : "
+        "source(%p)", source);
+
+    Pawn::pInterface->SvSourceStop(source);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSourceIsPlaying(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto source = Pawn::GetSource(params[1], "SvSourceIsPlaying");
+    if (source == nullptr) return false;
+
+    const auto result = Pawn::pInterface->SvSourceIsPlaying(source);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvSourceIsPlaying] : "
+        "source(%p) : return(%hhu)", source, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSourceDelete(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto source = Pawn::GetSource(params[1], "SvSourceDelete");
+    if (source == nullptr) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvSourceDelete] : "
+        "source(%p)", source);
+
+    Pawn::pInterface->SvSourceDelete(source);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupCreate(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[1], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string name(tmp_len + 1, '\0');
+    if (amx_GetString(name.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    name.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvGroupCreate(name);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvGroupCreate] : "
+        "name(%s) : return(%p)", name.c_str(), result);
+
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupCreateUnion(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 3 * sizeof(cell)) return NULL;
+
+    const auto group1 = Pawn::GetGroup(params[1], "SvGroupCreateUnion");
+    const auto group2 = Pawn::GetGroup(params[2], "SvGroupCreateUnion");
+    if (group1 == nullptr || group2 == nullptr) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[3], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string name(tmp_len + 1, '\0');
+    if (amx_GetString(name.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    name.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvGroupCreateUnion(group1, group2, name);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupCreateUnion] : group1(%p), group2(%p), name(%s) : return(%p)",
+        group1, group2, name.c_str(), result
+    );
+
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupCreateIntersection(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 3 * sizeof(cell)) return NULL;
+
+    const auto group1 = Pawn::GetGroup(params[1], "SvGroupCreateIntersection");
+    const auto group2 = Pawn::GetGroup(params[2], "SvGroupCreateIntersection");
+    if (group1 == nullptr || group2 == nullptr) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[3], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string name(tmp_len + 1, '\0');
+    if (amx_GetString(name.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    name.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvGroupCreateIntersection(group1, group2, name);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupCreateIntersection] : group1(%p), group2(%p), name(%s) : return(%p)",
+        group1, group2, name.c_str(), result
+    );
+
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupCreateDifference(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 3 * sizeof(cell)) return NULL;
+
+    const auto group1 = Pawn::GetGroup(params[1], "SvGroupCreateDifference");
+    const auto group2 = Pawn::GetGroup(params[2], "SvGroupCreateDifference");
+    if (group1 == nullptr || group2 == nullptr) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[3], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string name(tmp_len + 1, '\0');
+    if (amx_GetString(name.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    name.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvGroupCreateDifference(group1, group2, name);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupCreateDifference] : group1(%p), group2(%p), name(%s) : return(%p)",
+        group1, group2, name.c_str(), result
+    );
+
+    return result != nullptr ? static_cast<cell>(result->GetHandle()) : NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupAddPlayer(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupAddPlayer");
+    if (group == nullptr) return false;
+    const auto playerid = static_cast<uint16_t>(params[2]);
+
+    const auto result = Pawn::pInterface->SvGroupAddPlayer(group, playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupAddPlayer] : group(%p), playerid(%hu) : return(%hhu)",
+        group, playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupRemovePlayer(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupRemovePlayer");
+    if (group == nullptr) return false;
+    const auto playerid = static_cast<uint16_t>(params[2]);
+
+    const auto result = Pawn::pInterface->SvGroupRemovePlayer(group, playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupRemovePlayer] : group(%p), playerid(%hu) : return(%hhu)",
+        group, playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupHasPlayer(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupHasPlayer");
+    if (group == nullptr) return false;
+    const auto playerid = static_cast<uint16_t>(params[2]);
+
+    const auto result = Pawn::pInterface->SvGroupHasPlayer(group, playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGroupHasPlayer] : group(%p), playerid(%hu) : return(%hhu)",
+        group, playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupClear(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupClear");
+    if (group == nullptr) return false;
+
+    const auto result = Pawn::pInterface->SvGroupClear(group);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvGroupClear] : "
+        "group(%p) : return(%hhu)", group, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupGetPlayersCount(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupGetPlayersCount");
+    if (group == nullptr) return NULL;
+
+    const auto result = Pawn::pInterface->SvGroupGetPlayersCount(group);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvGroupGetPlayersCount] : "
+        "group(%p) : return(%u)", group, result);
+
+    return static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGroupDelete(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto group = Pawn::GetGroup(params[1], "SvGroupDelete");
+    if (group == nullptr) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvGroupDelete] : "
+        "group(%p)", group);
+
+    Pawn::pInterface->SvGroupDelete(group);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvStreamSetListenerGroup(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamSetListenerGroup");
+    if (stream == nullptr) return false;
+
+    // SV_NULL unbinds the group
+    const auto group = params[2] != NULL ? Pawn::GetGroup(params[2], "SvStreamSetListenerGroup") : nullptr;
+    if (params[2] != NULL && group == nullptr) return false;
+
+    const auto result = Pawn::pInterface->SvStreamSetListenerGroup(stream, group);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvStreamSetListenerGroup] : stream(%p), group(%p) : return(%hhu)",
+        stream, group, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvStreamSetSpeakerGroup(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvStreamSetSpeakerGroup");
+    if (stream == nullptr) return false;
+
+    // SV_NULL unbinds the group
+    const auto group = params[2] != NULL ? Pawn::GetGroup(params[2], "SvStreamSetSpeakerGroup") : nullptr;
+    if (params[2] != NULL && group == nullptr) return false;
+
+    const auto result = Pawn::pInterface->SvStreamSetSpeakerGroup(stream, group);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvStreamSetSpeakerGroup] : stream(%p), group(%p) : return(%hhu)",
+        stream, group, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSetVoiceRateLimit(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 3 * sizeof(cell)) return NULL;
+
+    const auto packetspersecond = static_cast<uint32_t>(params[1]);
+    const auto bytespersecond = static_cast<uint32_t>(params[2]);
+    const auto bursttime = static_cast<uint32_t>(params[3]);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvSetVoiceRateLimit] : packetspersecond(%u), bytespersecond(%u), bursttime(%u)",
+        packetspersecond, bytespersecond, bursttime
+    );
+
+    Pawn::pInterface->SvSetVoiceRateLimit(packetspersecond, bytespersecond, bursttime);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetPlayerThrottledPackets(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto playerid = static_cast<uint16_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvGetPlayerThrottledPackets(playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetPlayerThrottledPackets] : playerid(%hu) : return(%u)",
+        playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetPlayerThrottledBytes(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto playerid = static_cast<uint16_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvGetPlayerThrottledBytes(playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetPlayerThrottledBytes] : playerid(%hu) : return(%u)",
+        playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSetVoiceAuthMode(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto mode = static_cast<uint8_t>(params[1]);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvSetVoiceAuthMode] : mode(%hhu)",
+        mode
+    );
+
+    Pawn::pInterface->SvSetVoiceAuthMode(mode);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvHasVoiceAuth(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto playerid = static_cast<uint16_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvHasVoiceAuth(playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvHasVoiceAuth] : playerid(%hu) : return(%hhu)",
+        playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvHasCompactHeader(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto playerid = static_cast<uint16_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvHasCompactHeader(playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvHasCompactHeader] : playerid(%hu) : return(%hhu)",
+        playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSetBitrateLimits(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 2 * sizeof(cell)) return NULL;
+
+    const auto minbitrate = static_cast<uint32_t>(params[1]);
+    const auto maxbitrate = static_cast<uint32_t>(params[2]);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvSetBitrateLimits] : minbitrate(%u), maxbitrate(%u)",
+        minbitrate, maxbitrate
+    );
+
+    Pawn::pInterface->SvSetBitrateLimits(minbitrate, maxbitrate);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetPlayerBitrate(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto playerid = static_cast<uint16_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvGetPlayerBitrate(playerid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetPlayerBitrate] : playerid(%hu) : return(%u)",
+        playerid, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSetSimulcast(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto status = static_cast<bool>(params[1]);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvSetSimulcast] : status(%hhu)",
+        status
+    );
+
+    Pawn::pInterface->SvSetSimulcast(status);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationOpen(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 2 * sizeof(cell)) return false;
+
+    const auto port = static_cast<uint16_t>(params[1]);
+    const auto flushinterval = static_cast<uint32_t>(params[2]);
+
+    const auto result = Pawn::pInterface->SvFederationOpen(port, flushinterval);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvFederationOpen] : port(%hu), flushinterval(%u) : return(%hhu)",
+        port, flushinterval, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationClose(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvFederationClose]");
+
+    Pawn::pInterface->SvFederationClose();
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationAddPeer(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return -1;
+    if (params[0] != 3 * sizeof(cell)) return -1;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[1], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return -1;
+    std::string host(tmp_len + 1, '\0');
+    if (amx_GetString(host.data(), phys_addr, false, tmp_len + 1)) return -1;
+    host.resize(tmp_len);
+
+    const auto port = static_cast<uint16_t>(params[2]);
+    const auto key = static_cast<uint32_t>(params[3]);
+
+    const auto result = Pawn::pInterface->SvFederationAddPeer(host, port, key);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvFederationAddPeer] : host(%s), port(%hu) : return(%d)",
+        host.c_str(), port, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationRemovePeer(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 1 * sizeof(cell)) return false;
+
+    const auto peer = static_cast<int>(params[1]);
+
+    const auto result = Pawn::pInterface->SvFederationRemovePeer(peer);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvFederationRemovePeer] : peer(%d) : return(%hhu)",
+        peer, result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationExportStream(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 3 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvFederationExportStream");
+    if (stream == nullptr) return false;
+    const auto peer = static_cast<int>(params[2]);
+    const auto channel = static_cast<uint16_t>(params[3]);
+
+    const auto result = Pawn::pInterface->SvFederationExportStream(stream, peer, channel);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvFederationExportStream] : "
+        "stream(%p), peer(%d), channel(%hu) : return(%hhu)", stream, peer, channel, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationImportStream(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return false;
+    if (params[0] != 3 * sizeof(cell)) return false;
+
+    const auto stream = Pawn::GetStream(params[1], "SvFederationImportStream");
+    if (stream == nullptr) return false;
+    const auto peer = static_cast<int>(params[2]);
+    const auto channel = static_cast<uint16_t>(params[3]);
+
+    const auto result = Pawn::pInterface->SvFederationImportStream(stream, peer, channel);
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvFederationImportStream] : "
+        "stream(%p), peer(%d), channel(%hu) : return(%hhu)", stream, peer, channel, result);
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvFederationDetachStream(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto stream = Pawn::GetStream(params[1], "SvFederationDetachStream");
+    if (stream == nullptr) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvFederationDetachStream] : "
+        "stream(%p)", stream);
+
+    Pawn::pInterface->SvFederationDetachStream(stream);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvSetWorkerLimits(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 2 * sizeof(cell)) return NULL;
+
+    const auto minworkers = static_cast<uint32_t>(params[1]);
+    const auto maxworkers = static_cast<uint32_t>(params[2]);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvSetWorkerLimits] : minworkers(%u), maxworkers(%u)",
+        minworkers, maxworkers
+    );
+
+    Pawn::pInterface->SvSetWorkerLimits(minworkers, maxworkers);
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetWorkersCount(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 0 * sizeof(cell)) return NULL;
+
+    const auto result = Pawn::pInterface->SvGetWorkersCount();
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetWorkersCount] : return(%u)",
+        result
+    );
+
+    return result;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetStat(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    const auto statid = static_cast<uint32_t>(params[1]);
+
+    const auto result = Pawn::pInterface->SvGetStat(statid);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetStat] : statid(%u) : return(%lld)",
+        statid, static_cast<long long>(result)
+    );
+
+    return static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvGetLatency(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 2 * sizeof(cell)) return NULL;
+
+    const auto latencytype = static_cast<uint32_t>(params[1]);
+    const auto percentile = amx_ctof(params[2]);
+
+    const auto result = Pawn::pInterface->SvGetLatency(latencytype, percentile);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvGetLatency] : latencytype(%u), percentile(%.2f) : return(%llu)",
+        latencytype, percentile, static_cast<unsigned long long>(result)
+    );
+
+    return result > INT32_MAX ? INT32_MAX : static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvDumpLatency(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 0 * sizeof(cell)) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvDumpLatency]");
+
+    Pawn::pInterface->SvDumpLatency();
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvResetLatency(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 0 * sizeof(cell)) return NULL;
+
+    if (Pawn::debugStatus) Logger::Log("[sv:dbg:pawn:SvResetLatency]");
+
+    Pawn::pInterface->SvResetLatency();
+    return NULL;
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvTraceStart(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 0 * sizeof(cell)) return NULL;
+
+    const auto result = Pawn::pInterface->SvTraceStart();
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvTraceStart] : return(%hhu)",
+        result
+    );
+
+    return static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvTraceStop(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[1], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string filename(tmp_len + 1, '\0');
+    if (amx_GetString(filename.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    filename.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvTraceStop(filename);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvTraceStop] : filename(%s) : return(%hhu)",
+        filename.c_str(), result
+    );
+
+    return static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvCaptureStart(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 1 * sizeof(cell)) return NULL;
+
+    cell* phys_addr { nullptr }; int tmp_len { 0 };
+    if (amx_GetAddr(amx, params[1], &phys_addr) || amx_StrLen(phys_addr, &tmp_len)) return NULL;
+    std::string filename(tmp_len + 1, '\0');
+    if (amx_GetString(filename.data(), phys_addr, false, tmp_len + 1)) return NULL;
+    filename.resize(tmp_len);
+
+    const auto result = Pawn::pInterface->SvCaptureStart(filename);
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvCaptureStart] : filename(%s) : return(%hhu)",
+        filename.c_str(), result
+    );
+
+    return static_cast<cell>(result);
+}
+
+cell AMX_NATIVE_CALL Pawn::n_SvCaptureStop(AMX* const amx, cell* const params)
+{
+    if (Pawn::pInterface == nullptr) return NULL;
+    if (params[0] != 0 * sizeof(cell)) return NULL;
+
+    const auto result = Pawn::pInterface->SvCaptureStop();
+
+    if (Pawn::debugStatus) Logger::Log(
+        "[sv:dbg:pawn:SvCaptureStop] : return(%hhu)",
+        result
+    );
+
+    return static_cast<cell>(result);
+}
+
+Stream* Pawn::GetStream(const cell handle, const char* const native) noexcept
+{
+    const auto stream = Stream::FromHandle(static_cast<uint32_t>(handle));
+
+    if (stream == nullptr)
+    {
+        static Logger::Limiter invalidHandleLimiter { 1, 5 };
+
+        Logger::Log(invalidHandleLimiter, "[sv:err:pawn:%s] : "
+            "invalid stream handle (0x%x)", native, handle);
+    }
+
+    return stream;
+}
+
+Effect* Pawn::GetEffect(const cell handle, const char* const native) noexcept
+{
+    const auto effect = Effect::FromHandle(static_cast<uint32_t>(handle));
+
+    if (effect == nullptr)
+    {
+        static Logger::Limiter invalidHandleLimiter { 1, 5 };
+
+        Logger::Log(invalidHandleLimiter, "[sv:err:pawn:%s] : "
+            "invalid effect handle (0x%x)", native, handle);
+    }
+
+    return effect;
+}
+
+AudioSource* Pawn::GetSource(const cell handle, const char* const native) noexcept
+{
+    const auto source = AudioSource::FromHandle(static_cast<uint32_t>(handle));
+
+    if (source == nullptr)
+    {
+        static Logger::Limiter invalidHandleLimiter { 1, 5 };
+
+        Logger::Log(invalidHandleLimiter, "[sv:err:pawn:%s] : "
+            "invalid source handle (0x%x)", native, handle);
+    }
+
+    return source;
+}
+
+Group* Pawn::GetGroup(const cell handle, const char* const native) noexcept
+{
+    const auto group = Group::FromHandle(static_cast<uint32_t>(handle));
+
+    if (group == nullptr)
+    {
+        static Logger::Limiter invalidHandleLimiter { 1, 5 };
+
+        Logger::Log(invalidHandleLimiter, "[sv:err:pawn:%s] : "
+            "invalid group handle (0x%x)", native, handle);
+    }
+
+    return group;
+}
+
 bool Pawn::debugStatus { false };
 
 PawnInterfacePtr Pawn::pInterface { nullptr };
 
 std::vector<Pawn::AmxCallback> Pawn::callbacksOnPlayerActivationKeyPress;
 std::vector<Pawn::AmxCallback> Pawn::callbacksOnPlayerActivationKeyRelease;
+std::vector<Pawn::AmxCallback> Pawn::callbacksOnPlayerVoiceThrottle;
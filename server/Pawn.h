@@ -21,6 +21,8 @@
 #include "LocalStream.h"
 #include "PointStream.h"
 #include "Effect.h"
+#include "AudioSource.h"
+#include "Group.h"
 
 class PawnInterface {
 public:
@@ -182,6 +184,17 @@ public:
                                                     float deltavalue,
                                                     uint32_t time) = 0;
 
+    virtual bool    SvStreamSetMixMode             (Stream* stream,
+                                                    uint8_t mode) = 0;
+
+    virtual uint8_t SvStreamGetMixMode             (Stream* stream) = 0;
+
+    virtual bool    SvStreamRecordStart            (Stream* stream,
+                                                    const std::string& filename,
+                                                    bool perspeaker) = 0;
+
+    virtual bool    SvStreamRecordStop             (Stream* stream) = 0;
+
     // --------------------------------------------------------------------------
 
     virtual void    SvDeleteStream                 (Stream* stream) = 0;
@@ -265,6 +278,122 @@ public:
 
     virtual void    SvEffectDelete                 (Effect* effect) = 0;
 
+    // --------------------------------------------------------------------------
+
+    virtual AudioSource* SvSourceCreate            (const std::string& filename) = 0;
+
+    virtual void    SvSourcePlay                   (AudioSource* source,
+                                                    Stream* stream,
+                                                    bool loop) = 0;
+
+    virtual void    SvSourceStop                   (AudioSource* source) = 0;
+
+    virtual bool    SvSourceIsPlaying              (AudioSource* source) = 0;
+
+    virtual void    SvSourceDelete                 (AudioSource* source) = 0;
+
+    // --------------------------------------------------------------------------
+
+    virtual Group*  SvGroupCreate                  (const std::string& name) = 0;
+
+    virtual Group*  SvGroupCreateUnion             (Group* group1,
+                                                    Group* group2,
+                                                    const std::string& name) = 0;
+
+    virtual Group*  SvGroupCreateIntersection      (Group* group1,
+                                                    Group* group2,
+                                                    const std::string& name) = 0;
+
+    virtual Group*  SvGroupCreateDifference        (Group* group1,
+                                                    Group* group2,
+                                                    const std::string& name) = 0;
+
+    virtual bool    SvGroupAddPlayer               (Group* group,
+                                                    uint16_t playerid) = 0;
+
+    virtual bool    SvGroupRemovePlayer            (Group* group,
+                                                    uint16_t playerid) = 0;
+
+    virtual bool    SvGroupHasPlayer               (Group* group,
+                                                    uint16_t playerid) = 0;
+
+    virtual bool    SvGroupClear                   (Group* group) = 0;
+
+    virtual uint32_t SvGroupGetPlayersCount        (Group* group) = 0;
+
+    virtual void    SvGroupDelete                  (Group* group) = 0;
+
+    virtual bool    SvStreamSetListenerGroup       (Stream* stream,
+                                                    Group* group) = 0;
+
+    virtual bool    SvStreamSetSpeakerGroup        (Stream* stream,
+                                                    Group* group) = 0;
+
+    // --------------------------------------------------------------------------
+
+    virtual void    SvSetVoiceRateLimit            (uint32_t packetspersecond,
+                                                    uint32_t bytespersecond,
+                                                    uint32_t bursttime) = 0;
+
+    virtual uint32_t SvGetPlayerThrottledPackets   (uint16_t playerid) = 0;
+
+    virtual uint32_t SvGetPlayerThrottledBytes     (uint16_t playerid) = 0;
+
+    virtual void    SvSetVoiceAuthMode             (uint8_t mode) = 0;
+
+    virtual bool    SvHasVoiceAuth                 (uint16_t playerid) = 0;
+    virtual bool    SvHasCompactHeader             (uint16_t playerid) = 0;
+
+    virtual void    SvSetBitrateLimits             (uint32_t minbitrate,
+                                                    uint32_t maxbitrate) = 0;
+
+    virtual uint32_t SvGetPlayerBitrate            (uint16_t playerid) = 0;
+
+    virtual void    SvSetSimulcast                 (bool status) = 0;
+
+    virtual bool    SvFederationOpen               (uint16_t port,
+                                                    uint32_t flushinterval) = 0;
+
+    virtual void    SvFederationClose              () = 0;
+
+    virtual int     SvFederationAddPeer            (const std::string& host,
+                                                    uint16_t port,
+                                                    uint32_t key) = 0;
+
+    virtual bool    SvFederationRemovePeer         (int peer) = 0;
+
+    virtual bool    SvFederationExportStream       (Stream* stream,
+                                                    int peer,
+                                                    uint16_t channel) = 0;
+
+    virtual bool    SvFederationImportStream       (Stream* stream,
+                                                    int peer,
+                                                    uint16_t channel) = 0;
+
+    virtual void    SvFederationDetachStream       (Stream* stream) = 0;
+
+    virtual void    SvSetWorkerLimits              (uint32_t minworkers,
+                                                    uint32_t maxworkers) = 0;
+
+    virtual uint32_t SvGetWorkersCount             () = 0;
+
+    virtual int64_t SvGetStat                      (uint32_t statid) = 0;
+
+    virtual uint64_t SvGetLatency                  (uint32_t latencytype,
+                                                    float percentile) = 0;
+
+    virtual void    SvDumpLatency                  () = 0;
+
+    virtual void    SvResetLatency                 () = 0;
+
+    virtual bool    SvTraceStart                   () = 0;
+
+    virtual bool    SvTraceStop                    (const std::string& filename) = 0;
+
+    virtual bool    SvCaptureStart                 (const std::string& filename) = 0;
+
+    virtual bool    SvCaptureStop                  () = 0;
+
 };
 
 using PawnInterfacePtr = std::unique_ptr<PawnInterface>;
@@ -279,6 +408,7 @@ public:
 
     static void OnPlayerActivationKeyPressForAll(uint16_t playerid, uint8_t keyid) noexcept;
     static void OnPlayerActivationKeyReleaseForAll(uint16_t playerid, uint8_t keyid) noexcept;
+    static void OnPlayerVoiceThrottleForAll(uint16_t playerid, uint32_t droppedpackets) noexcept;
 
 private:
 
@@ -321,6 +451,10 @@ private:
     static cell AMX_NATIVE_CALL n_SvStreamParameterSlideFromTo(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvStreamParameterSlideTo(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvStreamParameterSlide(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamSetMixMode(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamGetMixMode(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamRecordStart(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamRecordStop(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvDeleteStream(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvEffectCreateChorus(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvEffectCreateCompressor(AMX* amx, cell* params);
@@ -334,6 +468,57 @@ private:
     static cell AMX_NATIVE_CALL n_SvEffectAttachStream(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvEffectDetachStream(AMX* amx, cell* params);
     static cell AMX_NATIVE_CALL n_SvEffectDelete(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSourceCreate(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSourcePlay(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSourceStop(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSourceIsPlaying(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSourceDelete(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupCreate(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupCreateUnion(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupCreateIntersection(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupCreateDifference(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupAddPlayer(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupRemovePlayer(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupHasPlayer(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupClear(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupGetPlayersCount(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGroupDelete(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamSetListenerGroup(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvStreamSetSpeakerGroup(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSetVoiceRateLimit(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetPlayerThrottledPackets(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetPlayerThrottledBytes(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSetVoiceAuthMode(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvHasVoiceAuth(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvHasCompactHeader(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSetBitrateLimits(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetPlayerBitrate(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSetSimulcast(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationOpen(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationClose(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationAddPeer(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationRemovePeer(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationExportStream(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationImportStream(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvFederationDetachStream(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvSetWorkerLimits(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetWorkersCount(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetStat(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvGetLatency(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvDumpLatency(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvResetLatency(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvTraceStart(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvTraceStop(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvCaptureStart(AMX* amx, cell* params);
+    static cell AMX_NATIVE_CALL n_SvCaptureStop(AMX* amx, cell* params);
+
+private:
+
+    // Resolve script handles, stale or forged ones are reported and give nullptr
+    static Stream* GetStream(cell handle, const char* native) noexcept;
+    static Effect* GetEffect(cell handle, const char* native) noexcept;
+    static AudioSource* GetSource(cell handle, const char* native) noexcept;
+    static Group* GetGroup(cell handle, const char* native) noexcept;
 
 private:
 
@@ -381,5 +566,6 @@ private:
 
     static std::vector<AmxCallback> callbacksOnPlayerActivationKeyPress;
     static std::vector<AmxCallback> callbacksOnPlayerActivationKeyRelease;
+    static std::vector<AmxCallback> callbacksOnPlayerVoiceThrottle;
 
 };
@@ -0,0 +1,100 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <ysf/structs.h>
+
+// Player ids packed into 64-bit words, a bit per player. Streams keep their
+// listeners and speakers so (in atomic words) and groups their members,
+// set operations and walks over members then go a word at a time.
+namespace PlayerBitset
+{
+    constexpr uint32_t kWordsCount = (MAX_PLAYERS + 63) / 64;
+
+    using Words = std::array<uint64_t, kWordsCount>;
+
+    constexpr uint32_t GetWord(const uint16_t playerId) noexcept
+    {
+        return playerId / 64;
+    }
+
+    constexpr uint64_t GetMask(const uint16_t playerId) noexcept
+    {
+        return uint64_t { 1 } << (playerId % 64);
+    }
+
+    inline uint32_t GetLowestBit(const uint64_t word) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#ifdef _WIN64
+        _BitScanForward64(&index, word);
+#else
+        if (static_cast<uint32_t>(word) != 0) _BitScanForward(&index, static_cast<unsigned long>(word));
+        else { _BitScanForward(&index, static_cast<unsigned long>(word >> 32)); index += 32; }
+#endif
+        return index;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    inline uint32_t CountBits(const uint64_t word) noexcept
+    {
+#ifdef _MSC_VER
+        return __popcnt(static_cast<uint32_t>(word)) + __popcnt(static_cast<uint32_t>(word >> 32));
+#else
+        return __builtin_popcountll(word);
+#endif
+    }
+
+    inline bool Test(const Words& words, const uint16_t playerId) noexcept
+    {
+        return words[GetWord(playerId)] & GetMask(playerId);
+    }
+
+    inline void Set(Words& words, const uint16_t playerId) noexcept
+    {
+        words[GetWord(playerId)] |= GetMask(playerId);
+    }
+
+    inline void Reset(Words& words, const uint16_t playerId) noexcept
+    {
+        words[GetWord(playerId)] &= ~GetMask(playerId);
+    }
+
+    inline uint32_t Count(const Words& words) noexcept
+    {
+        uint32_t count { 0 };
+
+        for (const auto word : words)
+            count += CountBits(word);
+
+        return count;
+    }
+
+    // Calls 'function' with id of every player whose bit is set in 'word'
+    template <class FunctionType>
+    inline void ForEach(uint64_t word, const uint32_t wordIndex, FunctionType&& function)
+    {
+        while (word != 0)
+        {
+            function(static_cast<uint16_t>(wordIndex * 64 + GetLowestBit(word)));
+            word &= word - 1;
+        }
+    }
+}
@@ -11,7 +11,9 @@
 
 #include <cassert>
 
-#include <ysf/globals.h>
+#include "StateMirror.h"
+#include "Group.h"
+#include "World.h"
 
 void PlayerStore::AddPlayerToStore(const uint16_t playerId, const uint8_t version, const bool microStatus)
 {
@@ -23,6 +25,9 @@ void PlayerStore::AddPlayerToStore(const uint16_t playerId, const uint8_t versio
         const auto pOldPlayerInfo = PlayerStore::playerInfo[playerId].exchange(pPlayerInfo, std::memory_order_acq_rel);
         PlayerStore::playerMutex[playerId].unlock();
 
+        StateMirror::MarkPlayer(playerId);
+        Group::MarkPlayer(playerId);
+
         if (pOldPlayerInfo != nullptr)
         {
             for (const auto stream : pOldPlayerInfo->listenerStreams)
@@ -44,6 +49,9 @@ void PlayerStore::RemovePlayerFromStore(const uint16_t playerId)
     const auto pPlayerInfo = PlayerStore::playerInfo[playerId].exchange(nullptr, std::memory_order_acq_rel);
     PlayerStore::playerMutex[playerId].unlock();
 
+    StateMirror::MarkPlayer(playerId);
+    Group::MarkPlayer(playerId);
+
     if (pPlayerInfo != nullptr)
     {
         for (const auto stream : pPlayerInfo->listenerStreams)
@@ -64,12 +72,9 @@ void PlayerStore::ClearStore()
 
 bool PlayerStore::IsPlayerConnected(const uint16_t playerId) noexcept
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     assert(playerId >= 0 && playerId < MAX_PLAYERS);
 
-    return pNetGame->pPlayerPool->bIsPlayerConnected[playerId];
+    return World::IsPlayerConnected(playerId);
 }
 
 bool PlayerStore::IsPlayerHasPlugin(const uint16_t playerId) noexcept
@@ -11,30 +11,29 @@
 
 #include <cassert>
 
-#include <ysf/globals.h>
-
 #include "Network.h"
 #include "PlayerStore.h"
+#include "StateMirror.h"
+#include "World.h"
 #include "Header.h"
 
 PointStream::PointStream(const float distance, const CVector& position) : LocalStream(distance)
 {
     PackWrap(this->packetStreamUpdatePosition, SV::ControlPacketType::updateLPStreamPosition, sizeof(SV::UpdateLPStreamPositionPacket));
 
-    PackGetStruct(&*this->packetStreamUpdatePosition, SV::UpdateLPStreamPositionPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetStreamUpdatePosition, SV::UpdateLPStreamPositionPacket)->stream = this->GetHandle();
     PackGetStruct(&*this->packetStreamUpdatePosition, SV::UpdateLPStreamPositionPacket)->position = position;
 }
 
 void PointStream::UpdatePosition(const CVector& position)
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     PackGetStruct(&*this->packetStreamUpdatePosition, SV::UpdateLPStreamPositionPacket)->position = position;
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    StateMirror::MarkStream(this->GetHandle());
+
+    if (World::GetConnectedPlayersCount() != 0)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        const auto playerPoolSize = World::GetPlayerPoolSize();
 
         for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
         {
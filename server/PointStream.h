@@ -16,6 +16,8 @@
 
 class PointStream : public virtual LocalStream {
 
+    friend class StateMirror;
+
     PointStream() = delete;
     PointStream(const PointStream&) = delete;
     PointStream(PointStream&&) = delete;
@@ -0,0 +1,179 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    constexpr int64_t kTokenScale = 1000;
+}
+
+void RateLimiter::SetLimits(const uint32_t packetsPerSecond, const uint32_t bytesPerSecond, uint32_t burstTime) noexcept
+{
+    if (burstTime == 0) burstTime = kDefaultBurstTime;
+
+    RateLimiter::packetCapacity.store(static_cast<int64_t>(packetsPerSecond) * burstTime, std::memory_order_relaxed);
+    RateLimiter::byteCapacity.store(static_cast<int64_t>(bytesPerSecond) * burstTime, std::memory_order_relaxed);
+    RateLimiter::packetRate.store(packetsPerSecond, std::memory_order_relaxed);
+    RateLimiter::byteRate.store(bytesPerSecond, std::memory_order_relaxed);
+}
+
+void RateLimiter::ResetPlayer(const uint16_t playerId) noexcept
+{
+    assert(playerId >= 0 && playerId < MAX_PLAYERS);
+
+    auto& bucket = RateLimiter::buckets[playerId];
+
+    while (bucket.lock.test_and_set(std::memory_order_acquire));
+
+    bucket.packetTokens = RateLimiter::packetCapacity.load(std::memory_order_relaxed);
+    bucket.byteTokens = RateLimiter::byteCapacity.load(std::memory_order_relaxed);
+    bucket.lastTime = Timer::Get();
+    bucket.lastEventTime = 0;
+    bucket.eventDroppedPackets = 0;
+
+    bucket.lock.clear(std::memory_order_release);
+
+    bucket.droppedPackets.store(0, std::memory_order_relaxed);
+    bucket.droppedBytes.store(0, std::memory_order_relaxed);
+}
+
+bool RateLimiter::CheckPacket(const uint16_t playerId, const uint32_t packetSize) noexcept
+{
+    assert(playerId >= 0 && playerId < MAX_PLAYERS);
+
+    const auto packetRate = RateLimiter::packetRate.load(std::memory_order_relaxed);
+    const auto byteRate = RateLimiter::byteRate.load(std::memory_order_relaxed);
+
+    if (packetRate == 0 && byteRate == 0)
+    {
+        RateLimiter::passedPackets.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    const int64_t packetCost = packetRate != 0 ? kTokenScale : 0;
+    const int64_t byteCost = byteRate != 0 ? kTokenScale * packetSize : 0;
+
+    const auto curTime = Timer::Get();
+
+    auto& bucket = RateLimiter::buckets[playerId];
+
+    bool passStatus { false };
+    uint32_t eventDroppedPackets { 0 };
+
+    while (bucket.lock.test_and_set(std::memory_order_acquire));
+
+    if (curTime > bucket.lastTime)
+    {
+        const auto elapsedTime = curTime - bucket.lastTime;
+
+        bucket.packetTokens = std::min(bucket.packetTokens + elapsedTime * packetRate,
+            RateLimiter::packetCapacity.load(std::memory_order_relaxed));
+        bucket.byteTokens = std::min(bucket.byteTokens + elapsedTime * byteRate,
+            RateLimiter::byteCapacity.load(std::memory_order_relaxed));
+
+        bucket.lastTime = curTime;
+    }
+
+    if (bucket.packetTokens >= packetCost && bucket.byteTokens >= byteCost)
+    {
+        bucket.packetTokens -= packetCost;
+        bucket.byteTokens -= byteCost;
+
+        passStatus = true;
+    }
+    else
+    {
+        ++bucket.eventDroppedPackets;
+
+        if (curTime - bucket.lastEventTime >= kThrottleEventInterval)
+        {
+            eventDroppedPackets = bucket.eventDroppedPackets;
+
+            bucket.eventDroppedPackets = 0;
+            bucket.lastEventTime = curTime;
+        }
+    }
+
+    bucket.lock.clear(std::memory_order_release);
+
+    if (passStatus)
+    {
+        RateLimiter::passedPackets.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bucket.droppedPackets.fetch_add(1, std::memory_order_relaxed);
+    bucket.droppedBytes.fetch_add(packetSize, std::memory_order_relaxed);
+
+    RateLimiter::throttledPackets.fetch_add(1, std::memory_order_relaxed);
+    RateLimiter::throttledBytes.fetch_add(packetSize, std::memory_order_relaxed);
+
+    if (eventDroppedPackets != 0)
+        RateLimiter::eventQueue.try_emplace(playerId, eventDroppedPackets);
+
+    return false;
+}
+
+uint64_t RateLimiter::GetPassedPackets() noexcept
+{
+    return RateLimiter::passedPackets.load(std::memory_order_relaxed);
+}
+
+uint64_t RateLimiter::GetThrottledPackets() noexcept
+{
+    return RateLimiter::throttledPackets.load(std::memory_order_relaxed);
+}
+
+uint64_t RateLimiter::GetThrottledBytes() noexcept
+{
+    return RateLimiter::throttledBytes.load(std::memory_order_relaxed);
+}
+
+uint32_t RateLimiter::GetPlayerThrottledPackets(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return NULL;
+
+    return RateLimiter::buckets[playerId].droppedPackets.load(std::memory_order_relaxed);
+}
+
+uint32_t RateLimiter::GetPlayerThrottledBytes(const uint16_t playerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS) return NULL;
+
+    return RateLimiter::buckets[playerId].droppedBytes.load(std::memory_order_relaxed);
+}
+
+bool RateLimiter::PopThrottleEvent(uint16_t& playerId, uint32_t& droppedPackets) noexcept
+{
+    ThrottleEvent throttleEvent;
+
+    if (!RateLimiter::eventQueue.try_pop(throttleEvent))
+        return false;
+
+    playerId = throttleEvent.playerId;
+    droppedPackets = throttleEvent.droppedPackets;
+
+    return true;
+}
+
+std::atomic<int64_t> RateLimiter::packetRate { kDefaultPacketsPerSecond };
+std::atomic<int64_t> RateLimiter::byteRate { kDefaultBytesPerSecond };
+std::atomic<int64_t> RateLimiter::packetCapacity { static_cast<int64_t>(kDefaultPacketsPerSecond) * kDefaultBurstTime };
+std::atomic<int64_t> RateLimiter::byteCapacity { static_cast<int64_t>(kDefaultBytesPerSecond) * kDefaultBurstTime };
+
+std::atomic<uint64_t> RateLimiter::passedPackets { 0 };
+std::atomic<uint64_t> RateLimiter::throttledPackets { 0 };
+std::atomic<uint64_t> RateLimiter::throttledBytes { 0 };
+
+std::array<RateLimiter::Bucket, MAX_PLAYERS> RateLimiter::buckets;
+MPMCQueue<RateLimiter::ThrottleEvent> RateLimiter::eventQueue { 4 * MAX_PLAYERS };
@@ -0,0 +1,112 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <MPMCQueue.h>
+#include <util/timer.h>
+#include <ysf/structs.h>
+
+class RateLimiter {
+
+    RateLimiter() = delete;
+    ~RateLimiter() = delete;
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter(RateLimiter&&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+    RateLimiter& operator=(RateLimiter&&) = delete;
+
+    friend class RelayLink;
+
+private:
+
+    static constexpr uint32_t kDefaultPacketsPerSecond = 40;
+    static constexpr uint32_t kDefaultBytesPerSecond = 32 * 1024;
+    static constexpr uint32_t kDefaultBurstTime = 1000;
+    static constexpr Timer::time_t kThrottleEventInterval = 1000;
+
+public:
+
+    static void SetLimits(uint32_t packetsPerSecond, uint32_t bytesPerSecond, uint32_t burstTime) noexcept;
+    static void ResetPlayer(uint16_t playerId) noexcept;
+
+    // Called by worker threads for every datagram that passed the key lookup.
+    // Returns false if the packet exceeds player's packet or byte budget.
+    static bool CheckPacket(uint16_t playerId, uint32_t packetSize) noexcept;
+
+    static uint64_t GetPassedPackets() noexcept;
+    static uint64_t GetThrottledPackets() noexcept;
+    static uint64_t GetThrottledBytes() noexcept;
+    static uint32_t GetPlayerThrottledPackets(uint16_t playerId) noexcept;
+    static uint32_t GetPlayerThrottledBytes(uint16_t playerId) noexcept;
+
+    // Drained from the main thread, throttle events are reported
+    // at most once per interval for each player
+    static bool PopThrottleEvent(uint16_t& playerId, uint32_t& droppedPackets) noexcept;
+
+private:
+
+    struct alignas(64) Bucket {
+
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+        int64_t packetTokens { 0 };
+        int64_t byteTokens { 0 };
+        Timer::time_t lastTime { 0 };
+        Timer::time_t lastEventTime { 0 };
+        uint32_t eventDroppedPackets { 0 };
+
+        std::atomic<uint32_t> droppedPackets { 0 };
+        std::atomic<uint32_t> droppedBytes { 0 };
+
+    };
+
+    struct ThrottleEvent {
+
+        ThrottleEvent() noexcept = default;
+        ThrottleEvent(const ThrottleEvent&) noexcept = default;
+        ThrottleEvent(ThrottleEvent&&) noexcept = default;
+        ThrottleEvent& operator=(const ThrottleEvent&) noexcept = default;
+        ThrottleEvent& operator=(ThrottleEvent&&) noexcept = default;
+
+    public:
+
+        explicit ThrottleEvent(uint16_t playerId, uint32_t droppedPackets) noexcept
+            : playerId(playerId), droppedPackets(droppedPackets) {}
+
+        ~ThrottleEvent() noexcept = default;
+
+    public:
+
+        uint16_t playerId { NULL };
+        uint32_t droppedPackets { NULL };
+
+    };
+
+private:
+
+    // Limits are kept in thousandths of token per millisecond so that
+    // refill is a single integer multiplication per dimension
+    static std::atomic<int64_t> packetRate;
+    static std::atomic<int64_t> byteRate;
+    static std::atomic<int64_t> packetCapacity;
+    static std::atomic<int64_t> byteCapacity;
+
+    static std::atomic<uint64_t> passedPackets;
+    static std::atomic<uint64_t> throttledPackets;
+    static std::atomic<uint64_t> throttledBytes;
+
+    static std::array<Bucket, MAX_PLAYERS> buckets;
+    static MPMCQueue<ThrottleEvent> eventQueue;
+
+};
@@ -0,0 +1,252 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Recorder.h"
+
+#include <util/logger.h>
+
+#include "Tracer.h"
+
+bool Recorder::Init()
+{
+    if (Recorder::enableStatus.load(std::memory_order_relaxed))
+        return true;
+
+    if (Recorder::recordQueue == nullptr)
+        Recorder::recordQueue = std::make_unique<MPMCQueue<Record>>(kQueueSize);
+
+    Recorder::droppedRecords.store(0, std::memory_order_relaxed);
+
+    Recorder::enableStatus.store(true, std::memory_order_release);
+    Recorder::writerThread = std::make_unique<std::thread>(Recorder::WriterThread);
+
+    return true;
+}
+
+void Recorder::Free() noexcept
+{
+    if (!Recorder::enableStatus.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    // Writer drains the queue and finishes open recordings before exit
+    Recorder::writerThread->join();
+    Recorder::writerThread.reset();
+
+    if (const auto droppedRecords = Recorder::droppedRecords.load(std::memory_order_relaxed); droppedRecords != 0)
+        Logger::Log("[sv:dbg:recorder:free] : recorder stopped (dropped records:%llu)", droppedRecords);
+}
+
+bool Recorder::Open(const uint32_t stream, const std::string& fileName, const uint8_t mode) noexcept
+{
+    if (!Recorder::enableStatus.load(std::memory_order_acquire))
+        return false;
+
+    if (fileName.empty() || fileName.size() > kMaxRecordSize)
+        return false;
+
+    return Recorder::recordQueue->try_emplace(RecordType::open, stream, mode,
+        NULL, fileName.data(), fileName.size(), Latency::Now());
+}
+
+void Recorder::Close(const uint32_t stream) noexcept
+{
+    if (!Recorder::enableStatus.load(std::memory_order_acquire))
+        return;
+
+    // Rare script call may wait for writer, losing it would leave files open
+    Recorder::recordQueue->emplace(RecordType::close, stream, NULL, NULL, nullptr, 0, Latency::Now());
+}
+
+void Recorder::Push(const uint32_t stream, const VoicePacket& voicePacket) noexcept
+{
+    if (!Recorder::enableStatus.load(std::memory_order_relaxed))
+        return;
+
+    if (voicePacket.length == 0 || voicePacket.length > kMaxRecordSize || !Recorder::recordQueue->try_emplace
+        (RecordType::packet, stream, voicePacket.sender, voicePacket.packid, voicePacket.data, voicePacket.length, Latency::Now()))
+    {
+        Recorder::droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Recorder::WriterThread() noexcept
+{
+    Tracer::SetThreadName("sv-recorder");
+
+    const auto flushInterval = static_cast<Latency::tsc_t>(1e6 * kFlushInterval * Latency::GetTicksPerNanosecond());
+
+    static Record record;
+    Latency::tsc_t lastFlushTime { Latency::Now() };
+
+    while (true)
+    {
+        if (!Recorder::recordQueue->try_pop(record))
+        {
+            if (!Recorder::enableStatus.load(std::memory_order_acquire)) break;
+
+            // Pages are collected in stdio buffers and reach disk in batches
+            if (Latency::Now() - lastFlushTime >= flushInterval)
+            {
+                for (auto& [stream, recording] : Recorder::recordings)
+                {
+                    for (auto& [sender, track] : recording.tracks)
+                    {
+                        if (track.writer != nullptr) track.writer->Flush();
+                    }
+                }
+
+                lastFlushTime = Latency::Now();
+            }
+
+            SleepForMilliseconds(1);
+            continue;
+        }
+
+        switch (record.type)
+        {
+            case RecordType::open:
+            {
+                auto& recording = Recorder::recordings[record.stream];
+
+                recording.fileName.assign(reinterpret_cast<const char*>(record.data), record.length);
+                recording.mode = record.id;
+                recording.startTime = record.time;
+                recording.tracks.clear();
+
+                // Stream file exists even if nobody spoke
+                if (recording.mode == Mode::perStream)
+                    Recorder::OpenTrack(recording, SV::kMixPlayer, recording.tracks[SV::kMixPlayer]);
+
+                Logger::Log("[sv:dbg:recorder:open] : recording of stream (handle:%08x) to (%s) started",
+                    record.stream, recording.fileName.c_str());
+
+                break;
+            }
+            case RecordType::close:
+            {
+                if (const auto iter = Recorder::recordings.find(record.stream); iter != Recorder::recordings.end())
+                {
+                    Logger::Log("[sv:dbg:recorder:close] : recording of stream (handle:%08x) to (%s) "
+                        "finished (tracks:%zu)", record.stream, iter->second.fileName.c_str(), iter->second.tracks.size());
+
+                    Recorder::recordings.erase(iter);
+                }
+
+                break;
+            }
+            case RecordType::packet:
+            {
+                // Packets pushed after stop are late for their recording
+                const auto iter = Recorder::recordings.find(record.stream);
+                if (iter == Recorder::recordings.end()) break;
+
+                auto& recording = iter->second;
+
+                const uint16_t sender = recording.mode == Mode::perStream ? SV::kMixPlayer : record.id;
+
+                auto& track = recording.tracks[sender];
+
+                if (track.writer == nullptr)
+                {
+                    if (track.errorStatus) break;
+                    Recorder::OpenTrack(recording, sender, track);
+                    if (track.writer == nullptr) break;
+                }
+
+                Recorder::WritePacket(recording, track, record);
+
+                break;
+            }
+        }
+    }
+
+    Recorder::recordings.clear();
+}
+
+void Recorder::OpenTrack(Recording& recording, const uint16_t sender, Track& track) noexcept
+{
+    const auto trackFileName = recording.mode == Mode::perStream ? recording.fileName + ".opus"
+        : recording.fileName + '_' + std::to_string(sender) + ".opus";
+
+    const auto file = std::fopen(trackFileName.c_str(), "wb");
+
+    if (file == nullptr)
+    {
+        Logger::Log("[sv:err:recorder:opentrack] : failed to open file (%s)", trackFileName.c_str());
+        track.errorStatus = true;
+        return;
+    }
+
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 16);
+
+    const uint32_t serial = static_cast<uint32_t>(recording.startTime) ^ (sender * 0x9e3779b1u);
+
+    track.writer = std::make_unique<OggWriter>(file, serial);
+
+    std::vector<std::string> comments;
+
+    if (recording.mode == Mode::perSpeaker)
+        comments.emplace_back("SV_PLAYER=" + std::to_string(sender));
+
+    if (!track.writer->WriteHeaders(comments))
+    {
+        Logger::Log("[sv:err:recorder:opentrack] : failed to write file (%s)", trackFileName.c_str());
+        track.writer.reset();
+        track.errorStatus = true;
+    }
+}
+
+void Recorder::WritePacket(const Recording& recording, Track& track, const Record& record) noexcept
+{
+    static const double ticksPerSample = 1e9 * Latency::GetTicksPerNanosecond() / SV::kFrequency;
+
+    const auto samples = OggWriter::GetPacketSamples(record.data, record.length);
+    if (samples == 0) return;
+
+    // Packet numbers restart with every talk spurt, so that only numbers
+    // within a spurt tell about losses and reordering
+    if (track.lastStatus && record.packid != 0)
+    {
+        if (record.packid <= track.lastPackid) return;
+
+        if (const uint32_t lostPackets = record.packid - track.lastPackid - 1; lostPackets <= kMaxLostPackets)
+            Recorder::WriteSilence(track, static_cast<uint64_t>(lostPackets) * track.lastSamples);
+    }
+
+    track.lastStatus = true;
+    track.lastPackid = record.packid;
+    track.lastSamples = samples;
+
+    // Packet arrives when its frame is over, silence between talk spurts
+    // is restored by arrival time relative to recording start
+    const uint64_t endPosition = record.time > recording.startTime
+        ? static_cast<uint64_t>((record.time - recording.startTime) / ticksPerSample) : 0;
+    const uint64_t position = track.writer->GetGranule();
+
+    if (endPosition > position + samples + kMaxDriftFrames * SV::kFrameSizeInSamples)
+        Recorder::WriteSilence(track, endPosition - samples - position);
+
+    track.writer->WritePacket(record.data, record.length, samples);
+}
+
+void Recorder::WriteSilence(Track& track, uint64_t samples) noexcept
+{
+    for (; samples >= SV::kFrameSizeInSamples; samples -= SV::kFrameSizeInSamples)
+    {
+        track.writer->WritePacket(OggWriter::kSilenceFrame, sizeof(OggWriter::kSilenceFrame), SV::kFrameSizeInSamples);
+    }
+}
+
+std::atomic_bool Recorder::enableStatus { false };
+std::atomic<uint64_t> Recorder::droppedRecords { 0 };
+
+std::unique_ptr<MPMCQueue<Recorder::Record>> Recorder::recordQueue { nullptr };
+std::unique_ptr<std::thread> Recorder::writerThread { nullptr };
+
+std::unordered_map<uint32_t, Recorder::Recording> Recorder::recordings;
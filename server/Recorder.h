@@ -0,0 +1,162 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <MPMCQueue.h>
+
+#include "VoicePacket.h"
+#include "OggWriter.h"
+#include "Latency.h"
+#include "Header.h"
+
+// Archives voice of streams into Ogg Opus files. Packets are copied into
+// a bounded queue (dropped if it is full) and muxed by a dedicated thread,
+// so that workers never wait for disk. Gaps between packets are filled
+// with silence, every file of recording starts at the moment of start.
+class Recorder {
+
+    Recorder() = delete;
+    ~Recorder() = delete;
+    Recorder(const Recorder&) = delete;
+    Recorder(Recorder&&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    Recorder& operator=(Recorder&&) = delete;
+
+private:
+
+    static constexpr uint32_t kQueueSize = 2048;
+    static constexpr uint32_t kMaxRecordSize = 1400;
+    static constexpr uint32_t kFlushInterval = 1000;
+
+    // Lost packets within a talk spurt are replaced by silence up to that
+    // count, longer breaks are restored by arrival time
+    static constexpr uint32_t kMaxLostPackets = 10;
+    // Arrival jitter tolerated before timeline is padded by arrival time
+    static constexpr uint32_t kMaxDriftFrames = 3;
+
+public:
+
+    struct Mode
+    {
+        enum : uint8_t
+        {
+            disabled,
+            perSpeaker, // "<name>_<playerid>.opus" for every speaker
+            perStream   // "<name>.opus" with stream mix
+        };
+    };
+
+public:
+
+    static bool Init();
+    static void Free() noexcept;
+
+    // Called by script thread, files are opened by writer
+    static bool Open(uint32_t stream, const std::string& fileName, uint8_t mode) noexcept;
+    static void Close(uint32_t stream) noexcept;
+
+    // Called by workers and mixers, never blocks
+    static void Push(uint32_t stream, const VoicePacket& voicePacket) noexcept;
+
+private:
+
+    struct RecordType
+    {
+        enum : uint8_t
+        {
+            open,   // data is file name, id is mode
+            close,  // no data
+            packet  // opus frame, id is sender
+        };
+    };
+
+    struct Record {
+
+        Record() noexcept = default;
+        Record(const Record&) noexcept = default;
+        Record(Record&&) noexcept = default;
+        Record& operator=(const Record&) noexcept = default;
+        Record& operator=(Record&&) noexcept = default;
+
+    public:
+
+        explicit Record(const uint8_t type, const uint32_t stream, const uint16_t id, const uint32_t packid,
+                        const void* const data, const uint16_t length, const Latency::tsc_t time) noexcept
+            : type(type), id(id), length(length), stream(stream), packid(packid), time(time)
+        {
+            if (length != 0) std::memcpy(this->data, data, length);
+        }
+
+        ~Record() noexcept = default;
+
+    public:
+
+        uint8_t type { NULL };
+        uint16_t id { NULL };
+        uint16_t length { NULL };
+        uint32_t stream { NULL };
+        uint32_t packid { NULL };
+        Latency::tsc_t time { 0 };
+        uint8_t data[kMaxRecordSize];
+
+    };
+
+    struct Track {
+
+        std::unique_ptr<OggWriter> writer { nullptr };
+
+        uint32_t lastPackid { 0 };
+        uint32_t lastSamples { SV::kFrameSizeInSamples };
+        bool lastStatus { false };
+
+        // File could not be opened, speaker is not recorded
+        bool errorStatus { false };
+
+    };
+
+    struct Recording {
+
+        std::string fileName;
+        uint8_t mode { Mode::disabled };
+        Latency::tsc_t startTime { 0 };
+
+        // Track is created by the first packet of its speaker
+        std::unordered_map<uint16_t, Track> tracks;
+
+    };
+
+private:
+
+    static void WriterThread() noexcept;
+
+    static void OpenTrack(Recording& recording, uint16_t sender, Track& track) noexcept;
+    static void WritePacket(const Recording& recording, Track& track, const Record& record) noexcept;
+    static void WriteSilence(Track& track, uint64_t samples) noexcept;
+
+private:
+
+    static std::atomic_bool enableStatus;
+    static std::atomic<uint64_t> droppedRecords;
+
+    static std::unique_ptr<MPMCQueue<Record>> recordQueue;
+    static std::unique_ptr<std::thread> writerThread;
+
+    // Owned by writer thread
+    static std::unordered_map<uint32_t, Recording> recordings;
+
+};
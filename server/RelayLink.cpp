@@ -0,0 +1,624 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "RelayLink.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include <util/logger.h>
+
+#include "Network.h"
+#include "PlayerStore.h"
+#include "RateLimiter.h"
+#include "Stream.h"
+
+bool RelayLink::Init(const uint16_t port, const std::string& shmName, const std::string& socketPath) noexcept
+{
+    if (RelayLink::initStatus) return false;
+
+#ifdef _WIN32
+    Logger::Log("[sv:err:relay:init] : voice relay is only supported on linux");
+    return false;
+#else
+    if (port == NULL)
+    {
+        Logger::Log("[sv:err:relay:init] : relay port is not set");
+        return false;
+    }
+
+    if (!shmName.empty())
+    {
+        // Segment of the previous run may still be mapped by relay,
+        // it notices the new one by stale heartbeat of the old one
+        shm_unlink(shmName.c_str());
+
+        if (const int shmHandle = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600); shmHandle != -1)
+        {
+            if (ftruncate(shmHandle, sizeof(Relay::Shared)) == 0)
+            {
+                const auto shared = mmap(nullptr, sizeof(Relay::Shared),
+                    PROT_READ | PROT_WRITE, MAP_SHARED, shmHandle, 0);
+
+                if (shared != MAP_FAILED)
+                {
+                    RelayLink::shared = static_cast<Relay::Shared*>(shared);
+
+                    RelayLink::shared->signature = Relay::kSignature;
+                    RelayLink::shared->version = Relay::kVersion;
+                    RelayLink::shared->pluginHeartbeat.store(RelayLink::GetTime(), std::memory_order_release);
+                }
+                else Logger::Log("[sv:err:relay:init] : mmap error (code:%d)", errno);
+            }
+            else Logger::Log("[sv:err:relay:init] : ftruncate error (code:%d)", errno);
+
+            close(shmHandle);
+        }
+        else Logger::Log("[sv:err:relay:init] : shm_open error (code:%d)", errno);
+
+        if (RelayLink::shared == nullptr)
+            shm_unlink(shmName.c_str());
+    }
+
+    if (RelayLink::shared == nullptr)
+    {
+        sockaddr_un bindAddr {};
+
+        if (socketPath.empty() || socketPath.size() >= sizeof(bindAddr.sun_path))
+        {
+            Logger::Log("[sv:err:relay:init] : invalid relay socket path (%s)", socketPath.c_str());
+            return false;
+        }
+
+        if ((RelayLink::listenSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1)
+        {
+            Logger::Log("[sv:err:relay:init] : socket error (code:%d)", errno);
+            return false;
+        }
+
+        bindAddr.sun_family = AF_UNIX;
+        std::memcpy(bindAddr.sun_path, socketPath.c_str(), socketPath.size());
+
+        unlink(socketPath.c_str());
+
+        if (bind(RelayLink::listenSocket, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) == -1 ||
+            listen(RelayLink::listenSocket, 1) == -1)
+        {
+            Logger::Log("[sv:err:relay:init] : bind error (code:%d)", errno);
+            close(RelayLink::listenSocket);
+            RelayLink::listenSocket = -1;
+            return false;
+        }
+    }
+
+    RelayLink::port = port;
+    RelayLink::shmName = shmName;
+    RelayLink::socketPath = socketPath;
+
+    RelayLink::attachStatus.store(false, std::memory_order_release);
+    RelayLink::resyncStatus.store(false, std::memory_order_relaxed);
+    RelayLink::lostStatus.store(false, std::memory_order_relaxed);
+    RelayLink::relayEpoch = 0;
+
+    if (RelayLink::shared != nullptr)
+        Logger::Log("[sv:dbg:relay:init] : waiting for relay on shared memory (%s)", shmName.c_str());
+    else
+        Logger::Log("[sv:dbg:relay:init] : waiting for relay on socket (%s)", socketPath.c_str());
+
+    RelayLink::initStatus = true;
+
+    return true;
+#endif
+}
+
+void RelayLink::Free() noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+#ifndef _WIN32
+    RelayLink::Detach();
+
+    if (RelayLink::shared != nullptr)
+    {
+        RelayLink::shared->pluginClosed.store(true, std::memory_order_release);
+
+        munmap(RelayLink::shared, sizeof(Relay::Shared));
+        shm_unlink(RelayLink::shmName.c_str());
+
+        RelayLink::shared = nullptr;
+    }
+
+    if (RelayLink::listenSocket != -1)
+    {
+        close(RelayLink::listenSocket);
+        unlink(RelayLink::socketPath.c_str());
+
+        RelayLink::listenSocket = -1;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock { RelayLink::eventsMutex };
+        RelayLink::identifiedPlayers.clear();
+    }
+#endif
+
+    RelayLink::initStatus = false;
+}
+
+uint16_t RelayLink::GetPort() noexcept
+{
+    return RelayLink::port;
+}
+
+void RelayLink::Process() noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    RelayLink::Attach();
+
+    if (RelayLink::attachStatus.load(std::memory_order_relaxed) &&
+        RelayLink::resyncStatus.load(std::memory_order_relaxed))
+    {
+        RelayLink::Resync();
+    }
+}
+
+bool RelayLink::PopIdentifiedPlayer(uint16_t& playerId, uint32_t& address, uint16_t& port) noexcept
+{
+    const std::lock_guard<std::mutex> lock { RelayLink::eventsMutex };
+
+    if (RelayLink::identifiedPlayers.empty()) return false;
+
+    const auto& identifiedPlayer = RelayLink::identifiedPlayers.front();
+
+    playerId = identifiedPlayer.player;
+    address = identifiedPlayer.address;
+    port = identifiedPlayer.port;
+
+    RelayLink::identifiedPlayers.pop_front();
+
+    return true;
+}
+
+void RelayLink::PublishPlayer(const uint16_t playerId) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    Relay::PlayerConnectRecord record {};
+
+    record.player = playerId;
+
+    {
+        const std::shared_lock<std::shared_mutex> lock { Network::playerKeyToPlayerIdTableMutex };
+
+        const auto playerKey = Network::playerKeyTable[playerId];
+        const auto& authKey = Network::playerAuthTable[playerId];
+
+        record.address = static_cast<uint32_t>(playerKey >> 32);
+        record.svrkey = static_cast<uint32_t>(playerKey);
+        record.compact = Network::playerCompactTable[playerId].load(std::memory_order_relaxed);
+        record.auth = authKey.status;
+        record.k0 = authKey.k0;
+        record.k1 = authKey.k1;
+    }
+
+    // Relay that restarted doesn't have to wait for player's next packet
+    if (const auto playerAddr = std::atomic_load(&Network::playerAddrTable[playerId]); playerAddr != nullptr)
+    {
+        record.endpointAddress = playerAddr->sin_addr.s_addr;
+        record.endpointPort = playerAddr->sin_port;
+    }
+
+    RelayLink::Write(Relay::RecordType::playerConnect, &record, sizeof(record));
+}
+
+void RelayLink::PublishPlayerDisconnect(const uint16_t playerId) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::PlayerRecord record { playerId };
+
+    RelayLink::Write(Relay::RecordType::playerDisconnect, &record, sizeof(record));
+}
+
+void RelayLink::PublishPlayerSpeak(const uint16_t playerId) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    bool speakStatus { false };
+
+    // Same condition as workers check for every packet
+    const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
+    if (pPlayerInfo != nullptr) speakStatus = !pPlayerInfo->muteStatus.load(std::memory_order_relaxed) &&
+        (pPlayerInfo->recordStatus.load(std::memory_order_relaxed) || !pPlayerInfo->keys.empty());
+    PlayerStore::ReleasePlayerWithSharedAccess(playerId);
+
+    const Relay::PlayerStatusRecord record { playerId, speakStatus };
+
+    RelayLink::Write(Relay::RecordType::playerSpeak, &record, sizeof(record));
+}
+
+void RelayLink::PublishVoiceAuthMode(const uint8_t mode) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::VoiceAuthModeRecord record { mode };
+
+    RelayLink::Write(Relay::RecordType::voiceAuthMode, &record, sizeof(record));
+}
+
+void RelayLink::PublishRateLimit(const uint32_t packetsPerSecond, const uint32_t bytesPerSecond, const uint32_t burstTime) noexcept
+{
+    RelayLink::rateLimit = { packetsPerSecond, bytesPerSecond, burstTime };
+
+    if (!RelayLink::initStatus) return;
+
+    RelayLink::Write(Relay::RecordType::rateLimit, &RelayLink::rateLimit, sizeof(RelayLink::rateLimit));
+}
+
+void RelayLink::PublishStream(const uint32_t stream, const bool relayStatus) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::StreamStatusRecord record { stream, relayStatus };
+
+    RelayLink::Write(Relay::RecordType::streamRelay, &record, sizeof(record));
+}
+
+void RelayLink::PublishStreamDelete(const uint32_t stream) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::StreamRecord record { stream };
+
+    RelayLink::Write(Relay::RecordType::streamDelete, &record, sizeof(record));
+}
+
+void RelayLink::PublishListener(const uint32_t stream, const uint16_t playerId, const uint8_t layerStatus) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::MemberRecord record { stream, playerId, layerStatus };
+
+    RelayLink::Write(Relay::RecordType::listener, &record, sizeof(record));
+}
+
+void RelayLink::PublishSpeaker(const uint32_t stream, const uint16_t playerId, const bool status) noexcept
+{
+    if (!RelayLink::initStatus) return;
+
+    const Relay::MemberRecord record { stream, playerId, status };
+
+    RelayLink::Write(Relay::RecordType::speaker, &record, sizeof(record));
+}
+
+bool RelayLink::SendVoicePacket(const uint16_t playerId, const VoicePacket& voicePacket) noexcept
+{
+    const Relay::PlayerRecord record { playerId };
+
+    return RelayLink::Write(Relay::RecordType::voicePacket, &record, sizeof(record),
+        &voicePacket, voicePacket.GetFullSize());
+}
+
+VoicePacketContainerPtr RelayLink::ReceiveVoicePacket(Latency::tsc_t& receiveTime)
+{
+    alignas(8) uint8_t buffer[Relay::kMaxRecordSize];
+
+    uint8_t type { Relay::RecordType::padding };
+    uint32_t size { 0 };
+
+    bool readStatus { false };
+
+    {
+        const std::lock_guard<std::mutex> lock { RelayLink::readMutex };
+        readStatus = RelayLink::Read(type, buffer, size);
+    }
+
+    if (!readStatus)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kEmptyWaitTime));
+        return nullptr;
+    }
+
+    switch (type)
+    {
+        case Relay::RecordType::hello:
+        {
+            if (size < sizeof(Relay::HelloRecord)) break;
+
+            Relay::HelloRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            if (record.version != Relay::kVersion || record.port != RelayLink::port)
+            {
+                Logger::Log("[sv:err:relay:receive] : relay (version:%u, port:%hu) doesn't match "
+                    "plugin (version:%u, port:%hu)", record.version, record.port, Relay::kVersion, RelayLink::port);
+            }
+        } break;
+        case Relay::RecordType::playerIdentified:
+        {
+            if (size < sizeof(Relay::PlayerAddressRecord)) break;
+
+            Relay::PlayerAddressRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            const std::lock_guard<std::mutex> lock { RelayLink::eventsMutex };
+            RelayLink::identifiedPlayers.emplace_back(record);
+        } break;
+        case Relay::RecordType::voiceFrame:
+        {
+            if (size < sizeof(Relay::FrameRecord) + sizeof(VoicePacket)) break;
+
+            Relay::FrameRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            const auto voicePacketPtr = reinterpret_cast<const VoicePacket*>(buffer + sizeof(record));
+            const uint32_t voicePacketSize = size - sizeof(record);
+
+            if (voicePacketPtr->GetFullSize() != voicePacketSize) break;
+
+            receiveTime = record.receiveTime;
+
+            return MakeVoicePacketContainer(voicePacketPtr, voicePacketSize);
+        }
+    }
+
+    return nullptr;
+}
+
+void RelayLink::Attach() noexcept
+{
+#ifndef _WIN32
+    const auto curTime = RelayLink::GetTime();
+
+    if (RelayLink::shared != nullptr)
+    {
+        RelayLink::shared->pluginHeartbeat.store(curTime, std::memory_order_release);
+
+        const auto relayEpoch = RelayLink::shared->relayEpoch.load(std::memory_order_acquire);
+        const bool aliveStatus = curTime - RelayLink::shared->relayHeartbeat.load
+            (std::memory_order_acquire) < Relay::kHeartbeatTimeout;
+
+        // Relay that stalled for a while is given full state as well
+        if (aliveStatus && (relayEpoch != RelayLink::relayEpoch || !RelayLink::attachStatus.load(std::memory_order_relaxed)))
+        {
+            RelayLink::relayEpoch = relayEpoch;
+            RelayLink::attachStatus.store(true, std::memory_order_release);
+
+            Logger::Log("[sv:dbg:relay:attach] : relay attached (epoch:%u)", relayEpoch);
+
+            RelayLink::Resync();
+        }
+        else if (!aliveStatus && RelayLink::attachStatus.load(std::memory_order_relaxed))
+        {
+            RelayLink::attachStatus.store(false, std::memory_order_release);
+
+            Logger::Log("[sv:err:relay:attach] : relay stopped responding, voice is down until it's back");
+        }
+
+        return;
+    }
+
+    if (RelayLink::lostStatus.exchange(false, std::memory_order_relaxed))
+    {
+        RelayLink::Detach();
+
+        Logger::Log("[sv:err:relay:attach] : relay disconnected, voice is down until it's back");
+    }
+
+    if (const int socketHandle = accept4(RelayLink::listenSocket, nullptr, nullptr,
+        SOCK_NONBLOCK | SOCK_CLOEXEC); socketHandle != -1)
+    {
+        const auto bufferSize { kSocketBufferSize };
+
+        setsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+        setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+        RelayLink::Detach();
+
+        {
+            const std::scoped_lock lock { RelayLink::writeMutex, RelayLink::readMutex };
+            RelayLink::socketHandle = socketHandle;
+        }
+
+        RelayLink::attachStatus.store(true, std::memory_order_release);
+
+        Logger::Log("[sv:dbg:relay:attach] : relay connected");
+
+        RelayLink::Resync();
+    }
+#endif
+}
+
+void RelayLink::Detach() noexcept
+{
+#ifndef _WIN32
+    RelayLink::attachStatus.store(false, std::memory_order_release);
+
+    const std::scoped_lock lock { RelayLink::writeMutex, RelayLink::readMutex };
+
+    if (RelayLink::socketHandle != -1)
+    {
+        close(RelayLink::socketHandle);
+        RelayLink::socketHandle = -1;
+    }
+#endif
+}
+
+void RelayLink::Resync() noexcept
+{
+    RelayLink::resyncStatus.store(false, std::memory_order_relaxed);
+
+    if (!RelayLink::Write(Relay::RecordType::reset, nullptr, 0))
+        return;
+
+    RelayLink::PublishVoiceAuthMode(Network::voiceAuthMode.load(std::memory_order_relaxed));
+    RelayLink::Write(Relay::RecordType::rateLimit, &RelayLink::rateLimit, sizeof(RelayLink::rateLimit));
+
+    uint32_t playersCount { 0 };
+
+    for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+    {
+        if (!Network::playerStatusTable[iPlayerId].load(std::memory_order_acquire))
+            continue;
+
+        RelayLink::PublishPlayer(iPlayerId);
+        RelayLink::PublishPlayerSpeak(iPlayerId);
+
+        ++playersCount;
+    }
+
+    Stream::streamTable.ForEach([](Stream* const stream)
+    {
+        RelayLink::PublishStream(stream->handle, stream->IsRelayed());
+
+        for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+        {
+            if (stream->HasListener(iPlayerId))
+            {
+                RelayLink::PublishListener(stream->handle, iPlayerId, stream->lowLayerListeners[iPlayerId].load
+                    (std::memory_order_relaxed) != 0 ? Relay::LayerStatus::low : Relay::LayerStatus::main);
+            }
+
+            if (stream->HasSpeaker(iPlayerId))
+                RelayLink::PublishSpeaker(stream->handle, iPlayerId, true);
+        }
+    });
+
+    Logger::Log("[sv:dbg:relay:resync] : sent state of %u players and %zu streams%s", playersCount,
+        Stream::GetStreamsCount(), RelayLink::resyncStatus.load(std::memory_order_relaxed) ? ", incomplete" : "");
+}
+
+bool RelayLink::Write(const uint8_t type, const void* const header, const uint32_t headerSize,
+    const void* const payload, const uint32_t payloadSize) noexcept
+{
+    if (!RelayLink::attachStatus.load(std::memory_order_acquire))
+        return false;
+
+    bool writeStatus { false };
+
+#ifndef _WIN32
+    {
+        const std::lock_guard<std::mutex> lock { RelayLink::writeMutex };
+
+        if (RelayLink::shared != nullptr)
+        {
+            writeStatus = RelayLink::shared->downstream.Write(type, header, headerSize, payload, payloadSize);
+        }
+        else if (RelayLink::socketHandle != -1 && sizeof(Relay::RecordHeader) +
+            headerSize + payloadSize <= Relay::kMaxRecordSize)
+        {
+            const Relay::RecordHeader recordHeader { static_cast<uint16_t>(headerSize + payloadSize), type, 0 };
+
+            iovec buffers[3] {
+                { const_cast<Relay::RecordHeader*>(&recordHeader), sizeof(recordHeader) },
+                { const_cast<void*>(header), headerSize },
+                { const_cast<void*>(payload), payloadSize }
+            };
+
+            msghdr message {};
+
+            message.msg_iov = buffers;
+            message.msg_iovlen = 3;
+
+            const auto result = sendmsg(RelayLink::socketHandle, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            writeStatus = result == static_cast<decltype(result)>(sizeof(recordHeader) + headerSize + payloadSize);
+
+            if (result == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+                RelayLink::lostStatus.store(true, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    // Relay state can't be patched after a lost update, so it's sent anew
+    if (!writeStatus && type != Relay::RecordType::voicePacket)
+        RelayLink::resyncStatus.store(true, std::memory_order_relaxed);
+
+    return writeStatus;
+}
+
+bool RelayLink::Read(uint8_t& type, void* const buffer, uint32_t& size) noexcept
+{
+    if (!RelayLink::attachStatus.load(std::memory_order_acquire))
+        return false;
+
+#ifndef _WIN32
+    if (RelayLink::shared != nullptr)
+        return RelayLink::shared->upstream.Read(type, buffer, size);
+
+    if (RelayLink::socketHandle == -1)
+        return false;
+
+    Relay::RecordHeader recordHeader;
+
+    iovec buffers[2] {
+        { &recordHeader, sizeof(recordHeader) },
+        { buffer, Relay::kMaxRecordSize }
+    };
+
+    msghdr message {};
+
+    message.msg_iov = buffers;
+    message.msg_iovlen = 2;
+
+    const auto result = recvmsg(RelayLink::socketHandle, &message, MSG_DONTWAIT);
+
+    if (result == 0 || (result == -1 && errno != EAGAIN && errno != EWOULDBLOCK))
+        RelayLink::lostStatus.store(true, std::memory_order_relaxed);
+
+    if (result < static_cast<decltype(result)>(sizeof(recordHeader)) ||
+        recordHeader.size != result - sizeof(recordHeader))
+        return false;
+
+    type = recordHeader.type;
+    size = recordHeader.size;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+int64_t RelayLink::GetTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool RelayLink::initStatus { false };
+
+uint16_t RelayLink::port { NULL };
+std::string RelayLink::shmName;
+std::string RelayLink::socketPath;
+
+Relay::Shared* RelayLink::shared { nullptr };
+int RelayLink::listenSocket { -1 };
+int RelayLink::socketHandle { -1 };
+
+std::atomic_bool RelayLink::attachStatus { false };
+std::atomic_bool RelayLink::resyncStatus { false };
+std::atomic_bool RelayLink::lostStatus { false };
+uint32_t RelayLink::relayEpoch { 0 };
+
+Relay::RateLimitRecord RelayLink::rateLimit { RateLimiter::kDefaultPacketsPerSecond,
+    RateLimiter::kDefaultBytesPerSecond, RateLimiter::kDefaultBurstTime };
+
+std::mutex RelayLink::writeMutex;
+std::mutex RelayLink::readMutex;
+
+std::mutex RelayLink::eventsMutex;
+std::deque<Relay::PlayerAddressRecord> RelayLink::identifiedPlayers;
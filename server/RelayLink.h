@@ -0,0 +1,120 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "RelayProtocol.h"
+#include "VoicePacket.h"
+#include "Latency.h"
+
+class Stream;
+
+// Plugin side of external voice relay (tools/relay). When enabled, relay owns
+// voice socket and forwards speakers of relayed streams by itself, plugin keeps
+// it in sync with players, their keys and stream membership. Streams that are
+// mixed, recorded or exported are not relayed, relay passes their speakers'
+// packets to plugin workers and plugin sends the result back through relay.
+// Relay may be restarted at any time, plugin sends full state every time
+// relay attaches. Only available on Linux.
+class RelayLink {
+
+    RelayLink() = delete;
+    ~RelayLink() = delete;
+    RelayLink(const RelayLink&) = delete;
+    RelayLink(RelayLink&&) = delete;
+    RelayLink& operator=(const RelayLink&) = delete;
+    RelayLink& operator=(RelayLink&&) = delete;
+
+private:
+
+    static constexpr uint32_t kSocketBufferSize = 4 * 1024 * 1024;
+    static constexpr uint32_t kEmptyWaitTime = 1;
+
+public:
+
+    // Clients are told to send voice to 'port' that relay has to listen on,
+    // shared memory is tried first and unix socket is the fallback
+    static bool Init(uint16_t port, const std::string& shmName, const std::string& socketPath) noexcept;
+    static void Free() noexcept;
+
+    static inline bool IsEnabled() noexcept
+    {
+        return RelayLink::initStatus;
+    }
+
+    static uint16_t GetPort() noexcept;
+
+    // Called every tick, attaches relay and resends state to it
+    static void Process() noexcept;
+
+    // Drained from the main thread, relay learns players' addresses from their first packets
+    static bool PopIdentifiedPlayer(uint16_t& playerId, uint32_t& address, uint16_t& port) noexcept;
+
+    // Player's key, header format and auth key are taken from network
+    static void PublishPlayer(uint16_t playerId) noexcept;
+    static void PublishPlayerDisconnect(uint16_t playerId) noexcept;
+    static void PublishPlayerSpeak(uint16_t playerId) noexcept;
+    static void PublishVoiceAuthMode(uint8_t mode) noexcept;
+    static void PublishRateLimit(uint32_t packetsPerSecond, uint32_t bytesPerSecond, uint32_t burstTime) noexcept;
+    static void PublishStream(uint32_t stream, bool relayStatus) noexcept;
+    static void PublishStreamDelete(uint32_t stream) noexcept;
+    static void PublishListener(uint32_t stream, uint16_t playerId, uint8_t layerStatus) noexcept;
+    static void PublishSpeaker(uint32_t stream, uint16_t playerId, bool status) noexcept;
+
+    static bool SendVoicePacket(uint16_t playerId, const VoicePacket& voicePacket) noexcept;
+
+    // Called by workers, waits a little if relay has nothing for plugin
+    static VoicePacketContainerPtr ReceiveVoicePacket(Latency::tsc_t& receiveTime);
+
+private:
+
+    static void Attach() noexcept;
+    static void Detach() noexcept;
+    static void Resync() noexcept;
+
+    static bool Write(uint8_t type, const void* header, uint32_t headerSize,
+        const void* payload = nullptr, uint32_t payloadSize = 0) noexcept;
+    static bool Read(uint8_t& type, void* buffer, uint32_t& size) noexcept;
+
+    static int64_t GetTime() noexcept;
+
+private:
+
+    static bool initStatus;
+
+    static uint16_t port;
+    static std::string shmName;
+    static std::string socketPath;
+
+    // Either shared memory or listening socket is used
+    static Relay::Shared* shared;
+    static int listenSocket;
+    static int socketHandle;
+
+    static std::atomic_bool attachStatus;
+    static std::atomic_bool resyncStatus;
+    static std::atomic_bool lostStatus;
+    static uint32_t relayEpoch;
+
+    // Kept for resync, limiter doesn't store limits in this form
+    static Relay::RateLimitRecord rateLimit;
+
+    static std::mutex writeMutex;
+    static std::mutex readMutex;
+
+    static std::mutex eventsMutex;
+    static std::deque<Relay::PlayerAddressRecord> identifiedPlayers;
+
+};
@@ -0,0 +1,266 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Format of the link between plugin and external relay (tools/relay). Plugin
+// publishes players, their keys and stream membership to relay that owns voice
+// socket and does fan-out, relay returns identified players and the packets
+// that plugin has to process itself. Link is a pair of rings in shared memory
+// created by plugin or, if it's unavailable, a unix seqpacket socket carrying
+// the same records, one per message.
+namespace Relay
+{
+    constexpr uint32_t kSignature = 0x4c525653; // "SVRL"
+    constexpr uint32_t kVersion = 1;
+
+    constexpr uint32_t kRingSize = 4 * 1024 * 1024;
+    constexpr uint32_t kMaxRecordSize = 2048;
+
+    // Side is considered gone if it didn't update its heartbeat for this time
+    constexpr int64_t kHeartbeatInterval = 100;
+    constexpr int64_t kHeartbeatTimeout = 2000;
+
+    struct RecordType
+    {
+        enum : uint8_t
+        {
+            padding,
+
+            // plugin -> relay
+            // ---------------------
+
+            reset,              // relay drops its state, snapshot follows
+            voiceAuthMode,      // VoiceAuthModeRecord
+            rateLimit,          // RateLimitRecord
+            playerConnect,      // PlayerConnectRecord
+            playerDisconnect,   // PlayerRecord
+            playerSpeak,        // PlayerStatusRecord, speaker isn't muted and may talk
+            streamRelay,        // StreamStatusRecord, relay forwards speakers of the stream
+            streamDelete,       // StreamRecord
+            listener,           // MemberRecord, status is LayerStatus
+            speaker,            // MemberRecord
+            voicePacket,        // PlayerRecord followed by voice packet to send to the player
+
+            // relay -> plugin
+            // ---------------------
+
+            hello,              // HelloRecord
+            playerIdentified,   // PlayerAddressRecord
+            voiceFrame          // FrameRecord followed by voice packet of player
+        };
+    };
+
+    struct LayerStatus
+    {
+        enum : uint8_t
+        {
+            detached,
+            main,
+            low
+        };
+    };
+
+#pragma pack(push, 1)
+
+    struct RecordHeader
+    {
+        uint16_t size;
+        uint8_t type;
+        uint8_t reserved;
+    };
+
+    struct VoiceAuthModeRecord
+    {
+        uint8_t mode;
+    };
+
+    struct RateLimitRecord
+    {
+        uint32_t packetsPerSecond;
+        uint32_t bytesPerSecond;
+        uint32_t burstTime;
+    };
+
+    struct PlayerConnectRecord
+    {
+        uint16_t player;
+        uint32_t address;
+        uint32_t svrkey;
+        uint8_t compact;
+        uint8_t auth;
+        uint64_t k0;
+        uint64_t k1;
+
+        // Voice address if player is already identified, zero otherwise
+        uint32_t endpointAddress;
+        uint16_t endpointPort;
+    };
+
+    struct PlayerRecord
+    {
+        uint16_t player;
+    };
+
+    struct PlayerStatusRecord
+    {
+        uint16_t player;
+        uint8_t status;
+    };
+
+    struct StreamRecord
+    {
+        uint32_t stream;
+    };
+
+    struct StreamStatusRecord
+    {
+        uint32_t stream;
+        uint8_t status;
+    };
+
+    struct MemberRecord
+    {
+        uint32_t stream;
+        uint16_t player;
+        uint8_t status;
+    };
+
+    struct HelloRecord
+    {
+        uint32_t version;
+        uint16_t port;
+    };
+
+    struct PlayerAddressRecord
+    {
+        uint16_t player;
+        uint32_t address;
+        uint16_t port;
+    };
+
+    struct FrameRecord
+    {
+        uint64_t receiveTime;
+    };
+
+#pragma pack(pop)
+
+    // Single producer, single consumer ring of records. Positions grow
+    // monotonically, record that doesn't fit before the end of ring is
+    // preceded by padding up to the end.
+    struct Ring
+    {
+        alignas(64) std::atomic<uint32_t> head;
+        alignas(64) std::atomic<uint32_t> tail;
+        alignas(64) uint8_t data[kRingSize];
+
+        bool Write(const uint8_t type, const void* const header, const uint32_t headerSize,
+            const void* const payload = nullptr, const uint32_t payloadSize = 0) noexcept
+        {
+            const uint32_t recordSize = Align(sizeof(RecordHeader) + headerSize + payloadSize);
+            if (recordSize > kMaxRecordSize) return false;
+
+            const uint32_t curHead = this->head.load(std::memory_order_relaxed);
+            const uint32_t curTail = this->tail.load(std::memory_order_acquire);
+
+            const uint32_t position = curHead % kRingSize;
+            const uint32_t paddingSize = kRingSize - position < recordSize ? kRingSize - position : 0;
+
+            if (kRingSize - (curHead - curTail) < paddingSize + recordSize)
+                return false;
+
+            if (paddingSize != 0)
+            {
+                const RecordHeader padding { 0, RecordType::padding, 0 };
+                std::memcpy(this->data + position, &padding, sizeof(padding));
+            }
+
+            uint8_t* const record = this->data + (position + paddingSize) % kRingSize;
+            const RecordHeader recordHeader { static_cast<uint16_t>(headerSize + payloadSize), type, 0 };
+
+            std::memcpy(record, &recordHeader, sizeof(recordHeader));
+            if (headerSize != 0) std::memcpy(record + sizeof(recordHeader), header, headerSize);
+            if (payloadSize != 0) std::memcpy(record + sizeof(recordHeader) + headerSize, payload, payloadSize);
+
+            this->head.store(curHead + paddingSize + recordSize, std::memory_order_release);
+
+            return true;
+        }
+
+        // 'buffer' must have room for kMaxRecordSize bytes
+        bool Read(uint8_t& type, void* const buffer, uint32_t& size) noexcept
+        {
+            uint32_t curTail = this->tail.load(std::memory_order_relaxed);
+            const uint32_t curHead = this->head.load(std::memory_order_acquire);
+
+            while (curTail != curHead)
+            {
+                const uint32_t position = curTail % kRingSize;
+
+                RecordHeader recordHeader;
+                std::memcpy(&recordHeader, this->data + position, sizeof(recordHeader));
+
+                if (recordHeader.type == RecordType::padding)
+                {
+                    curTail += kRingSize - position;
+                    continue;
+                }
+
+                type = recordHeader.type;
+                size = recordHeader.size;
+
+                std::memcpy(buffer, this->data + position + sizeof(recordHeader), size);
+
+                this->tail.store(curTail + Align(sizeof(recordHeader) + size), std::memory_order_release);
+
+                return true;
+            }
+
+            this->tail.store(curTail, std::memory_order_release);
+
+            return false;
+        }
+
+        // Consumer drops everything written before
+        void Skip() noexcept
+        {
+            this->tail.store(this->head.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+    private:
+
+        static constexpr uint32_t Align(const uint32_t size) noexcept
+        {
+            return (size + 3) & ~3u;
+        }
+    };
+
+    // Created by plugin, relay attaches to it by name
+    struct Shared
+    {
+        uint32_t signature;
+        uint32_t version;
+
+        // Relay bumps epoch when it attaches, plugin answers with snapshot
+        std::atomic<uint32_t> relayEpoch;
+
+        // Milliseconds of CLOCK_MONOTONIC, shared by processes of one host
+        std::atomic<int64_t> pluginHeartbeat;
+        std::atomic<int64_t> relayHeartbeat;
+        std::atomic<uint8_t> pluginClosed;
+
+        Ring downstream; // plugin -> relay
+        Ring upstream;   // relay -> plugin
+    };
+}
@@ -0,0 +1,161 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Generational slot map handing out 32-bit handles for objects referenced
+// by scripts and clients. Handle packs slot index (low 16 bits) with slot
+// generation (next 15 bits), the generation is bumped every time the slot
+// is released, so handle of a removed object never resolves to an object
+// that reused its slot. Handles are positive cells and never zero.
+// Not thread-safe, used from the main thread only.
+template<class ObjectType>
+class SlotMap {
+
+    SlotMap(const SlotMap&) = delete;
+    SlotMap(SlotMap&&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+    SlotMap& operator=(SlotMap&&) = delete;
+
+public:
+
+    using handle_t = uint32_t;
+
+    static constexpr handle_t kInvalidHandle = 0;
+
+private:
+
+    static constexpr uint32_t kIndexBits = 16;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kGenerationMask = 0x7fff;
+    static constexpr uint32_t kNoneSlot = UINT32_MAX;
+
+public:
+
+    SlotMap() noexcept = default;
+    ~SlotMap() noexcept = default;
+
+public:
+
+    // Returns kInvalidHandle when all slots are taken
+    handle_t Insert(ObjectType* const object)
+    {
+        uint32_t index;
+
+        // Released slots are reused in FIFO order, that makes a stale
+        // handle wait for as many reuses as possible before it may collide
+        if (this->freeHead != kNoneSlot)
+        {
+            index = this->freeHead;
+            this->freeHead = this->slots[index].nextFree;
+            if (this->freeHead == kNoneSlot) this->freeTail = kNoneSlot;
+        }
+        else if (this->slots.size() <= kIndexMask)
+        {
+            index = static_cast<uint32_t>(this->slots.size());
+            this->slots.emplace_back();
+        }
+        else return kInvalidHandle;
+
+        auto& slot = this->slots[index];
+
+        slot.object = object;
+        slot.nextFree = kNoneSlot;
+
+        ++this->objectsCount;
+
+        return SlotMap::MakeHandle(index, slot.generation);
+    }
+
+    bool Remove(const handle_t handle) noexcept
+    {
+        const auto index = handle & kIndexMask;
+
+        if (this->Get(handle) == nullptr) return false;
+
+        auto& slot = this->slots[index];
+
+        slot.object = nullptr;
+        slot.generation = (slot.generation & kGenerationMask) + 1;
+        if (slot.generation > kGenerationMask) slot.generation = 1;
+
+        if (this->freeTail != kNoneSlot) this->slots[this->freeTail].nextFree = index;
+        else this->freeHead = index;
+
+        this->freeTail = index;
+
+        --this->objectsCount;
+
+        return true;
+    }
+
+    ObjectType* Get(const handle_t handle) const noexcept
+    {
+        const auto index = handle & kIndexMask;
+
+        if (index >= this->slots.size()) return nullptr;
+
+        const auto& slot = this->slots[index];
+
+        if (SlotMap::MakeHandle(index, slot.generation) != handle)
+            return nullptr;
+
+        return slot.object;
+    }
+
+    std::size_t GetCount() const noexcept
+    {
+        return this->objectsCount;
+    }
+
+    template<class FunctionType>
+    void ForEach(FunctionType&& function) const
+    {
+        for (const auto& slot : this->slots)
+        {
+            if (slot.object != nullptr) function(slot.object);
+        }
+    }
+
+    // Index is unique among live objects and stays below 65536
+    static uint32_t GetIndex(const handle_t handle) noexcept
+    {
+        return handle & kIndexMask;
+    }
+
+private:
+
+    static handle_t MakeHandle(const uint32_t index, const uint32_t generation) noexcept
+    {
+        return (generation << kIndexBits) | index;
+    }
+
+private:
+
+    struct Slot {
+
+        ObjectType* object { nullptr };
+        uint32_t generation { 1 };
+        uint32_t nextFree { kNoneSlot };
+
+    };
+
+private:
+
+    std::vector<Slot> slots;
+
+    uint32_t freeHead { kNoneSlot };
+    uint32_t freeTail { kNoneSlot };
+
+    std::size_t objectsCount { 0 };
+
+};
@@ -0,0 +1,108 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "SourcePool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include "PacedTicker.h"
+#include "Tracer.h"
+#include "Header.h"
+
+bool SourcePool::Init()
+{
+    if (SourcePool::initStatus) return false;
+
+    SourcePool::status.store(true);
+    SourcePool::thread = std::thread(SourcePool::ThreadFunc);
+
+    SourcePool::initStatus = true;
+
+    return true;
+}
+
+void SourcePool::Free() noexcept
+{
+    if (!SourcePool::initStatus) return;
+
+    SourcePool::status.store(false);
+
+    if (SourcePool::thread.joinable())
+        SourcePool::thread.join();
+
+    SourcePool::initStatus = false;
+}
+
+void SourcePool::Register(AudioSource* const source)
+{
+    const std::unique_lock<std::shared_mutex> lock { SourcePool::sourcesMutex };
+
+    SourcePool::sources.emplace_back(source);
+}
+
+void SourcePool::Unregister(AudioSource* const source) noexcept
+{
+    const std::unique_lock<std::shared_mutex> lock { SourcePool::sourcesMutex };
+
+    const auto iter = std::find(SourcePool::sources.begin(), SourcePool::sources.end(), source);
+    if (iter != SourcePool::sources.end()) SourcePool::sources.erase(iter);
+}
+
+void SourcePool::DetachStream(const Stream* const stream) noexcept
+{
+    const std::unique_lock<std::shared_mutex> lock { SourcePool::sourcesMutex };
+
+    SourcePool::sources.erase(std::remove_if(SourcePool::sources.begin(), SourcePool::sources.end(),
+        [stream](AudioSource* const source) noexcept
+        {
+            if (source->stream != stream) return false;
+
+            source->playStatus.store(false, std::memory_order_relaxed);
+            source->stream = nullptr;
+
+            return true;
+        }),
+        SourcePool::sources.end());
+}
+
+uint32_t SourcePool::GetSourcesCount() noexcept
+{
+    const std::shared_lock<std::shared_mutex> lock { SourcePool::sourcesMutex };
+
+    return static_cast<uint32_t>(SourcePool::sources.size());
+}
+
+void SourcePool::ThreadFunc() noexcept
+{
+    Tracer::SetThreadName("sv-sources");
+
+    PacedTicker ticker { std::chrono::milliseconds(SV::kVoiceRate) };
+
+    while (SourcePool::status.load(std::memory_order_relaxed))
+    {
+        ticker.Wait();
+
+        const Tracer::Span span { "SourcePool::Tick" };
+
+        const std::shared_lock<std::shared_mutex> lock { SourcePool::sourcesMutex };
+
+        for (const auto source : SourcePool::sources)
+            source->Tick();
+    }
+}
+
+bool SourcePool::initStatus { false };
+
+std::atomic_bool SourcePool::status { false };
+std::thread SourcePool::thread;
+
+std::shared_mutex SourcePool::sourcesMutex;
+std::vector<AudioSource*> SourcePool::sources;
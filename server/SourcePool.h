@@ -0,0 +1,61 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "AudioSource.h"
+
+class Stream;
+
+// Single thread pacing all playing audio sources: every source sends one
+// packet per voice frame, so that a source costs a copy and its fan-out
+class SourcePool {
+
+    SourcePool() = delete;
+    ~SourcePool() = delete;
+    SourcePool(const SourcePool&) = delete;
+    SourcePool(SourcePool&&) = delete;
+    SourcePool& operator=(const SourcePool&) = delete;
+    SourcePool& operator=(SourcePool&&) = delete;
+
+public:
+
+    static bool Init();
+    static void Free() noexcept;
+
+    // Unregister waits until current tick of the source is finished
+    static void Register(AudioSource* source);
+    static void Unregister(AudioSource* source) noexcept;
+
+    // Stops sources playing into stream that is being deleted
+    static void DetachStream(const Stream* stream) noexcept;
+
+    static uint32_t GetSourcesCount() noexcept;
+
+private:
+
+    static void ThreadFunc() noexcept;
+
+private:
+
+    static bool initStatus;
+
+    static std::atomic_bool status;
+    static std::thread thread;
+
+    static std::shared_mutex sourcesMutex;
+    static std::vector<AudioSource*> sources;
+
+};
@@ -0,0 +1,288 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "StateMirror.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+#include <util/logger.h>
+
+#include "Network.h"
+#include "PlayerStore.h"
+#include "LocalStream.h"
+#include "PointStream.h"
+#include "Stream.h"
+#include "Header.h"
+
+static_assert(Mirror::kMaxPlayers == MAX_PLAYERS, "mirror has to hold every player");
+static_assert(Mirror::kPlayerWords == PlayerBitset::kWordsCount, "stream words are copied as they are");
+
+bool StateMirror::Init(const std::string& shmName) noexcept
+{
+    if (StateMirror::initStatus) return false;
+
+#ifdef _WIN32
+    Logger::Log("[sv:err:mirror:init] : state mirror is only supported on linux");
+    return false;
+#else
+    if (shmName.empty())
+    {
+        Logger::Log("[sv:err:mirror:init] : shared memory name is not set");
+        return false;
+    }
+
+    // Readers of the previous run keep their mapping until
+    // they notice it's closed and open the new segment
+    shm_unlink(shmName.c_str());
+
+    const int shmHandle = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+    if (shmHandle == -1)
+    {
+        Logger::Log("[sv:err:mirror:init] : shm_open error (code:%d)", errno);
+        return false;
+    }
+
+    void* shared { MAP_FAILED };
+
+    if (ftruncate(shmHandle, sizeof(Mirror::Shared)) == 0)
+    {
+        if ((shared = mmap(nullptr, sizeof(Mirror::Shared), PROT_READ | PROT_WRITE,
+            MAP_SHARED, shmHandle, 0)) == MAP_FAILED)
+        {
+            Logger::Log("[sv:err:mirror:init] : mmap error (code:%d)", errno);
+        }
+    }
+    else Logger::Log("[sv:err:mirror:init] : ftruncate error (code:%d)", errno);
+
+    close(shmHandle);
+
+    if (shared == MAP_FAILED)
+    {
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    StateMirror::shared = static_cast<Mirror::Shared*>(shared);
+    StateMirror::shmName = shmName;
+
+    // Fresh segment is zeroed, that is every record is empty
+    StateMirror::shared->maxPlayers = Mirror::kMaxPlayers;
+    StateMirror::shared->maxStreams = Mirror::kMaxStreams;
+    StateMirror::shared->pluginHeartbeat.store(StateMirror::GetTime(), std::memory_order_relaxed);
+    StateMirror::shared->version = Mirror::kVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    StateMirror::shared->signature = Mirror::kSignature;
+
+    StateMirror::heartbeatTime = StateMirror::GetTime();
+
+    Logger::Log("[sv:dbg:mirror:init] : state is mirrored to shared memory (%s, size:%u)",
+        shmName.c_str(), static_cast<uint32_t>(sizeof(Mirror::Shared)));
+
+    StateMirror::initStatus = true;
+
+    return true;
+#endif
+}
+
+void StateMirror::Free() noexcept
+{
+    if (!StateMirror::initStatus) return;
+
+    StateMirror::initStatus = false;
+
+#ifndef _WIN32
+    StateMirror::shared->pluginClosed.store(true, std::memory_order_release);
+
+    munmap(StateMirror::shared, sizeof(Mirror::Shared));
+    shm_unlink(StateMirror::shmName.c_str());
+
+    StateMirror::shared = nullptr;
+#endif
+
+    StateMirror::dirtyStatus.store(false, std::memory_order_relaxed);
+
+    for (auto& dirtyPlayer : StateMirror::dirtyPlayers)
+        dirtyPlayer.store(false, std::memory_order_relaxed);
+
+    for (auto& dirtyStream : StateMirror::dirtyStreams)
+        dirtyStream.store(NULL, std::memory_order_relaxed);
+}
+
+void StateMirror::MarkPlayer(const uint16_t playerId) noexcept
+{
+    assert(playerId < MAX_PLAYERS);
+
+    if (!StateMirror::initStatus) return;
+
+    StateMirror::dirtyPlayers[playerId].store(true, std::memory_order_relaxed);
+    StateMirror::dirtyStatus.store(true, std::memory_order_release);
+}
+
+void StateMirror::MarkStream(const uint32_t stream) noexcept
+{
+    if (!StateMirror::initStatus || stream == NULL) return;
+
+    const auto slot = Mirror::GetStreamSlot(stream);
+
+    if (slot >= Mirror::kMaxStreams)
+    {
+        static Logger::Limiter slotLimiter { 1, 60 };
+
+        Logger::Log(slotLimiter, "[sv:err:mirror:mark] : stream (%u) is beyond mirrored streams (%u)",
+            stream, Mirror::kMaxStreams);
+
+        return;
+    }
+
+    // Handle of the deleted stream is replaced by the one of the stream
+    // reusing its slot, main thread writes the latter over the record
+    StateMirror::dirtyStreams[slot].store(stream, std::memory_order_relaxed);
+    StateMirror::dirtyStatus.store(true, std::memory_order_release);
+}
+
+void StateMirror::Process() noexcept
+{
+    if (!StateMirror::initStatus) return;
+
+    if (StateMirror::dirtyStatus.exchange(false, std::memory_order_acq_rel))
+    {
+        for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+        {
+            if (StateMirror::dirtyPlayers[iPlayerId].exchange(false, std::memory_order_relaxed))
+                StateMirror::WritePlayer(iPlayerId);
+        }
+
+        auto streamsLimit = StateMirror::shared->streamsLimit.load(std::memory_order_relaxed);
+
+        for (uint32_t iSlot { 0 }; iSlot < Mirror::kMaxStreams; ++iSlot)
+        {
+            if (const auto stream = StateMirror::dirtyStreams[iSlot].exchange(NULL, std::memory_order_relaxed))
+            {
+                StateMirror::WriteStream(iSlot, stream);
+                streamsLimit = std::max(streamsLimit, iSlot + 1);
+            }
+        }
+
+        StateMirror::shared->streamsLimit.store(streamsLimit, std::memory_order_release);
+        StateMirror::shared->changes.fetch_add(1, std::memory_order_release);
+    }
+
+    if (const auto curTime = StateMirror::GetTime(); curTime - StateMirror::heartbeatTime >= Mirror::kHeartbeatInterval)
+    {
+        StateMirror::shared->pluginHeartbeat.store(curTime, std::memory_order_release);
+        StateMirror::heartbeatTime = curTime;
+    }
+}
+
+void StateMirror::WritePlayer(const uint16_t playerId) noexcept
+{
+    Mirror::PlayerRecord record {};
+
+    const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
+    if (pPlayerInfo != nullptr)
+    {
+        record.status = true;
+        record.pluginVersion = pPlayerInfo->pluginVersion;
+        record.microStatus = pPlayerInfo->microStatus;
+        record.muteStatus = pPlayerInfo->muteStatus.load(std::memory_order_relaxed);
+        record.recordStatus = pPlayerInfo->recordStatus.load(std::memory_order_relaxed);
+
+        for (const auto keyId : pPlayerInfo->keys)
+            Mirror::SetBit(record.keys, keyId);
+    }
+    PlayerStore::ReleasePlayerWithSharedAccess(playerId);
+
+    if (record.status)
+    {
+        if (const auto playerAddr = std::atomic_load(&Network::playerAddrTable[playerId]))
+        {
+            record.address = playerAddr->sin_addr.s_addr;
+            record.port = playerAddr->sin_port;
+        }
+    }
+
+    StateMirror::shared->players[playerId].Store(record);
+}
+
+void StateMirror::WriteStream(const uint32_t slot, const uint32_t stream) noexcept
+{
+    Mirror::StreamRecord record {};
+
+    // Deleted stream leaves its slot empty
+    if (const auto pStream = Stream::FromHandle(stream))
+    {
+        record.handle = stream;
+        record.type = pStream->GetCreatePacketType();
+        record.mixMode = pStream->GetMixMode();
+        record.recordStatus = pStream->IsRecording();
+        record.target = Mirror::kNoneTarget;
+
+        if (const auto pLocalStream = dynamic_cast<const LocalStream*>(pStream))
+        {
+            record.distance = PackGetStruct(&*pLocalStream->packetStreamUpdateDistance,
+                SV::UpdateLStreamDistancePacket)->distance;
+        }
+
+        if (const auto pPointStream = dynamic_cast<const PointStream*>(pStream))
+        {
+            const auto& position = PackGetStruct(&*pPointStream->packetStreamUpdatePosition,
+                SV::UpdateLPStreamPositionPacket)->position;
+
+            record.position[0] = position.fX;
+            record.position[1] = position.fY;
+            record.position[2] = position.fZ;
+        }
+
+        switch (record.type)
+        {
+            case SV::ControlPacketType::createLStreamAtVehicle:
+            case SV::ControlPacketType::createLStreamAtPlayer:
+            case SV::ControlPacketType::createLStreamAtObject:
+                record.target = PackGetStruct(&*pStream->packetCreateStream, SV::CreateLStreamAtPacket)->target;
+        }
+
+        for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+        {
+            record.listeners[iWord] = pStream->attachedListeners[iWord].load(std::memory_order_relaxed);
+            record.speakers[iWord] = pStream->attachedSpeakers[iWord].load(std::memory_order_relaxed);
+
+            record.listenersCount += PlayerBitset::CountBits(record.listeners[iWord]);
+            record.speakersCount += PlayerBitset::CountBits(record.speakers[iWord]);
+        }
+    }
+
+    StateMirror::shared->streams[slot].Store(record);
+}
+
+int64_t StateMirror::GetTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool StateMirror::initStatus { false };
+
+std::string StateMirror::shmName;
+Mirror::Shared* StateMirror::shared { nullptr };
+
+int64_t StateMirror::heartbeatTime { 0 };
+
+std::atomic_bool StateMirror::dirtyStatus { false };
+std::array<std::atomic_bool, MAX_PLAYERS> StateMirror::dirtyPlayers {};
+std::array<std::atomic<uint32_t>, Mirror::kMaxStreams> StateMirror::dirtyStreams {};
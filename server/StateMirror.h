@@ -0,0 +1,72 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <ysf/structs.h>
+
+#include "MirrorProtocol.h"
+
+// Plugin side of the state mirror (MirrorProtocol.h). Changes of players and
+// streams are marked from any thread, main thread rewrites marked records
+// once a tick, so every record shows the state of the end of some tick.
+// Only available on Linux.
+class StateMirror {
+
+    StateMirror() = delete;
+    ~StateMirror() = delete;
+    StateMirror(const StateMirror&) = delete;
+    StateMirror(StateMirror&&) = delete;
+    StateMirror& operator=(const StateMirror&) = delete;
+    StateMirror& operator=(StateMirror&&) = delete;
+
+public:
+
+    static bool Init(const std::string& shmName) noexcept;
+    static void Free() noexcept;
+
+    static inline bool IsEnabled() noexcept
+    {
+        return StateMirror::initStatus;
+    }
+
+    static void MarkPlayer(uint16_t playerId) noexcept;
+    static void MarkStream(uint32_t stream) noexcept;
+
+    // Called every tick after everything else has changed the state
+    static void Process() noexcept;
+
+private:
+
+    static void WritePlayer(uint16_t playerId) noexcept;
+    static void WriteStream(uint32_t slot, uint32_t stream) noexcept;
+
+    static int64_t GetTime() noexcept;
+
+private:
+
+    static bool initStatus;
+
+    static std::string shmName;
+    static Mirror::Shared* shared;
+
+    static int64_t heartbeatTime;
+
+    static std::atomic_bool dirtyStatus;
+    static std::array<std::atomic_bool, MAX_PLAYERS> dirtyPlayers;
+
+    // Handle of the stream last marked in slot, zero if slot is clean
+    static std::array<std::atomic<uint32_t>, Mirror::kMaxStreams> dirtyStreams;
+
+};
@@ -25,7 +25,7 @@ StaticLocalStreamAtObject::StaticLocalStreamAtObject(
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLStreamAtObject, sizeof(SV::CreateLStreamAtPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target = objectId;
@@ -25,7 +25,7 @@ StaticLocalStreamAtPlayer::StaticLocalStreamAtPlayer(
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLStreamAtPlayer, sizeof(SV::CreateLStreamAtPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLStreamAtPacket)->target = playerId;
@@ -26,7 +26,7 @@ StaticLocalStreamAtPoint::StaticLocalStreamAtPoint(
 
     PackWrap(this->packetCreateStream, SV::ControlPacketType::createLPStream, sizeof(SV::CreateLPStreamPacket) + nameLength);
 
-    PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->stream = reinterpret_cast<uint32_t>(static_cast<Stream*>(this));
+    PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->stream = this->GetHandle();
     std::memcpy(PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->name, nameString, nameLength);
     PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->distance = distance;
     PackGetStruct(&*this->packetCreateStream, SV::CreateLPStreamPacket)->position = position;
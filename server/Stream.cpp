@@ -11,60 +11,165 @@
 
 #include <cassert>
 
-#include <ysf/globals.h>
+#include <util/logger.h>
 
 #include "Network.h"
+#include "SourcePool.h"
+#include "Federation.h"
+#include "Group.h"
+#include "RelayLink.h"
+#include "StateMirror.h"
 #include "PlayerStore.h"
+#include "World.h"
+#include "Metrics.h"
 #include "Header.h"
 
 Stream::Stream()
+    : handle(Stream::streamTable.Insert(this))
 {
+    if (this->handle == SlotMap<Stream>::kInvalidHandle)
+        Logger::Log("[sv:err:stream:init] : streams limit reached");
+
     PackWrap(this->packetDeleteStream, SV::ControlPacketType::deleteStream, sizeof(SV::DeleteStreamPacket));
 
-    PackGetStruct(&*this->packetDeleteStream, SV::DeleteStreamPacket)->stream = reinterpret_cast<uint32_t>(this);
+    PackGetStruct(&*this->packetDeleteStream, SV::DeleteStreamPacket)->stream = this->handle;
+
+    this->UpdateRelayStatus();
 }
 
 Stream::~Stream() noexcept
 {
+    // Sources only use this base part of stream, so they may play until here
+    SourcePool::DetachStream(this);
+    Federation::DetachStream(this);
+    Group::DetachStream(this);
+
+    this->StopRecord();
+
+    delete this->mixer.load(std::memory_order_relaxed);
+
     for (const auto& deleteCallback : this->deleteCallbacks)
     {
         if (deleteCallback != nullptr) deleteCallback(this);
     }
+
+    RelayLink::PublishStreamDelete(this->handle);
+    StateMirror::MarkStream(this->handle);
+
+    Stream::streamTable.Remove(this->handle);
+}
+
+uint32_t Stream::GetHandle() const noexcept
+{
+    return this->handle;
 }
 
-void Stream::SendVoicePacket(VoicePacket& voicePacket) const
+Stream* Stream::FromHandle(const uint32_t handle) noexcept
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
+    return Stream::streamTable.Get(handle);
+}
 
-    assert(voicePacket.sender >= 0 && voicePacket.sender < MAX_PLAYERS);
+std::size_t Stream::GetStreamsCount() noexcept
+{
+    return Stream::streamTable.GetCount();
+}
 
-    if (!this->HasSpeaker(voicePacket.sender))
+void Stream::SendVoicePacket(VoicePacket& voicePacket, VoicePacket* const lowPacket) const
+{
+    // Audio sources send on behalf of ids above players' ones and are not attached
+    if (voicePacket.sender < MAX_PLAYERS && !this->HasSpeaker(voicePacket.sender))
         return;
 
-    voicePacket.stream = reinterpret_cast<uint32_t>(this);
+    if (this->recordMode.load(std::memory_order_relaxed) == Recorder::Mode::perSpeaker)
+        Recorder::Push(this->handle, voicePacket);
+
+    // Peers receive speakers' frames rather than the mix
+    if (this->exportStatus.load(std::memory_order_relaxed))
+        Federation::Push(this->handle, voicePacket);
+
+    if (const auto mixer = this->mixer.load(std::memory_order_acquire); mixer != nullptr)
+    {
+        const auto mixMode = mixer->GetMode();
+
+        if (mixMode != Mixer::Mode::disabled || mixer->IsRecording())
+            mixer->Push(voicePacket);
+
+        if (mixMode != Mixer::Mode::disabled)
+            return;
+    }
+
+    voicePacket.stream = this->handle;
     voicePacket.CalcHash();
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    if (lowPacket != nullptr)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        lowPacket->stream = this->handle;
+        lowPacket->CalcHash();
+    }
 
-        for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
+    if (World::GetConnectedPlayersCount() != 0)
+    {
+        const auto playerPoolSize = World::GetPlayerPoolSize();
+
+        uint32_t sendedPackets { 0 };
+        uint32_t sendedBytes { 0 };
+        uint32_t lowLayerPackets { 0 };
+        uint32_t failedPackets { 0 };
+
+        const auto wordsCount = PlayerBitset::GetWord(playerPoolSize) + 1;
+
+        for (uint32_t iWord { 0 }; iWord < wordsCount; ++iWord)
         {
-            if (this->HasListener(iPlayerId) && PlayerStore::IsPlayerConnected(iPlayerId) && iPlayerId != voicePacket.sender)
-                Network::SendVoicePacket(iPlayerId, voicePacket);
+            auto listeners = this->attachedListeners[iWord].load(std::memory_order_relaxed);
+
+            if (voicePacket.sender < MAX_PLAYERS && PlayerBitset::GetWord(voicePacket.sender) == iWord)
+                listeners &= ~PlayerBitset::GetMask(voicePacket.sender);
+
+            PlayerBitset::ForEach(listeners, iWord, [&](const uint16_t iPlayerId)
+            {
+                if (iPlayerId > playerPoolSize || !PlayerStore::IsPlayerConnected(iPlayerId))
+                    return;
+
+                const bool lowLayerStatus = lowPacket != nullptr &&
+                    this->lowLayerListeners[iPlayerId].load(std::memory_order_relaxed) != 0;
+                const auto& packet = lowLayerStatus ? *lowPacket : voicePacket;
+
+                if (Network::SendVoicePacket(iPlayerId, packet))
+                {
+                    ++sendedPackets;
+                    sendedBytes += packet.GetFullSize();
+                    lowLayerPackets += lowLayerStatus;
+                }
+                else ++failedPackets;
+            });
         }
+
+        if (sendedPackets != 0)
+        {
+            Metrics::Add(StatType::voicePacketsForwarded, sendedPackets);
+            Metrics::Add(StatType::voiceBytesForwarded, sendedBytes);
+        }
+
+        if (lowLayerPackets != 0)
+            Metrics::Add(StatType::lowLayerPacketsForwarded, lowLayerPackets);
+
+        if (failedPackets != 0)
+            Metrics::Add(StatType::voicePacketsSendErrors, failedPackets);
     }
 }
 
-void Stream::SendControlPacket(ControlPacket& controlPacket) const
+uint16_t Stream::GetCreatePacketType() const noexcept
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
+    if (this->packetCreateStream == nullptr) return NULL;
 
-    if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+    return (*this->packetCreateStream)->packet;
+}
+
+void Stream::SendControlPacket(ControlPacket& controlPacket) const
+{
+    if (World::GetConnectedPlayersCount() != 0)
     {
-        const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+        const auto playerPoolSize = World::GetPlayerPoolSize();
 
         for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
         {
@@ -79,9 +184,17 @@ bool Stream::AttachListener(const uint16_t playerId)
     assert(playerId < MAX_PLAYERS);
 
     if (!PlayerStore::IsPlayerHasPlugin(playerId)) return false;
-    if (this->attachedListeners[playerId].exchange(true, std::memory_order_relaxed))
+    if (this->attachedListeners[PlayerBitset::GetWord(playerId)].fetch_or
+        (PlayerBitset::GetMask(playerId), std::memory_order_relaxed) & PlayerBitset::GetMask(playerId))
         return false;
 
+    this->lowLayerListeners[playerId].store(Stream::congestedListeners[playerId].load(std::memory_order_relaxed)
+        ? LowLayerReason::congestion : NULL, std::memory_order_relaxed);
+
+    RelayLink::PublishListener(this->handle, playerId, this->lowLayerListeners[playerId].load
+        (std::memory_order_relaxed) != 0 ? Relay::LayerStatus::low : Relay::LayerStatus::main);
+    StateMirror::MarkStream(this->handle);
+
     Network::SendControlPacket(playerId, *&*this->packetCreateStream);
 
     for (const auto& playerCallback : this->playerCallbacks)
@@ -98,16 +211,23 @@ bool Stream::HasListener(const uint16_t playerId) const noexcept
 {
     assert(playerId < MAX_PLAYERS);
 
-    return this->attachedListeners[playerId].load(std::memory_order_relaxed);
+    return this->attachedListeners[PlayerBitset::GetWord(playerId)].load
+        (std::memory_order_relaxed) & PlayerBitset::GetMask(playerId);
 }
 
 bool Stream::DetachListener(const uint16_t playerId)
 {
     assert(playerId < MAX_PLAYERS);
 
-    if (!this->attachedListeners[playerId].exchange(false, std::memory_order_relaxed))
+    if (!(this->attachedListeners[PlayerBitset::GetWord(playerId)].fetch_and
+        (~PlayerBitset::GetMask(playerId), std::memory_order_relaxed) & PlayerBitset::GetMask(playerId)))
         return false;
 
+    this->lowLayerListeners[playerId].store(NULL, std::memory_order_relaxed);
+
+    RelayLink::PublishListener(this->handle, playerId, Relay::LayerStatus::detached);
+    StateMirror::MarkStream(this->handle);
+
     if (PlayerStore::IsPlayerConnected(playerId) && this->packetDeleteStream)
         Network::SendControlPacket(playerId, *&*this->packetDeleteStream);
 
@@ -122,19 +242,27 @@ std::vector<uint16_t> Stream::DetachAllListeners()
 
     detachedListeners.reserve(this->attachedListenersCount);
 
-    for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
     {
-        if (this->attachedListeners[iPlayerId].exchange(false, std::memory_order_relaxed))
+        const auto listeners = this->attachedListeners[iWord].exchange(0, std::memory_order_relaxed);
+
+        PlayerBitset::ForEach(listeners, iWord, [&](const uint16_t iPlayerId)
         {
+            this->lowLayerListeners[iPlayerId].store(NULL, std::memory_order_relaxed);
+
+            RelayLink::PublishListener(this->handle, iPlayerId, Relay::LayerStatus::detached);
+
             if (PlayerStore::IsPlayerConnected(iPlayerId) && this->packetDeleteStream)
                 Network::SendControlPacket(iPlayerId, *&*this->packetDeleteStream);
 
             detachedListeners.emplace_back(iPlayerId);
-        }
+        });
     }
 
     this->attachedListenersCount = 0;
 
+    StateMirror::MarkStream(this->handle);
+
     return detachedListeners;
 }
 
@@ -143,9 +271,13 @@ bool Stream::AttachSpeaker(const uint16_t playerId) noexcept
     assert(playerId < MAX_PLAYERS);
 
     if (!PlayerStore::IsPlayerHasPlugin(playerId)) return false;
-    if (this->attachedSpeakers[playerId].exchange(true, std::memory_order_relaxed))
+    if (this->attachedSpeakers[PlayerBitset::GetWord(playerId)].fetch_or
+        (PlayerBitset::GetMask(playerId), std::memory_order_relaxed) & PlayerBitset::GetMask(playerId))
         return false;
 
+    RelayLink::PublishSpeaker(this->handle, playerId, true);
+    StateMirror::MarkStream(this->handle);
+
     ++this->attachedSpeakersCount;
 
     return true;
@@ -155,35 +287,94 @@ bool Stream::HasSpeaker(const uint16_t playerId) const noexcept
 {
     assert(playerId < MAX_PLAYERS);
 
-    return this->attachedSpeakers[playerId].load(std::memory_order_relaxed);
+    return this->attachedSpeakers[PlayerBitset::GetWord(playerId)].load
+        (std::memory_order_relaxed) & PlayerBitset::GetMask(playerId);
 }
 
 bool Stream::DetachSpeaker(const uint16_t playerId) noexcept
 {
     assert(playerId < MAX_PLAYERS);
 
-    if (!this->attachedSpeakers[playerId].exchange(false, std::memory_order_relaxed))
+    if (!(this->attachedSpeakers[PlayerBitset::GetWord(playerId)].fetch_and
+        (~PlayerBitset::GetMask(playerId), std::memory_order_relaxed) & PlayerBitset::GetMask(playerId)))
         return false;
 
+    RelayLink::PublishSpeaker(this->handle, playerId, false);
+    StateMirror::MarkStream(this->handle);
+
     --this->attachedSpeakersCount;
 
     return true;
 }
 
+void Stream::SetLowLayerReason(const uint16_t playerId, const uint8_t reason, const bool status) noexcept
+{
+    assert(playerId < MAX_PLAYERS);
+
+    if (!this->HasListener(playerId)) return;
+
+    const auto prevReasons = status
+        ? this->lowLayerListeners[playerId].fetch_or(reason, std::memory_order_relaxed)
+        : this->lowLayerListeners[playerId].fetch_and(~reason, std::memory_order_relaxed);
+
+    const auto curReasons = status ? prevReasons | reason : prevReasons & ~reason;
+
+    if ((prevReasons != 0) != (curReasons != 0))
+    {
+        RelayLink::PublishListener(this->handle, playerId, curReasons != 0
+            ? Relay::LayerStatus::low : Relay::LayerStatus::main);
+    }
+}
+
+void Stream::SetListenerCongestion(const uint16_t playerId, const bool status) noexcept
+{
+    assert(playerId < MAX_PLAYERS);
+
+    if (Stream::congestedListeners[playerId].exchange(status, std::memory_order_relaxed) == status)
+        return;
+
+    Stream::streamTable.ForEach([=](Stream* const stream)
+    {
+        stream->SetLowLayerReason(playerId, LowLayerReason::congestion, status);
+    });
+}
+
+void Stream::GetHeardSpeakers(const uint16_t listenerId, PlayerBitset::Words& speakers) noexcept
+{
+    assert(listenerId < MAX_PLAYERS);
+
+    speakers.fill(0);
+
+    Stream::streamTable.ForEach([&](Stream* const stream)
+    {
+        if (!stream->HasListener(listenerId)) return;
+
+        for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
+            speakers[iWord] |= stream->attachedSpeakers[iWord].load(std::memory_order_relaxed);
+    });
+}
+
 std::vector<uint16_t> Stream::DetachAllSpeakers()
 {
     std::vector<uint16_t> detachedSpeakers;
 
     detachedSpeakers.reserve(this->attachedSpeakersCount);
 
-    for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+    for (uint32_t iWord { 0 }; iWord < PlayerBitset::kWordsCount; ++iWord)
     {
-        if (this->attachedSpeakers[iPlayerId].exchange(false, std::memory_order_relaxed))
+        const auto speakers = this->attachedSpeakers[iWord].exchange(0, std::memory_order_relaxed);
+
+        PlayerBitset::ForEach(speakers, iWord, [&](const uint16_t iPlayerId)
+        {
+            RelayLink::PublishSpeaker(this->handle, iPlayerId, false);
             detachedSpeakers.emplace_back(iPlayerId);
+        });
     }
 
     this->attachedSpeakersCount = 0;
 
+    StateMirror::MarkStream(this->handle);
+
     return detachedSpeakers;
 }
 
@@ -210,9 +401,6 @@ void Stream::SetParameter(const uint8_t parameter, const float value) noexcept
 
 void Stream::ResetParameter(const uint8_t parameter) noexcept
 {
-    assert(pNetGame != nullptr);
-    assert(pNetGame->pPlayerPool != nullptr);
-
     const auto valueIter = kDefaultValues.find(parameter);
     if (valueIter == kDefaultValues.end()) return;
 
@@ -221,9 +409,9 @@ void Stream::ResetParameter(const uint8_t parameter) noexcept
     {
         iter->second.Set(valueIter->second);
 
-        if (pNetGame->pPlayerPool->dwConnectedPlayers != 0)
+        if (World::GetConnectedPlayersCount() != 0)
         {
-            const auto playerPoolSize = pNetGame->pPlayerPool->dwPlayerPoolSize;
+            const auto playerPoolSize = World::GetPlayerPoolSize();
 
             for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
             {
@@ -277,6 +465,120 @@ void Stream::SlideParameter(const uint8_t parameter, const float deltaValue, con
     iter.first->second.Slide(deltaValue, time);
 }
 
+bool Stream::SetMixMode(const uint8_t mode)
+{
+    if (mode > Mixer::Mode::perListener) return false;
+
+    if (mode == Mixer::Mode::disabled && this->mixer.load(std::memory_order_relaxed) == nullptr)
+        return true;
+
+    const auto mixer = this->AcquireMixer();
+    if (mixer == nullptr) return false;
+
+    mixer->SetMode(mode);
+
+    this->UpdateRelayStatus();
+
+    return true;
+}
+
+uint8_t Stream::GetMixMode() const noexcept
+{
+    const auto mixer = this->mixer.load(std::memory_order_relaxed);
+    return mixer != nullptr ? mixer->GetMode() : Mixer::Mode::disabled;
+}
+
+bool Stream::StartRecord(const std::string& fileName, const bool perSpeaker)
+{
+    if (this->recordMode.load(std::memory_order_relaxed) != Recorder::Mode::disabled)
+        return false;
+
+    const uint8_t recordMode = perSpeaker ? Recorder::Mode::perSpeaker : Recorder::Mode::perStream;
+
+    Mixer* mixer { nullptr };
+
+    if (recordMode == Recorder::Mode::perStream && (mixer = this->AcquireMixer()) == nullptr)
+        return false;
+
+    if (!Recorder::Open(this->handle, fileName, recordMode))
+    {
+        Logger::Log("[sv:err:stream:startrecord] : failed to start recording to (%s)", fileName.c_str());
+        return false;
+    }
+
+    if (mixer != nullptr) mixer->SetRecording(true);
+
+    this->recordMode.store(recordMode, std::memory_order_relaxed);
+
+    this->UpdateRelayStatus();
+
+    return true;
+}
+
+bool Stream::StopRecord() noexcept
+{
+    const auto recordMode = this->recordMode.exchange(Recorder::Mode::disabled, std::memory_order_relaxed);
+    if (recordMode == Recorder::Mode::disabled) return false;
+
+    if (recordMode == Recorder::Mode::perStream)
+        this->mixer.load(std::memory_order_relaxed)->SetRecording(false);
+
+    Recorder::Close(this->handle);
+
+    this->UpdateRelayStatus();
+
+    return true;
+}
+
+bool Stream::IsRecording() const noexcept
+{
+    return this->recordMode.load(std::memory_order_relaxed) != Recorder::Mode::disabled;
+}
+
+Mixer* Stream::AcquireMixer()
+{
+    auto mixer = this->mixer.load(std::memory_order_relaxed);
+
+    if (mixer == nullptr)
+    {
+        if (!Mixer::IsAvailable())
+        {
+            Logger::Log("[sv:err:stream:acquiremixer] : plugin is built without mixing support");
+            return nullptr;
+        }
+
+        mixer = new Mixer(*this);
+        this->mixer.store(mixer, std::memory_order_release);
+    }
+
+    return mixer;
+}
+
+bool Stream::IsRelayed() const noexcept
+{
+    return this->relayStatus.load(std::memory_order_relaxed);
+}
+
+void Stream::UpdateRelayStatus() noexcept
+{
+    // Mirror keeps mix mode and record status of the stream
+    StateMirror::MarkStream(this->handle);
+
+    if (!RelayLink::IsEnabled()) return;
+
+    const auto mixer = this->mixer.load(std::memory_order_relaxed);
+
+    const bool relayStatus = (mixer == nullptr || mixer->GetMode() == Mixer::Mode::disabled) &&
+        this->recordMode.load(std::memory_order_relaxed) == Recorder::Mode::disabled &&
+        !this->exportStatus.load(std::memory_order_relaxed);
+
+    // Packets that relay passed up before it learnt the stream became
+    // relayed are skipped by workers, the switch costs a few milliseconds
+    this->relayStatus.store(relayStatus, std::memory_order_relaxed);
+
+    RelayLink::PublishStream(this->handle, relayStatus);
+}
+
 std::size_t Stream::AddPlayerCallback(PlayerCallback playerCallback) noexcept
 {
     for (std::size_t i { 0 }; i < this->playerCallbacks.size(); ++i)
@@ -322,3 +624,6 @@ void Stream::RemoveDeleteCallback(const std::size_t callback) noexcept
 
     this->deleteCallbacks[callback] = nullptr;
 }
+
+SlotMap<Stream> Stream::streamTable;
+std::array<std::atomic_bool, MAX_PLAYERS> Stream::congestedListeners {};
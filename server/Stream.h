@@ -12,6 +12,7 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <string>
 #include <array>
 #include <vector>
 #include <set>
@@ -23,9 +24,17 @@
 #include "VoicePacket.h"
 #include "Parameter.h"
 #include "Effect.h"
+#include "Mixer.h"
+#include "Recorder.h"
+#include "PlayerBitset.h"
+#include "SlotMap.h"
 
 class Stream {
 
+    friend class Federation;
+    friend class RelayLink;
+    friend class StateMirror;
+
     Stream(const Stream&) = delete;
     Stream(Stream&&) = delete;
     Stream& operator=(const Stream&) = delete;
@@ -36,6 +45,18 @@ private:
     using PlayerCallback = std::function<void(Stream*, uint16_t)>;
     using DeleteCallback = std::function<void(Stream*)>;
 
+protected:
+
+    // Reasons to send low simulcast layer to a listener
+    struct LowLayerReason
+    {
+        enum : uint8_t
+        {
+            distance   = 1 << 0,
+            congestion = 1 << 1
+        };
+    };
+
 protected:
 
     explicit Stream();
@@ -46,9 +67,28 @@ public:
 
 public:
 
-    void SendVoicePacket(VoicePacket& packet) const;
+    // Listeners with any low layer reason receive 'lowPacket' if speaker simulcasts
+    void SendVoicePacket(VoicePacket& packet, VoicePacket* lowPacket = nullptr) const;
     void SendControlPacket(ControlPacket& packet) const;
 
+    uint16_t GetCreatePacketType() const noexcept;
+
+    // Identifies the stream for scripts and clients
+    uint32_t GetHandle() const noexcept;
+
+    // Returns nullptr for handles of deleted streams
+    static Stream* FromHandle(uint32_t handle) noexcept;
+    static std::size_t GetStreamsCount() noexcept;
+
+    // Congested listener receives low layer in all streams
+    static void SetListenerCongestion(uint16_t playerId, bool status) noexcept;
+
+    // Speakers that the listener is attached to hear in any stream
+    static void GetHeardSpeakers(uint16_t listenerId, PlayerBitset::Words& speakers) noexcept;
+
+    // Speakers of relayed stream are forwarded by external relay rather than workers
+    bool IsRelayed() const noexcept;
+
     virtual bool AttachListener(uint16_t playerId);
     bool HasListener(uint16_t playerId) const noexcept;
     virtual bool DetachListener(uint16_t playerId);
@@ -67,27 +107,70 @@ public:
     void SlideParameterTo(uint8_t parameter, float endValue, uint32_t time) noexcept;
     void SlideParameter(uint8_t parameter, float deltaValue, uint32_t time) noexcept;
 
+    // Mixing replaces forwarding of speakers' packets with one mixed stream,
+    // returns false for unknown mode or if plugin is built without codec
+    bool SetMixMode(uint8_t mode);
+    uint8_t GetMixMode() const noexcept;
+
+    // Voice is archived to "<name>_<playerid>.opus" per speaker or to "<name>.opus",
+    // recording of the whole stream takes its mix and so requires codec as well
+    bool StartRecord(const std::string& fileName, bool perSpeaker);
+    bool StopRecord() noexcept;
+    bool IsRecording() const noexcept;
+
     std::size_t AddPlayerCallback(PlayerCallback playerCallback) noexcept;
     std::size_t AddDeleteCallback(DeleteCallback deleteCallback) noexcept;
     void RemovePlayerCallback(std::size_t callback) noexcept;
     void RemoveDeleteCallback(std::size_t callback) noexcept;
 
+protected:
+
+    void SetLowLayerReason(uint16_t playerId, uint8_t reason, bool status) noexcept;
+
 protected:
 
     int attachedSpeakersCount { 0 };
     int attachedListenersCount { 0 };
 
-    std::array<std::atomic_bool, MAX_PLAYERS> attachedSpeakers {};
-    std::array<std::atomic_bool, MAX_PLAYERS> attachedListeners {};
+    // A bit per player, fan-out walks set bits a word at a time
+    std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> attachedSpeakers {};
+    std::array<std::atomic<uint64_t>, PlayerBitset::kWordsCount> attachedListeners {};
+
+    // Layer of every listener is chosen here rather than per packet,
+    // workers only check whether listener has any LowLayerReason
+    std::array<std::atomic<uint8_t>, MAX_PLAYERS> lowLayerListeners {};
 
     ControlPacketContainerPtr packetCreateStream { nullptr };
     ControlPacketContainerPtr packetDeleteStream { nullptr };
 
 private:
 
+    const uint32_t handle;
+
     std::vector<PlayerCallback> playerCallbacks;
     std::vector<DeleteCallback> deleteCallbacks;
 
     std::map<uint8_t, Parameter> parameters;
 
+    // Created on the first enabling and read by workers without locks
+    std::atomic<Mixer*> mixer { nullptr };
+    std::atomic<uint8_t> recordMode { Recorder::Mode::disabled };
+
+    // Set by Federation while stream is exported to any peer
+    std::atomic_bool exportStatus { false };
+
+    std::atomic_bool relayStatus { false };
+
+private:
+
+    Mixer* AcquireMixer();
+
+    // Stream is relayed unless plugin has to see its speakers' packets
+    void UpdateRelayStatus() noexcept;
+
+private:
+
+    static SlotMap<Stream> streamTable;
+    static std::array<std::atomic_bool, MAX_PLAYERS> congestedListeners;
+
 };
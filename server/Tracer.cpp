@@ -0,0 +1,183 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <util/logger.h>
+
+#include "Header.h"
+
+bool Tracer::Start() noexcept
+{
+    if (Tracer::enableStatus.load(std::memory_order_relaxed))
+        return false;
+
+    {
+        const std::lock_guard<std::mutex> lock { Tracer::buffersMutex };
+
+        // Threads that have exited since the last trace have nothing to give
+        Tracer::DropReleasedBuffers();
+
+        for (const auto& buffer : Tracer::buffers)
+            buffer->writeIndex.store(0, std::memory_order_relaxed);
+    }
+
+    Tracer::startTime = Latency::Now();
+    Tracer::enableStatus.store(true, std::memory_order_release);
+
+    Logger::Log("[sv:dbg:tracer:start] : tracing started");
+
+    return true;
+}
+
+bool Tracer::Stop(const std::string& traceFile)
+{
+    if (!Tracer::enableStatus.exchange(false, std::memory_order_acq_rel))
+        return false;
+
+    // Let spans that were open at the moment of stop complete
+    SleepForMilliseconds(10);
+
+    const auto file = std::fopen(traceFile.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        Logger::Log("[sv:err:tracer:stop] : failed to open trace file (%s)", traceFile.c_str());
+        return false;
+    }
+
+    const double ticksPerMicrosecond = 1000.0 * Latency::GetTicksPerNanosecond();
+
+    std::size_t eventsCount { 0 };
+    bool firstEvent { true };
+
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+
+    {
+        const std::lock_guard<std::mutex> lock { Tracer::buffersMutex };
+
+        for (const auto& buffer : Tracer::buffers)
+        {
+            // Thread hasn't recorded anything in this trace
+            if (buffer->writeIndex.load(std::memory_order_acquire) == 0) continue;
+
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                firstEvent ? "" : ",", buffer->threadId, buffer->threadName.c_str());
+
+            firstEvent = false;
+
+            const auto writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+            const auto beginIndex = writeIndex > kBufferSize ? writeIndex - kBufferSize : 0;
+
+            for (auto iEvent = beginIndex; iEvent < writeIndex; ++iEvent)
+            {
+                const auto& event = buffer->events[iEvent % kBufferSize];
+                if (event.beginTime < Tracer::startTime || event.endTime < event.beginTime) continue;
+
+                std::fprintf(file, ",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, buffer->threadId, (event.beginTime - Tracer::startTime) / ticksPerMicrosecond,
+                    (event.endTime - event.beginTime) / ticksPerMicrosecond);
+
+                ++eventsCount;
+            }
+        }
+
+        Tracer::DropReleasedBuffers();
+    }
+
+    std::fputs("]}\n", file);
+    std::fclose(file);
+
+    Logger::Log("[sv:dbg:tracer:stop] : %u spans written to (%s)",
+        static_cast<uint32_t>(eventsCount), traceFile.c_str());
+
+    return true;
+}
+
+void Tracer::SetThreadName(const char* const name)
+{
+    Tracer::threadName = name;
+
+    if (Tracer::threadBuffer != nullptr)
+    {
+        const std::lock_guard<std::mutex> lock { Tracer::buffersMutex };
+        Tracer::threadBuffer->threadName = name;
+    }
+}
+
+void Tracer::Record(const char* const name, const Latency::tsc_t beginTime, const Latency::tsc_t endTime) noexcept
+{
+    const auto buffer = Tracer::GetThreadBuffer();
+    if (buffer == nullptr) return;
+
+    const auto writeIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+
+    auto& event = buffer->events[writeIndex % kBufferSize];
+
+    event.name = name;
+    event.beginTime = beginTime;
+    event.endTime = endTime;
+
+    buffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+Tracer::Buffer* Tracer::GetThreadBuffer()
+{
+    if (Tracer::threadBuffer != nullptr) return Tracer::threadBuffer;
+
+    try
+    {
+        const auto buffer = std::make_shared<Buffer>();
+
+        const std::lock_guard<std::mutex> lock { Tracer::buffersMutex };
+
+        buffer->threadId = ++Tracer::lastThreadId;
+        buffer->threadName = !Tracer::threadName.empty() ? Tracer::threadName : "thread-" + std::to_string(buffer->threadId);
+
+        Tracer::buffers.emplace_back(buffer);
+
+        Tracer::threadBuffer = buffer.get();
+        Tracer::threadBufferOwner.buffer = buffer.get();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+
+    return Tracer::threadBuffer;
+}
+
+void Tracer::DropReleasedBuffers() noexcept
+{
+    Tracer::buffers.erase(std::remove_if(Tracer::buffers.begin(), Tracer::buffers.end(),
+        [](const BufferPtr& buffer) noexcept { return buffer->releaseStatus; }),
+        Tracer::buffers.end());
+}
+
+Tracer::BufferOwner::~BufferOwner() noexcept
+{
+    if (this->buffer == nullptr) return;
+
+    const std::lock_guard<std::mutex> lock { Tracer::buffersMutex };
+    this->buffer->releaseStatus = true;
+}
+
+std::atomic_bool Tracer::enableStatus { false };
+Latency::tsc_t Tracer::startTime { 0 };
+
+std::mutex Tracer::buffersMutex;
+std::vector<Tracer::BufferPtr> Tracer::buffers;
+uint32_t Tracer::lastThreadId { 0 };
+
+thread_local Tracer::Buffer* Tracer::threadBuffer { nullptr };
+thread_local Tracer::BufferOwner Tracer::threadBufferOwner;
+thread_local std::string Tracer::threadName;
@@ -0,0 +1,132 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Latency.h"
+
+// Span recorder producing Chrome trace-event JSON (chrome://tracing, Perfetto).
+// Every thread writes its spans into its own ring buffer, so recording takes
+// two TSC reads and a few plain stores. Span names must be string literals.
+class Tracer {
+
+    Tracer() = delete;
+    ~Tracer() = delete;
+    Tracer(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+
+private:
+
+    static constexpr uint32_t kBufferSize = 1 << 16;
+
+public:
+
+    class Span {
+
+        Span(const Span&) = delete;
+        Span(Span&&) = delete;
+        Span& operator=(const Span&) = delete;
+        Span& operator=(Span&&) = delete;
+
+    public:
+
+        explicit Span(const char* const name) noexcept
+            : name(name), beginTime(Tracer::IsEnabled() ? Latency::Now() : 0) {}
+
+        ~Span() noexcept
+        {
+            if (this->beginTime != 0) Tracer::Record(this->name, this->beginTime, Latency::Now());
+        }
+
+    private:
+
+        const char* const name;
+        const Latency::tsc_t beginTime;
+
+    };
+
+public:
+
+    static bool Start() noexcept;
+    static bool Stop(const std::string& traceFile);
+
+    static inline bool IsEnabled() noexcept
+    {
+        return Tracer::enableStatus.load(std::memory_order_relaxed);
+    }
+
+    // Name shown for the calling thread in trace viewer
+    static void SetThreadName(const char* name);
+
+    static void Record(const char* name, Latency::tsc_t beginTime, Latency::tsc_t endTime) noexcept;
+
+private:
+
+    struct Event {
+
+        const char* name;
+        Latency::tsc_t beginTime;
+        Latency::tsc_t endTime;
+
+    };
+
+    struct Buffer {
+
+        uint32_t threadId { 0 };
+        std::string threadName;
+
+        std::atomic<uint64_t> writeIndex { 0 };
+        std::unique_ptr<Event[]> events { std::make_unique<Event[]>(kBufferSize) };
+
+        // Thread has exited, spans of the running trace are kept till stop
+        bool releaseStatus { false };
+
+    };
+
+    using BufferPtr = std::shared_ptr<Buffer>;
+
+    // Releases buffer of the thread on its exit
+    struct BufferOwner {
+
+        Buffer* buffer { nullptr };
+
+        ~BufferOwner() noexcept;
+
+    };
+
+private:
+
+    static Buffer* GetThreadBuffer();
+
+    // Called with locked buffers
+    static void DropReleasedBuffers() noexcept;
+
+private:
+
+    static std::atomic_bool enableStatus;
+    static Latency::tsc_t startTime;
+
+    static std::mutex buffersMutex;
+    static std::vector<BufferPtr> buffers;
+    static uint32_t lastThreadId;
+
+    static thread_local Buffer* threadBuffer;
+    static thread_local BufferOwner threadBufferOwner;
+    static thread_local std::string threadName;
+
+};
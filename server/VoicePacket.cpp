@@ -9,6 +9,12 @@
 
 #include "VoicePacket.h"
 
+#include <cstring>
+
+#include <util/siphash.h>
+
+#include "Header.h"
+
 static uint32_t CalcCrc32cHash(const uint8_t* buffer, uint32_t length, uint32_t crc = 0) noexcept
 {
     crc = ~crc;
@@ -23,6 +29,14 @@ static uint32_t CalcCrc32cHash(const uint8_t* buffer, uint32_t length, uint32_t
     return ~crc;
 }
 
+static uint8_t* WriteVarint(uint8_t* buffer, uint32_t value) noexcept
+{
+    for (; value >= 0x80; value >>= 7) *buffer++ = static_cast<uint8_t>(value | 0x80);
+    *buffer++ = static_cast<uint8_t>(value);
+
+    return buffer;
+}
+
 uint32_t VoicePacket::GetFullSize() const noexcept
 {
     return sizeof(*this) + this->length;
@@ -43,3 +57,85 @@ void VoicePacket::CalcHash() noexcept
         sizeof(*this) - sizeof(this->hash)
     );
 }
+
+bool VoicePacket::CheckAuthTag(const uint64_t k0, const uint64_t k1) const noexcept
+{
+    uint64_t tag; std::memcpy(&tag, this->data + this->length, sizeof(tag));
+    return tag == SipHash::Calc(k0, k1, this, this->GetFullSize());
+}
+
+uint32_t VoicePacket::WriteCompactHeader(uint8_t* const buffer) const noexcept
+{
+    auto pointer = buffer;
+
+    *pointer++ = (this->packet & SV::CompactFlagType::typeMask) |
+        (this->packid == NULL ? SV::CompactFlagType::firstPacket : NULL);
+
+    pointer = WriteVarint(pointer, this->stream);
+    pointer = WriteVarint(pointer, this->sender);
+
+    const auto packid = static_cast<uint16_t>(this->packid);
+    std::memcpy(pointer, &packid, sizeof(packid));
+    pointer += sizeof(packid);
+
+    return pointer - buffer;
+}
+
+bool VoicePacket::ReadCompactUpstream(const uint8_t* const buffer, const uint32_t length, const uint32_t lastPackid) noexcept
+{
+    if (length < kCompactUpstreamHeaderSize) return false;
+
+    uint16_t packid;
+
+    std::memcpy(&this->svrkey, buffer, sizeof(this->svrkey));
+    std::memcpy(&packid, buffer + sizeof(this->svrkey) + sizeof(uint8_t), sizeof(packid));
+
+    const uint8_t flags = buffer[sizeof(this->svrkey)];
+
+    this->packet = flags & SV::CompactFlagType::typeMask;
+    this->stream = NULL;
+    this->sender = NULL;
+    this->length = length - kCompactUpstreamHeaderSize;
+    this->packid = flags & SV::CompactFlagType::firstPacket ? NULL : VoicePacket::RestorePackid(lastPackid, packid);
+
+    std::memcpy(this->data, buffer + kCompactUpstreamHeaderSize, this->length);
+
+    // Streams calculate hash before forwarding anyway
+    this->hash = NULL;
+
+    return true;
+}
+
+uint32_t VoicePacket::RestorePackid(const uint32_t lastPackid, const uint16_t packid) noexcept
+{
+    // Nearest to the previous one, so that reordered packets stay behind it
+    return lastPackid + static_cast<int16_t>(packid - static_cast<uint16_t>(lastPackid));
+}
+
+bool VoicePacket::SplitSimulcast(VoicePacket& lowPacket) noexcept
+{
+    if (this->length < sizeof(SV::SimulcastPacket)) return false;
+
+    const auto simulcastPacket = reinterpret_cast<const SV::SimulcastPacket*>(this->data);
+
+    const uint32_t layersLength = this->length - sizeof(SV::SimulcastPacket);
+    const uint32_t mainLength = simulcastPacket->mainLength;
+
+    if (mainLength == 0 || mainLength >= layersLength) return false;
+
+    lowPacket.hash = NULL;
+    lowPacket.svrkey = this->svrkey;
+    lowPacket.packet = SV::VoicePacketType::voicePacket;
+    lowPacket.stream = this->stream;
+    lowPacket.sender = this->sender;
+    lowPacket.length = layersLength - mainLength;
+    lowPacket.packid = this->packid;
+
+    std::memcpy(lowPacket.data, simulcastPacket->data + mainLength, lowPacket.length);
+    std::memmove(this->data, simulcastPacket->data, mainLength);
+
+    this->packet = SV::VoicePacketType::voicePacket;
+    this->length = mainLength;
+
+    return true;
+}
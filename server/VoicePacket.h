@@ -30,6 +30,29 @@ struct VoicePacket
     uint32_t GetFullSize() const noexcept;
     bool CheckHeader() const noexcept;
     void CalcHash() noexcept;
+
+    // Tag is placed right after packet data and covers header with data
+    bool CheckAuthTag(uint64_t k0, uint64_t k1) const noexcept;
+
+    // Compact header (v3.3) replaces this one for players that negotiated it:
+    //   downstream: flags, varint stream, varint sender, packid (16 bits)
+    //   upstream:   player key (32 bits), flags, packid (16 bits)
+    // Data length is the rest of datagram (before tag), packid wraps and is
+    // restored by receiver from the previous one of the same sender
+    static constexpr uint32_t kMaxCompactHeaderSize = 1 + 5 + 3 + 2;
+    static constexpr uint32_t kCompactUpstreamHeaderSize = 4 + 1 + 2;
+
+    uint32_t WriteCompactHeader(uint8_t* buffer) const noexcept;
+
+    // Container must have room for 'length' bytes of data, 'lastPackid' is
+    // the restored packid of the previous packet from this player
+    bool ReadCompactUpstream(const uint8_t* buffer, uint32_t length, uint32_t lastPackid) noexcept;
+
+    static uint32_t RestorePackid(uint32_t lastPackid, uint16_t packid) noexcept;
+
+    // Turns simulcast packet into voice packet of its main layer and writes voice
+    // packet of low layer to 'lowPacket' that must have room for 'length' bytes
+    bool SplitSimulcast(VoicePacket& lowPacket) noexcept;
 };
 
 #pragma pack(pop)
@@ -0,0 +1,171 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Worker.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <util/logger.h>
+
+#include "Metrics.h"
+#include "Tracer.h"
+#include "Header.h"
+
+Worker::Worker(const uint32_t index, const bool affinityStatus)
+    : state(std::make_shared<State>())
+    , thread(std::make_unique<std::thread>(Worker::ThreadFunc, state, index))
+{
+    Worker::SetupThread(*this->thread, index, affinityStatus);
+}
+
+Worker::~Worker()
+{
+    // Thread may be blocked in socket until the next packet,
+    // it will exit by itself after that
+    if (this->thread->joinable())
+        this->thread->detach();
+
+    this->state->status.store(false);
+}
+
+uint64_t Worker::GetBusyTime() const noexcept
+{
+    return this->state->busyTime.load(std::memory_order_relaxed);
+}
+
+uint64_t Worker::GetBlockedTime() const noexcept
+{
+    return this->state->blockedTime.load(std::memory_order_relaxed);
+}
+
+void Worker::ThreadFunc(const std::shared_ptr<State> state, const uint32_t index)
+{
+    using Clock = std::chrono::steady_clock;
+
+    {
+        char threadName[16];
+        std::snprintf(threadName, sizeof(threadName), "sv-worker-%u", index);
+        Tracer::SetThreadName(threadName);
+    }
+
+    auto blockBeginTime = Clock::now();
+
+    while (state->status.load(std::memory_order_relaxed))
+    {
+        Latency::tsc_t receiveTime;
+
+        const auto voicePacket = Network::ReceiveVoicePacket(receiveTime);
+        if (voicePacket == nullptr) continue;
+
+        const auto busyBeginTime = Clock::now();
+
+        const Tracer::Span span { "Worker::FanOut" };
+
+        auto& voicePacketRef = *voicePacket;
+
+        // Layers are split once, streams choose one of them for every listener
+        static thread_local std::array<uint8_t, 1400> lowPacketBuffer;
+
+        VoicePacket* lowPacket { nullptr };
+        bool validStatus { true };
+
+        if (voicePacketRef->packet == SV::VoicePacketType::simulcastPacket)
+        {
+            lowPacket = reinterpret_cast<VoicePacket*>(lowPacketBuffer.data());
+            validStatus = voicePacketRef->SplitSimulcast(*lowPacket);
+            if (!validStatus) Metrics::Add(StatType::voicePacketsDroppedSize);
+        }
+
+        const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(voicePacketRef->sender);
+
+        if (validStatus && pPlayerInfo != nullptr && !pPlayerInfo->muteStatus.load(std::memory_order_relaxed) &&
+            (pPlayerInfo->recordStatus.load(std::memory_order_relaxed) || !pPlayerInfo->keys.empty()))
+        {
+            for (const auto stream : pPlayerInfo->speakerStreams)
+            {
+                // Relay has already forwarded the packet to listeners of such streams
+                if (stream->IsRelayed()) continue;
+
+                stream->SendVoicePacket(*&voicePacketRef, lowPacket);
+                Latency::Record(Latency::GetStreamLatencyType(stream->GetCreatePacketType()), Latency::Now() - receiveTime);
+            }
+
+            if (!pPlayerInfo->speakerStreams.empty())
+                Latency::Record(LatencyType::forward, Latency::Now() - receiveTime);
+        }
+
+        PlayerStore::ReleasePlayerWithSharedAccess(voicePacketRef->sender);
+
+        const auto busyEndTime = Clock::now();
+
+        state->blockedTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>
+            (busyBeginTime - blockBeginTime).count(), std::memory_order_relaxed);
+        state->busyTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>
+            (busyEndTime - busyBeginTime).count(), std::memory_order_relaxed);
+
+        blockBeginTime = busyEndTime;
+    }
+}
+
+void Worker::SetupThread(std::thread& thread, const uint32_t index, const bool affinityStatus) noexcept
+{
+    const auto cpuCount = std::thread::hardware_concurrency();
+
+    char threadName[16];
+    std::snprintf(threadName, sizeof(threadName), "sv-worker-%u", index);
+
+#ifdef _WIN32
+    // SetThreadDescription is only present since Windows 10 (1607)
+    using SetThreadDescriptionType = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+
+    if (const auto kernelModule = GetModuleHandleA("kernel32.dll"))
+    {
+        if (const auto setThreadDescription = reinterpret_cast<SetThreadDescriptionType>
+            (GetProcAddress(kernelModule, "SetThreadDescription")))
+        {
+            wchar_t threadNameW[sizeof(threadName)];
+            std::swprintf(threadNameW, sizeof(threadName), L"%hs", threadName);
+            setThreadDescription(thread.native_handle(), threadNameW);
+        }
+    }
+
+    if (affinityStatus && cpuCount != 0)
+    {
+        const auto cpuIndex = index % cpuCount;
+
+        if (cpuIndex < 8 * sizeof(DWORD_PTR) &&
+            SetThreadAffinityMask(thread.native_handle(), static_cast<DWORD_PTR>(1) << cpuIndex) == 0)
+        {
+            Logger::Log("[sv:err:worker:setup] : failed to set affinity for worker (%u)", index);
+        }
+    }
+#else
+    pthread_setname_np(thread.native_handle(), threadName);
+
+    if (affinityStatus && cpuCount != 0)
+    {
+        cpu_set_t cpuSet;
+
+        CPU_ZERO(&cpuSet);
+        CPU_SET(index % cpuCount, &cpuSet);
+
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0)
+            Logger::Log("[sv:err:worker:setup] : failed to set affinity for worker (%u)", index);
+    }
+#endif
+}
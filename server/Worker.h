@@ -10,6 +10,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <thread>
 
@@ -25,48 +26,38 @@ class Worker {
     Worker& operator=(const Worker&) = delete;
     Worker& operator=(Worker&&) = delete;
 
-public:
+private:
 
-    explicit Worker()
-        : status(std::make_shared<std::atomic_bool>(true))
-        , thread(std::make_unique<std::thread>(Worker::ThreadFunc, status))
-    {}
+    struct State {
 
-    ~Worker()
-    {
-        if (this->thread->joinable())
-            this->thread->detach();
+        std::atomic_bool status { true };
 
-        this->status->store(false);
-    }
+        // Nanoseconds spent on packet processing and
+        // waiting for packets in the socket respectively
+        std::atomic<uint64_t> busyTime { 0 };
+        std::atomic<uint64_t> blockedTime { 0 };
 
-private:
+    };
+
+public:
+
+    explicit Worker(uint32_t index, bool affinityStatus);
 
-    static void ThreadFunc(const std::shared_ptr<std::atomic_bool> status)
-    {
-        while (status->load(std::memory_order_relaxed))
-        {
-            const auto voicePacket = Network::ReceiveVoicePacket();
-            if (voicePacket == nullptr) continue;
+    ~Worker();
 
-            auto& voicePacketRef = *voicePacket;
+public:
 
-            const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(voicePacketRef->sender);
+    uint64_t GetBusyTime() const noexcept;
+    uint64_t GetBlockedTime() const noexcept;
 
-            if (pPlayerInfo != nullptr && !pPlayerInfo->muteStatus.load(std::memory_order_relaxed) &&
-                (pPlayerInfo->recordStatus.load(std::memory_order_relaxed) || !pPlayerInfo->keys.empty()))
-            {
-                for (const auto stream : pPlayerInfo->speakerStreams)
-                    stream->SendVoicePacket(*&voicePacketRef);
-            }
+private:
 
-            PlayerStore::ReleasePlayerWithSharedAccess(voicePacketRef->sender);
-        }
-    }
+    static void ThreadFunc(std::shared_ptr<State> state, uint32_t index);
+    static void SetupThread(std::thread& thread, uint32_t index, bool affinityStatus) noexcept;
 
 private:
 
-    const std::shared_ptr<std::atomic_bool> status;
+    const std::shared_ptr<State> state;
     const std::unique_ptr<std::thread> thread;
 
 };
@@ -0,0 +1,168 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+#include <util/logger.h>
+
+bool WorkerPool::Init(uint32_t minWorkers, uint32_t maxWorkers, const bool affinityStatus)
+{
+    if (WorkerPool::initStatus) return false;
+
+    if (minWorkers == 0) minWorkers = 1;
+    if (maxWorkers < minWorkers) maxWorkers = minWorkers;
+
+    Logger::Log("[sv:dbg:workerpool:init] : creating pool (min:%u;max:%u;affinity:%hhu)...",
+        minWorkers, maxWorkers, affinityStatus);
+
+    WorkerPool::minWorkers = minWorkers;
+    WorkerPool::maxWorkers = maxWorkers;
+    WorkerPool::affinityStatus = affinityStatus;
+
+    WorkerPool::workers.reserve(maxWorkers);
+    WorkerPool::Resize(minWorkers);
+
+    WorkerPool::initStatus = true;
+
+    return true;
+}
+
+void WorkerPool::Free() noexcept
+{
+    if (!WorkerPool::initStatus) return;
+
+    WorkerPool::workers.clear();
+    WorkerPool::workersBusyTime.clear();
+
+    WorkerPool::utilization = 0;
+
+    WorkerPool::initStatus = false;
+}
+
+void WorkerPool::Process()
+{
+    if (!WorkerPool::initStatus) return;
+
+    const auto curTime = Timer::Get();
+
+    // Pool is created before the first tick updates timer
+    if (WorkerPool::lastSampleTime == 0)
+    {
+        WorkerPool::ResetSamples();
+        return;
+    }
+
+    const auto sampleTime = curTime - WorkerPool::lastSampleTime;
+
+    if (sampleTime < kSampleInterval) return;
+
+    uint64_t busyTime { 0 };
+
+    for (std::size_t i { 0 }; i < WorkerPool::workers.size(); ++i)
+    {
+        const auto workerBusyTime = WorkerPool::workers[i]->GetBusyTime();
+
+        busyTime += workerBusyTime - WorkerPool::workersBusyTime[i];
+        WorkerPool::workersBusyTime[i] = workerBusyTime;
+    }
+
+    const uint64_t availableTime = static_cast<uint64_t>(sampleTime) * 1000000 * WorkerPool::workers.size();
+
+    WorkerPool::utilization = static_cast<uint32_t>(std::min<uint64_t>(100, 100 * busyTime / availableTime));
+    WorkerPool::lastSampleTime = curTime;
+
+    if (WorkerPool::utilization >= kScaleUpThreshold) ++WorkerPool::overloadSamples;
+    else WorkerPool::overloadSamples = 0;
+
+    if (WorkerPool::utilization <= kScaleDownThreshold) ++WorkerPool::idleSamples;
+    else WorkerPool::idleSamples = 0;
+
+    const auto workersCount = static_cast<uint32_t>(WorkerPool::workers.size());
+
+    if (WorkerPool::overloadSamples >= kScaleUpSamples && workersCount < WorkerPool::maxWorkers)
+    {
+        Logger::Log("[sv:dbg:workerpool:process] : utilization %u%%, scaling up to %u workers",
+            WorkerPool::utilization, workersCount + 1);
+
+        WorkerPool::Resize(workersCount + 1);
+    }
+    else if (WorkerPool::idleSamples >= kScaleDownSamples && workersCount > WorkerPool::minWorkers)
+    {
+        Logger::Log("[sv:dbg:workerpool:process] : utilization %u%%, scaling down to %u workers",
+            WorkerPool::utilization, workersCount - 1);
+
+        WorkerPool::Resize(workersCount - 1);
+    }
+}
+
+void WorkerPool::SetLimits(uint32_t minWorkers, uint32_t maxWorkers)
+{
+    if (!WorkerPool::initStatus) return;
+
+    if (minWorkers == 0) minWorkers = 1;
+    if (maxWorkers < minWorkers) maxWorkers = minWorkers;
+
+    WorkerPool::minWorkers = minWorkers;
+    WorkerPool::maxWorkers = maxWorkers;
+
+    const auto workersCount = static_cast<uint32_t>(WorkerPool::workers.size());
+
+    if (workersCount < minWorkers) WorkerPool::Resize(minWorkers);
+    else if (workersCount > maxWorkers) WorkerPool::Resize(maxWorkers);
+}
+
+uint32_t WorkerPool::GetWorkersCount() noexcept
+{
+    return static_cast<uint32_t>(WorkerPool::workers.size());
+}
+
+uint32_t WorkerPool::GetUtilization() noexcept
+{
+    return WorkerPool::utilization;
+}
+
+void WorkerPool::Resize(const uint32_t workersCount)
+{
+    while (WorkerPool::workers.size() > workersCount)
+        WorkerPool::workers.pop_back();
+
+    while (WorkerPool::workers.size() < workersCount)
+        WorkerPool::workers.emplace_back(MakeWorker(static_cast<uint32_t>
+            (WorkerPool::workers.size()), WorkerPool::affinityStatus));
+
+    WorkerPool::ResetSamples();
+}
+
+void WorkerPool::ResetSamples() noexcept
+{
+    WorkerPool::workersBusyTime.resize(WorkerPool::workers.size());
+
+    for (std::size_t i { 0 }; i < WorkerPool::workers.size(); ++i)
+        WorkerPool::workersBusyTime[i] = WorkerPool::workers[i]->GetBusyTime();
+
+    WorkerPool::lastSampleTime = Timer::Get();
+    WorkerPool::overloadSamples = 0;
+    WorkerPool::idleSamples = 0;
+}
+
+bool WorkerPool::initStatus { false };
+bool WorkerPool::affinityStatus { false };
+
+uint32_t WorkerPool::minWorkers { 0 };
+uint32_t WorkerPool::maxWorkers { 0 };
+
+std::vector<WorkerPtr> WorkerPool::workers;
+std::vector<uint64_t> WorkerPool::workersBusyTime;
+
+Timer::time_t WorkerPool::lastSampleTime { 0 };
+uint32_t WorkerPool::utilization { 0 };
+uint32_t WorkerPool::overloadSamples { 0 };
+uint32_t WorkerPool::idleSamples { 0 };
@@ -0,0 +1,73 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <util/timer.h>
+
+#include "Worker.h"
+
+class WorkerPool {
+
+    WorkerPool() = delete;
+    ~WorkerPool() = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+private:
+
+    static constexpr Timer::time_t kSampleInterval = 1000;
+
+    // Utilization thresholds in percents, pool grows after kScaleUpSamples
+    // overloaded samples in a row and shrinks after kScaleDownSamples idle ones
+    static constexpr uint32_t kScaleUpThreshold = 75;
+    static constexpr uint32_t kScaleDownThreshold = 25;
+    static constexpr uint32_t kScaleUpSamples = 3;
+    static constexpr uint32_t kScaleDownSamples = 30;
+
+public:
+
+    static bool Init(uint32_t minWorkers, uint32_t maxWorkers, bool affinityStatus);
+    static void Free() noexcept;
+
+    // Called from main thread, samples utilization and resizes pool
+    static void Process();
+
+    static void SetLimits(uint32_t minWorkers, uint32_t maxWorkers);
+
+    static uint32_t GetWorkersCount() noexcept;
+    static uint32_t GetUtilization() noexcept;
+
+private:
+
+    static void Resize(uint32_t workersCount);
+    static void ResetSamples() noexcept;
+
+private:
+
+    static bool initStatus;
+    static bool affinityStatus;
+
+    static uint32_t minWorkers;
+    static uint32_t maxWorkers;
+
+    static std::vector<WorkerPtr> workers;
+    static std::vector<uint64_t> workersBusyTime;
+
+    static Timer::time_t lastSampleTime;
+    static uint32_t utilization;
+    static uint32_t overloadSamples;
+    static uint32_t idleSamples;
+
+};
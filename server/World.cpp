@@ -0,0 +1,125 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "World.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <pawn/plugincommon.h>
+#include <ysf/globals.h>
+#include <util/logger.h>
+
+bool World::Init(void* const* const pluginData) noexcept
+{
+    if (pNetGame != nullptr) return true;
+
+    const auto getNetGame = reinterpret_cast<CNetGame*(*)()>(pluginData[PLUGIN_DATA_NETGAME]);
+    if (getNetGame == nullptr || (pNetGame = getNetGame()) == nullptr) return false;
+
+    Logger::Log("[sv:dbg:world:init] : net game pointer (value:%p) received", pNetGame);
+
+    return true;
+}
+
+bool World::IsReady() noexcept
+{
+    return pNetGame != nullptr && pNetGame->pPlayerPool != nullptr;
+}
+
+uint32_t World::GetConnectedPlayersCount() noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pPlayerPool != nullptr);
+
+    return pNetGame->pPlayerPool->dwConnectedPlayers;
+}
+
+uint16_t World::GetPlayerPoolSize() noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pPlayerPool != nullptr);
+
+    return static_cast<uint16_t>(std::min<uint32_t>(pNetGame->pPlayerPool->dwPlayerPoolSize, MAX_PLAYERS - 1));
+}
+
+bool World::IsPlayerConnected(const uint16_t playerId) noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pPlayerPool != nullptr);
+
+    assert(playerId >= 0 && playerId < MAX_PLAYERS);
+
+    return pNetGame->pPlayerPool->bIsPlayerConnected[playerId];
+}
+
+bool World::IsPlayerExists(const uint16_t playerId) noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pPlayerPool != nullptr);
+
+    return playerId < MAX_PLAYERS && pNetGame->pPlayerPool->pPlayer[playerId] != nullptr;
+}
+
+bool World::IsVehicleExists(const uint16_t vehicleId) noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pVehiclePool != nullptr);
+
+    return vehicleId < MAX_VEHICLES && pNetGame->pVehiclePool->pVehicle[vehicleId] != nullptr;
+}
+
+bool World::IsObjectExists(const uint16_t objectId) noexcept
+{
+    assert(pNetGame != nullptr);
+    assert(pNetGame->pObjectPool != nullptr);
+
+    return objectId < MAX_OBJECTS && pNetGame->pObjectPool->pObjects[objectId] != nullptr;
+}
+
+bool World::GetPlayerPosition(const uint16_t playerId, CVector& position) noexcept
+{
+    if (!World::IsPlayerExists(playerId)) return false;
+
+    position = pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition;
+
+    return true;
+}
+
+bool World::GetVehiclePosition(const uint16_t vehicleId, CVector& position) noexcept
+{
+    if (!World::IsVehicleExists(vehicleId)) return false;
+
+    position = pNetGame->pVehiclePool->pVehicle[vehicleId]->vecPosition;
+
+    return true;
+}
+
+bool World::GetObjectPosition(const uint16_t objectId, CVector& position) noexcept
+{
+    if (!World::IsObjectExists(objectId)) return false;
+
+    position = pNetGame->pObjectPool->pObjects[objectId]->matWorld.pos;
+
+    return true;
+}
+
+bool World::IsPlayerStreamedIn(const uint16_t playerId, const uint16_t forPlayerId) noexcept
+{
+    if (playerId >= MAX_PLAYERS || !World::IsPlayerExists(forPlayerId)) return false;
+
+    return pNetGame->pPlayerPool->pPlayer[forPlayerId]->byteStreamedIn[playerId];
+}
+
+bool World::IsVehicleStreamedIn(const uint16_t vehicleId, const uint16_t forPlayerId) noexcept
+{
+    if (vehicleId >= MAX_VEHICLES || !World::IsPlayerExists(forPlayerId)) return false;
+
+    return pNetGame->pPlayerPool->pPlayer[forPlayerId]->byteVehicleStreamedIn[vehicleId];
+}
@@ -0,0 +1,53 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <ysf/structs.h>
+
+// Game world of the host server as seen by streams: players, vehicles and
+// objects with their positions and streaming state. World.cpp reads it from
+// SA-MP net game structures, a host with other memory layout (or pointer
+// size) replaces only that file. Network side of the host is RakNet class.
+class World {
+
+    World() = delete;
+    ~World() = delete;
+    World(const World&) = delete;
+    World(World&&) = delete;
+    World& operator=(const World&) = delete;
+    World& operator=(World&&) = delete;
+
+public:
+
+    // Takes game state from plugin data table, may be called
+    // until it succeeds (net game is created after plugins load)
+    static bool Init(void* const* pluginData) noexcept;
+    static bool IsReady() noexcept;
+
+    static uint32_t GetConnectedPlayersCount() noexcept;
+    // Highest player id ever connected, loops go up to it inclusive
+    static uint16_t GetPlayerPoolSize() noexcept;
+
+    static bool IsPlayerConnected(uint16_t playerId) noexcept;
+    static bool IsPlayerExists(uint16_t playerId) noexcept;
+    static bool IsVehicleExists(uint16_t vehicleId) noexcept;
+    static bool IsObjectExists(uint16_t objectId) noexcept;
+
+    // Return false if entity does not exist
+    static bool GetPlayerPosition(uint16_t playerId, CVector& position) noexcept;
+    static bool GetVehiclePosition(uint16_t vehicleId, CVector& position) noexcept;
+    static bool GetObjectPosition(uint16_t objectId, CVector& position) noexcept;
+
+    static bool IsPlayerStreamedIn(uint16_t playerId, uint16_t forPlayerId) noexcept;
+    static bool IsVehicleStreamedIn(uint16_t vehicleId, uint16_t forPlayerId) noexcept;
+
+};
@@ -0,0 +1,144 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../Header.h"
+
+void Bench::SetFilter(const std::string& filter) noexcept
+{
+    Bench::filter = filter;
+}
+
+bool Bench::IsEnabled(const std::string& name) noexcept
+{
+    return Bench::filter.empty() || name.find(Bench::filter) != std::string::npos;
+}
+
+void Bench::Report(const std::string& name, const std::string& params, const uint64_t iterations,
+                   const uint64_t runTime, const uint64_t opsPerIteration, const uint32_t threads) noexcept
+{
+    Result result;
+
+    result.name = name;
+    result.params = params;
+    result.iterations = iterations;
+    result.threads = threads;
+    result.nsPerOp = static_cast<double>(runTime) / (iterations * opsPerIteration);
+    result.opsPerSec = 1e9 * iterations * opsPerIteration * threads / runTime;
+
+    std::printf("%-40s %-28s %12.1f ns/op %14.0f ops/s", name.c_str(),
+        params.c_str(), result.nsPerOp, result.opsPerSec);
+
+    const auto baselineIter = Bench::baseline.find(name + '\t' + params);
+    if (baselineIter != Bench::baseline.end() && baselineIter->second > 0)
+        std::printf(" %+8.1f%%", 100 * (result.nsPerOp / baselineIter->second - 1));
+
+    std::putchar('\n');
+    std::fflush(stdout);
+
+    Bench::results.emplace_back(std::move(result));
+}
+
+void Bench::AddCounter(const std::string& counter, const double value) noexcept
+{
+    if (Bench::results.empty()) return;
+
+    std::printf("%-40s %-28s %12.1f %s\n", "", "", value, counter.c_str());
+    std::fflush(stdout);
+
+    Bench::results.back().counters.emplace_back(counter, value);
+}
+
+bool Bench::WriteJson(const std::string& fileName) noexcept
+{
+    const auto file = std::fopen(fileName.c_str(), "w");
+    if (file == nullptr) return false;
+
+    std::fprintf(file, "{\"version\":%hhu,\"compiler\":\"%s\",\"pointer_size\":%zu,\"benchmarks\":[",
+        SV::kVersion, __VERSION__, sizeof(void*));
+
+    for (std::size_t i = 0; i < Bench::results.size(); ++i)
+    {
+        const auto& result = Bench::results[i];
+
+        std::fprintf(file, "%s{\"name\":\"%s\",\"params\":\"%s\",\"iterations\":%llu,"
+            "\"threads\":%u,\"ns_per_op\":%.3f,\"ops_per_sec\":%.1f",
+            i != 0 ? "," : "", result.name.c_str(), result.params.c_str(),
+            static_cast<unsigned long long>(result.iterations), result.threads,
+            result.nsPerOp, result.opsPerSec);
+
+        for (const auto& counter : result.counters)
+            std::fprintf(file, ",\"%s\":%.1f", counter.first.c_str(), counter.second);
+
+        std::fputc('}', file);
+    }
+
+    std::fputs("]}\n", file);
+    std::fclose(file);
+
+    return true;
+}
+
+bool Bench::LoadBaseline(const std::string& fileName) noexcept
+{
+    const auto file = std::fopen(fileName.c_str(), "r");
+    if (file == nullptr) return false;
+
+    std::string json;
+
+    char buffer[4096];
+    std::size_t readSize;
+
+    while ((readSize = std::fread(buffer, 1, sizeof(buffer), file)) != 0)
+        json.append(buffer, readSize);
+
+    std::fclose(file);
+
+    // Only the layout produced by WriteJson is understood
+    const auto readString = [&json](const char* const key, std::size_t& position, std::string& value) -> bool
+    {
+        const auto keyPosition = json.find(key, position);
+        if (keyPosition == std::string::npos) return false;
+
+        const auto valueBegin = keyPosition + std::strlen(key);
+        const auto valueEnd = json.find('"', valueBegin);
+        if (valueEnd == std::string::npos) return false;
+
+        value.assign(json, valueBegin, valueEnd - valueBegin);
+        position = valueEnd;
+
+        return true;
+    };
+
+    std::size_t position { 0 };
+    std::string name, params;
+
+    while (readString("{\"name\":\"", position, name) && readString("\"params\":\"", position, params))
+    {
+        constexpr char kNsPerOpKey[] = "\"ns_per_op\":";
+
+        const auto keyPosition = json.find(kNsPerOpKey, position);
+        if (keyPosition == std::string::npos) break;
+
+        position = keyPosition + sizeof(kNsPerOpKey) - 1;
+
+        Bench::baseline[name + '\t' + params] = std::strtod(json.c_str() + position, nullptr);
+    }
+
+    return !Bench::baseline.empty();
+}
+
+std::string Bench::filter;
+std::vector<Bench::Result> Bench::results;
+std::map<std::string, double> Bench::baseline;
@@ -0,0 +1,115 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal microbenchmark runner: body is called with growing iteration
+// count until one run lasts long enough to be measured reliably
+class Bench {
+
+    Bench() = delete;
+    ~Bench() = delete;
+    Bench(const Bench&) = delete;
+    Bench(Bench&&) = delete;
+    Bench& operator=(const Bench&) = delete;
+    Bench& operator=(Bench&&) = delete;
+
+private:
+
+    static constexpr uint64_t kMinRunTime = 200000000; // ns
+    static constexpr uint64_t kMaxIterations = 1ull << 32;
+
+public:
+
+    struct Result {
+
+        std::string name;
+        std::string params;
+
+        uint64_t iterations { 0 };
+        uint32_t threads { 1 };
+
+        double nsPerOp { 0 };
+        double opsPerSec { 0 };
+
+        // Measured quantities other than time, e.g. bytes sent per operation
+        std::vector<std::pair<std::string, double>> counters;
+
+    };
+
+public:
+
+    static void SetFilter(const std::string& filter) noexcept;
+    static bool IsEnabled(const std::string& name) noexcept;
+
+    // 'body' performs given number of iterations, every iteration is
+    // 'opsPerIteration' operations done by each of 'threads' threads
+    template <class Body>
+    static void Run(const std::string& name, const std::string& params, Body&& body,
+                    const uint64_t opsPerIteration = 1, const uint32_t threads = 1)
+    {
+        if (!Bench::IsEnabled(name)) return;
+
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t iterations { 1 };
+        uint64_t runTime { 0 };
+
+        while (true)
+        {
+            const auto beginTime = Clock::now();
+            body(iterations);
+            runTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - beginTime).count();
+
+            if (runTime >= kMinRunTime || iterations >= kMaxIterations) break;
+
+            // Aim slightly above the minimum to finish in one more run
+            const auto estimate = runTime != 0 ? iterations * (kMinRunTime * 5 / 4) / runTime : iterations * 100;
+            iterations = std::min(std::max(estimate, iterations * 2), iterations * 100);
+        }
+
+        Bench::Report(name, params, iterations, runTime, opsPerIteration, threads);
+    }
+
+    // Keeps compiler from throwing away computations whose result is unused
+    template <class Type>
+    static inline void Consume(const Type& value) noexcept
+    {
+        asm volatile("" : : "g"(value) : "memory");
+    }
+
+    // Attaches counter to the result of the last run
+    static void AddCounter(const std::string& counter, double value) noexcept;
+
+    static bool WriteJson(const std::string& fileName) noexcept;
+
+    // Takes results written by WriteJson in another run (e.g. other
+    // build), reports then show change of ns/op against them
+    static bool LoadBaseline(const std::string& fileName) noexcept;
+
+private:
+
+    static void Report(const std::string& name, const std::string& params, uint64_t iterations,
+                       uint64_t runTime, uint64_t opsPerIteration, uint32_t threads) noexcept;
+
+private:
+
+    static std::string filter;
+    static std::vector<Result> results;
+    static std::map<std::string, double> baseline;
+
+};
@@ -0,0 +1,203 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Fixture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <ysf/globals.h>
+
+#include "../ControlPacket.h"
+#include "../Header.h"
+#include "../Network.h"
+#include "../PlayerStore.h"
+#include "../RelayLink.h"
+#include "../StateMirror.h"
+#include "../VoicePacket.h"
+
+// Network stand-in
+// --------------------------------------------------------------------
+
+bool Network::SendControlPacket(const uint16_t, const ControlPacket&)
+{
+    Fixture::sentControlPackets.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool Network::SendVoicePacket(const uint16_t, const VoicePacket& voicePacket)
+{
+    Fixture::sentVoicePackets.fetch_add(1, std::memory_order_relaxed);
+    Fixture::sentVoiceBytes.fetch_add(voicePacket.GetFullSize(), std::memory_order_relaxed);
+    return true;
+}
+
+// RelayLink stand-in (relay is never enabled in benchmarks)
+// --------------------------------------------------------------------
+
+void RelayLink::PublishStream(const uint32_t, const bool) noexcept {}
+void RelayLink::PublishStreamDelete(const uint32_t) noexcept {}
+void RelayLink::PublishListener(const uint32_t, const uint16_t, const uint8_t) noexcept {}
+void RelayLink::PublishSpeaker(const uint32_t, const uint16_t, const bool) noexcept {}
+
+bool RelayLink::initStatus { false };
+
+// StateMirror stand-in (mirror has its own benchmark on a private segment)
+// --------------------------------------------------------------------
+
+void StateMirror::MarkPlayer(const uint16_t) noexcept {}
+void StateMirror::MarkStream(const uint32_t) noexcept {}
+
+bool StateMirror::initStatus { false };
+
+// Fixture
+// --------------------------------------------------------------------
+
+bool Fixture::Init(const uint16_t playersCount, const uint32_t seed) noexcept
+{
+    Fixture::Free();
+
+    Fixture::randomState = seed != 0 ? seed : 1;
+
+    if ((pNetGame = static_cast<CNetGame*>(std::calloc(1, sizeof(CNetGame)))) == nullptr ||
+        (pNetGame->pPlayerPool = static_cast<CPlayerPool*>(std::calloc(1, sizeof(CPlayerPool)))) == nullptr ||
+        (pNetGame->pVehiclePool = static_cast<CVehiclePool*>(std::calloc(1, sizeof(CVehiclePool)))) == nullptr ||
+        (pNetGame->pObjectPool = static_cast<CObjectPool*>(std::calloc(1, sizeof(CObjectPool)))) == nullptr)
+    {
+        Fixture::Free();
+        return false;
+    }
+
+    for (uint16_t playerId { 0 }; playerId < playersCount && playerId < MAX_PLAYERS; ++playerId)
+    {
+        const auto pPlayer = static_cast<CPlayer*>(std::calloc(1, sizeof(CPlayer)));
+        if (pPlayer == nullptr) break;
+
+        pPlayer->vecPosition = Fixture::GetRandomPosition();
+
+        // Everything around is streamed in, distance checks are left to the plugin
+        std::fill(std::begin(pPlayer->byteStreamedIn), std::end(pPlayer->byteStreamedIn), true);
+        std::fill(std::begin(pPlayer->byteVehicleStreamedIn), std::end(pPlayer->byteVehicleStreamedIn), true);
+
+        pNetGame->pPlayerPool->pPlayer[playerId] = pPlayer;
+        pNetGame->pPlayerPool->bIsPlayerConnected[playerId] = true;
+        pNetGame->pPlayerPool->dwConnectedPlayers = playerId + 1;
+        pNetGame->pPlayerPool->dwPlayerPoolSize = playerId;
+
+        const auto angle = 6.2831853f * (Fixture::NextRandom() & 0xffff) / 0x10000;
+        Fixture::directions[playerId] = { std::cos(angle), std::sin(angle), 0.f };
+
+        PlayerStore::AddPlayerToStore(playerId, SV::kVersion, true);
+
+        Fixture::playersCount = playerId + 1;
+    }
+
+    return true;
+}
+
+void Fixture::Free() noexcept
+{
+    PlayerStore::ClearStore();
+
+    if (pNetGame == nullptr) return;
+
+    if (pNetGame->pPlayerPool != nullptr)
+    {
+        for (const auto pPlayer : pNetGame->pPlayerPool->pPlayer) std::free(pPlayer);
+        std::free(pNetGame->pPlayerPool);
+    }
+
+    if (pNetGame->pVehiclePool != nullptr)
+    {
+        for (const auto pVehicle : pNetGame->pVehiclePool->pVehicle) std::free(pVehicle);
+        std::free(pNetGame->pVehiclePool);
+    }
+
+    if (pNetGame->pObjectPool != nullptr)
+    {
+        for (const auto pObject : pNetGame->pObjectPool->pObjects) std::free(pObject);
+        std::free(pNetGame->pObjectPool);
+    }
+
+    std::free(pNetGame);
+    pNetGame = nullptr;
+
+    Fixture::playersCount = 0;
+}
+
+CVector Fixture::GetRandomPosition() noexcept
+{
+    return { kArea * (Fixture::NextRandom() & 0xffff) / 0x10000,
+             kArea * (Fixture::NextRandom() & 0xffff) / 0x10000, 10.f };
+}
+
+uint32_t Fixture::NextRandom() noexcept
+{
+    // xorshift keeps runs reproducible across standard libraries
+    auto& x = Fixture::randomState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return x;
+}
+
+void Fixture::MovePlayers(const float step) noexcept
+{
+    for (uint16_t playerId { 0 }; playerId < Fixture::playersCount; ++playerId)
+    {
+        auto& position = pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition;
+        auto& direction = Fixture::directions[playerId];
+
+        position.fX += direction.fX * step;
+        position.fY += direction.fY * step;
+
+        if (position.fX < 0.f || position.fX > kArea) direction.fX = -direction.fX;
+        if (position.fY < 0.f || position.fY > kArea) direction.fY = -direction.fY;
+    }
+}
+
+bool Fixture::CreateVehicle(const uint16_t vehicleId, const CVector& position) noexcept
+{
+    if (pNetGame == nullptr || vehicleId >= MAX_VEHICLES) return false;
+
+    auto& pVehicle = pNetGame->pVehiclePool->pVehicle[vehicleId];
+
+    if (pVehicle == nullptr && (pVehicle = static_cast<CVehicle*>(std::calloc(1, sizeof(CVehicle)))) == nullptr)
+        return false;
+
+    pVehicle->vecPosition = position;
+
+    return true;
+}
+
+bool Fixture::CreateObject(const uint16_t objectId, const CVector& position) noexcept
+{
+    if (pNetGame == nullptr || objectId >= MAX_OBJECTS) return false;
+
+    auto& pObject = pNetGame->pObjectPool->pObjects[objectId];
+
+    if (pObject == nullptr && (pObject = static_cast<CObject*>(std::calloc(1, sizeof(CObject)))) == nullptr)
+        return false;
+
+    pObject->matWorld.pos = position;
+
+    return true;
+}
+
+std::atomic<uint64_t> Fixture::sentControlPackets { 0 };
+std::atomic<uint64_t> Fixture::sentVoicePackets { 0 };
+std::atomic<uint64_t> Fixture::sentVoiceBytes { 0 };
+
+uint16_t Fixture::playersCount { 0 };
+uint32_t Fixture::randomState { 1 };
+
+CVector Fixture::directions[MAX_PLAYERS];
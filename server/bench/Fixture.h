@@ -0,0 +1,61 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include <ysf/structs.h>
+
+// Game state and network stand-in for benchmarks: mock net game with
+// players walking inside a square area, all of them having the plugin,
+// and Network send functions replaced with counters
+class Fixture {
+
+    Fixture() = delete;
+    ~Fixture() = delete;
+    Fixture(const Fixture&) = delete;
+    Fixture(Fixture&&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+    Fixture& operator=(Fixture&&) = delete;
+
+public:
+
+    static constexpr float kArea = 500.f;
+
+public:
+
+    static bool Init(uint16_t playersCount, uint32_t seed = 1) noexcept;
+    static void Free() noexcept;
+
+    static CVector GetRandomPosition() noexcept;
+    static uint32_t NextRandom() noexcept;
+
+    // Moves every player by 'step' meters along his own direction
+    static void MovePlayers(float step) noexcept;
+
+    static bool CreateVehicle(uint16_t vehicleId, const CVector& position) noexcept;
+    static bool CreateObject(uint16_t objectId, const CVector& position) noexcept;
+
+public:
+
+    static std::atomic<uint64_t> sentControlPackets;
+    static std::atomic<uint64_t> sentVoicePackets;
+    static std::atomic<uint64_t> sentVoiceBytes;
+
+private:
+
+    static uint16_t playersCount;
+    static uint32_t randomState;
+
+    static CVector directions[MAX_PLAYERS];
+
+};
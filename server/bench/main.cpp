@@ -0,0 +1,854 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef SV_MCU
+#include <opus.h>
+#endif
+
+#include <util/siphash.h>
+
+#include "../ControlPacket.h"
+#include "../DynamicLocalStreamAtObject.h"
+#include "../DynamicLocalStreamAtPlayer.h"
+#include "../DynamicLocalStreamAtPoint.h"
+#include "../DynamicLocalStreamAtVehicle.h"
+#include "../GlobalStream.h"
+#include "../Group.h"
+#include "../Header.h"
+#include "../Mixer.h"
+#include "../MirrorProtocol.h"
+#include "../PlayerStore.h"
+#include "../SlotMap.h"
+#include "../VoicePacket.h"
+
+#include "Bench.h"
+#include "Fixture.h"
+
+namespace
+{
+    constexpr uint64_t kAuthKey0 = 0x0706050403020100;
+    constexpr uint64_t kAuthKey1 = 0x0f0e0d0c0b0a0908;
+
+    constexpr float kStreamDistance = 50.f;
+    constexpr uint32_t kStreamMaxPlayers = 100;
+    constexpr uint32_t kStreamColor = 0xff00ff00;
+
+    // Opus frames of 100 ms at 8..48 kbit/s
+    constexpr uint32_t kPayloadSizes[] { 100, 300, 600 };
+
+    std::string Param(const char* const name, const uint64_t value)
+    {
+        return std::string(name) + '=' + std::to_string(value);
+    }
+
+    std::vector<uint8_t> MakeVoicePacket(const uint32_t payloadSize, const uint16_t sender)
+    {
+        std::vector<uint8_t> buffer(sizeof(VoicePacket) + payloadSize + SV::kVoiceAuthTagSize);
+
+        auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+        packet.svrkey = 0x12345678;
+        packet.packet = SV::VoicePacketType::voicePacket;
+        packet.sender = sender;
+        packet.length = payloadSize;
+        packet.packid = 1;
+
+        for (uint32_t i = 0; i < payloadSize; ++i)
+            packet.data[i] = static_cast<uint8_t>(i * 131u);
+
+        packet.CalcHash();
+
+        const auto tag = SipHash::Calc(kAuthKey0, kAuthKey1, &packet, packet.GetFullSize());
+        std::memcpy(packet.data + payloadSize, &tag, sizeof(tag));
+
+        return buffer;
+    }
+
+    // Voice packet
+    // --------------------------------------------------------------------
+
+    void BenchVoicePacket()
+    {
+        auto buffer = MakeVoicePacket(kPayloadSizes[0], 0);
+        auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+        Bench::Run("voice_packet/calc_hash", "", [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                packet.packid = static_cast<uint32_t>(i);
+                packet.CalcHash();
+                Bench::Consume(packet.hash);
+            }
+        });
+
+        Bench::Run("voice_packet/check_header", "", [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+                Bench::Consume(packet.CheckHeader());
+        });
+
+        // Cost of voice authentication paid by worker for every incoming packet
+        for (const auto payloadSize : kPayloadSizes)
+        {
+            auto buffer = MakeVoicePacket(payloadSize, 0);
+            const auto& packet = *reinterpret_cast<const VoicePacket*>(buffer.data());
+
+            Bench::Run("voice_packet/check_auth_tag", Param("payload", payloadSize), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    Bench::Consume(packet.CheckAuthTag(kAuthKey0, kAuthKey1));
+            });
+        }
+
+        // Compact header is written for every listener that negotiated it,
+        // stream handle is taken from a real slot map to get its varint size
+        {
+            SlotMap<VoicePacket> handles;
+            packet.stream = handles.Insert(&packet);
+
+            uint8_t header[VoicePacket::kMaxCompactHeaderSize];
+            uint32_t headerSize { 0 };
+
+            Bench::Run("voice_packet/write_compact_header", "", [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    packet.packid = static_cast<uint32_t>(i);
+                    headerSize = packet.WriteCompactHeader(header);
+                    Bench::Consume(header);
+                }
+            });
+
+            Bench::AddCounter("header_bytes", headerSize);
+            Bench::AddCounter("legacy_header_bytes", sizeof(VoicePacket));
+        }
+
+        for (const auto payloadSize : kPayloadSizes)
+        {
+            std::vector<uint8_t> datagram(VoicePacket::kCompactUpstreamHeaderSize + payloadSize);
+
+            datagram[sizeof(uint32_t)] = SV::VoicePacketType::voicePacket;
+            for (uint32_t i = 0; i < payloadSize; ++i)
+                datagram[VoicePacket::kCompactUpstreamHeaderSize + i] = static_cast<uint8_t>(i * 131u);
+
+            std::vector<uint8_t> buffer(sizeof(VoicePacket) + payloadSize);
+            auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+            Bench::Run("voice_packet/read_compact_upstream", Param("payload", payloadSize), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const uint16_t packid = static_cast<uint16_t>(i + 1);
+                    std::memcpy(datagram.data() + sizeof(uint32_t) + sizeof(uint8_t), &packid, sizeof(packid));
+                    Bench::Consume(packet.ReadCompactUpstream(datagram.data(), datagram.size(), static_cast<uint32_t>(i)));
+                }
+            });
+        }
+
+        // Split is done in place, so every iteration also restores the packet
+        // as worker would have received it
+        for (const auto payloadSize : kPayloadSizes)
+        {
+            const uint32_t lowSize = payloadSize / 3;
+            const uint32_t layersSize = sizeof(SV::SimulcastPacket) + payloadSize + lowSize;
+
+            auto source = MakeVoicePacket(layersSize, 0);
+            reinterpret_cast<VoicePacket*>(source.data())->packet = SV::VoicePacketType::simulcastPacket;
+            reinterpret_cast<SV::SimulcastPacket*>(reinterpret_cast<VoicePacket*>(source.data())->data)->mainLength = payloadSize;
+
+            std::vector<uint8_t> buffer(source.size());
+            std::vector<uint8_t> lowBuffer(sizeof(VoicePacket) + lowSize);
+
+            auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+            auto& lowPacket = *reinterpret_cast<VoicePacket*>(lowBuffer.data());
+
+            Bench::Run("voice_packet/split_simulcast", Param("payload", payloadSize), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    std::memcpy(buffer.data(), source.data(), source.size());
+                    Bench::Consume(packet.SplitSimulcast(lowPacket));
+                }
+            });
+        }
+    }
+
+    // Player key lookup
+    // --------------------------------------------------------------------
+
+    // Same container and locking as Network's key to player id table
+    void BenchPlayerKeyLookup()
+    {
+        for (const uint32_t playersCount : { 100u, 1000u })
+        {
+            std::shared_mutex tableMutex;
+            std::map<uint64_t, uint16_t> table;
+            std::vector<uint64_t> keys;
+
+            for (uint32_t playerId = 0; playerId < playersCount; ++playerId)
+            {
+                const uint64_t playerAddr = 0x0100007f + (playerId << 24);
+                const uint64_t playerKey = playerAddr << 32 | Fixture::NextRandom();
+
+                table[playerKey] = playerId;
+                keys.emplace_back(playerKey);
+            }
+
+            Bench::Run("network/player_key_lookup", Param("players", playersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const std::shared_lock<std::shared_mutex> lock { tableMutex };
+                    const auto iter = table.find(keys[(i * 7919) % keys.size()]);
+                    Bench::Consume(iter != table.end() ? iter->second : SV::kNonePlayer);
+                }
+            });
+        }
+    }
+
+    // Stream fan-out
+    // --------------------------------------------------------------------
+
+    void BenchStreamFanOut()
+    {
+        for (const uint16_t listenersCount : { 10, 100, 500, 999 })
+        {
+            if (!Bench::IsEnabled("stream/send_voice_packet") &&
+                !Bench::IsEnabled("stream/send_voice_packet_simulcast")) break;
+
+            Fixture::Init(listenersCount + 1);
+
+            const auto stream = std::make_unique<GlobalStream>(kStreamColor, "bench");
+
+            stream->AttachSpeaker(0);
+
+            for (uint16_t playerId { 1 }; playerId <= listenersCount; ++playerId)
+                stream->AttachListener(playerId);
+
+            auto buffer = MakeVoicePacket(kPayloadSizes[1], 0);
+            auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+            Bench::Run("stream/send_voice_packet", Param("listeners", listenersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    stream->SendVoicePacket(packet);
+            });
+
+            // Every other listener is congested and gets the low layer
+            auto lowBuffer = MakeVoicePacket(kPayloadSizes[1] / 3, 0);
+            auto& lowPacket = *reinterpret_cast<VoicePacket*>(lowBuffer.data());
+
+            for (uint16_t playerId { 2 }; playerId <= listenersCount; playerId += 2)
+                Stream::SetListenerCongestion(playerId, true);
+
+            Bench::Run("stream/send_voice_packet_simulcast", Param("listeners", listenersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    stream->SendVoicePacket(packet, &lowPacket);
+            });
+
+            for (uint16_t playerId { 2 }; playerId <= listenersCount; playerId += 2)
+                Stream::SetListenerCongestion(playerId, false);
+
+            stream->DetachAllListeners();
+            stream->DetachAllSpeakers();
+        }
+
+        Fixture::Free();
+    }
+
+    // Mixer
+    // --------------------------------------------------------------------
+
+    // Voice-like signal: harmonics of speaker's own pitch under syllable envelope
+    void MakeVoiceFrame(int16_t* const pcm, const uint32_t speaker, const uint32_t frameIndex)
+    {
+        const float pitch = 100.f + 13.f * (speaker % 11);
+
+        for (uint32_t i = 0; i < SV::kFrameSizeInSamples; ++i)
+        {
+            const float time = static_cast<float>(frameIndex * SV::kFrameSizeInSamples + i) / SV::kFrequency;
+            const float envelope = 0.5f + 0.5f * std::sin(2.f * 3.14159265f * 4.f * time + speaker);
+
+            float sample = 0;
+
+            for (uint32_t harmonic = 1; harmonic <= 5; ++harmonic)
+                sample += std::sin(2.f * 3.14159265f * pitch * harmonic * time) / harmonic;
+
+            pcm[i] = static_cast<int16_t>(4000.f * envelope * sample);
+        }
+    }
+
+    void BenchMixKernel()
+    {
+        std::vector<std::array<int16_t, SV::kFrameSizeInSamples>> frames(40);
+        std::array<int32_t, SV::kFrameSizeInSamples> mix {};
+        std::array<int16_t, SV::kFrameSizeInSamples> output {};
+
+        for (uint32_t speaker = 0; speaker < frames.size(); ++speaker)
+            MakeVoiceFrame(frames[speaker].data(), speaker, 0);
+
+        // One operation is mixing of a whole frame as mixer does every tick
+        for (const uint32_t speakersCount : { 2u, 10u, 40u })
+        {
+            Bench::Run("mixer/mix_kernel", Param("speakers", speakersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    std::fill(mix.begin(), mix.end(), 0);
+
+                    for (uint32_t speaker = 0; speaker < speakersCount; ++speaker)
+                        Mixer::Accumulate(mix.data(), frames[speaker].data(), mix.size());
+
+                    Mixer::Saturate(output.data(), mix.data(), output.size());
+                    Bench::Consume(output[i % output.size()]);
+                }
+            });
+        }
+    }
+
+#ifdef SV_MCU
+    // Speaker's packets as client sends them, cycled during benchmark
+    std::vector<std::vector<uint8_t>> EncodeVoicePackets(const uint16_t speaker, const uint32_t framesCount)
+    {
+        std::vector<std::vector<uint8_t>> packets;
+
+        int opusErrorCode { -1 };
+
+        const auto encoder = opus_encoder_create(SV::kFrequency, 1, OPUS_APPLICATION_VOIP, &opusErrorCode);
+        if (encoder == nullptr) return packets;
+
+        opus_encoder_ctl(encoder, OPUS_SET_BITRATE(SV::kDefaultBitrate));
+        opus_encoder_ctl(encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+
+        std::array<int16_t, SV::kFrameSizeInSamples> pcm {};
+
+        for (uint32_t frameIndex = 0; frameIndex < framesCount; ++frameIndex)
+        {
+            MakeVoiceFrame(pcm.data(), speaker, frameIndex);
+
+            uint8_t data[1200];
+
+            const auto length = opus_encode(encoder, pcm.data(), SV::kFrameSizeInSamples, data, sizeof(data));
+            if (length <= 0) break;
+
+            auto buffer = MakeVoicePacket(length, speaker);
+            auto& packet = *reinterpret_cast<VoicePacket*>(buffer.data());
+
+            std::memcpy(packet.data, data, length);
+            packet.packid = frameIndex;
+
+            packets.emplace_back(std::move(buffer));
+        }
+
+        opus_encoder_destroy(encoder);
+
+        return packets;
+    }
+
+    // One operation is a voice frame of every speaker: forwarding sends each
+    // packet to every listener, mixing decodes them and sends one packet per
+    // listener. Counters show egress and the number of packets client decodes.
+    void BenchMixer()
+    {
+        constexpr uint16_t kListenersCount = 200;
+        constexpr uint32_t kFramesCount = 10;
+
+        if (!Bench::IsEnabled("mixer/")) return;
+
+        for (const uint16_t speakersCount : { 1, 5, 10, 40 })
+        {
+            Fixture::Init(kListenersCount);
+
+            std::vector<std::vector<std::vector<uint8_t>>> packets;
+
+            for (uint16_t speaker { 0 }; speaker < speakersCount; ++speaker)
+                packets.emplace_back(EncodeVoicePackets(speaker, kFramesCount));
+
+            const auto stream = std::make_unique<GlobalStream>(kStreamColor, "bench");
+
+            for (uint16_t playerId { 0 }; playerId < kListenersCount; ++playerId)
+            {
+                stream->AttachListener(playerId);
+                if (playerId < speakersCount) stream->AttachSpeaker(playerId);
+            }
+
+            const auto report = [&](const uint64_t sentPackets, const uint64_t sentBytes, const uint64_t ticks)
+            {
+                Bench::AddCounter("egress_bytes_per_op", static_cast<double>(sentBytes) / ticks);
+                Bench::AddCounter("egress_packets_per_op", static_cast<double>(sentPackets) / ticks);
+            };
+
+            const auto params = Param("speakers", speakersCount) + ',' + Param("listeners", kListenersCount);
+
+            uint64_t ticks { 0 };
+
+            Fixture::sentVoicePackets = 0;
+            Fixture::sentVoiceBytes = 0;
+
+            Bench::Run("mixer/forward", params, [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i, ++ticks)
+                {
+                    for (uint16_t speaker { 0 }; speaker < speakersCount; ++speaker)
+                        stream->SendVoicePacket(*reinterpret_cast<VoicePacket*>(packets[speaker][ticks % kFramesCount].data()));
+                }
+            });
+
+            if (Bench::IsEnabled("mixer/forward"))
+                report(Fixture::sentVoicePackets, Fixture::sentVoiceBytes, ticks);
+
+            for (const uint8_t mode : { Mixer::Mode::shared, Mixer::Mode::perListener })
+            {
+                const auto name = mode == Mixer::Mode::shared ? "mixer/mix_shared" : "mixer/mix_per_listener";
+
+                if (!Bench::IsEnabled(name)) continue;
+
+                Mixer mixer { *stream };
+
+                mixer.SetMode(mode);
+
+                ticks = 0;
+
+                Fixture::sentVoicePackets = 0;
+                Fixture::sentVoiceBytes = 0;
+
+                Bench::Run(name, params, [&](const uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; ++i, ++ticks)
+                    {
+                        for (uint16_t speaker { 0 }; speaker < speakersCount; ++speaker)
+                            mixer.Push(*reinterpret_cast<VoicePacket*>(packets[speaker][ticks % kFramesCount].data()));
+
+                        mixer.Tick();
+                    }
+                });
+
+                report(Fixture::sentVoicePackets, Fixture::sentVoiceBytes, ticks);
+            }
+
+            stream->DetachAllListeners();
+            stream->DetachAllSpeakers();
+        }
+
+        Fixture::Free();
+    }
+#endif
+
+    // Dynamic streams
+    // --------------------------------------------------------------------
+
+    template <class StreamFactory>
+    void BenchDynamicTick(const char* const name, StreamFactory&& createStream)
+    {
+        for (const uint16_t playersCount : { 100, 500, 1000 })
+        {
+            for (const uint16_t streamsCount : { 1, 10, 50 })
+            {
+                if (!Bench::IsEnabled(name)) return;
+
+                Fixture::Init(playersCount);
+
+                std::vector<std::unique_ptr<DynamicStream>> streams;
+
+                for (uint16_t i { 0 }; i < streamsCount; ++i)
+                    streams.emplace_back(createStream(i));
+
+                // Players walk a meter per tick so that listeners keep changing,
+                // moving costs a fraction of a single stream tick
+                Bench::Run(name, Param("players", playersCount) + ',' + Param("streams", streamsCount),
+                    [&](const uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; ++i)
+                    {
+                        Fixture::MovePlayers(1.f);
+
+                        for (const auto& stream : streams)
+                            stream->Tick();
+                    }
+                }, streamsCount);
+
+                streams.clear();
+            }
+        }
+
+        Fixture::Free();
+    }
+
+    void BenchDynamicStreams()
+    {
+        BenchDynamicTick("dynamic_stream/tick_at_point", [](const uint16_t index)
+        {
+            return std::make_unique<DynamicLocalStreamAtPoint>(kStreamDistance, kStreamMaxPlayers,
+                Fixture::GetRandomPosition(), kStreamColor, "bench");
+        });
+
+        BenchDynamicTick("dynamic_stream/tick_at_player", [](const uint16_t index)
+        {
+            return std::make_unique<DynamicLocalStreamAtPlayer>(kStreamDistance, kStreamMaxPlayers,
+                index, kStreamColor, "bench");
+        });
+
+        BenchDynamicTick("dynamic_stream/tick_at_vehicle", [](const uint16_t index)
+        {
+            Fixture::CreateVehicle(index, Fixture::GetRandomPosition());
+            return std::make_unique<DynamicLocalStreamAtVehicle>(kStreamDistance, kStreamMaxPlayers,
+                index, kStreamColor, "bench");
+        });
+
+        BenchDynamicTick("dynamic_stream/tick_at_object", [](const uint16_t index)
+        {
+            Fixture::CreateObject(index, Fixture::GetRandomPosition());
+            return std::make_unique<DynamicLocalStreamAtObject>(kStreamDistance, kStreamMaxPlayers,
+                index, kStreamColor, "bench");
+        });
+    }
+
+    // Player store
+    // --------------------------------------------------------------------
+
+    void BenchPlayerStore()
+    {
+        if (!Bench::IsEnabled("player_store/shared_access")) return;
+
+        Fixture::Init(MAX_PLAYERS);
+
+        const auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (uint32_t threadsCount = 1; threadsCount <= std::min(maxThreads, 16u); threadsCount *= 2)
+        {
+            // Every thread walks players in its own order as workers do
+            // for senders of their packets, so threads collide on hot players
+            Bench::Run("player_store/shared_access", Param("threads", threadsCount), [&](const uint64_t iterations)
+            {
+                std::atomic<uint32_t> readyCount { 0 };
+                std::vector<std::thread> threads;
+
+                for (uint32_t t = 0; t < threadsCount; ++t)
+                {
+                    threads.emplace_back([&, t]
+                    {
+                        readyCount.fetch_add(1, std::memory_order_relaxed);
+                        while (readyCount.load(std::memory_order_relaxed) != threadsCount);
+
+                        for (uint64_t i = 0; i < iterations; ++i)
+                        {
+                            const uint16_t playerId = ((i + t) * 7) % 64;
+
+                            const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
+                            if (pPlayerInfo != nullptr) Bench::Consume(pPlayerInfo->muteStatus.load(std::memory_order_relaxed));
+                            PlayerStore::ReleasePlayerWithSharedAccess(playerId);
+                        }
+                    });
+                }
+
+                for (auto& thread : threads)
+                    thread.join();
+            }, 1, threadsCount);
+        }
+
+        Fixture::Free();
+    }
+
+    // Groups
+    // --------------------------------------------------------------------
+
+    // "team ∪ admins − muted" bound as listeners, every iteration mutes or
+    // unmutes one member and brings the stream up to date as a tick does
+    void BenchGroups()
+    {
+        for (const uint16_t membersCount : { 100, 500, 999 })
+        {
+            if (!Bench::IsEnabled("group/update_composed") &&
+                !Bench::IsEnabled("group/apply_to_stream")) break;
+
+            Fixture::Init(membersCount + 1);
+            Group::Process();
+
+            const auto team = std::make_unique<Group>("team");
+            const auto admins = std::make_unique<Group>("admins");
+            const auto muted = std::make_unique<Group>("muted");
+
+            for (uint16_t playerId { 1 }; playerId <= membersCount; ++playerId)
+            {
+                if (playerId % 10 != 0) team->AddPlayer(playerId);
+                else admins->AddPlayer(playerId);
+            }
+
+            const auto audience = std::make_unique<Group>(Group::Operation::unite, team->GetHandle(), admins->GetHandle(), "audience");
+            const auto listeners = std::make_unique<Group>(Group::Operation::subtract, audience->GetHandle(), muted->GetHandle(), "listeners");
+
+            Bench::Run("group/update_composed", Param("members", membersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const uint16_t playerId = 1 + i % membersCount;
+
+                    if (i / membersCount % 2 == 0) muted->AddPlayer(playerId);
+                    else muted->RemovePlayer(playerId);
+
+                    Bench::Consume(listeners->GetPlayersCount());
+                }
+            });
+
+            muted->Clear();
+
+            const auto stream = std::make_unique<GlobalStream>(kStreamColor, "bench");
+
+            Group::BindListeners(stream.get(), listeners.get());
+            Group::Process();
+
+            Bench::Run("group/apply_to_stream", Param("members", membersCount), [&](const uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const uint16_t playerId = 1 + i % membersCount;
+
+                    if (i / membersCount % 2 == 0) muted->AddPlayer(playerId);
+                    else muted->RemovePlayer(playerId);
+
+                    Group::Process();
+                }
+            });
+
+            Group::BindListeners(stream.get(), nullptr);
+            Group::Process();
+        }
+
+        Fixture::Free();
+        Group::Process();
+    }
+
+    // State mirror
+    // --------------------------------------------------------------------
+
+    Mirror::StreamRecord MakeStreamRecord(const uint32_t membersCount) noexcept
+    {
+        Mirror::StreamRecord record {};
+
+        record.handle = 1;
+        record.type = SV::ControlPacketType::createLPStream;
+        record.distance = kStreamDistance;
+        record.target = Mirror::kNoneTarget;
+
+        for (uint32_t playerId = 0; playerId < membersCount; ++playerId)
+        {
+            Mirror::SetBit(record.listeners, playerId);
+            Mirror::SetBit(record.speakers, playerId);
+        }
+
+        record.listenersCount = membersCount;
+        record.speakersCount = membersCount;
+
+        return record;
+    }
+
+    void BenchStateMirror()
+    {
+        // Private segment, readers of a real one map the same layout
+        const auto shared = std::make_unique<Mirror::Shared>();
+
+        Mirror::PlayerRecord playerRecord {};
+
+        playerRecord.status = true;
+        playerRecord.pluginVersion = SV::kVersion;
+        Mirror::SetBit(playerRecord.keys, 0x42);
+
+        Bench::Run("state_mirror/store_player", "", [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                playerRecord.muteStatus = i & 1;
+                shared->players[i % Mirror::kMaxPlayers].Store(playerRecord);
+            }
+        });
+
+        Bench::Run("state_mirror/load_player", "", [&](const uint64_t iterations)
+        {
+            Mirror::PlayerRecord record;
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                shared->players[i % Mirror::kMaxPlayers].Load(record);
+                Bench::Consume(record.muteStatus);
+            }
+        });
+
+        const auto streamRecord = MakeStreamRecord(kStreamMaxPlayers);
+
+        Bench::Run("state_mirror/store_stream", "", [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+                shared->streams[i % 64].Store(streamRecord);
+        });
+
+        Bench::Run("state_mirror/load_stream", "", [&](const uint64_t iterations)
+        {
+            Mirror::StreamRecord record;
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                shared->streams[i % 64].Load(record);
+                Bench::Consume(record.listenersCount);
+            }
+        });
+
+        if (!Bench::IsEnabled("state_mirror/load_stream_contended")) return;
+
+        // Writer keeps rewriting the record being read, the worst case of a stream
+        // whose members change every tick, readers retry or give up on it
+        std::atomic_bool writeStatus { true };
+
+        std::thread writer([&]
+        {
+            auto record = streamRecord;
+
+            while (writeStatus.load(std::memory_order_relaxed))
+            {
+                ++record.listenersCount;
+                shared->streams[0].Store(record);
+            }
+        });
+
+        uint64_t loadsCount { 0 };
+        uint64_t failedLoads { 0 };
+
+        Bench::Run("state_mirror/load_stream_contended", "", [&](const uint64_t iterations)
+        {
+            Mirror::StreamRecord record;
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                if (!shared->streams[0].Load(record)) ++failedLoads;
+                Bench::Consume(record.listenersCount);
+            }
+
+            loadsCount += iterations;
+        });
+
+        writeStatus.store(false, std::memory_order_relaxed);
+        writer.join();
+
+        Bench::AddCounter("failed_loads_per_op", loadsCount != 0 ? static_cast<double>(failedLoads) / loadsCount : 0);
+    }
+
+    // Control packets
+    // --------------------------------------------------------------------
+
+    // Stack memory is released on return only, so packet is built in its own frame
+    __attribute__((noinline)) uint32_t BuildAddKeyPacket(const uint8_t keyId) noexcept
+    {
+        ControlPacket* packet;
+
+        PackAlloca(packet, SV::ControlPacketType::addKey, sizeof(SV::AddKeyPacket));
+        PackGetStruct(packet, SV::AddKeyPacket)->keyId = keyId;
+
+        Bench::Consume(packet);
+
+        return packet->GetFullSize();
+    }
+
+    void BenchControlPackets()
+    {
+        const std::string name { "bench stream name" };
+
+        // Heap container as streams build their create packets
+        Bench::Run("control_packet/create_container", Param("name", name.size()), [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                ControlPacketContainerPtr packet;
+
+                PackWrap(packet, SV::ControlPacketType::createGStream, sizeof(SV::CreateGStreamPacket) + name.size() + 1);
+
+                PackGetStruct(&*packet, SV::CreateGStreamPacket)->stream = static_cast<uint32_t>(i);
+                PackGetStruct(&*packet, SV::CreateGStreamPacket)->color = 0xff00ff00;
+                std::memcpy(PackGetStruct(&*packet, SV::CreateGStreamPacket)->name, name.c_str(), name.size() + 1);
+
+                Bench::Consume((*packet)->GetFullSize());
+            }
+        });
+
+        // Stack packet as natives build their small packets
+        Bench::Run("control_packet/create_alloca", "", [&](const uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+                Bench::Consume(BuildAddKeyPacket(static_cast<uint8_t>(i)));
+        });
+    }
+
+    void Usage(const char* const program) noexcept
+    {
+        std::printf(
+            "usage: %s [options]\n"
+            "  --filter <text>      run only benchmarks whose name contains text\n"
+            "  --json <file>        write results as json\n"
+            "  --baseline <file>    print change against results of another run\n",
+            program);
+    }
+}
+
+int main(const int argc, char** const argv)
+{
+    std::string jsonFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option { argv[i] };
+
+        if (i + 1 >= argc) { Usage(argv[0]); return EXIT_FAILURE; }
+
+        if (option == "--filter") Bench::SetFilter(argv[++i]);
+        else if (option == "--json") jsonFile = argv[++i];
+        else if (option == "--baseline")
+        {
+            if (!Bench::LoadBaseline(argv[++i]))
+            {
+                std::fprintf(stderr, "failed to read '%s'\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else { Usage(argv[0]); return EXIT_FAILURE; }
+    }
+
+    BenchVoicePacket();
+    BenchPlayerKeyLookup();
+    BenchStreamFanOut();
+    BenchMixKernel();
+#ifdef SV_MCU
+    BenchMixer();
+#endif
+    BenchDynamicStreams();
+    BenchPlayerStore();
+    BenchGroups();
+    BenchStateMirror();
+    BenchControlPackets();
+
+    if (!jsonFile.empty() && !Bench::WriteJson(jsonFile))
+    {
+        std::fprintf(stderr, "failed to write '%s'\n", jsonFile.c_str());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
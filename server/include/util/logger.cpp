@@ -9,34 +9,237 @@
 
 #include "logger.h"
 
+#include <chrono>
+
+Logger::Limiter::Limiter(const uint32_t interval, const uint32_t burst) noexcept
+    : interval(interval), burst(burst)
+{}
+
+bool Logger::Limiter::Allow(uint32_t& suppressedCount) noexcept
+{
+    const auto curTime = Logger::cachedTime.load(std::memory_order_relaxed);
+    auto windowTime = this->windowTime.load(std::memory_order_relaxed);
+
+    if (curTime - windowTime >= this->interval && this->windowTime.compare_exchange_strong
+        (windowTime, curTime, std::memory_order_relaxed, std::memory_order_relaxed))
+    {
+        this->windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (this->windowCount.fetch_add(1, std::memory_order_relaxed) >= this->burst)
+    {
+        this->suppressedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressedCount = this->suppressedCount.exchange(0, std::memory_order_relaxed);
+
+    return true;
+}
+
+Logger::RingOwner::~RingOwner() noexcept
+{
+    if (this->ring != nullptr) this->ring->ownerStatus.store(false, std::memory_order_release);
+}
+
 bool Logger::Init(const char* const logFile, const logprintf_t logFunc) noexcept
 {
     if (logFile == nullptr || *logFile == '\0' || logFunc == nullptr)
         return false;
 
-    const std::lock_guard<std::mutex> lockFile { Logger::logFileMutex };
-    const std::lock_guard<std::mutex> lockConsole { Logger::logConsoleMutex };
+    if (Logger::initStatus.load(std::memory_order_acquire))
+        return false;
 
-    if (Logger::logFile != nullptr || Logger::logFunc != nullptr)
+    if ((Logger::logFile = std::fopen(logFile, "wt")) == nullptr)
         return false;
 
-    return (Logger::logFile = std::fopen(logFile, "wt")) != nullptr &&
-           (Logger::logFunc = logFunc) != nullptr;
+    Logger::logFunc = logFunc;
+    Logger::cachedTime.store(static_cast<uint32_t>(std::time(nullptr)), std::memory_order_relaxed);
+    Logger::initStatus.store(true, std::memory_order_release);
+
+    try
+    {
+        Logger::flushBuffer.reserve(kRingSize * kRecordTextSize);
+        Logger::flushThread = std::make_unique<std::thread>(&Logger::FlushThreadFunc);
+    }
+    catch (...)
+    {
+        Logger::initStatus.store(false, std::memory_order_release);
+
+        std::fclose(Logger::logFile);
+
+        Logger::logFile = nullptr;
+        Logger::logFunc = nullptr;
+
+        return false;
+    }
+
+    return true;
 }
 
 void Logger::Free() noexcept
 {
-    const std::lock_guard<std::mutex> lockFile { Logger::logFileMutex };
-    const std::lock_guard<std::mutex> lockConsole { Logger::logConsoleMutex };
+    if (!Logger::initStatus.exchange(false, std::memory_order_acq_rel))
+        return;
 
-    if (Logger::logFile != nullptr) std::fclose(Logger::logFile);
+    Logger::flushThread->join();
+    Logger::flushThread.reset();
+
+    Logger::Flush();
+
+    std::fclose(Logger::logFile);
 
     Logger::logFile = nullptr;
     Logger::logFunc = nullptr;
 }
 
-FILE* Logger::logFile { nullptr };
+Logger::Ring* Logger::GetThreadRing() noexcept
+{
+    if (Logger::threadRing.ring != nullptr)
+        return Logger::threadRing.ring;
+
+    const std::lock_guard<std::mutex> lock { Logger::ringsMutex };
+
+    // Rings of finished threads are handed over once the flusher drained them
+    for (const auto& ring : Logger::rings)
+    {
+        if (!ring->ownerStatus.load(std::memory_order_acquire) &&
+            ring->readIndex.load(std::memory_order_acquire) == ring->writeIndex.load(std::memory_order_relaxed))
+        {
+            ring->ownerStatus.store(true, std::memory_order_relaxed);
+            return Logger::threadRing.ring = ring.get();
+        }
+    }
+
+    try
+    {
+        Logger::rings.emplace_back(std::make_unique<Ring>());
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+
+    return Logger::threadRing.ring = Logger::rings.back().get();
+}
+
+void Logger::Flush() noexcept
+{
+    Logger::cachedTime.store(static_cast<uint32_t>(std::time(nullptr)), std::memory_order_relaxed);
+
+    Logger::flushRings.clear();
+    Logger::flushRecords.clear();
+    Logger::flushBuffer.clear();
+
+    uint32_t droppedCount { 0 };
+
+    try
+    {
+        {
+            const std::lock_guard<std::mutex> lock { Logger::ringsMutex };
+
+            for (const auto& ring : Logger::rings)
+            {
+                const auto readIndex = ring->readIndex.load(std::memory_order_relaxed);
+                const auto writeIndex = ring->writeIndex.load(std::memory_order_acquire);
+
+                droppedCount += ring->droppedCount.exchange(0, std::memory_order_relaxed);
+
+                if (readIndex == writeIndex) continue;
+
+                for (auto index = readIndex; index != writeIndex; ++index)
+                    Logger::flushRecords.emplace_back(&ring->records[index % kRingSize]);
+
+                Logger::flushRings.emplace_back(ring.get(), writeIndex);
+            }
+        }
+
+        // Restore the global order of lines written by different threads
+        std::sort(Logger::flushRecords.begin(), Logger::flushRecords.end(),
+            [](const Record* const a, const Record* const b) noexcept
+            { return static_cast<int32_t>(a->sequence - b->sequence) < 0; });
+
+        char timeString[16] {};
+        uint32_t timeValue { 0 };
+
+        const auto formatTime = [&](const uint32_t time) noexcept
+        {
+            if (time == timeValue && timeString[0] != '\0') return;
+
+            const auto cTime = static_cast<std::time_t>(time);
+            const auto timeOfDay = std::localtime(&cTime);
+
+            if (timeOfDay != nullptr) std::snprintf(timeString, sizeof(timeString), "[%.2d:%.2d:%.2d] : ",
+                timeOfDay->tm_hour, timeOfDay->tm_min, timeOfDay->tm_sec);
+
+            timeValue = time;
+        };
+
+        for (const auto record : Logger::flushRecords)
+        {
+            if (record->outputs & kFileOutput)
+            {
+                formatTime(record->time);
+
+                Logger::flushBuffer.append(timeString);
+                Logger::flushBuffer.append(record->text, record->length);
+                Logger::flushBuffer.push_back('\n');
+            }
+
+            if (record->outputs & kConsoleOutput)
+            {
+                Logger::logFunc("%s", record->text);
+            }
+        }
+
+        if (droppedCount != 0)
+        {
+            char droppedString[96];
+
+            formatTime(Logger::cachedTime.load(std::memory_order_relaxed));
+
+            std::snprintf(droppedString, sizeof(droppedString), "[sv:err:logger:flush] : "
+                "%u messages dropped on ring overflow", droppedCount);
+
+            Logger::flushBuffer.append(timeString);
+            Logger::flushBuffer.append(droppedString);
+            Logger::flushBuffer.push_back('\n');
+        }
+    }
+    catch (...) {}
+
+    if (!Logger::flushBuffer.empty())
+    {
+        std::fwrite(Logger::flushBuffer.data(), 1, Logger::flushBuffer.size(), Logger::logFile);
+        std::fflush(Logger::logFile);
+    }
+
+    for (const auto& [ring, writeIndex] : Logger::flushRings)
+        ring->readIndex.store(writeIndex, std::memory_order_release);
+}
+
+void Logger::FlushThreadFunc() noexcept
+{
+    while (Logger::initStatus.load(std::memory_order_acquire))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFlushInterval));
+        Logger::Flush();
+    }
+}
+
+std::FILE* Logger::logFile { nullptr };
 logprintf_t Logger::logFunc { nullptr };
 
-std::mutex Logger::logFileMutex;
-std::mutex Logger::logConsoleMutex;
+std::atomic_bool Logger::initStatus { false };
+std::atomic<uint32_t> Logger::sequence { 0 };
+std::atomic<uint32_t> Logger::cachedTime { 0 };
+
+std::mutex Logger::ringsMutex;
+std::vector<Logger::RingPtr> Logger::rings;
+
+std::unique_ptr<std::thread> Logger::flushThread { nullptr };
+std::vector<std::pair<Logger::Ring*, uint32_t>> Logger::flushRings;
+std::vector<const Logger::Record*> Logger::flushRecords;
+std::string Logger::flushBuffer;
+
+thread_local Logger::RingOwner Logger::threadRing;
@@ -9,9 +9,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
-#include <iostream>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <ysf/globals.h>
 
@@ -24,60 +31,193 @@ class Logger {
     Logger& operator=(const Logger&) = delete;
     Logger& operator=(Logger&&) = delete;
 
+private:
+
+    static constexpr uint32_t kRingSize = 512;
+    static constexpr uint32_t kRecordTextSize = 256;
+    static constexpr uint32_t kFlushInterval = 10;
+
+    static constexpr uint8_t kFileOutput = 1 << 0;
+    static constexpr uint8_t kConsoleOutput = 1 << 1;
+
+public:
+
+    // Per call-site rate limiter, declared as a static local next to
+    // noisy log calls. Lets through up to 'burst' messages per 'interval'
+    // seconds, the count of suppressed ones goes with the next message.
+    class Limiter {
+
+        Limiter() = delete;
+        Limiter(const Limiter&) = delete;
+        Limiter(Limiter&&) = delete;
+        Limiter& operator=(const Limiter&) = delete;
+        Limiter& operator=(Limiter&&) = delete;
+
+    public:
+
+        explicit Limiter(uint32_t interval, uint32_t burst = 1) noexcept;
+
+        ~Limiter() noexcept = default;
+
+    public:
+
+        bool Allow(uint32_t& suppressedCount) noexcept;
+
+    private:
+
+        const uint32_t interval;
+        const uint32_t burst;
+
+        std::atomic<uint32_t> windowTime { 0 };
+        std::atomic<uint32_t> windowCount { 0 };
+        std::atomic<uint32_t> suppressedCount { 0 };
+
+    };
+
 public:
 
     static bool Init(const char* logFile, logprintf_t logFunc) noexcept;
     static void Free() noexcept;
 
     template<class... ARGS>
-    static bool LogToFile(const char* const message, const ARGS... args) noexcept
+    static inline bool LogToFile(const char* const message, const ARGS... args) noexcept
     {
-        const std::lock_guard<std::mutex> lock { Logger::logFileMutex };
+        return Logger::Push(kFileOutput, NULL, message, args...);
+    }
 
-        if (Logger::logFile == nullptr)
-            return false;
+    template<class... ARGS>
+    static inline bool LogToConsole(const char* const message, const ARGS... args) noexcept
+    {
+        return Logger::Push(kConsoleOutput, NULL, message, args...);
+    }
 
-        const auto cTime = std::time(nullptr);
-        const auto timeOfDay = std::localtime(&cTime);
+    template<class... ARGS>
+    static inline void Log(const char* const message, const ARGS... args) noexcept
+    {
+        Logger::Push(kFileOutput | kConsoleOutput, NULL, message, args...);
+    }
 
-        if (timeOfDay == nullptr)
-            return false;
+    template<class... ARGS>
+    static inline bool LogToFile(Limiter& limiter, const char* const message, const ARGS... args) noexcept
+    {
+        uint32_t suppressedCount { 0 };
+        if (!limiter.Allow(suppressedCount)) return false;
+
+        return Logger::Push(kFileOutput, suppressedCount, message, args...);
+    }
 
-        std::fprintf(Logger::logFile, "[%.2d:%.2d:%.2d] : ",
-            timeOfDay->tm_hour, timeOfDay->tm_min, timeOfDay->tm_sec);
-        std::fprintf(Logger::logFile, message, args...);
-        std::fputc('\n', Logger::logFile);
-        std::fflush(Logger::logFile);
+    template<class... ARGS>
+    static inline void Log(Limiter& limiter, const char* const message, const ARGS... args) noexcept
+    {
+        uint32_t suppressedCount { 0 };
+        if (!limiter.Allow(suppressedCount)) return;
 
-        return true;
+        Logger::Push(kFileOutput | kConsoleOutput, suppressedCount, message, args...);
     }
 
+private:
+
+    struct Record {
+
+        uint32_t sequence;
+        uint32_t time;
+        uint16_t length;
+        uint8_t outputs;
+
+        char text[kRecordTextSize];
+
+    };
+
+    struct Ring {
+
+        std::atomic<uint32_t> writeIndex { 0 };
+        std::atomic<uint32_t> droppedCount { 0 };
+        std::atomic_bool ownerStatus { true };
+
+        alignas(64) std::atomic<uint32_t> readIndex { 0 };
+
+        std::unique_ptr<Record[]> records { std::make_unique<Record[]>(kRingSize) };
+
+    };
+
+    struct RingOwner {
+
+        ~RingOwner() noexcept;
+
+        Ring* ring { nullptr };
+
+    };
+
+    using RingPtr = std::unique_ptr<Ring>;
+
+private:
+
+    // Formats the message right into the calling thread's ring,
+    // the file and console are written by the flush thread only
     template<class... ARGS>
-    static bool LogToConsole(const char* const message, const ARGS... args) noexcept
+    static bool Push(const uint8_t outputs, const uint32_t suppressedCount,
+                     const char* const message, const ARGS... args) noexcept
     {
-        const std::lock_guard<std::mutex> lock { Logger::logConsoleMutex };
+        if (!Logger::initStatus.load(std::memory_order_acquire))
+            return false;
+
+        const auto ring = Logger::GetThreadRing();
+        if (ring == nullptr) return false;
 
-        if (Logger::logFunc == nullptr)
+        const auto writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+
+        if (writeIndex - ring->readIndex.load(std::memory_order_acquire) >= kRingSize)
+        {
+            ring->droppedCount.fetch_add(1, std::memory_order_relaxed);
             return false;
+        }
+
+        auto& record = ring->records[writeIndex % kRingSize];
+
+        auto length = std::snprintf(record.text, sizeof(record.text), message, args...);
+        if (length < 0) return false;
+
+        length = std::min(length, static_cast<int>(sizeof(record.text) - 1));
+
+        if (suppressedCount != 0)
+        {
+            const auto suffixLength = std::snprintf(record.text + length, sizeof(record.text) - length,
+                " (%u similar suppressed)", suppressedCount);
+            if (suffixLength > 0) length = std::min(length + suffixLength, static_cast<int>(sizeof(record.text) - 1));
+        }
+
+        record.sequence = Logger::sequence.fetch_add(1, std::memory_order_relaxed);
+        record.time = Logger::cachedTime.load(std::memory_order_relaxed);
+        record.length = static_cast<uint16_t>(length);
+        record.outputs = outputs;
 
-        Logger::logFunc(message, args...);
+        ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
 
         return true;
     }
 
-    template<class... ARGS>
-    static inline void Log(const char* const message, const ARGS... args) noexcept
-    {
-        Logger::LogToFile(message, args...);
-        Logger::LogToConsole(message, args...);
-    }
+    static Ring* GetThreadRing() noexcept;
+
+    static void Flush() noexcept;
+    static void FlushThreadFunc() noexcept;
 
 private:
 
-    static FILE* logFile;
+    static std::FILE* logFile;
     static logprintf_t logFunc;
 
-    static std::mutex logFileMutex;
-    static std::mutex logConsoleMutex;
+    static std::atomic_bool initStatus;
+    static std::atomic<uint32_t> sequence;
+    static std::atomic<uint32_t> cachedTime;
+
+    static std::mutex ringsMutex;
+    static std::vector<RingPtr> rings;
+
+    static std::unique_ptr<std::thread> flushThread;
+    static std::vector<std::pair<Ring*, uint32_t>> flushRings;
+    static std::vector<const Record*> flushRecords;
+    static std::string flushBuffer;
+
+    static thread_local RingOwner threadRing;
 
 };
@@ -96,6 +96,14 @@ bool RakNet::Init(const void* const serverBaseAddr) noexcept
 
     Logger::Log("[dbg:raknet:init] : module initializing...");
 
+    // Hooked code and addresses belong to 32-bit SA-MP server, x86-64
+    // hosts link their own implementation of this class instead
+    if (sizeof(void*) != sizeof(uint32_t))
+    {
+        Logger::Log("[err:raknet:init] : server hooks are only available in 32-bit build");
+        return false;
+    }
+
     Memory::addr_t moduleAddr { nullptr };
     Memory::size_t moduleSize { 0 };
 
@@ -219,15 +227,17 @@ bool RakNet::IsLoaded() noexcept
     return RakNet::loadStatus;
 }
 
-void RakNet::Process() noexcept
+std::size_t RakNet::Process() noexcept
 {
+    std::size_t flushedMessages { 0 };
+
     // Rpc's sending...
     {
         const std::unique_lock<std::shared_mutex> lock { RakNet::rpcQueueMutex };
 
         SendRpcInfo sendRpcInfo;
         
-        while (RakNet::rpcQueue.try_pop(sendRpcInfo)) RakNet::Rpc(
+        for (; RakNet::rpcQueue.try_pop(sendRpcInfo); ++flushedMessages) RakNet::Rpc(
             &sendRpcInfo.rpcId, sendRpcInfo.bitStream.get(), PacketPriority::MEDIUM_PRIORITY,
             PacketReliability::RELIABLE_ORDERED, '\0', RakNet::GetPlayerIdFromIndex(sendRpcInfo.playerId),
             sendRpcInfo.playerId == 0xffff, false);
@@ -239,7 +249,7 @@ void RakNet::Process() noexcept
 
         SendPacketInfo sendPacketInfo;
         
-        while (RakNet::packetQueue.try_pop(sendPacketInfo)) RakNet::Send(
+        for (; RakNet::packetQueue.try_pop(sendPacketInfo); ++flushedMessages) RakNet::Send(
             sendPacketInfo.bitStream.get(), PacketPriority::MEDIUM_PRIORITY, PacketReliability::RELIABLE_ORDERED,
             '\0', RakNet::GetPlayerIdFromIndex(sendPacketInfo.playerId), sendPacketInfo.playerId == 0xffff);
     }
@@ -250,9 +260,11 @@ void RakNet::Process() noexcept
 
         uint16_t kickPlayerId;
         
-        while (RakNet::kickQueue.try_pop(kickPlayerId))
+        for (; RakNet::kickQueue.try_pop(kickPlayerId); ++flushedMessages)
             RakNet::Kick(RakNet::GetPlayerIdFromIndex(kickPlayerId));
     }
+
+    return flushedMessages;
 }
 
 bool RakNet::SendRPC(const uint8_t rpcId, const uint16_t playerId, const void* const dataPtr, const int dataSize)
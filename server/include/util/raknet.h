@@ -44,7 +44,8 @@ public:
     static void Free() noexcept;
 
     static bool IsLoaded() noexcept;
-    static void Process() noexcept;
+    // Returns count of flushed queued messages
+    static std::size_t Process() noexcept;
 
     static bool SendRPC(uint8_t rpcId, uint16_t playerId, const void* dataPtr, int dataSize);
     static bool SendPacket(uint8_t packetId, uint16_t playerId, const void* dataPtr, int dataSize);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class SipHash {
+
+    SipHash() = delete;
+    ~SipHash() = delete;
+    SipHash(const SipHash&) = delete;
+    SipHash(SipHash&&) = delete;
+    SipHash& operator=(const SipHash&) = delete;
+    SipHash& operator=(SipHash&&) = delete;
+
+public:
+
+    static constexpr std::size_t kKeySize = 16;
+    static constexpr std::size_t kTagSize = 8;
+
+public:
+
+    // SipHash-2-4 with 128-bit key (k0 - low half, k1 - high half)
+    static uint64_t Calc(uint64_t k0, uint64_t k1, const void* data, std::size_t length) noexcept;
+
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <map>
 #include <pawn/amx/amx.h>
 #include <raknet/networktypes.h>
@@ -171,6 +172,9 @@ typedef void(*VARCHANGEFUNC)();
 
 #pragma pack(push, 1)
 
+// Layouts follow 32-bit SA-MP server, sizes of structures holding pointers
+// are only checked there (x86-64 builds get them from a compatible host)
+
 struct PingAndClockDifferential {
 	unsigned short pingTime;
 	unsigned int clockDifferential;
@@ -181,13 +185,13 @@ struct RemoteSystemStruct {
 	PlayerID playerId;
 	PlayerID myExternalPlayerId;
 	unsigned char gapD[1895];
-	unsigned long dword774;
+	unsigned int dword774;
 	unsigned short word778;
 	unsigned char gap77A[2];
-	unsigned long dword77C;
-	unsigned long dword780;
+	unsigned int dword77C;
+	unsigned int dword780;
 	unsigned char gap784[276];
-	unsigned long dword898;
+	unsigned int dword898;
 	unsigned char gap89C[16];
 	unsigned char byte8AC;
 	unsigned char gap8AD[1023];
@@ -211,7 +215,7 @@ static_assert(sizeof(RemoteSystemStruct) == 3255, "Invalid RemoteSystemStruct si
 
 typedef struct _MATRIX4X4  {
 	CVector right;
-	unsigned long  flags;
+	unsigned int  flags;
 	CVector up;
 	float  pad_u;
 	CVector at;
@@ -223,18 +227,18 @@ static_assert(sizeof(_MATRIX4X4) == 64, "Invalid _MATRIX4X4 size");
 
 struct ConsoleVariable_s {
 	CON_VARTYPE		VarType;
-	unsigned long			VarFlags;
+	unsigned int			VarFlags;
 	void*			VarPtr;
 	VARCHANGEFUNC	VarChangeFunc;
 };
-static_assert(sizeof(ConsoleVariable_s) == 16, "Invalid ConsoleVariable_s size");
+static_assert(sizeof(void*) != 4 || sizeof(ConsoleVariable_s) == 16, "Invalid ConsoleVariable_s size");
 
 struct ConsoleCommand_s {
 	char			szName[255];
-	unsigned long			dwFlags;
+	unsigned int			dwFlags;
 	void			(*fptrFunc)();
 };
-static_assert(sizeof(ConsoleCommand_s) == 263, "Invalid ConsoleCommand_s size");
+static_assert(sizeof(void*) != 4 || sizeof(ConsoleCommand_s) == 263, "Invalid ConsoleCommand_s size");
 
 struct CAimSyncData {
 	unsigned char			byteCameraMode;
@@ -299,7 +303,7 @@ struct CSyncData {
 	CVector					vecSurfing;
 	unsigned short			wSurfingInfo;
 	union {
-		unsigned long		dwAnimationData;
+		unsigned int		dwAnimationData;
 		struct {
 			unsigned short	wAnimIndex;
 			unsigned short	wAnimFlags;
@@ -350,12 +354,12 @@ typedef struct CTextdraw {
 		};
 	};
 	CVector2D				vecLetter;
-	unsigned long			dwLetterColor;
+	unsigned int			dwLetterColor;
 	CVector2D				vecLine;
-	unsigned long			dwBoxColor;
+	unsigned int			dwBoxColor;
 	unsigned char			byteShadow;
 	unsigned char			byteOutline;
-	unsigned long			dwBackgroundColor;
+	unsigned int			dwBackgroundColor;
 	unsigned char			byteStyle;
 	unsigned char			byteSelectable;
 	CVector2D				vecPos;
@@ -373,11 +377,11 @@ struct CPlayerTextDraw {
 	char					*szFontText[MAX_PLAYER_TEXT_DRAWS];
 	bool					bHasText[MAX_PLAYER_TEXT_DRAWS];
 };
-static_assert(sizeof(CPlayerTextDraw) == 2048 + 1024 + 256, "Invalid CPlayerTextDraw size");
+static_assert(sizeof(void*) != 4 || sizeof(CPlayerTextDraw) == 2048 + 1024 + 256, "Invalid CPlayerTextDraw size");
 
 struct C3DText {
 	char*					szText;
-	unsigned long			dwColor;
+	unsigned int			dwColor;
 	CVector					vecPos;
 	float					fDrawDistance;
 	bool					bLineOfSight;
@@ -385,7 +389,7 @@ struct C3DText {
 	unsigned short			wAttachedToPlayerID;
 	unsigned short			wAttachedToVehicleID;
 };
-static_assert(sizeof(C3DText) == 33, "Invalid C3DText size");
+static_assert(sizeof(void*) != 4 || sizeof(C3DText) == 33, "Invalid C3DText size");
 
 struct CPlayerText3DLabels {
 	C3DText					TextLabels[MAX_3DTEXT_PLAYER];
@@ -393,7 +397,7 @@ struct CPlayerText3DLabels {
 	unsigned char			unknown9800[MAX_3DTEXT_PLAYER];
 	unsigned short			wOwnerID;
 };
-static_assert(sizeof(CPlayerText3DLabels) == 38914, "Invalid CPlayerText3DLabels size");
+static_assert(sizeof(void*) != 4 || sizeof(CPlayerText3DLabels) == 38914, "Invalid CPlayerText3DLabels size");
 
 struct CAttachedObject {
     int						iModelID;
@@ -401,8 +405,8 @@ struct CAttachedObject {
     CVector					vecPos;
     CVector					vecRot;
     CVector					vecScale;
-	unsigned long			dwMaterialColor1;
-	unsigned long			dwMaterialColor2;
+	unsigned int			dwMaterialColor1;
+	unsigned int			dwMaterialColor2;
 };
 static_assert(sizeof(CAttachedObject) == 52, "Invalid CAttachedObject size");
 
@@ -435,14 +439,14 @@ struct CPVar {
     float					fValue;
     char*					szValue;
 };
-static_assert(sizeof(CPVar) == 61, "Invalid CPVar size");
+static_assert(sizeof(void*) != 4 || sizeof(CPVar) == 61, "Invalid CPVar size");
 
 struct CPlayerVar {
     CPVar					Vars[MAX_PVARS];
 	int						bIsPVarActive[MAX_PVARS];
     int						iUpperIndex;
 };
-static_assert(sizeof(CPlayerVar) == 48800 + 3200 + 4, "Invalid CPlayerVar size");
+static_assert(sizeof(void*) != 4 || sizeof(CPlayerVar) == 48800 + 3200 + 4, "Invalid CPlayerVar size");
 
 struct CPlayer {
 	CAimSyncData			aimSyncData;
@@ -456,25 +460,25 @@ struct CPlayer {
 	CUnoccupiedSyncData		unoccupiedSyncData;
 	CSpectatingSyncData		spectatingSyncData;
 	CTrailerSyncData		trailerSyncData;
-	unsigned long			dwPlayerSyncUnused;
-	unsigned long			dwVehicleSyncUnused;
+	unsigned int			dwPlayerSyncUnused;
+	unsigned int			dwVehicleSyncUnused;
 	unsigned char			byteStreamedIn[MAX_PLAYERS];
 	unsigned char			byteVehicleStreamedIn[MAX_VEHICLES];
 	unsigned char			byteSomethingUnused[1000];
 	unsigned char			byte3DTextLabelStreamedIn[1024];
 	unsigned char			bPickupStreamedIn[MAX_PICKUPS];
 	unsigned char			byteActorStreamedIn[MAX_PLAYERS];
-	unsigned long			dwStreamedInPlayers;
-	unsigned long			dwStreamedInVehicles;
-	unsigned long			dwStreamedInSomethingUnused;
-	unsigned long			dwStreamedIn3DTextLabels;
-	unsigned long			dwStreamedInPickups;
-	unsigned long			dwStreamedInActors;
-	unsigned long			bHasSetVehiclePos;
-	unsigned long			dwSetVehiclePosTick;
+	unsigned int			dwStreamedInPlayers;
+	unsigned int			dwStreamedInVehicles;
+	unsigned int			dwStreamedInSomethingUnused;
+	unsigned int			dwStreamedIn3DTextLabels;
+	unsigned int			dwStreamedInPickups;
+	unsigned int			dwStreamedInActors;
+	unsigned int			bHasSetVehiclePos;
+	unsigned int			dwSetVehiclePosTick;
 	CVector					vecVehicleNewPos;
 	int						bCameraTarget;
-	unsigned long			bHasSpawnInfo;
+	unsigned int			bHasSpawnInfo;
 	int						bUpdateKeys;
 	CVector					vecPosition;
 	float					fHealth;
@@ -484,8 +488,8 @@ struct CPlayer {
 	CVector					vecVelocity;
 	unsigned short			wLRAnalog;
 	unsigned short			wUDAnalog;
-	unsigned long			dwKeys;
-	unsigned long			dwOldKeys;
+	unsigned int			dwKeys;
+	unsigned int			dwOldKeys;
 	int						bEditObject;
 	int						bEditAttachedObject;
 	unsigned short			wDialogID;
@@ -516,7 +520,7 @@ struct CPlayer {
 	unsigned char			byteFightingStyle;
 	unsigned char			byteSeatId;
 	unsigned short			wVehicleId;
-	unsigned long			dwNickNameColor;
+	unsigned int			dwNickNameColor;
 	int						bShowCheckpoint;
 	int						bShowRaceCheckpoint;
 	int						iInteriorId;
@@ -527,31 +531,31 @@ struct CPlayer {
 	unsigned char			byteCurrentWeapon;
 	unsigned short			wTargetId;
 	unsigned short			wTargetActorId;
-	unsigned long			dwLastShotTick;
+	unsigned int			dwLastShotTick;
 	unsigned char			dwLastShotWeapon;
 	CBulletSyncData			bulletSyncData;
 	unsigned char			m_byteTime;
 	float					m_fGameTime;
 	unsigned char			byteSpectateType;
-	unsigned long			wSpectateID;
-	unsigned long			dwLastStreaming;
-	unsigned long			dwNPCRecordingType;
+	unsigned int			wSpectateID;
+	unsigned int			dwLastStreaming;
+	unsigned int			dwNPCRecordingType;
 	FILE					*pRecordingFile;
-	unsigned long			dwFirstNPCWritingTime;
+	unsigned int			dwFirstNPCWritingTime;
 	PAD(unused, 9);
 	CPlayerVar*				pPlayerVars;
 };
-static_assert(sizeof(CPlayer) == 11486, "Invalid CPlayer size");
+static_assert(sizeof(void*) != 4 || sizeof(CPlayer) == 11486, "Invalid CPlayer size");
 
 struct CPlayerPool {
-	unsigned long			dwVirtualWorld[MAX_PLAYERS];
-	unsigned long			dwPlayersCount;
-	unsigned long			dwlastMarkerUpdate;
+	unsigned int			dwVirtualWorld[MAX_PLAYERS];
+	unsigned int			dwPlayersCount;
+	unsigned int			dwlastMarkerUpdate;
 	float					fUpdatePlayerGameTimers;
-	unsigned long			dwScore[MAX_PLAYERS];
-	unsigned long			dwMoney[MAX_PLAYERS];
-	unsigned long			dwDrunkLevel[MAX_PLAYERS];
-	unsigned long			dwLastScoreUpdate[MAX_PLAYERS];
+	unsigned int			dwScore[MAX_PLAYERS];
+	unsigned int			dwMoney[MAX_PLAYERS];
+	unsigned int			dwDrunkLevel[MAX_PLAYERS];
+	unsigned int			dwLastScoreUpdate[MAX_PLAYERS];
 	char					szSerial[MAX_PLAYERS][101];
 	char					szVersion[MAX_PLAYERS][25];
 	RemoteSystemStruct		*pRemoteSystem[MAX_PLAYERS];
@@ -561,11 +565,11 @@ struct CPlayerPool {
 	int						bIsAnAdmin[MAX_PLAYERS];
 	int						bIsNPC[MAX_PLAYERS];
 	PAD(pad0, 8000);
-	unsigned long			dwConnectedPlayers;
-	unsigned long			dwPlayerPoolSize;
-	unsigned long			dwUnk;
+	unsigned int			dwConnectedPlayers;
+	unsigned int			dwPlayerPoolSize;
+	unsigned int			dwUnk;
 };
-static_assert(sizeof(CPlayerPool) == 199024, "Invalid CPlayerPool size");
+static_assert(sizeof(void*) != 4 || sizeof(CPlayerPool) == 199024, "Invalid CPlayerPool size");
 
 struct CVehicleSpawn {
 	int						iModelID;
@@ -616,12 +620,12 @@ struct CVehicle {
 	unsigned short			wCabID;
 	unsigned short			wLastDriverID;
 	unsigned short			vehPassengers[7];
-	unsigned long			vehActive;
-	unsigned long			vehWasted;
+	unsigned int			vehActive;
+	unsigned int			vehWasted;
 	CVehicleSpawn			customSpawn;
 	float					fHealth;
-	unsigned long			vehDoorStatus;
-	unsigned long			vehPanelStatus;
+	unsigned int			vehDoorStatus;
+	unsigned int			vehPanelStatus;
 	unsigned char			vehLightStatus;
 	unsigned char			vehTireStatus;
 	bool					bDead;
@@ -631,8 +635,8 @@ struct CVehicle {
 	CVehicleParams			vehParamEx;
     unsigned char			bDeathNotification;
     unsigned char			bOccupied;
-    unsigned long			vehOccupiedTick;
-    unsigned long			vehRespawnTick;
+    unsigned int			vehOccupiedTick;
+    unsigned int			vehRespawnTick;
 	unsigned char			byteSirenEnabled;
 	unsigned char			byteNewSirenState;
 };
@@ -643,9 +647,9 @@ struct CVehiclePool {
 	int						iVirtualWorld[MAX_VEHICLES];
 	int						bVehicleSlotState[MAX_VEHICLES];
 	CVehicle				*pVehicle[MAX_VEHICLES];
-	unsigned long			dwVehiclePoolSize;
+	unsigned int			dwVehiclePoolSize;
 };
-static_assert(sizeof(CVehiclePool) == 24216, "Invalid CVehiclePool size");
+static_assert(sizeof(void*) != 4 || sizeof(CVehiclePool) == 24216, "Invalid CVehiclePool size");
 
 struct tPickup {
 	int						iModel;
@@ -664,15 +668,15 @@ struct CObjectMaterial {
 	unsigned char			byteUsed;
 	unsigned char			byteSlot;
 	unsigned short			wModelID;
-	unsigned long			dwMaterialColor;
+	unsigned int			dwMaterialColor;
 	char					szMaterialTXD[64 + 1];
 	char					szMaterialTexture[64 + 1];
 	unsigned char			byteMaterialSize;
 	char					szFont[64 + 1];
 	unsigned char			byteFontSize;
 	unsigned char			byteBold;
-	unsigned long			dwFontColor;
-	unsigned long			dwBackgroundColor;
+	unsigned int			dwFontColor;
+	unsigned int			dwBackgroundColor;
 	unsigned char			byteAlignment;
 };
 static_assert(sizeof(CObjectMaterial) == 215, "Invalid CObjectMaterial size");
@@ -687,18 +691,18 @@ struct CObject {
 	unsigned char			bIsMoving;
 	unsigned char			bNoCameraCol;
 	float					fMoveSpeed;
-	unsigned long			unk_4;
+	unsigned int			unk_4;
 	float					fDrawDistance;
 	unsigned short			wAttachedVehicleID;
 	unsigned short			wAttachedObjectID;
 	CVector					vecAttachedOffset;
 	CVector					vecAttachedRotation;
 	unsigned char			byteSyncRot;
-	unsigned long			dwMaterialCount;
+	unsigned int			dwMaterialCount;
 	CObjectMaterial			Material[MAX_OBJECT_MATERIAL];
 	char					*szMaterialText[MAX_OBJECT_MATERIAL];
 };
-static_assert(sizeof(CObject) == 3701, "Invalid CObject size");
+static_assert(sizeof(void*) != 4 || sizeof(CObject) == 3701, "Invalid CObject size");
 
 struct CObjectPool {
 	int						bPlayerObjectSlotState[MAX_PLAYERS][MAX_OBJECTS];
@@ -769,12 +773,12 @@ struct CActor {
 	int						iSkinID;			
 	CVector					vecSpawnPos;	
 	float					fSpawnAngle;		
-	unsigned long			pad4;				
-	unsigned long			pad5;				
+	unsigned int			pad4;				
+	unsigned int			pad5;				
 	unsigned char			byteLoopAnim;		
 	CActorAnim				anim;
 	float					fHealth;			
-	unsigned long			pad;				
+	unsigned int			pad;				
 	float					fAngle;			
 	CVector					vecPos;	
 	unsigned char			pad8[12];			
@@ -786,7 +790,7 @@ struct CActorPool {
 	int						iActorVirtualWorld[MAX_ACTORS];
 	int						bValidActor[MAX_ACTORS];
 	CActor*					pActor[MAX_ACTORS];
-	unsigned long			dwActorPoolSize;
+	unsigned int			dwActorPoolSize;
 };
 
 struct CGameMode {
@@ -813,12 +817,12 @@ struct ScriptTimer_s {
 	void*					cellParams;
 };
 
-typedef std::map<unsigned long, ScriptTimer_s*> DwordTimerMap;
+typedef std::map<unsigned int, ScriptTimer_s*> DwordTimerMap;
 
 class CScriptTimers {
 public:
 	DwordTimerMap			Timers;
-	unsigned long			dwTimerCount;
+	unsigned int			dwTimerCount;
 };
 
 struct CNetGame {
@@ -839,9 +843,9 @@ struct CNetGame {
 	void					*pHttpClient;
 	CScriptTimers			*pScriptTimers;
 	void					*pRak;
-	unsigned long			dwSomethingTick;
-	unsigned long			dwUnk;
-	unsigned long			dwUnk1;
+	unsigned int			dwSomethingTick;
+	unsigned int			dwUnk;
+	unsigned int			dwUnk1;
 	int						bLanMode;
 	int						bShowPlayerMarkers;
 	unsigned char			byteShowNameTags;
@@ -305,7 +305,7 @@ bool Unlock(void *address, size_t len) {
 	unsigned long oldp;
 	return !!VirtualProtect(address, len, PAGE_EXECUTE_READWRITE, &oldp);
 #else
-	size_t iPageSize = getpagesize(), iAddr = ((reinterpret_cast <uint32_t>(address) / iPageSize) * iPageSize);
+	size_t iPageSize = getpagesize(), iAddr = ((reinterpret_cast <uintptr_t>(address) / iPageSize) * iPageSize);
 	return !mprotect(reinterpret_cast <void*>(iAddr), len, PROT_READ | PROT_WRITE | PROT_EXEC);
 #endif
 }
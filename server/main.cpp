@@ -17,7 +17,22 @@
 #include "Pawn.h"
 #include "Network.h"
 #include "PlayerStore.h"
-#include "Worker.h"
+#include "RateLimiter.h"
+#include "BitrateController.h"
+#include "Config.h"
+#include "Metrics.h"
+#include "Latency.h"
+#include "Tracer.h"
+#include "Capture.h"
+#include "WorkerPool.h"
+#include "MixerPool.h"
+#include "Recorder.h"
+#include "SourcePool.h"
+#include "Federation.h"
+#include "RelayLink.h"
+#include "StateMirror.h"
+#include "Group.h"
+#include "World.h"
 
 #include "Stream.h"
 #include "GlobalStream.h"
@@ -49,16 +64,19 @@
 namespace SV
 {
     uint32_t bitrate { SV::kDefaultBitrate };
-    std::map<uint32_t, Stream*> streamTable;
     std::set<DynamicStream*> dlstreamList;
-    std::vector<WorkerPtr> workers;
 
     class PawnHandler : public PawnInterface {
     public:
 
         void SvInit(const uint32_t bitrate) override
         {
+            Capture::RecordNative("SvInit", { Capture::Value(bitrate) });
+
             SV::bitrate = bitrate;
+
+            Mixer::SetBitrate(bitrate);
+            BitrateController::SetBaseBitrate(bitrate);
         }
 
         uint8_t SvGetVersion(const uint16_t playerId) override
@@ -87,6 +105,8 @@ namespace SV
 
         bool SvStartRecord(const uint16_t playerId) override
         {
+            Capture::RecordNative("SvStartRecord", { Capture::Value(playerId) });
+
             bool prevRecordStatus { true };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
@@ -95,6 +115,9 @@ namespace SV
 
             if (prevRecordStatus) return false;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::startRecord, NULL);
@@ -104,6 +127,8 @@ namespace SV
 
         bool SvStopRecord(const uint16_t playerId) override
         {
+            Capture::RecordNative("SvStopRecord", { Capture::Value(playerId) });
+
             bool prevRecordStatus { false };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
@@ -112,6 +137,9 @@ namespace SV
 
             if (!prevRecordStatus) return false;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::stopRecord, NULL);
@@ -123,6 +151,8 @@ namespace SV
 
         bool SvAddKey(const uint16_t playerId, const uint8_t keyId) override
         {
+            Capture::RecordNative("SvAddKey", { Capture::Value(playerId), Capture::Value(keyId) });
+
             bool addKeyStatus { false };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(playerId);
@@ -131,6 +161,9 @@ namespace SV
 
             if (!addKeyStatus) return false;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::addKey, sizeof(SV::AddKeyPacket));
@@ -152,6 +185,8 @@ namespace SV
 
         bool SvRemoveKey(const uint16_t playerId, const uint8_t keyId) override
         {
+            Capture::RecordNative("SvRemoveKey", { Capture::Value(playerId), Capture::Value(keyId) });
+
             bool removeKeyStatus { false };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(playerId);
@@ -160,6 +195,9 @@ namespace SV
 
             if (!removeKeyStatus) return false;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::removeKey, sizeof(SV::RemoveKeyPacket));
@@ -170,12 +208,17 @@ namespace SV
 
         void SvRemoveAllKeys(const uint16_t playerId) override
         {
+            Capture::RecordNative("SvRemoveAllKeys", { Capture::Value(playerId) });
+
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(playerId);
             if (pPlayerInfo != nullptr) pPlayerInfo->keys.clear();
             PlayerStore::ReleasePlayerWithUniqueAccess(playerId);
 
             if (pPlayerInfo == nullptr) return;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::removeAllKeys, NULL);
@@ -198,6 +241,8 @@ namespace SV
 
         void SvMutePlayerEnable(const uint16_t playerId) override
         {
+            Capture::RecordNative("SvMutePlayerEnable", { Capture::Value(playerId) });
+
             bool prevMutePlayerStatus { true };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
@@ -206,6 +251,9 @@ namespace SV
 
             if (prevMutePlayerStatus) return;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::muteEnable, NULL);
@@ -215,6 +263,8 @@ namespace SV
 
         void SvMutePlayerDisable(const uint16_t playerId) override
         {
+            Capture::RecordNative("SvMutePlayerDisable", { Capture::Value(playerId) });
+
             bool prevMutePlayerStatus { false };
 
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
@@ -223,6 +273,9 @@ namespace SV
 
             if (!prevMutePlayerStatus) return;
 
+            RelayLink::PublishPlayerSpeak(playerId);
+            StateMirror::MarkPlayer(playerId);
+
             ControlPacket* controlPacket { nullptr };
 
             PackAlloca(controlPacket, SV::ControlPacketType::muteDisable, NULL);
@@ -239,7 +292,13 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvCreateGStream", { Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -260,7 +319,13 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvCreateSLStreamAtPoint", { Capture::Float(distance), Capture::Float(posx), Capture::Float(posy), Capture::Float(posz), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -272,7 +337,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pVehiclePool->pVehicle[vehicleId] == nullptr)
+            if (!World::IsVehicleExists(vehicleId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) StaticLocalStreamAtVehicle(distance, vehicleId, color, name);
@@ -280,7 +345,13 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvCreateSLStreamAtVehicle", { Capture::Float(distance), Capture::Value(vehicleId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -292,7 +363,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pPlayerPool->pPlayer[playerId] == nullptr)
+            if (!World::IsPlayerExists(playerId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) StaticLocalStreamAtPlayer(distance, playerId, color, name);
@@ -300,7 +371,13 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvCreateSLStreamAtPlayer", { Capture::Float(distance), Capture::Value(playerId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -312,7 +389,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pObjectPool->pObjects[objectId] == nullptr)
+            if (!World::IsObjectExists(objectId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) StaticLocalStreamAtObject(distance, objectId, color, name);
@@ -320,7 +397,13 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvCreateSLStreamAtObject", { Capture::Float(distance), Capture::Value(objectId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -342,8 +425,15 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
             SV::dlstreamList.insert(static_cast<DynamicStream*>(stream));
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+
+            Capture::RecordNative("SvCreateDLStreamAtPoint", { Capture::Float(distance), Capture::Value(maxPlayers), Capture::Float(posx), Capture::Float(posy), Capture::Float(posz), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -356,7 +446,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pVehiclePool->pVehicle[vehicleId] == nullptr)
+            if (!World::IsVehicleExists(vehicleId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) DynamicLocalStreamAtVehicle(distance, maxPlayers, vehicleId, color, name);
@@ -364,8 +454,15 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
             SV::dlstreamList.insert(static_cast<DynamicStream*>(stream));
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+
+            Capture::RecordNative("SvCreateDLStreamAtVehicle", { Capture::Float(distance), Capture::Value(maxPlayers), Capture::Value(vehicleId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -378,7 +475,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pPlayerPool->pPlayer[playerId] == nullptr)
+            if (!World::IsPlayerExists(playerId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) DynamicLocalStreamAtPlayer(distance, maxPlayers, playerId, color, name);
@@ -386,8 +483,15 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
             SV::dlstreamList.insert(static_cast<DynamicStream*>(stream));
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+
+            Capture::RecordNative("SvCreateDLStreamAtPlayer", { Capture::Float(distance), Capture::Value(maxPlayers), Capture::Value(playerId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -400,7 +504,7 @@ namespace SV
             const std::string& name
         ) override
         {
-            if (pNetGame->pObjectPool->pObjects[objectId] == nullptr)
+            if (!World::IsObjectExists(objectId))
                 return nullptr;
 
             const auto stream = new (std::nothrow) DynamicLocalStreamAtObject(distance, maxPlayers, objectId, color, name);
@@ -408,8 +512,15 @@ namespace SV
 
             const auto baseStream = static_cast<Stream*>(stream);
 
+            if (baseStream->GetHandle() == SlotMap<Stream>::kInvalidHandle)
+            {
+                delete baseStream;
+                return nullptr;
+            }
+
             SV::dlstreamList.insert(static_cast<DynamicStream*>(stream));
-            SV::streamTable.emplace(reinterpret_cast<uint32_t>(baseStream), baseStream);
+
+            Capture::RecordNative("SvCreateDLStreamAtObject", { Capture::Float(distance), Capture::Value(maxPlayers), Capture::Value(objectId), Capture::Value(color), Capture::String(name) }, Capture::Handle(baseStream->GetHandle()));
 
             return baseStream;
         }
@@ -418,11 +529,15 @@ namespace SV
 
         void SvUpdatePositionForLPStream(PointStream* const lpStream, const float posx, const float posy, const float posz) override
         {
+            Capture::RecordNative("SvUpdatePositionForLPStream", { Capture::Handle(lpStream->GetHandle()), Capture::Float(posx), Capture::Float(posy), Capture::Float(posz) });
+
             lpStream->UpdatePosition(CVector(posx, posy, posz));
         }
 
         void SvUpdateDistanceForLStream(LocalStream* const lStream, const float distance) override
         {
+            Capture::RecordNative("SvUpdateDistanceForLStream", { Capture::Handle(lStream->GetHandle()), Capture::Float(distance) });
+
             lStream->UpdateDistance(distance);
         }
 
@@ -430,6 +545,8 @@ namespace SV
 
         bool SvAttachListenerToStream(Stream* const stream, const uint16_t playerId) override
         {
+            Capture::RecordNative("SvAttachListenerToStream", { Capture::Handle(stream->GetHandle()), Capture::Value(playerId) });
+
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
             if (pPlayerInfo != nullptr) pPlayerInfo->listenerStreams.insert(stream);
             PlayerStore::ReleasePlayerWithSharedAccess(playerId);
@@ -444,6 +561,8 @@ namespace SV
 
         bool SvDetachListenerFromStream(Stream* const stream, const uint16_t playerId) override
         {
+            Capture::RecordNative("SvDetachListenerFromStream", { Capture::Handle(stream->GetHandle()), Capture::Value(playerId) });
+
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithSharedAccess(playerId);
             if (pPlayerInfo != nullptr) pPlayerInfo->listenerStreams.erase(stream);
             PlayerStore::ReleasePlayerWithSharedAccess(playerId);
@@ -453,6 +572,8 @@ namespace SV
 
         void SvDetachAllListenersFromStream(Stream* const stream) override
         {
+            Capture::RecordNative("SvDetachAllListenersFromStream", { Capture::Handle(stream->GetHandle()) });
+
             const auto detachedListeners = stream->DetachAllListeners();
 
             for (const auto playerId : detachedListeners)
@@ -467,6 +588,8 @@ namespace SV
 
         bool SvAttachSpeakerToStream(Stream* const stream, const uint16_t playerId) override
         {
+            Capture::RecordNative("SvAttachSpeakerToStream", { Capture::Handle(stream->GetHandle()), Capture::Value(playerId) });
+
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(playerId);
             if (pPlayerInfo != nullptr) pPlayerInfo->speakerStreams.insert(stream);
             PlayerStore::ReleasePlayerWithUniqueAccess(playerId);
@@ -481,6 +604,8 @@ namespace SV
 
         bool SvDetachSpeakerFromStream(Stream* const stream, const uint16_t playerId) override
         {
+            Capture::RecordNative("SvDetachSpeakerFromStream", { Capture::Handle(stream->GetHandle()), Capture::Value(playerId) });
+
             const auto pPlayerInfo = PlayerStore::RequestPlayerWithUniqueAccess(playerId);
             if (pPlayerInfo != nullptr) pPlayerInfo->speakerStreams.erase(stream);
             PlayerStore::ReleasePlayerWithUniqueAccess(playerId);
@@ -490,6 +615,8 @@ namespace SV
 
         void SvDetachAllSpeakersFromStream(Stream* const stream) override
         {
+            Capture::RecordNative("SvDetachAllSpeakersFromStream", { Capture::Handle(stream->GetHandle()) });
+
             const auto detachedSpeakers = stream->DetachAllSpeakers();
 
             for (const auto playerId : detachedSpeakers)
@@ -504,11 +631,15 @@ namespace SV
 
         void SvStreamParameterSet(Stream* const stream, const uint8_t parameter, const float value) override
         {
+            Capture::RecordNative("SvStreamParameterSet", { Capture::Handle(stream->GetHandle()), Capture::Value(parameter), Capture::Float(value) });
+
             stream->SetParameter(parameter, value);
         }
 
         void SvStreamParameterReset(Stream* const stream, const uint8_t parameter) override
         {
+            Capture::RecordNative("SvStreamParameterReset", { Capture::Handle(stream->GetHandle()), Capture::Value(parameter) });
+
             stream->ResetParameter(parameter);
         }
 
@@ -524,23 +655,53 @@ namespace SV
 
         void SvStreamParameterSlideFromTo(Stream* const stream, const uint8_t parameter, const float startvalue, const float endvalue, const uint32_t time) override
         {
+            Capture::RecordNative("SvStreamParameterSlideFromTo", { Capture::Handle(stream->GetHandle()), Capture::Value(parameter), Capture::Float(startvalue), Capture::Float(endvalue), Capture::Value(time) });
+
             stream->SlideParameterFromTo(parameter, startvalue, endvalue, time);
         }
 
         void SvStreamParameterSlideTo(Stream* const stream, const uint8_t parameter, const float endvalue, const uint32_t time) override
         {
+            Capture::RecordNative("SvStreamParameterSlideTo", { Capture::Handle(stream->GetHandle()), Capture::Value(parameter), Capture::Float(endvalue), Capture::Value(time) });
+
             stream->SlideParameterTo(parameter, endvalue, time);
         }
 
         void SvStreamParameterSlide(Stream* const stream, const uint8_t parameter, const float deltavalue, const uint32_t time) override
         {
+            Capture::RecordNative("SvStreamParameterSlide", { Capture::Handle(stream->GetHandle()), Capture::Value(parameter), Capture::Float(deltavalue), Capture::Value(time) });
+
             stream->SlideParameter(parameter, deltavalue, time);
         }
 
+        bool SvStreamSetMixMode(Stream* const stream, const uint8_t mode) override
+        {
+            Capture::RecordNative("SvStreamSetMixMode", { Capture::Handle(stream->GetHandle()), Capture::Value(mode) });
+
+            return stream->SetMixMode(mode);
+        }
+
+        uint8_t SvStreamGetMixMode(Stream* const stream) override
+        {
+            return stream->GetMixMode();
+        }
+
+        bool SvStreamRecordStart(Stream* const stream, const std::string& filename, const bool perspeaker) override
+        {
+            return stream->StartRecord(filename, perspeaker);
+        }
+
+        bool SvStreamRecordStop(Stream* const stream) override
+        {
+            return stream->StopRecord();
+        }
+
         // -------------------------------------------------------------------------------------
 
         void SvDeleteStream(Stream* const stream) override
         {
+            Capture::RecordNative("SvDeleteStream", { Capture::Handle(stream->GetHandle()) });
+
             const auto detachedSpeakers = stream->DetachAllSpeakers();
 
             for (const auto playerId : detachedSpeakers)
@@ -559,7 +720,6 @@ namespace SV
                 PlayerStore::ReleasePlayerWithSharedAccess(playerId);
             }
 
-            SV::streamTable.erase(reinterpret_cast<uint32_t>(stream));
             if (const auto dlStream = dynamic_cast<DynamicStream*>(stream))
                 SV::dlstreamList.erase(dlStream);
 
@@ -570,68 +730,497 @@ namespace SV
 
         Effect* SvEffectCreateChorus(const int priority, const float wetdrymix, const float depth, const float feedback, const float frequency, const uint32_t waveform, const float delay, const uint32_t phase) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::chorus, priority, ChorusParameters { wetdrymix, depth, feedback, frequency, waveform, delay, phase });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::chorus, priority, ChorusParameters { wetdrymix, depth, feedback, frequency, waveform, delay, phase });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateChorus", { Capture::Value(priority), Capture::Float(wetdrymix), Capture::Float(depth), Capture::Float(feedback), Capture::Float(frequency), Capture::Value(waveform), Capture::Float(delay), Capture::Value(phase) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateCompressor(const int priority, const float gain, const float attack, const float release, const float threshold, const float ratio, const float predelay) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::compressor, priority, CompressorParameters { gain, attack, release, threshold, ratio, predelay });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::compressor, priority, CompressorParameters { gain, attack, release, threshold, ratio, predelay });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateCompressor", { Capture::Value(priority), Capture::Float(gain), Capture::Float(attack), Capture::Float(release), Capture::Float(threshold), Capture::Float(ratio), Capture::Float(predelay) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateDistortion(const int priority, const float gain, const float edge, const float posteqcenterfrequency, const float posteqbandwidth, const float prelowpasscutoff) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::distortion, priority, DistortionParameters { gain, edge, posteqcenterfrequency, posteqbandwidth, prelowpasscutoff });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::distortion, priority, DistortionParameters { gain, edge, posteqcenterfrequency, posteqbandwidth, prelowpasscutoff });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateDistortion", { Capture::Value(priority), Capture::Float(gain), Capture::Float(edge), Capture::Float(posteqcenterfrequency), Capture::Float(posteqbandwidth), Capture::Float(prelowpasscutoff) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateEcho(const int priority, const float wetdrymix, const float feedback, const float leftdelay, const float rightdelay, const bool pandelay) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::echo, priority, EchoParameters { wetdrymix, feedback, leftdelay, rightdelay, pandelay });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::echo, priority, EchoParameters { wetdrymix, feedback, leftdelay, rightdelay, pandelay });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateEcho", { Capture::Value(priority), Capture::Float(wetdrymix), Capture::Float(feedback), Capture::Float(leftdelay), Capture::Float(rightdelay), Capture::Value(pandelay) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateFlanger(const int priority, const float wetdrymix, const float depth, const float feedback, const float frequency, const uint32_t waveform, const float delay, const uint32_t phase) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::flanger, priority, FlangerParameters { wetdrymix, depth, feedback, frequency, waveform, delay, phase });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::flanger, priority, FlangerParameters { wetdrymix, depth, feedback, frequency, waveform, delay, phase });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateFlanger", { Capture::Value(priority), Capture::Float(wetdrymix), Capture::Float(depth), Capture::Float(feedback), Capture::Float(frequency), Capture::Value(waveform), Capture::Float(delay), Capture::Value(phase) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateGargle(const int priority, const uint32_t ratehz, const uint32_t waveshape) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::gargle, priority, GargleParameters { ratehz, waveshape });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::gargle, priority, GargleParameters { ratehz, waveshape });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateGargle", { Capture::Value(priority), Capture::Value(ratehz), Capture::Value(waveshape) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateI3dl2reverb(const int priority, const int room, const int roomhf, const float roomrollofffactor, const float decaytime, const float decayhfratio, const int reflections, const float reflectionsdelay, const int reverb, const float reverbdelay, const float diffusion, const float density, const float hfreference) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::i3dl2reverb, priority, I3dl2reverbParameters { room, roomhf, roomrollofffactor, decaytime, decayhfratio, reflections, reflectionsdelay, reverb, reverbdelay, diffusion, density, hfreference });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::i3dl2reverb, priority, I3dl2reverbParameters { room, roomhf, roomrollofffactor, decaytime, decayhfratio, reflections, reflectionsdelay, reverb, reverbdelay, diffusion, density, hfreference });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateI3dl2reverb", { Capture::Value(priority), Capture::Value(room), Capture::Value(roomhf), Capture::Float(roomrollofffactor), Capture::Float(decaytime), Capture::Float(decayhfratio), Capture::Value(reflections), Capture::Float(reflectionsdelay), Capture::Value(reverb), Capture::Float(reverbdelay), Capture::Float(diffusion), Capture::Float(density), Capture::Float(hfreference) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateParameq(const int priority, const float center, const float bandwidth, const float gain) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::parameq, priority, ParameqParameters { center, bandwidth, gain });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::parameq, priority, ParameqParameters { center, bandwidth, gain });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateParameq", { Capture::Value(priority), Capture::Float(center), Capture::Float(bandwidth), Capture::Float(gain) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         Effect* SvEffectCreateReverb(const int priority, const float ingain, const float reverbmix, const float reverbtime, const float highfreqrtratio) override
         {
-            return new (std::nothrow) Effect(SV::EffectType::reverb, priority, ReverbParameters { ingain, reverbmix, reverbtime, highfreqrtratio });
+            const auto effect = new (std::nothrow) Effect(SV::EffectType::reverb, priority, ReverbParameters { ingain, reverbmix, reverbtime, highfreqrtratio });
+            if (effect == nullptr) return nullptr;
+
+            if (effect->GetHandle() == SlotMap<Effect>::kInvalidHandle)
+            {
+                delete effect;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvEffectCreateReverb", { Capture::Value(priority), Capture::Float(ingain), Capture::Float(reverbmix), Capture::Float(reverbtime), Capture::Float(highfreqrtratio) }, Capture::Handle(effect->GetHandle()));
+
+            return effect;
         }
 
         void SvEffectAttachStream(Effect* const effect, Stream* const stream) override
         {
+            Capture::RecordNative("SvEffectAttachStream", { Capture::Handle(effect->GetHandle()), Capture::Handle(stream->GetHandle()) });
+
             effect->AttachStream(stream);
         }
 
         void SvEffectDetachStream(Effect* const effect, Stream* const stream) override
         {
+            Capture::RecordNative("SvEffectDetachStream", { Capture::Handle(effect->GetHandle()), Capture::Handle(stream->GetHandle()) });
+
             effect->DetachStream(stream);
         }
 
         void SvEffectDelete(Effect* const effect) override
         {
+            Capture::RecordNative("SvEffectDelete", { Capture::Handle(effect->GetHandle()) });
+
             delete effect;
         }
 
+        // -------------------------------------------------------------------------------------
+
+        AudioSource* SvSourceCreate(const std::string& filename) override
+        {
+            auto file = AudioFile::Load(filename);
+            if (file == nullptr) return nullptr;
+
+            const auto source = new (std::nothrow) AudioSource(std::move(file));
+            if (source == nullptr) return nullptr;
+
+            if (source->GetSender() == SV::kNonePlayer)
+            {
+                delete source;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvSourceCreate", { Capture::String(filename) }, Capture::Handle(source->GetHandle()));
+
+            return source;
+        }
+
+        void SvSourcePlay(AudioSource* const source, Stream* const stream, const bool loop) override
+        {
+            Capture::RecordNative("SvSourcePlay", { Capture::Handle(source->GetHandle()), Capture::Handle(stream->GetHandle()), Capture::Value(loop) });
+
+            source->Play(stream, loop);
+        }
+
+        void SvSourceStop(AudioSource* const source) override
+        {
+            Capture::RecordNative("SvSourceStop", { Capture::Handle(source->GetHandle()) });
+
+            source->Stop();
+        }
+
+        bool SvSourceIsPlaying(AudioSource* const source) override
+        {
+            return source->IsPlaying();
+        }
+
+        void SvSourceDelete(AudioSource* const source) override
+        {
+            Capture::RecordNative("SvSourceDelete", { Capture::Handle(source->GetHandle()) });
+
+            delete source;
+        }
+
+        // -------------------------------------------------------------------------------------
+
+        Group* SvGroupCreate(const std::string& name) override
+        {
+            const auto group = new (std::nothrow) Group(name);
+            if (group == nullptr) return nullptr;
+
+            if (group->GetHandle() == SlotMap<Group>::kInvalidHandle)
+            {
+                delete group;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvGroupCreate", { Capture::String(name) }, Capture::Handle(group->GetHandle()));
+
+            return group;
+        }
+
+        Group* SvGroupCreateUnion(Group* const group1, Group* const group2, const std::string& name) override
+        {
+            const auto group = new (std::nothrow) Group(Group::Operation::unite, group1->GetHandle(), group2->GetHandle(), name);
+            if (group == nullptr) return nullptr;
+
+            if (group->GetHandle() == SlotMap<Group>::kInvalidHandle)
+            {
+                delete group;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvGroupCreateUnion", { Capture::Handle(group1->GetHandle()), Capture::Handle(group2->GetHandle()), Capture::String(name) }, Capture::Handle(group->GetHandle()));
+
+            return group;
+        }
+
+        Group* SvGroupCreateIntersection(Group* const group1, Group* const group2, const std::string& name) override
+        {
+            const auto group = new (std::nothrow) Group(Group::Operation::intersect, group1->GetHandle(), group2->GetHandle(), name);
+            if (group == nullptr) return nullptr;
+
+            if (group->GetHandle() == SlotMap<Group>::kInvalidHandle)
+            {
+                delete group;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvGroupCreateIntersection", { Capture::Handle(group1->GetHandle()), Capture::Handle(group2->GetHandle()), Capture::String(name) }, Capture::Handle(group->GetHandle()));
+
+            return group;
+        }
+
+        Group* SvGroupCreateDifference(Group* const group1, Group* const group2, const std::string& name) override
+        {
+            const auto group = new (std::nothrow) Group(Group::Operation::subtract, group1->GetHandle(), group2->GetHandle(), name);
+            if (group == nullptr) return nullptr;
+
+            if (group->GetHandle() == SlotMap<Group>::kInvalidHandle)
+            {
+                delete group;
+                return nullptr;
+            }
+
+            Capture::RecordNative("SvGroupCreateDifference", { Capture::Handle(group1->GetHandle()), Capture::Handle(group2->GetHandle()), Capture::String(name) }, Capture::Handle(group->GetHandle()));
+
+            return group;
+        }
+
+        bool SvGroupAddPlayer(Group* const group, const uint16_t playerId) override
+        {
+            Capture::RecordNative("SvGroupAddPlayer", { Capture::Handle(group->GetHandle()), Capture::Value(playerId) });
+
+            return group->AddPlayer(playerId);
+        }
+
+        bool SvGroupRemovePlayer(Group* const group, const uint16_t playerId) override
+        {
+            Capture::RecordNative("SvGroupRemovePlayer", { Capture::Handle(group->GetHandle()), Capture::Value(playerId) });
+
+            return group->RemovePlayer(playerId);
+        }
+
+        bool SvGroupHasPlayer(Group* const group, const uint16_t playerId) override
+        {
+            return group->HasPlayer(playerId);
+        }
+
+        bool SvGroupClear(Group* const group) override
+        {
+            Capture::RecordNative("SvGroupClear", { Capture::Handle(group->GetHandle()) });
+
+            return group->Clear();
+        }
+
+        uint32_t SvGroupGetPlayersCount(Group* const group) override
+        {
+            return group->GetPlayersCount();
+        }
+
+        void SvGroupDelete(Group* const group) override
+        {
+            Capture::RecordNative("SvGroupDelete", { Capture::Handle(group->GetHandle()) });
+
+            delete group;
+        }
+
+        bool SvStreamSetListenerGroup(Stream* const stream, Group* const group) override
+        {
+            Capture::RecordNative("SvStreamSetListenerGroup", { Capture::Handle(stream->GetHandle()), group != nullptr ? Capture::Handle(group->GetHandle()) : Capture::Value(NULL) });
+
+            return Group::BindListeners(stream, group);
+        }
+
+        bool SvStreamSetSpeakerGroup(Stream* const stream, Group* const group) override
+        {
+            Capture::RecordNative("SvStreamSetSpeakerGroup", { Capture::Handle(stream->GetHandle()), group != nullptr ? Capture::Handle(group->GetHandle()) : Capture::Value(NULL) });
+
+            return Group::BindSpeakers(stream, group);
+        }
+
+        // -------------------------------------------------------------------------------------
+
+        void SvSetVoiceRateLimit(const uint32_t packetsPerSecond, const uint32_t bytesPerSecond, const uint32_t burstTime) override
+        {
+            Capture::RecordNative("SvSetVoiceRateLimit", { Capture::Value(packetsPerSecond), Capture::Value(bytesPerSecond), Capture::Value(burstTime) });
+
+            RateLimiter::SetLimits(packetsPerSecond, bytesPerSecond, burstTime);
+            RelayLink::PublishRateLimit(packetsPerSecond, bytesPerSecond, burstTime);
+        }
+
+        uint32_t SvGetPlayerThrottledPackets(const uint16_t playerId) override
+        {
+            return RateLimiter::GetPlayerThrottledPackets(playerId);
+        }
+
+        uint32_t SvGetPlayerThrottledBytes(const uint16_t playerId) override
+        {
+            return RateLimiter::GetPlayerThrottledBytes(playerId);
+        }
+
+        void SvSetVoiceAuthMode(const uint8_t mode) override
+        {
+            Capture::RecordNative("SvSetVoiceAuthMode", { Capture::Value(mode) });
+
+            Network::SetVoiceAuthMode(mode);
+        }
+
+        bool SvHasVoiceAuth(const uint16_t playerId) override
+        {
+            return Network::HasVoiceAuth(playerId);
+        }
+
+        bool SvHasCompactHeader(const uint16_t playerId) override
+        {
+            return Network::HasCompactHeader(playerId);
+        }
+
+        void SvSetBitrateLimits(const uint32_t minBitrate, const uint32_t maxBitrate) override
+        {
+            Capture::RecordNative("SvSetBitrateLimits", { Capture::Value(minBitrate), Capture::Value(maxBitrate) });
+
+            BitrateController::SetLimits(minBitrate, maxBitrate);
+        }
+
+        uint32_t SvGetPlayerBitrate(const uint16_t playerId) override
+        {
+            return BitrateController::GetPlayerBitrate(playerId);
+        }
+
+        void SvSetSimulcast(const bool status) override
+        {
+            Capture::RecordNative("SvSetSimulcast", { Capture::Value(status) });
+
+            Network::SetSimulcast(status);
+        }
+
+        bool SvFederationOpen(const uint16_t port, const uint32_t flushInterval) override
+        {
+            Capture::RecordNative("SvFederationOpen", { Capture::Value(port), Capture::Value(flushInterval) });
+
+            return Federation::Open(port, flushInterval);
+        }
+
+        void SvFederationClose() override
+        {
+            Capture::RecordNative("SvFederationClose", {});
+
+            Federation::Close();
+        }
+
+        int SvFederationAddPeer(const std::string& host, const uint16_t port, const uint32_t key) override
+        {
+            Capture::RecordNative("SvFederationAddPeer", { Capture::String(host), Capture::Value(port), Capture::Value(key) });
+
+            return Federation::AddPeer(host, port, key);
+        }
+
+        bool SvFederationRemovePeer(const int peer) override
+        {
+            Capture::RecordNative("SvFederationRemovePeer", { Capture::Value(peer) });
+
+            return Federation::RemovePeer(peer);
+        }
+
+        bool SvFederationExportStream(Stream* const stream, const int peer, const uint16_t channel) override
+        {
+            Capture::RecordNative("SvFederationExportStream", { Capture::Handle(stream->GetHandle()), Capture::Value(peer), Capture::Value(channel) });
+
+            return Federation::ExportStream(stream, peer, channel);
+        }
+
+        bool SvFederationImportStream(Stream* const stream, const int peer, const uint16_t channel) override
+        {
+            Capture::RecordNative("SvFederationImportStream", { Capture::Handle(stream->GetHandle()), Capture::Value(peer), Capture::Value(channel) });
+
+            return Federation::ImportStream(stream, peer, channel);
+        }
+
+        void SvFederationDetachStream(Stream* const stream) override
+        {
+            Capture::RecordNative("SvFederationDetachStream", { Capture::Handle(stream->GetHandle()) });
+
+            Federation::DetachStream(stream);
+        }
+
+        void SvSetWorkerLimits(const uint32_t minWorkers, const uint32_t maxWorkers) override
+        {
+            Capture::RecordNative("SvSetWorkerLimits", { Capture::Value(minWorkers), Capture::Value(maxWorkers) });
+
+            WorkerPool::SetLimits(minWorkers, maxWorkers);
+        }
+
+        uint32_t SvGetWorkersCount() override
+        {
+            return WorkerPool::GetWorkersCount();
+        }
+
+        int64_t SvGetStat(const uint32_t statId) override
+        {
+            return Metrics::Get(statId);
+        }
+
+        uint64_t SvGetLatency(const uint32_t latencyType, const float percentile) override
+        {
+            return Latency::GetPercentile(latencyType, percentile);
+        }
+
+        void SvDumpLatency() override
+        {
+            Latency::DumpToLog();
+        }
+
+        void SvResetLatency() override
+        {
+            Latency::Reset();
+        }
+
+        bool SvTraceStart() override
+        {
+            return Tracer::Start();
+        }
+
+        bool SvTraceStop(const std::string& filename) override
+        {
+            return Tracer::Stop(filename.empty() ? SV::kTraceFileName : filename);
+        }
+
+        bool SvCaptureStart(const std::string& filename) override
+        {
+            return Capture::Start(filename.empty() ? SV::kCaptureFileName : filename);
+        }
+
+        bool SvCaptureStop() override
+        {
+            return Capture::Stop();
+        }
+
     };
 
     void ConnectHandler(const uint16_t playerId, const SV::ConnectPacket& connectStruct) noexcept
     {
+        RateLimiter::ResetPlayer(playerId);
+        BitrateController::ResetPlayer(playerId);
         PlayerStore::AddPlayerToStore(playerId, connectStruct.version, connectStruct.micro);
     }
 
@@ -651,13 +1240,23 @@ namespace SV
 
     static __forceinline void Tick() noexcept
     {
+        const Tracer::Span span { "SV::Tick" };
+
         for (const auto dlStream : SV::dlstreamList)
+        {
+            const Tracer::Span span { "DynamicStream::Tick" };
             dlStream->Tick();
+        }
+
+        Group::Process();
 
         uint16_t senderId { SV::kNonePlayer };
+        uint32_t controlPacketsCount { 0 };
 
         while (const auto controlPacket = Network::ReceiveControlPacket(senderId))
         {
+            ++controlPacketsCount;
+
             const auto& controlPacketRef = *controlPacket;
 
             switch (controlPacketRef->packet)
@@ -694,10 +1293,36 @@ namespace SV
 
                     Pawn::OnPlayerActivationKeyReleaseForAll(senderId, keyId);
                 } break;
+                case SV::ControlPacketType::receiverReport:
+                {
+                    const auto entries = PackGetStruct(&controlPacketRef, SV::ReceiverReportEntry);
+                    if (controlPacketRef->length % sizeof(*entries) != 0) break;
+
+                    BitrateController::AddReport(senderId, entries, controlPacketRef->length / sizeof(*entries));
+                } break;
             }
         }
 
+        uint16_t throttledPlayerId { SV::kNonePlayer };
+        uint32_t droppedPackets { 0 };
+
+        while (RateLimiter::PopThrottleEvent(throttledPlayerId, droppedPackets))
+            Pawn::OnPlayerVoiceThrottleForAll(throttledPlayerId, droppedPackets);
+
+        BitrateController::Tick();
+
+        Capture::SamplePositions();
+
+        WorkerPool::Process();
         Network::Process();
+
+        StateMirror::Process();
+
+        Metrics::Add(StatType::ticksCount);
+        Metrics::Set(StatType::controlQueueDepth, controlPacketsCount);
+        Metrics::Set(StatType::workersCount, WorkerPool::GetWorkersCount());
+        Metrics::Set(StatType::workersUtilization, WorkerPool::GetUtilization());
+        Metrics::Set(StatType::streamsCount, Stream::GetStreamsCount());
     }
 }
 
@@ -705,8 +1330,12 @@ namespace SV
 
 PLUGIN_EXPORT void PLUGIN_CALL ProcessTick() noexcept
 {
+    const auto tickBeginTime = Latency::Now();
+
     Timer::Tick();
     SV::Tick();
+
+    Latency::Record(LatencyType::tick, Latency::Now() - tickBeginTime);
 }
 
 PLUGIN_EXPORT void PLUGIN_CALL Unload() noexcept
@@ -719,13 +1348,26 @@ PLUGIN_EXPORT void PLUGIN_CALL Unload() noexcept
     Logger::Log("           SampVoice unloading...           ");
     Logger::Log(" -------------------------------------------");
 
-    SV::workers.clear();
+    Federation::Close();
+    SourcePool::Free();
+    WorkerPool::Free();
+    MixerPool::Free();
+    Recorder::Free();
+    Metrics::Free();
+
+    if (Tracer::IsEnabled())
+        Tracer::Stop(SV::kTraceFileName);
+
+    Capture::Stop();
 
     PlayerStore::ClearStore();
 
     Pawn::Free();
     RakNet::Free();
     Network::Free();
+    RelayLink::Free();
+    StateMirror::Free();
+    Config::Free();
     Logger::Free();
 }
 
@@ -753,37 +1395,65 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void** const ppData) noexcept
         return false;
     }
 
+    Config::Load(SV::kConfigFileName);
+
+    Tracer::SetThreadName("main");
+
     if (!Network::Init(logprintf))
     {
         Logger::Log("[sv:err:main:Load] : failed to init network");
+        Config::Free();
         Logger::Free();
         return false;
     }
 
+    // Must be decided before voice server is bound
+    if (Config::Has("relay_port") && !RelayLink::Init(static_cast<uint16_t>(Config::GetInt("relay_port", 0)),
+        Config::GetString("relay_shm", SV::kRelayShmName), Config::GetString("relay_socket", SV::kRelaySocketName)))
+    {
+        Logger::Log("[sv:err:main:Load] : failed to init relay link, voice is served by plugin");
+    }
+
+    if (Config::Has("mirror_shm") && !StateMirror::Init(Config::GetString("mirror_shm", SV::kMirrorShmName)))
+        Logger::Log("[sv:err:main:Load] : failed to init state mirror");
+
     Network::AddConnectCallback(SV::ConnectHandler);
     Network::AddPlayerInitCallback(SV::PlayerInitHandler);
     Network::AddDisconnectCallback(SV::DisconnectHandler);
 
+    // Group members are dropped on leaving the server, voice connection or not
+    RakNet::AddDisconnectCallback(Group::DropPlayer);
+
     if (!Pawn::Init(std::make_unique<SV::PawnHandler>()))
     {
         Logger::Log("[sv:err:main:Load] : failed to init pawn");
         Network::Free();
+        Config::Free();
         Logger::Free();
         return false;
     }
 
     {
         auto nprocs = std::thread::hardware_concurrency();
+        if (!nprocs) nprocs = SV::kVoiceThreadsCount;
 
-        if (!nprocs || nprocs > SV::kVoiceThreadsCount)
-            nprocs = SV::kVoiceThreadsCount;
-
-        Logger::Log("[sv:dbg:main:Load] : creating %u work threads...", nprocs);
+        // By default pool starts with as many workers as before and may grow up to cores count
+        const auto minWorkers = static_cast<uint32_t>(Config::GetInt("workers_min", std::min(nprocs, SV::kVoiceThreadsCount)));
+        const auto maxWorkers = static_cast<uint32_t>(Config::GetInt("workers_max", nprocs));
+        const auto affinityStatus = Config::GetBool("workers_affinity", false);
 
-        SV::workers.reserve(nprocs); for (auto i { nprocs }; i > 0; --i)
-            SV::workers.emplace_back(MakeWorker());
+        WorkerPool::Init(minWorkers, maxWorkers, affinityStatus);
     }
 
+    MixerPool::Init(static_cast<uint32_t>(Config::GetInt("mixer_threads", 2)));
+    Recorder::Init();
+    SourcePool::Init();
+
+    Metrics::Init(Config::GetString("stats_file"), static_cast<uint32_t>(Config::GetInt("stats_interval", 10000)));
+
+    if (Config::Has("capture_file"))
+        Capture::Start(Config::GetString("capture_file", SV::kCaptureFileName));
+
     Logger::Log(" -------------------------------------------    ");
     Logger::Log("   ___                __   __    _              ");
     Logger::Log("  / __| __ _ _ __  _ _\\ \\ / /__ (_) __ ___    ");
@@ -799,8 +1469,7 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void** const ppData) noexcept
 
 PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX* const amx) noexcept
 {
-    if (pNetGame == nullptr && (pNetGame = reinterpret_cast<CNetGame*(*)()>(ppPluginData[PLUGIN_DATA_NETGAME])()) != nullptr)
-        Logger::Log("[sv:dbg:main:AmxLoad] : net game pointer (value:%p) received", pNetGame);
+    World::Init(ppPluginData);
 
     if (!Network::Bind()) Logger::Log("[sv:dbg:main:AmxLoad] : failed to bind voice server");
 
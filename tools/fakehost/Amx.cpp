@@ -0,0 +1,166 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Amx.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <pawn/plugincommon.h>
+
+void* Amx::GetExports() noexcept
+{
+    for (std::size_t i { 0 }; i <= PLUGIN_AMX_EXPORT_UTF8Put; ++i)
+    {
+        if (Amx::exports[i] == nullptr)
+            Amx::exports[i] = reinterpret_cast<void*>(&Amx::Unsupported);
+    }
+
+    Amx::exports[PLUGIN_AMX_EXPORT_Register] = reinterpret_cast<void*>(&Amx::Register);
+    Amx::exports[PLUGIN_AMX_EXPORT_FindPublic] = reinterpret_cast<void*>(&Amx::FindPublic);
+    Amx::exports[PLUGIN_AMX_EXPORT_GetAddr] = reinterpret_cast<void*>(&Amx::GetAddr);
+    Amx::exports[PLUGIN_AMX_EXPORT_StrLen] = reinterpret_cast<void*>(&Amx::StrLen);
+    Amx::exports[PLUGIN_AMX_EXPORT_GetString] = reinterpret_cast<void*>(&Amx::GetString);
+
+    return Amx::exports;
+}
+
+AMX* Amx::GetInstance() noexcept
+{
+    return &Amx::amx;
+}
+
+bool Amx::HasNative(const char* const name) noexcept
+{
+    return Amx::natives.find(name) != Amx::natives.end();
+}
+
+cell Amx::Call(const char* const name, const std::initializer_list<cell> args) noexcept
+{
+    return Amx::Call(name, std::vector<cell>(args));
+}
+
+cell Amx::Call(const char* const name, const std::vector<cell>& args) noexcept
+{
+    const auto iNative = Amx::natives.find(name);
+
+    if (iNative == Amx::natives.end())
+    {
+        std::fprintf(stderr, "fakehost: native '%s' is not registered\n", name);
+        Amx::heapTop = 0;
+        return NULL;
+    }
+
+    std::vector<cell> params;
+
+    params.reserve(1 + args.size());
+    params.emplace_back(static_cast<cell>(args.size() * sizeof(cell)));
+    params.insert(params.end(), args.begin(), args.end());
+
+    const auto result = iNative->second(&Amx::amx, params.data());
+
+    Amx::heapTop = 0;
+
+    return result;
+}
+
+cell Amx::Float(float value) noexcept
+{
+    return amx_ftoc(value);
+}
+
+float Amx::ToFloat(cell value) noexcept
+{
+    return amx_ctof(value);
+}
+
+cell Amx::String(const char* const string) noexcept
+{
+    const auto length = std::strlen(string);
+
+    if (Amx::heap.size() < kHeapSize) Amx::heap.resize(kHeapSize);
+    if (Amx::heapTop + length + 1 > Amx::heap.size()) return NULL;
+
+    const auto address = Amx::heapTop;
+
+    // Unpacked string, one character per cell
+    for (std::size_t i { 0 }; i < length; ++i)
+        Amx::heap[Amx::heapTop++] = static_cast<unsigned char>(string[i]);
+
+    Amx::heap[Amx::heapTop++] = '\0';
+
+    return static_cast<cell>(address * sizeof(cell));
+}
+
+int AMXAPI Amx::Register(AMX*, const AMX_NATIVE_INFO* const nativeList, const int number) noexcept
+{
+    for (int i { 0 }; (number < 0 || i < number) && nativeList[i].name != nullptr; ++i)
+        Amx::natives[nativeList[i].name] = nativeList[i].func;
+
+    return AMX_ERR_NONE;
+}
+
+int AMXAPI Amx::FindPublic(AMX*, const char*, int* const index) noexcept
+{
+    if (index != nullptr) *index = -1;
+    return AMX_ERR_NOTFOUND;
+}
+
+int AMXAPI Amx::GetAddr(AMX*, const cell amxAddr, cell** const physAddr) noexcept
+{
+    const auto index = static_cast<std::size_t>(amxAddr) / sizeof(cell);
+
+    if (amxAddr < 0 || amxAddr % sizeof(cell) != 0 || index >= Amx::heap.size())
+    {
+        *physAddr = nullptr;
+        return AMX_ERR_MEMACCESS;
+    }
+
+    *physAddr = Amx::heap.data() + index;
+
+    return AMX_ERR_NONE;
+}
+
+int AMXAPI Amx::StrLen(const cell* const string, int* const length) noexcept
+{
+    *length = 0;
+
+    if (string == nullptr) return AMX_ERR_PARAMS;
+
+    while (string[*length] != '\0') ++*length;
+
+    return AMX_ERR_NONE;
+}
+
+int AMXAPI Amx::GetString(char* const dest, const cell* const source, int, const size_t size) noexcept
+{
+    if (size == 0) return AMX_ERR_NONE;
+
+    std::size_t length { 0 };
+
+    for (; length + 1 < size && source[length] != '\0'; ++length)
+        dest[length] = static_cast<char>(source[length]);
+
+    dest[length] = '\0';
+
+    return AMX_ERR_NONE;
+}
+
+int AMXAPI Amx::Unsupported() noexcept
+{
+    return AMX_ERR_NOTFOUND;
+}
+
+AMX Amx::amx {};
+void* Amx::exports[PLUGIN_AMX_EXPORT_UTF8Put + 1] {};
+
+std::unordered_map<std::string, AMX_NATIVE> Amx::natives;
+
+std::vector<cell> Amx::heap(Amx::kHeapSize);
+std::size_t Amx::heapTop { 0 };
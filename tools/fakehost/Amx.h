@@ -0,0 +1,75 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pawn/amx/amx.h>
+
+// Fake abstract machine: exports table that captures natives registered by
+// the plugin and lets the harness call them like a compiled script would.
+// Script has no publics, so plugin callbacks are never executed.
+class Amx {
+
+    Amx() = delete;
+    ~Amx() = delete;
+    Amx(const Amx&) = delete;
+    Amx(Amx&&) = delete;
+    Amx& operator=(const Amx&) = delete;
+    Amx& operator=(Amx&&) = delete;
+
+private:
+
+    static constexpr std::size_t kHeapSize = 64 * 1024;
+
+public:
+
+    // Passed to plugin as PLUGIN_DATA_AMX_EXPORTS
+    static void* GetExports() noexcept;
+    static AMX* GetInstance() noexcept;
+
+    static bool HasNative(const char* name) noexcept;
+
+    // Calls registered native, arguments are cells prepared with
+    // Amx::Float and Amx::String helpers or plain integers
+    static cell Call(const char* name, std::initializer_list<cell> args) noexcept;
+    static cell Call(const char* name, const std::vector<cell>& args) noexcept;
+
+    static cell Float(float value) noexcept;
+    static float ToFloat(cell value) noexcept;
+
+    // Copies string to machine's heap and returns its address,
+    // heap is released after every native call
+    static cell String(const char* string) noexcept;
+
+private:
+
+    static int AMXAPI Register(AMX* amx, const AMX_NATIVE_INFO* nativeList, int number) noexcept;
+    static int AMXAPI FindPublic(AMX* amx, const char* name, int* index) noexcept;
+    static int AMXAPI GetAddr(AMX* amx, cell amxAddr, cell** physAddr) noexcept;
+    static int AMXAPI StrLen(const cell* string, int* length) noexcept;
+    static int AMXAPI GetString(char* dest, const cell* source, int useWchar, size_t size) noexcept;
+    static int AMXAPI Unsupported() noexcept;
+
+private:
+
+    static AMX amx;
+    static void* exports[];
+
+    static std::unordered_map<std::string, AMX_NATIVE> natives;
+
+    static std::vector<cell> heap;
+    static std::size_t heapTop;
+
+};
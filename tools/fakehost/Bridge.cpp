@@ -0,0 +1,124 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Bridge.h"
+
+#include <cstring>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool Bridge::Init(const uint16_t port) noexcept
+{
+    if (Bridge::socketHandle != -1) return false;
+
+    if ((Bridge::socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) == -1)
+        return false;
+
+    sockaddr_in bindAddress {};
+
+    bindAddress.sin_family = AF_INET;
+    bindAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+    bindAddress.sin_port = htons(port);
+
+    if (bind(Bridge::socketHandle, reinterpret_cast<const sockaddr*>(&bindAddress), sizeof(bindAddress)) == -1)
+    {
+        close(Bridge::socketHandle);
+        Bridge::socketHandle = -1;
+        return false;
+    }
+
+    Bridge::playerAddresses.fill({});
+
+    return true;
+}
+
+void Bridge::Free() noexcept
+{
+    if (Bridge::socketHandle == -1) return;
+
+    close(Bridge::socketHandle);
+    Bridge::socketHandle = -1;
+}
+
+bool Bridge::IsActive() noexcept
+{
+    return Bridge::socketHandle != -1;
+}
+
+bool Bridge::Receive(uint8_t& type, uint16_t& playerId, uint32_t& address, std::vector<uint8_t>& data) noexcept
+{
+    if (Bridge::socketHandle == -1) return false;
+
+    uint8_t messageBuffer[StandIn::kMaxMessageSize];
+
+    while (true)
+    {
+        sockaddr_in senderAddress {};
+        socklen_t senderAddressLength { sizeof(senderAddress) };
+
+        const auto length = recvfrom(Bridge::socketHandle, messageBuffer, sizeof(messageBuffer), MSG_DONTWAIT,
+            reinterpret_cast<sockaddr*>(&senderAddress), &senderAddressLength);
+
+        if (length < 0) return false;
+        if (length < static_cast<ssize_t>(sizeof(StandIn::Message))) continue;
+
+        const auto& message = *reinterpret_cast<const StandIn::Message*>(messageBuffer);
+
+        if (message.signature != StandIn::kSignature || message.player >= kMaxPlayers)
+            continue;
+
+        if (message.type == StandIn::MessageType::connect)
+            Bridge::playerAddresses[message.player] = senderAddress;
+        else if (Bridge::playerAddresses[message.player].sin_port != senderAddress.sin_port ||
+            Bridge::playerAddresses[message.player].sin_addr.s_addr != senderAddress.sin_addr.s_addr)
+            continue;
+
+        if (message.type == StandIn::MessageType::disconnect)
+            Bridge::playerAddresses[message.player] = {};
+
+        type = message.type;
+        playerId = message.player;
+        address = senderAddress.sin_addr.s_addr;
+        data.assign(messageBuffer + sizeof(StandIn::Message), messageBuffer + length);
+
+        return true;
+    }
+}
+
+bool Bridge::Send(const uint16_t playerId, const uint8_t* const packetPtr, const uint32_t packetSize) noexcept
+{
+    if (!Bridge::HasPlayer(playerId)) return false;
+    if (sizeof(StandIn::Message) + packetSize > StandIn::kMaxMessageSize) return false;
+
+    uint8_t messageBuffer[StandIn::kMaxMessageSize];
+
+    auto& message = *reinterpret_cast<StandIn::Message*>(messageBuffer);
+
+    message.signature = StandIn::kSignature;
+    message.type = StandIn::MessageType::packet;
+    message.player = playerId;
+
+    std::memcpy(message.data, packetPtr, packetSize);
+
+    const auto messageSize = sizeof(StandIn::Message) + packetSize;
+
+    return sendto(Bridge::socketHandle, messageBuffer, messageSize, 0,
+        reinterpret_cast<const sockaddr*>(&Bridge::playerAddresses[playerId]),
+        sizeof(Bridge::playerAddresses[playerId])) == static_cast<ssize_t>(messageSize);
+}
+
+bool Bridge::HasPlayer(const uint16_t playerId) noexcept
+{
+    return Bridge::socketHandle != -1 && playerId < kMaxPlayers &&
+        Bridge::playerAddresses[playerId].sin_port != 0;
+}
+
+int Bridge::socketHandle { -1 };
+std::array<sockaddr_in, Bridge::kMaxPlayers> Bridge::playerAddresses {};
@@ -0,0 +1,55 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include <StandIn.h>
+
+// Host side of the RakNet stand-in: lets external loadgen processes
+// play SA-MP clients of the harness over udp
+class Bridge {
+
+    Bridge() = delete;
+    ~Bridge() = delete;
+    Bridge(const Bridge&) = delete;
+    Bridge(Bridge&&) = delete;
+    Bridge& operator=(const Bridge&) = delete;
+    Bridge& operator=(Bridge&&) = delete;
+
+private:
+
+    static constexpr uint16_t kMaxPlayers = 1000;
+
+public:
+
+    static bool Init(uint16_t port) noexcept;
+    static void Free() noexcept;
+
+    static bool IsActive() noexcept;
+
+    // Non-blocking, returns false when there are no more messages.
+    // 'address' is sender ipv4 address in network byte order.
+    static bool Receive(uint8_t& type, uint16_t& playerId, uint32_t& address, std::vector<uint8_t>& data) noexcept;
+
+    // Sends packet to stand-in peer which connected the player
+    static bool Send(uint16_t playerId, const uint8_t* packetPtr, uint32_t packetSize) noexcept;
+    static bool HasPlayer(uint16_t playerId) noexcept;
+
+private:
+
+    static int socketHandle;
+    static std::array<sockaddr_in, kMaxPlayers> playerAddresses;
+
+};
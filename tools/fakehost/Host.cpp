@@ -0,0 +1,95 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Host.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+#include <pawn/plugincommon.h>
+
+#include "Amx.h"
+#include "NetGame.h"
+
+PLUGIN_EXPORT bool PLUGIN_CALL Load(void** ppData) noexcept;
+PLUGIN_EXPORT void PLUGIN_CALL Unload() noexcept;
+PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX* amx) noexcept;
+PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX* amx) noexcept;
+PLUGIN_EXPORT void PLUGIN_CALL ProcessTick() noexcept;
+
+bool Host::Init(const bool verboseStatus) noexcept
+{
+    if (Host::initStatus) return false;
+
+    Host::verboseStatus = verboseStatus;
+
+    if (!NetGame::Init())
+    {
+        std::fprintf(stderr, "fakehost: failed to allocate net game\n");
+        return false;
+    }
+
+    Host::pluginData[PLUGIN_DATA_LOGPRINTF] = reinterpret_cast<void*>(&Host::Logprintf);
+    Host::pluginData[PLUGIN_DATA_AMX_EXPORTS] = Amx::GetExports();
+    Host::pluginData[PLUGIN_DATA_NETGAME] = reinterpret_cast<void*>(&NetGame::GetInstance);
+
+    if (!Load(Host::pluginData))
+    {
+        std::fprintf(stderr, "fakehost: plugin failed to load\n");
+        NetGame::Free();
+        return false;
+    }
+
+    AmxLoad(Amx::GetInstance());
+
+    Host::initStatus = true;
+
+    return true;
+}
+
+void Host::Free() noexcept
+{
+    if (!Host::initStatus) return;
+
+    AmxUnload(Amx::GetInstance());
+    Unload();
+
+    NetGame::Free();
+
+    Host::initStatus = false;
+}
+
+uint64_t Host::Tick() noexcept
+{
+    const auto beginTime = std::chrono::steady_clock::now();
+
+    ProcessTick();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - beginTime).count();
+}
+
+void Host::Logprintf(const char* const format, ...) noexcept
+{
+    if (!Host::verboseStatus) return;
+
+    va_list args;
+
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+
+    std::putchar('\n');
+}
+
+bool Host::initStatus { false };
+bool Host::verboseStatus { false };
+
+void* Host::pluginData[256] {};
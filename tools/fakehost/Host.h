@@ -0,0 +1,45 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// Plays the part of SA-MP server process: hands plugin the data table
+// with logprintf, amx exports and net game getter, loads it, registers
+// fake script and drives its tick the way server main loop does.
+class Host {
+
+    Host() = delete;
+    ~Host() = delete;
+    Host(const Host&) = delete;
+    Host(Host&&) = delete;
+    Host& operator=(const Host&) = delete;
+    Host& operator=(Host&&) = delete;
+
+public:
+
+    static bool Init(bool verboseStatus) noexcept;
+    static void Free() noexcept;
+
+    // Returns tick duration in nanoseconds
+    static uint64_t Tick() noexcept;
+
+private:
+
+    static void Logprintf(const char* format, ...) noexcept;
+
+private:
+
+    static bool initStatus;
+    static bool verboseStatus;
+
+    static void* pluginData[];
+
+};
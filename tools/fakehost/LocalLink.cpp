@@ -0,0 +1,96 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "LocalLink.h"
+
+#include <Link.h>
+
+// Link (client side)
+// --------------------------------------------------------------------
+
+bool Link::Init(const in_addr&, uint16_t) noexcept
+{
+    return true;
+}
+
+void Link::Free() noexcept
+{
+    LocalLink::hostQueue.clear();
+    LocalLink::clientQueue.clear();
+}
+
+bool Link::SendConnect(const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    return Link::Send(StandIn::MessageType::connect, playerId, dataPtr, dataSize);
+}
+
+bool Link::SendDisconnect(const uint16_t playerId) noexcept
+{
+    return Link::Send(StandIn::MessageType::disconnect, playerId, nullptr, 0);
+}
+
+bool Link::SendPacket(const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    return Link::Send(StandIn::MessageType::packet, playerId, dataPtr, dataSize);
+}
+
+bool Link::ReceivePacket(uint16_t& playerId, std::vector<uint8_t>& packet, uint32_t) noexcept
+{
+    if (LocalLink::clientQueue.empty()) return false;
+
+    auto& message = LocalLink::clientQueue.front();
+
+    playerId = message.playerId;
+    packet = std::move(message.data);
+
+    LocalLink::clientQueue.pop_front();
+
+    return true;
+}
+
+bool Link::Send(const uint8_t type, const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    LocalLink::Message message;
+
+    message.type = type;
+    message.playerId = playerId;
+    message.data.assign(static_cast<const uint8_t*>(dataPtr),
+        static_cast<const uint8_t*>(dataPtr) + dataSize);
+
+    LocalLink::hostQueue.emplace_back(std::move(message));
+
+    return true;
+}
+
+// LocalLink (host side)
+// --------------------------------------------------------------------
+
+bool LocalLink::PopMessage(Message& message) noexcept
+{
+    if (LocalLink::hostQueue.empty()) return false;
+
+    message = std::move(LocalLink::hostQueue.front());
+    LocalLink::hostQueue.pop_front();
+
+    return true;
+}
+
+void LocalLink::PushPacket(const uint16_t playerId, const uint8_t* const packetPtr, const uint32_t packetSize) noexcept
+{
+    Message message;
+
+    message.type = StandIn::MessageType::packet;
+    message.playerId = playerId;
+    message.data.assign(packetPtr, packetPtr + packetSize);
+
+    LocalLink::clientQueue.emplace_back(std::move(message));
+}
+
+std::deque<LocalLink::Message> LocalLink::hostQueue;
+std::deque<LocalLink::Message> LocalLink::clientQueue;
@@ -0,0 +1,50 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// In-process replacement of loadgen's stand-in Link: simulated players of
+// the harness talk to the host through two queues instead of a socket,
+// their voice traffic still goes over real loopback udp.
+class LocalLink {
+
+    LocalLink() = delete;
+    ~LocalLink() = delete;
+    LocalLink(const LocalLink&) = delete;
+    LocalLink(LocalLink&&) = delete;
+    LocalLink& operator=(const LocalLink&) = delete;
+    LocalLink& operator=(LocalLink&&) = delete;
+
+public:
+
+    struct Message {
+
+        uint8_t type { NULL }; // StandIn::MessageType
+        uint16_t playerId { NULL };
+        std::vector<uint8_t> data;
+
+    };
+
+public:
+
+    // Host side: messages sent by players and packets addressed to them
+    static bool PopMessage(Message& message) noexcept;
+    static void PushPacket(uint16_t playerId, const uint8_t* packetPtr, uint32_t packetSize) noexcept;
+
+public:
+
+    static std::deque<Message> hostQueue;
+    static std::deque<Message> clientQueue;
+
+};
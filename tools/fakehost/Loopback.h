@@ -0,0 +1,86 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <raknet/networktypes.h>
+#include <ysf/structs.h>
+
+// Host side of the loopback RakNet shim. The shim implements RakNet class of
+// the plugin without SA-MP server: connects, packets and disconnects are
+// injected by the harness on the main thread the same way server hooks would
+// deliver them, and everything the plugin sends is captured instead of being
+// transmitted.
+class Loopback {
+
+    Loopback() = delete;
+    ~Loopback() = delete;
+    Loopback(const Loopback&) = delete;
+    Loopback(Loopback&&) = delete;
+    Loopback& operator=(const Loopback&) = delete;
+    Loopback& operator=(Loopback&&) = delete;
+
+public:
+
+    static constexpr uint16_t kBroadcastId = 0xffff;
+
+    struct Capture {
+
+        uint16_t playerId { NULL };
+        bool rpcStatus { false };
+
+        // Packet id (or rpc id) followed by its payload
+        std::vector<uint8_t> data;
+
+    };
+
+public:
+
+    // 'joinData' is ClientJoin RPC payload carrying sampvoice connect struct,
+    // 'address' is ipv4 address in network byte order reported for the player
+    static bool Connect(uint16_t playerId, uint32_t address, const void* joinData, uint32_t joinSize) noexcept;
+    static bool Receive(uint16_t playerId, const void* packetData, uint32_t packetSize) noexcept;
+    static void Disconnect(uint16_t playerId) noexcept;
+
+    static bool IsPlayerConnected(uint16_t playerId) noexcept;
+
+    // When disabled captured messages are only counted, that keeps
+    // long benchmark runs from growing capture queue
+    static void SetCaptureStatus(bool status) noexcept;
+    static bool PopCapture(Capture& capture) noexcept;
+
+    static uint64_t GetCapturedCount() noexcept;
+
+public:
+
+    // Shim state, used by RakNet implementation only
+
+    static bool initStatus;
+
+    static std::vector<std::function<void(uint16_t, RPCParameters&)>> connectCallbacks;
+    static std::vector<std::function<bool(uint16_t, Packet&)>> packetCallbacks;
+    static std::vector<std::function<void(uint16_t)>> disconnectCallbacks;
+
+    static std::array<uint32_t, MAX_PLAYERS> playerAddresses;
+
+    static std::mutex sendMutex;
+    static std::vector<Capture> sendQueue;
+
+    static bool captureStatus;
+    static std::deque<Capture> captureQueue;
+    static uint64_t capturedCount;
+
+};
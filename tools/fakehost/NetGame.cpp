@@ -0,0 +1,255 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "NetGame.h"
+
+#include <cstdlib>
+
+bool NetGame::Init() noexcept
+{
+    if (NetGame::pNetGame != nullptr) return false;
+
+    NetGame::pNetGame = static_cast<CNetGame*>(std::calloc(1, sizeof(CNetGame)));
+    if (NetGame::pNetGame == nullptr) return false;
+
+    NetGame::pNetGame->pPlayerPool = static_cast<CPlayerPool*>(std::calloc(1, sizeof(CPlayerPool)));
+    NetGame::pNetGame->pVehiclePool = static_cast<CVehiclePool*>(std::calloc(1, sizeof(CVehiclePool)));
+    NetGame::pNetGame->pObjectPool = static_cast<CObjectPool*>(std::calloc(1, sizeof(CObjectPool)));
+
+    if (NetGame::pNetGame->pPlayerPool == nullptr ||
+        NetGame::pNetGame->pVehiclePool == nullptr ||
+        NetGame::pNetGame->pObjectPool == nullptr)
+    {
+        NetGame::Free();
+        return false;
+    }
+
+    return true;
+}
+
+void NetGame::Free() noexcept
+{
+    if (NetGame::pNetGame == nullptr) return;
+
+    if (const auto pPlayerPool = NetGame::pNetGame->pPlayerPool; pPlayerPool != nullptr)
+    {
+        for (const auto pPlayer : pPlayerPool->pPlayer) std::free(pPlayer);
+        std::free(pPlayerPool);
+    }
+
+    if (const auto pVehiclePool = NetGame::pNetGame->pVehiclePool; pVehiclePool != nullptr)
+    {
+        for (const auto pVehicle : pVehiclePool->pVehicle) std::free(pVehicle);
+        std::free(pVehiclePool);
+    }
+
+    if (const auto pObjectPool = NetGame::pNetGame->pObjectPool; pObjectPool != nullptr)
+    {
+        for (const auto pObject : pObjectPool->pObjects) std::free(pObject);
+        std::free(pObjectPool);
+    }
+
+    std::free(NetGame::pNetGame);
+    NetGame::pNetGame = nullptr;
+}
+
+CNetGame* NetGame::GetInstance() noexcept
+{
+    return NetGame::pNetGame;
+}
+
+bool NetGame::ConnectPlayer(const uint16_t playerId) noexcept
+{
+    if (NetGame::pNetGame == nullptr || playerId >= MAX_PLAYERS) return false;
+
+    const auto pPlayerPool = NetGame::pNetGame->pPlayerPool;
+
+    if (pPlayerPool->pPlayer[playerId] == nullptr &&
+        (pPlayerPool->pPlayer[playerId] = static_cast<CPlayer*>(std::calloc(1, sizeof(CPlayer)))) == nullptr)
+        return false;
+
+    if (!pPlayerPool->bIsPlayerConnected[playerId])
+    {
+        pPlayerPool->bIsPlayerConnected[playerId] = true;
+        ++pPlayerPool->dwConnectedPlayers;
+    }
+
+    NetGame::UpdatePoolSize();
+
+    return true;
+}
+
+void NetGame::DisconnectPlayer(const uint16_t playerId) noexcept
+{
+    if (!NetGame::IsPlayerConnected(playerId)) return;
+
+    const auto pPlayerPool = NetGame::pNetGame->pPlayerPool;
+
+    std::free(pPlayerPool->pPlayer[playerId]);
+    pPlayerPool->pPlayer[playerId] = nullptr;
+
+    pPlayerPool->bIsPlayerConnected[playerId] = false;
+    --pPlayerPool->dwConnectedPlayers;
+
+    for (const auto pPlayer : pPlayerPool->pPlayer)
+    {
+        if (pPlayer != nullptr) pPlayer->byteStreamedIn[playerId] = false;
+    }
+
+    NetGame::UpdatePoolSize();
+}
+
+bool NetGame::IsPlayerConnected(const uint16_t playerId) noexcept
+{
+    return NetGame::pNetGame != nullptr && playerId < MAX_PLAYERS &&
+        NetGame::pNetGame->pPlayerPool->bIsPlayerConnected[playerId];
+}
+
+bool NetGame::SetPlayerPosition(const uint16_t playerId, const CVector& position) noexcept
+{
+    if (!NetGame::IsPlayerConnected(playerId)) return false;
+
+    NetGame::pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition = position;
+
+    return true;
+}
+
+bool NetGame::GetPlayerPosition(const uint16_t playerId, CVector& position) noexcept
+{
+    if (!NetGame::IsPlayerConnected(playerId)) return false;
+
+    position = NetGame::pNetGame->pPlayerPool->pPlayer[playerId]->vecPosition;
+
+    return true;
+}
+
+bool NetGame::CreateVehicle(const uint16_t vehicleId, const CVector& position) noexcept
+{
+    if (NetGame::pNetGame == nullptr || vehicleId >= MAX_VEHICLES) return false;
+
+    auto& pVehicle = NetGame::pNetGame->pVehiclePool->pVehicle[vehicleId];
+
+    if (pVehicle == nullptr && (pVehicle = static_cast<CVehicle*>(std::calloc(1, sizeof(CVehicle)))) == nullptr)
+        return false;
+
+    pVehicle->vecPosition = position;
+
+    return true;
+}
+
+void NetGame::DestroyVehicle(const uint16_t vehicleId) noexcept
+{
+    if (NetGame::pNetGame == nullptr || vehicleId >= MAX_VEHICLES) return;
+
+    std::free(NetGame::pNetGame->pVehiclePool->pVehicle[vehicleId]);
+    NetGame::pNetGame->pVehiclePool->pVehicle[vehicleId] = nullptr;
+
+    for (const auto pPlayer : NetGame::pNetGame->pPlayerPool->pPlayer)
+    {
+        if (pPlayer != nullptr) pPlayer->byteVehicleStreamedIn[vehicleId] = false;
+    }
+}
+
+bool NetGame::SetVehiclePosition(const uint16_t vehicleId, const CVector& position) noexcept
+{
+    if (NetGame::pNetGame == nullptr || vehicleId >= MAX_VEHICLES) return false;
+
+    const auto pVehicle = NetGame::pNetGame->pVehiclePool->pVehicle[vehicleId];
+    if (pVehicle == nullptr) return false;
+
+    pVehicle->vecPosition = position;
+
+    return true;
+}
+
+bool NetGame::CreateObject(const uint16_t objectId, const CVector& position) noexcept
+{
+    if (NetGame::pNetGame == nullptr || objectId >= MAX_OBJECTS) return false;
+
+    auto& pObject = NetGame::pNetGame->pObjectPool->pObjects[objectId];
+
+    if (pObject == nullptr && (pObject = static_cast<CObject*>(std::calloc(1, sizeof(CObject)))) == nullptr)
+        return false;
+
+    pObject->matWorld.pos = position;
+
+    return true;
+}
+
+void NetGame::DestroyObject(const uint16_t objectId) noexcept
+{
+    if (NetGame::pNetGame == nullptr || objectId >= MAX_OBJECTS) return;
+
+    std::free(NetGame::pNetGame->pObjectPool->pObjects[objectId]);
+    NetGame::pNetGame->pObjectPool->pObjects[objectId] = nullptr;
+}
+
+bool NetGame::SetObjectPosition(const uint16_t objectId, const CVector& position) noexcept
+{
+    if (NetGame::pNetGame == nullptr || objectId >= MAX_OBJECTS) return false;
+
+    const auto pObject = NetGame::pNetGame->pObjectPool->pObjects[objectId];
+    if (pObject == nullptr) return false;
+
+    pObject->matWorld.pos = position;
+
+    return true;
+}
+
+void NetGame::UpdateStreaming(const float distance) noexcept
+{
+    if (NetGame::pNetGame == nullptr) return;
+
+    const auto pPlayerPool = NetGame::pNetGame->pPlayerPool;
+    const auto pVehiclePool = NetGame::pNetGame->pVehiclePool;
+
+    if (pPlayerPool->dwConnectedPlayers == 0) return;
+
+    const auto playerPoolSize = pPlayerPool->dwPlayerPoolSize;
+
+    for (uint16_t iPlayerId { 0 }; iPlayerId <= playerPoolSize; ++iPlayerId)
+    {
+        const auto ipPlayer = pPlayerPool->pPlayer[iPlayerId];
+        if (ipPlayer == nullptr) continue;
+
+        for (uint16_t jPlayerId { 0 }; jPlayerId <= playerPoolSize; ++jPlayerId)
+        {
+            const auto jpPlayer = pPlayerPool->pPlayer[jPlayerId];
+
+            ipPlayer->byteStreamedIn[jPlayerId] = jpPlayer != nullptr && jPlayerId != iPlayerId &&
+                (jpPlayer->vecPosition - ipPlayer->vecPosition).Length() <= distance;
+        }
+
+        for (uint16_t vehicleId { 0 }; vehicleId < MAX_VEHICLES; ++vehicleId)
+        {
+            const auto pVehicle = pVehiclePool->pVehicle[vehicleId];
+
+            ipPlayer->byteVehicleStreamedIn[vehicleId] = pVehicle != nullptr &&
+                (pVehicle->vecPosition - ipPlayer->vecPosition).Length() <= distance;
+        }
+    }
+}
+
+void NetGame::UpdatePoolSize() noexcept
+{
+    const auto pPlayerPool = NetGame::pNetGame->pPlayerPool;
+
+    pPlayerPool->dwPlayerPoolSize = 0;
+
+    for (uint16_t playerId { MAX_PLAYERS }; playerId-- != 0;)
+    {
+        if (pPlayerPool->bIsPlayerConnected[playerId])
+        {
+            pPlayerPool->dwPlayerPoolSize = playerId;
+            break;
+        }
+    }
+}
+
+CNetGame* NetGame::pNetGame { nullptr };
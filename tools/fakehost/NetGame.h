@@ -0,0 +1,63 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <ysf/structs.h>
+
+// Mock of SA-MP server game state read by the plugin: player, vehicle and
+// object pools with positions set by the harness script. Pools are allocated
+// zeroed as the server does, only fields that plugin reads are maintained.
+class NetGame {
+
+    NetGame() = delete;
+    ~NetGame() = delete;
+    NetGame(const NetGame&) = delete;
+    NetGame(NetGame&&) = delete;
+    NetGame& operator=(const NetGame&) = delete;
+    NetGame& operator=(NetGame&&) = delete;
+
+public:
+
+    static bool Init() noexcept;
+    static void Free() noexcept;
+
+    // Passed to plugin as PLUGIN_DATA_NETGAME
+    static CNetGame* GetInstance() noexcept;
+
+    static bool ConnectPlayer(uint16_t playerId) noexcept;
+    static void DisconnectPlayer(uint16_t playerId) noexcept;
+    static bool IsPlayerConnected(uint16_t playerId) noexcept;
+    static bool SetPlayerPosition(uint16_t playerId, const CVector& position) noexcept;
+    static bool GetPlayerPosition(uint16_t playerId, CVector& position) noexcept;
+
+    static bool CreateVehicle(uint16_t vehicleId, const CVector& position) noexcept;
+    static void DestroyVehicle(uint16_t vehicleId) noexcept;
+    static bool SetVehiclePosition(uint16_t vehicleId, const CVector& position) noexcept;
+
+    static bool CreateObject(uint16_t objectId, const CVector& position) noexcept;
+    static void DestroyObject(uint16_t objectId) noexcept;
+    static bool SetObjectPosition(uint16_t objectId, const CVector& position) noexcept;
+
+    // Marks players and vehicles within 'distance' of every connected
+    // player as streamed in for him, as server's streamer would do
+    static void UpdateStreaming(float distance) noexcept;
+
+private:
+
+    static void UpdatePoolSize() noexcept;
+
+private:
+
+    static CNetGame* pNetGame;
+
+};
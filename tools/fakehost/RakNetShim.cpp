@@ -0,0 +1,283 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <util/raknet.h>
+
+#include <cstring>
+
+#include "Loopback.h"
+
+// RakNet
+// --------------------------------------------------------------------
+
+bool RakNet::Init(const void*) noexcept
+{
+    if (Loopback::initStatus) return false;
+
+    Loopback::playerAddresses.fill(NULL);
+    Loopback::initStatus = true;
+
+    return true;
+}
+
+void RakNet::Free() noexcept
+{
+    if (!Loopback::initStatus) return;
+
+    Loopback::connectCallbacks.clear();
+    Loopback::packetCallbacks.clear();
+    Loopback::disconnectCallbacks.clear();
+
+    Loopback::initStatus = false;
+}
+
+bool RakNet::IsLoaded() noexcept
+{
+    return Loopback::initStatus;
+}
+
+std::size_t RakNet::Process() noexcept
+{
+    std::vector<Loopback::Capture> sendQueue;
+
+    {
+        const std::lock_guard<std::mutex> lock { Loopback::sendMutex };
+        sendQueue.swap(Loopback::sendQueue);
+    }
+
+    Loopback::capturedCount += sendQueue.size();
+
+    if (Loopback::captureStatus)
+    {
+        for (auto& capture : sendQueue)
+            Loopback::captureQueue.emplace_back(std::move(capture));
+    }
+
+    return sendQueue.size();
+}
+
+namespace
+{
+    bool Enqueue(const uint16_t playerId, const bool rpcStatus, const uint8_t id,
+                 const void* const dataPtr, const int dataSize)
+    {
+        if (!Loopback::initStatus || dataSize < 0) return false;
+        if (playerId != Loopback::kBroadcastId && playerId >= MAX_PLAYERS) return false;
+
+        Loopback::Capture capture;
+
+        capture.playerId = playerId;
+        capture.rpcStatus = rpcStatus;
+        capture.data.resize(sizeof(id) + dataSize);
+        capture.data[0] = id;
+
+        if (dataSize != 0) std::memcpy(capture.data.data() + sizeof(id), dataPtr, dataSize);
+
+        const std::lock_guard<std::mutex> lock { Loopback::sendMutex };
+        Loopback::sendQueue.emplace_back(std::move(capture));
+
+        return true;
+    }
+}
+
+bool RakNet::SendRPC(const uint8_t rpcId, const uint16_t playerId, const void* const dataPtr, const int dataSize)
+{
+    return Enqueue(playerId, true, rpcId, dataPtr, dataSize);
+}
+
+bool RakNet::SendPacket(const uint8_t packetId, const uint16_t playerId, const void* const dataPtr, const int dataSize)
+{
+    return Enqueue(playerId, false, packetId, dataPtr, dataSize);
+}
+
+bool RakNet::KickPlayer(const uint16_t playerId) noexcept
+{
+    if (!Loopback::IsPlayerConnected(playerId)) return false;
+
+    Loopback::Disconnect(playerId);
+
+    return true;
+}
+
+namespace
+{
+    template <class CallbackType>
+    std::size_t AddCallback(std::vector<CallbackType>& callbacks, CallbackType callback)
+    {
+        if (!Loopback::initStatus) return -1;
+
+        for (std::size_t i { 0 }; i < callbacks.size(); ++i)
+        {
+            if (callbacks[i] == nullptr)
+            {
+                callbacks[i] = std::move(callback);
+                return i;
+            }
+        }
+
+        callbacks.emplace_back(std::move(callback));
+        return callbacks.size() - 1;
+    }
+
+    template <class CallbackType>
+    void RemoveCallback(std::vector<CallbackType>& callbacks, const std::size_t callback)
+    {
+        if (!Loopback::initStatus || callback >= callbacks.size()) return;
+
+        callbacks[callback] = nullptr;
+    }
+}
+
+std::size_t RakNet::AddConnectCallback(ConnectCallback callback) noexcept
+{
+    return AddCallback(Loopback::connectCallbacks, decltype(Loopback::connectCallbacks)::value_type(std::move(callback)));
+}
+
+std::size_t RakNet::AddPacketCallback(PacketCallback callback) noexcept
+{
+    return AddCallback(Loopback::packetCallbacks, decltype(Loopback::packetCallbacks)::value_type(std::move(callback)));
+}
+
+std::size_t RakNet::AddDisconnectCallback(DisconnectCallback callback) noexcept
+{
+    return AddCallback(Loopback::disconnectCallbacks, decltype(Loopback::disconnectCallbacks)::value_type(std::move(callback)));
+}
+
+void RakNet::RemoveConnectCallback(const std::size_t callback) noexcept
+{
+    RemoveCallback(Loopback::connectCallbacks, callback);
+}
+
+void RakNet::RemovePacketCallback(const std::size_t callback) noexcept
+{
+    RemoveCallback(Loopback::packetCallbacks, callback);
+}
+
+void RakNet::RemoveDisconnectCallback(const std::size_t callback) noexcept
+{
+    RemoveCallback(Loopback::disconnectCallbacks, callback);
+}
+
+PlayerID RakNet::GetPlayerIdFromIndex(const int32_t index) noexcept
+{
+    if (index < 0 || index >= MAX_PLAYERS || Loopback::playerAddresses[index] == NULL)
+        return UNASSIGNED_PLAYER_ID;
+
+    return { Loopback::playerAddresses[index], static_cast<unsigned short>(index) };
+}
+
+// Loopback
+// --------------------------------------------------------------------
+
+bool Loopback::Connect(const uint16_t playerId, const uint32_t address,
+                       const void* const joinData, const uint32_t joinSize) noexcept
+{
+    if (!Loopback::initStatus || playerId >= MAX_PLAYERS || address == NULL)
+        return false;
+
+    if (Loopback::playerAddresses[playerId] != NULL)
+        Loopback::Disconnect(playerId);
+
+    Loopback::playerAddresses[playerId] = address;
+
+    std::vector<uint8_t> joinBuffer(static_cast<const uint8_t*>(joinData),
+        static_cast<const uint8_t*>(joinData) + joinSize);
+
+    RPCParameters parameters {};
+
+    parameters.input = joinBuffer.data();
+    parameters.numberOfBitsOfData = BYTES_TO_BITS(joinSize);
+    parameters.sender = RakNet::GetPlayerIdFromIndex(playerId);
+
+    for (const auto& connectCallback : Loopback::connectCallbacks)
+    {
+        if (connectCallback != nullptr) connectCallback(playerId, parameters);
+    }
+
+    return true;
+}
+
+bool Loopback::Receive(const uint16_t playerId, const void* const packetData, const uint32_t packetSize) noexcept
+{
+    if (!Loopback::IsPlayerConnected(playerId) || packetSize == 0)
+        return false;
+
+    std::vector<uint8_t> packetBuffer(static_cast<const uint8_t*>(packetData),
+        static_cast<const uint8_t*>(packetData) + packetSize);
+
+    Packet packet {};
+
+    packet.playerIndex = playerId;
+    packet.playerId = RakNet::GetPlayerIdFromIndex(playerId);
+    packet.length = packetSize;
+    packet.bitSize = BYTES_TO_BITS(packetSize);
+    packet.data = packetBuffer.data();
+
+    // As in receive hook, packet handled by any callback is not passed further
+    for (const auto& packetCallback : Loopback::packetCallbacks)
+    {
+        if (packetCallback != nullptr && !packetCallback(playerId, packet))
+            return true;
+    }
+
+    return true;
+}
+
+void Loopback::Disconnect(const uint16_t playerId) noexcept
+{
+    if (!Loopback::IsPlayerConnected(playerId)) return;
+
+    for (const auto& disconnectCallback : Loopback::disconnectCallbacks)
+    {
+        if (disconnectCallback != nullptr) disconnectCallback(playerId);
+    }
+
+    Loopback::playerAddresses[playerId] = NULL;
+}
+
+bool Loopback::IsPlayerConnected(const uint16_t playerId) noexcept
+{
+    return Loopback::initStatus && playerId < MAX_PLAYERS && Loopback::playerAddresses[playerId] != NULL;
+}
+
+void Loopback::SetCaptureStatus(const bool status) noexcept
+{
+    Loopback::captureStatus = status;
+    if (!status) Loopback::captureQueue.clear();
+}
+
+bool Loopback::PopCapture(Capture& capture) noexcept
+{
+    if (Loopback::captureQueue.empty()) return false;
+
+    capture = std::move(Loopback::captureQueue.front());
+    Loopback::captureQueue.pop_front();
+
+    return true;
+}
+
+uint64_t Loopback::GetCapturedCount() noexcept
+{
+    return Loopback::capturedCount;
+}
+
+bool Loopback::initStatus { false };
+
+std::vector<std::function<void(uint16_t, RPCParameters&)>> Loopback::connectCallbacks;
+std::vector<std::function<bool(uint16_t, Packet&)>> Loopback::packetCallbacks;
+std::vector<std::function<void(uint16_t)>> Loopback::disconnectCallbacks;
+
+std::array<uint32_t, MAX_PLAYERS> Loopback::playerAddresses {};
+
+std::mutex Loopback::sendMutex;
+std::vector<Loopback::Capture> Loopback::sendQueue;
+
+bool Loopback::captureStatus { true };
+std::deque<Loopback::Capture> Loopback::captureQueue;
+uint64_t Loopback::capturedCount { 0 };
@@ -0,0 +1,161 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Replay.h"
+
+#include <cstring>
+
+#include <Capture.h>
+
+#include "Amx.h"
+
+bool Replay::Open(const std::string& captureFile) noexcept
+{
+    Replay::captureFile = std::fopen(captureFile.c_str(), "rb");
+    if (Replay::captureFile == nullptr) return false;
+
+    Capture::FileHeader fileHeader {};
+
+    if (std::fread(&fileHeader, sizeof(fileHeader), 1, Replay::captureFile) != 1 ||
+        fileHeader.signature != Capture::kSignature || fileHeader.version != Capture::kVersion)
+    {
+        std::fclose(Replay::captureFile);
+        Replay::captureFile = nullptr;
+        return false;
+    }
+
+    Replay::captureTime = 0;
+    Replay::skippedNatives = 0;
+    Replay::handleTable.clear();
+
+    return true;
+}
+
+void Replay::Close() noexcept
+{
+    if (Replay::captureFile == nullptr) return;
+
+    std::fclose(Replay::captureFile);
+    Replay::captureFile = nullptr;
+}
+
+bool Replay::Read(Record& record) noexcept
+{
+    if (Replay::captureFile == nullptr) return false;
+
+    Capture::RecordHeader recordHeader {};
+
+    if (std::fread(&recordHeader, sizeof(recordHeader), 1, Replay::captureFile) != 1)
+        return false;
+
+    Replay::captureTime += recordHeader.deltaTime;
+
+    record.type = recordHeader.type;
+    record.id = recordHeader.id;
+    record.time = Replay::captureTime;
+    record.data.resize(recordHeader.length);
+
+    // Capture cut off in the middle of record ends the replay
+    return recordHeader.length == 0 || std::fread(record.data.data(),
+        recordHeader.length, 1, Replay::captureFile) == 1;
+}
+
+bool Replay::CallNative(const std::vector<uint8_t>& data) noexcept
+{
+    std::size_t offset { 0 };
+
+    const auto readBytes = [&](void* const bytes, const std::size_t size) noexcept -> bool
+    {
+        if (offset + size > data.size()) return false;
+        std::memcpy(bytes, data.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    uint8_t nameLength { 0 };
+    if (!readBytes(&nameLength, sizeof(nameLength))) return false;
+
+    std::string name(nameLength, '\0');
+    if (!readBytes(&name[0], nameLength)) return false;
+
+    uint8_t resultType { 0 }; uint32_t resultValue { 0 };
+    if (!readBytes(&resultType, sizeof(resultType)) || !readBytes(&resultValue, sizeof(resultValue)))
+        return false;
+
+    uint8_t argsCount { 0 };
+    if (!readBytes(&argsCount, sizeof(argsCount))) return false;
+
+    // Strings are copied to machine's heap right before the call
+    std::vector<cell> args(argsCount);
+    std::vector<std::pair<std::size_t, std::string>> strings;
+    uint32_t firstHandle { NULL };
+
+    for (std::size_t i { 0 }; i < argsCount; ++i)
+    {
+        uint8_t argType { 0 };
+        if (!readBytes(&argType, sizeof(argType))) return false;
+
+        if (argType == Capture::ArgType::string)
+        {
+            uint16_t stringLength { 0 };
+            if (!readBytes(&stringLength, sizeof(stringLength))) return false;
+
+            std::string string(stringLength, '\0');
+            if (stringLength != 0 && !readBytes(&string[0], stringLength)) return false;
+
+            strings.emplace_back(i, std::move(string));
+            continue;
+        }
+
+        uint32_t argValue { 0 };
+        if (!readBytes(&argValue, sizeof(argValue))) return false;
+
+        if (argType == Capture::ArgType::handle)
+        {
+            const auto iHandle = Replay::handleTable.find(argValue);
+
+            if (iHandle == Replay::handleTable.end())
+            {
+                ++Replay::skippedNatives;
+                return false;
+            }
+
+            if (i == 0) firstHandle = argValue;
+            args[i] = iHandle->second;
+        }
+        else
+        {
+            args[i] = static_cast<cell>(argValue);
+        }
+    }
+
+    for (const auto& string : strings)
+        args[string.first] = Amx::String(string.second.c_str());
+
+    const auto result = Amx::Call(name.c_str(), args);
+
+    if (resultType == Capture::ArgType::handle && resultValue != NULL && result != NULL)
+        Replay::handleTable[resultValue] = result;
+
+    if (name == "SvDeleteStream" || name == "SvEffectDelete" || name == "SvSourceDelete" || name == "SvGroupDelete")
+        Replay::handleTable.erase(firstHandle);
+
+    return true;
+}
+
+uint64_t Replay::GetSkippedNatives() noexcept
+{
+    return Replay::skippedNatives;
+}
+
+std::FILE* Replay::captureFile { nullptr };
+uint64_t Replay::captureTime { 0 };
+uint64_t Replay::skippedNatives { 0 };
+
+std::unordered_map<uint32_t, cell> Replay::handleTable;
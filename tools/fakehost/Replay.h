@@ -0,0 +1,63 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pawn/amx/amx.h>
+
+// Reader of capture files written by the plugin (see server/Capture.h).
+// Script calls are replayed through fake machine with stream and effect
+// handles of the capture translated to the ones of the running plugin.
+class Replay {
+
+    Replay() = delete;
+    ~Replay() = delete;
+    Replay(const Replay&) = delete;
+    Replay(Replay&&) = delete;
+    Replay& operator=(const Replay&) = delete;
+    Replay& operator=(Replay&&) = delete;
+
+public:
+
+    struct Record
+    {
+        uint8_t type;
+        uint16_t id;
+        uint64_t time; // microseconds from capture start
+        std::vector<uint8_t> data;
+    };
+
+public:
+
+    static bool Open(const std::string& captureFile) noexcept;
+    static void Close() noexcept;
+
+    static bool Read(Record& record) noexcept;
+
+    // Returns false if the call was skipped because it refers to
+    // a handle created before the capture had been started
+    static bool CallNative(const std::vector<uint8_t>& data) noexcept;
+
+    static uint64_t GetSkippedNatives() noexcept;
+
+private:
+
+    static std::FILE* captureFile;
+    static uint64_t captureTime;
+    static uint64_t skippedNatives;
+
+    static std::unordered_map<uint32_t, cell> handleTable;
+
+};
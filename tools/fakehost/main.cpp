@@ -0,0 +1,889 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/resource.h>
+
+#include <Capture.h>
+#include <ControlPacket.h>
+#include <Header.h>
+#include <Histogram.h>
+#include <Latency.h>
+#include <Link.h>
+#include <Metrics.h>
+#include <Player.h>
+
+#include "Amx.h"
+#include "Bridge.h"
+#include "Host.h"
+#include "LocalLink.h"
+#include "Loopback.h"
+#include "NetGame.h"
+#include "Replay.h"
+
+namespace
+{
+    constexpr uint8_t kRaknetPacketId = 222;
+    constexpr uint32_t kVoiceInterval = 100;
+    constexpr uint32_t kKeepAliveInterval = 5000;
+    constexpr uint32_t kStreamingInterval = 1000;
+    constexpr uint32_t kReplayTailInterval = 1000;
+    constexpr float kStreamingDistance = 300.f;
+    constexpr uint32_t kStreamColor = 0xff00ff00;
+    constexpr uint8_t kActivationKey = 0x42;
+    constexpr uint32_t kTrunkKey = 1;
+    constexpr uint32_t kTrunkChannel = 1;
+    constexpr uint32_t kTrunkFlushInterval = 5;
+
+    struct StreamType
+    {
+        enum : uint8_t
+        {
+            global,
+            staticAtPlayer,
+            dynamicAtPlayer,
+            dynamicAtVehicle,
+            dynamicAtObject
+        };
+    };
+
+    struct Options
+    {
+        uint32_t players { 100 };
+        uint32_t speakers { 10 };
+        uint8_t streamType { StreamType::global };
+        float distance { 50.f };
+        uint32_t maxListeners { 100 };
+        float area { 500.f };
+        float speed { 5.f };
+        uint32_t ticks { 10000 };
+        bool ticksStatus { false };
+        uint32_t tickRate { 200 };
+        uint32_t bitrate { 24000 };
+        uint32_t seed { 1 };
+        uint16_t bridgePort { 0 };
+        bool auth { false };
+        bool compact { false };
+        bool simulcast { false };
+        uint16_t trunkPort { 0 };
+        uint16_t trunkPeerPort { 0 };
+        bool trunkExport { false };
+        bool trunkImport { false };
+        bool verbose { false };
+        std::string jsonFile;
+        std::string replayFile;
+        std::string captureFile;
+    };
+
+    struct Walker
+    {
+        CVector position;
+        CVector velocity;
+    };
+
+    std::atomic_bool runStatus { true };
+
+    Options options;
+    std::mt19937 genRandom;
+
+    std::vector<std::unique_ptr<Player>> players;
+    std::vector<std::unique_ptr<Player>> retiredPlayers;
+    std::array<Walker, MAX_PLAYERS> walkers {};
+    std::array<bool, MAX_PLAYERS> initStatus {};
+    std::array<cell, MAX_PLAYERS> speakerStreams {};
+    cell globalStream { NULL };
+
+    std::array<uint64_t, 256> controlCounts {};
+    uint64_t initCount { 0 };
+
+    void Usage(const char* const program) noexcept
+    {
+        std::printf(
+            "usage: %s [options]\n"
+            "  --players <n>        in-process simulated players (default 100)\n"
+            "  --speakers <n>       players that talk, taken from the first ids (default 10)\n"
+            "  --stream <type>      global, slp (static at player), dlp (dynamic at player),\n"
+            "                       dlv (dynamic at vehicle), dlo (dynamic at object) (default global)\n"
+            "  --distance <m>       local stream distance (default 50)\n"
+            "  --max-listeners <n>  dynamic stream listeners limit (default 100)\n"
+            "  --area <m>           side of the square players walk in (default 500)\n"
+            "  --speed <m/s>        players walking speed (default 5)\n"
+            "  --ticks <n>          server ticks to run (default 10000)\n"
+            "  --tick-rate <hz>     ticks per second, 0 runs unthrottled (default 200)\n"
+            "  --bitrate <bps>      opus bitrate that sets voice payload size (default 24000)\n"
+            "  --seed <n>           random seed of player placement and walking (default 1)\n"
+            "  --bridge <port>      also accept loadgen players over raknet stand-in\n"
+            "  --auth               negotiate voice packet authentication\n"
+            "  --compact            negotiate compact voice packet header\n"
+            "  --simulcast          send low voice layer along with the main one\n"
+            "  --trunk-port <port>  open federation trunk on the port\n"
+            "  --trunk-peer <port>  add peer server trunk on the loopback port\n"
+            "  --trunk-export       export global stream to the peer\n"
+            "  --trunk-import       import global stream from the peer\n"
+            "  --verbose            print plugin log to console\n"
+            "  --json <file>        write results as json\n"
+            "  --replay <file>      replay plugin capture (SvCaptureStart) instead of simulated\n"
+            "                       players, in real time or at max speed with --tick-rate 0,\n"
+            "                       runs until capture ends unless --ticks is given\n"
+            "  --capture <file>     record the run with plugin capture\n",
+            program);
+    }
+
+    bool ParseOptions(const int argc, char** const argv) noexcept
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option { argv[i] };
+            const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (option == "--auth") { options.auth = true; continue; }
+            if (option == "--compact") { options.compact = true; continue; }
+            if (option == "--simulcast") { options.simulcast = true; continue; }
+            if (option == "--trunk-export") { options.trunkExport = true; continue; }
+            if (option == "--trunk-import") { options.trunkImport = true; continue; }
+            if (option == "--verbose") { options.verbose = true; continue; }
+            if (value == nullptr) return false;
+
+            if (option == "--players") options.players = std::atoi(value);
+            else if (option == "--speakers") options.speakers = std::atoi(value);
+            else if (option == "--stream")
+            {
+                const std::string type { value };
+
+                if (type == "global") options.streamType = StreamType::global;
+                else if (type == "slp") options.streamType = StreamType::staticAtPlayer;
+                else if (type == "dlp") options.streamType = StreamType::dynamicAtPlayer;
+                else if (type == "dlv") options.streamType = StreamType::dynamicAtVehicle;
+                else if (type == "dlo") options.streamType = StreamType::dynamicAtObject;
+                else return false;
+            }
+            else if (option == "--distance") options.distance = std::atof(value);
+            else if (option == "--max-listeners") options.maxListeners = std::atoi(value);
+            else if (option == "--area") options.area = std::atof(value);
+            else if (option == "--speed") options.speed = std::atof(value);
+            else if (option == "--ticks")
+            {
+                options.ticks = std::atoi(value);
+                options.ticksStatus = true;
+            }
+            else if (option == "--tick-rate") options.tickRate = std::atoi(value);
+            else if (option == "--bitrate") options.bitrate = std::atoi(value);
+            else if (option == "--seed") options.seed = std::atoi(value);
+            else if (option == "--bridge") options.bridgePort = static_cast<uint16_t>(std::atoi(value));
+            else if (option == "--trunk-port") options.trunkPort = static_cast<uint16_t>(std::atoi(value));
+            else if (option == "--trunk-peer") options.trunkPeerPort = static_cast<uint16_t>(std::atoi(value));
+            else if (option == "--json") options.jsonFile = value;
+            else if (option == "--replay") options.replayFile = value;
+            else if (option == "--capture") options.captureFile = value;
+            else return false;
+
+            ++i;
+        }
+
+        // Replayed players come and go as recorded
+        if (!options.replayFile.empty()) options.players = 0;
+        if (!options.replayFile.empty() && !options.ticksStatus) options.ticks = UINT32_MAX;
+
+        options.speakers = std::min(options.speakers, options.players);
+
+        // Trunk carries the global stream
+        if ((options.trunkExport || options.trunkImport) && (options.trunkPort == 0 ||
+            options.trunkPeerPort == 0 || options.streamType != StreamType::global ||
+            !options.replayFile.empty())) return false;
+
+        return options.players <= MAX_PLAYERS && options.ticks != 0 &&
+            (options.players != 0 || options.bridgePort != 0 || !options.replayFile.empty());
+    }
+
+    CVector RandomPosition() noexcept
+    {
+        std::uniform_real_distribution<float> genCoord { 0.f, options.area };
+        return { genCoord(genRandom), genCoord(genRandom), 10.f };
+    }
+
+    CVector RandomVelocity() noexcept
+    {
+        std::uniform_real_distribution<float> genAngle { 0.f, 6.2831853f };
+        const auto angle = genAngle(genRandom);
+        return { options.speed * std::cos(angle), options.speed * std::sin(angle), 0.f };
+    }
+
+    // Script
+    // --------------------------------------------------------------------
+
+    // Called when plugin sent 'pluginInit' to the player, that is
+    // where gamemodes usually set up player's streams
+    void OnPlayerInit(const uint16_t playerId) noexcept
+    {
+        if (playerId >= MAX_PLAYERS || initStatus[playerId]) return;
+
+        initStatus[playerId] = true;
+        ++initCount;
+
+        // Replayed capture carries the calls of real gamemode
+        if (!options.replayFile.empty()) return;
+
+        const bool speakerStatus = Amx::Call("SvHasMicro", { playerId }) != NULL;
+
+        // Voice is forwarded only for players with an activation key
+        if (speakerStatus) Amx::Call("SvAddKey", { playerId, kActivationKey });
+
+        switch (options.streamType)
+        {
+            case StreamType::global:
+            {
+                Amx::Call("SvAttachListenerToStream", { globalStream, playerId });
+                if (speakerStatus) Amx::Call("SvAttachSpeakerToStream", { globalStream, playerId });
+            } break;
+            case StreamType::staticAtPlayer:
+            {
+                // Static streams have no automatic listeners, every
+                // player hears every speaker's stream within distance
+                if (speakerStatus)
+                {
+                    speakerStreams[playerId] = Amx::Call("SvCreateSLStreamAtPlayer", { Amx::Float(options.distance),
+                        playerId, kStreamColor, Amx::String("fakehost") });
+
+                    for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+                    {
+                        if (initStatus[iPlayerId] && iPlayerId != playerId)
+                            Amx::Call("SvAttachListenerToStream", { speakerStreams[playerId], iPlayerId });
+                    }
+
+                    Amx::Call("SvAttachSpeakerToStream", { speakerStreams[playerId], playerId });
+                }
+
+                for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+                {
+                    if (speakerStreams[iPlayerId] != NULL && iPlayerId != playerId)
+                        Amx::Call("SvAttachListenerToStream", { speakerStreams[iPlayerId], playerId });
+                }
+            } break;
+            case StreamType::dynamicAtPlayer:
+            {
+                if (!speakerStatus) break;
+
+                speakerStreams[playerId] = Amx::Call("SvCreateDLStreamAtPlayer", { Amx::Float(options.distance),
+                    static_cast<cell>(options.maxListeners), playerId, kStreamColor, Amx::String("fakehost") });
+                Amx::Call("SvAttachSpeakerToStream", { speakerStreams[playerId], playerId });
+            } break;
+            case StreamType::dynamicAtVehicle:
+            {
+                if (!speakerStatus) break;
+
+                // Speaker is the driver of the vehicle with his id
+                NetGame::CreateVehicle(playerId, walkers[playerId].position);
+
+                speakerStreams[playerId] = Amx::Call("SvCreateDLStreamAtVehicle", { Amx::Float(options.distance),
+                    static_cast<cell>(options.maxListeners), playerId, kStreamColor, Amx::String("fakehost") });
+                Amx::Call("SvAttachSpeakerToStream", { speakerStreams[playerId], playerId });
+            } break;
+            case StreamType::dynamicAtObject:
+            {
+                if (!speakerStatus) break;
+
+                // Speaker talks through a static object placed where he joined
+                NetGame::CreateObject(playerId, walkers[playerId].position);
+
+                speakerStreams[playerId] = Amx::Call("SvCreateDLStreamAtObject", { Amx::Float(options.distance),
+                    static_cast<cell>(options.maxListeners), playerId, kStreamColor, Amx::String("fakehost") });
+                Amx::Call("SvAttachSpeakerToStream", { speakerStreams[playerId], playerId });
+            } break;
+        }
+    }
+
+    void OnPlayerLeave(const uint16_t playerId) noexcept
+    {
+        if (playerId >= MAX_PLAYERS || !initStatus[playerId]) return;
+
+        initStatus[playerId] = false;
+
+        if (speakerStreams[playerId] != NULL)
+        {
+            Amx::Call("SvDeleteStream", { speakerStreams[playerId] });
+            speakerStreams[playerId] = NULL;
+        }
+
+        NetGame::DestroyVehicle(playerId);
+        NetGame::DestroyObject(playerId);
+    }
+
+    void HandleMessage(const uint8_t type, const uint16_t playerId, const uint32_t address,
+                       const std::vector<uint8_t>& data) noexcept
+    {
+        if (playerId >= MAX_PLAYERS) return;
+
+        switch (type)
+        {
+            case StandIn::MessageType::connect:
+            {
+                if (!NetGame::ConnectPlayer(playerId)) break;
+
+                // Replayed players stand where they were last recorded
+                if (options.replayFile.empty()) walkers[playerId] = { RandomPosition(), RandomVelocity() };
+                NetGame::SetPlayerPosition(playerId, walkers[playerId].position);
+
+                Loopback::Connect(playerId, address, data.data(), data.size());
+            } break;
+            case StandIn::MessageType::packet:
+            {
+                Loopback::Receive(playerId, data.data(), data.size());
+            } break;
+            case StandIn::MessageType::disconnect:
+            {
+                OnPlayerLeave(playerId);
+                Loopback::Disconnect(playerId);
+                NetGame::DisconnectPlayer(playerId);
+            } break;
+        }
+    }
+
+    void DeliverPacket(const uint16_t playerId, const std::vector<uint8_t>& packet) noexcept
+    {
+        if (Bridge::HasPlayer(playerId)) Bridge::Send(playerId, packet.data(), packet.size());
+        else if (playerId < players.size() && players[playerId] != nullptr)
+            LocalLink::PushPacket(playerId, packet.data(), packet.size());
+    }
+
+    void DispatchCaptures() noexcept
+    {
+        Loopback::Capture capture;
+
+        while (Loopback::PopCapture(capture))
+        {
+            if (capture.rpcStatus || capture.data.size() < sizeof(uint8_t) + sizeof(ControlPacket) ||
+                capture.data[0] != kRaknetPacketId) continue;
+
+            const auto controlPacketPtr = reinterpret_cast<const ControlPacket*>(capture.data.data() + sizeof(uint8_t));
+
+            ++controlCounts[controlPacketPtr->packet];
+
+            if (capture.playerId == Loopback::kBroadcastId)
+            {
+                for (uint16_t iPlayerId { 0 }; iPlayerId < MAX_PLAYERS; ++iPlayerId)
+                {
+                    if (Loopback::IsPlayerConnected(iPlayerId))
+                        DeliverPacket(iPlayerId, capture.data);
+                }
+
+                continue;
+            }
+
+            if (controlPacketPtr->packet == SV::ControlPacketType::pluginInit)
+                OnPlayerInit(capture.playerId);
+
+            DeliverPacket(capture.playerId, capture.data);
+        }
+    }
+
+    void WalkPlayers(const float deltaTime) noexcept
+    {
+        for (uint16_t playerId { 0 }; playerId < MAX_PLAYERS; ++playerId)
+        {
+            if (!NetGame::IsPlayerConnected(playerId)) continue;
+
+            auto& walker = walkers[playerId];
+
+            walker.position.fX += walker.velocity.fX * deltaTime;
+            walker.position.fY += walker.velocity.fY * deltaTime;
+
+            if (walker.position.fX < 0.f || walker.position.fX > options.area) walker.velocity.fX = -walker.velocity.fX;
+            if (walker.position.fY < 0.f || walker.position.fY > options.area) walker.velocity.fY = -walker.velocity.fY;
+
+            NetGame::SetPlayerPosition(playerId, walker.position);
+
+            if (options.streamType == StreamType::dynamicAtVehicle)
+                NetGame::SetVehiclePosition(playerId, walker.position);
+        }
+    }
+
+    // Replay
+    // --------------------------------------------------------------------
+
+    Replay::Record replayRecord;
+    bool replayPendingStatus { false };
+    uint64_t replayedRecords { 0 };
+
+    void ConnectReplayPlayer(const uint16_t playerId, const bool speakerStatus, const bool authStatus) noexcept
+    {
+        if (players[playerId] != nullptr)
+        {
+            players[playerId]->Disconnect();
+            retiredPlayers.emplace_back(std::move(players[playerId]));
+        }
+
+        players[playerId] = std::make_unique<Player>(playerId, speakerStatus);
+        players[playerId]->Connect(authStatus, options.compact, options.simulcast);
+    }
+
+    void ApplyRecord(const Replay::Record& record) noexcept
+    {
+        const auto id = record.id;
+
+        CVector position;
+
+        if (record.data.size() == sizeof(position))
+            std::memcpy(&position, record.data.data(), sizeof(position));
+
+        switch (record.type)
+        {
+            case Capture::RecordType::connect:
+            {
+                if (id >= MAX_PLAYERS || record.data.size() != sizeof(Capture::ConnectRecord)) break;
+
+                Capture::ConnectRecord connectRecord;
+                std::memcpy(&connectRecord, record.data.data(), sizeof(connectRecord));
+
+                ConnectReplayPlayer(id, connectRecord.micro != NULL,
+                    (connectRecord.features & SV::ConnectFeatureType::voiceAuth) != NULL);
+            } break;
+            case Capture::RecordType::disconnect:
+            {
+                if (id < MAX_PLAYERS && players[id] != nullptr) players[id]->Disconnect();
+            } break;
+            case Capture::RecordType::controlPacket:
+            {
+                if (id >= MAX_PLAYERS) break;
+
+                // Players connected before the capture had been started
+                // appear with their first packet
+                if (players[id] == nullptr) ConnectReplayPlayer(id, true, options.auth);
+
+                std::vector<uint8_t> packet { kRaknetPacketId };
+                packet.insert(packet.end(), record.data.begin(), record.data.end());
+
+                Link::SendPacket(id, packet.data(), packet.size());
+            } break;
+            case Capture::RecordType::voicePacket:
+            {
+                if (id >= MAX_PLAYERS || record.data.size() < sizeof(VoicePacket)) break;
+
+                if (players[id] == nullptr) ConnectReplayPlayer(id, true, options.auth);
+
+                const auto& voicePacket = *reinterpret_cast<const VoicePacket*>(record.data.data());
+                if (voicePacket.GetFullSize() != record.data.size()) break;
+
+                players[id]->SendRecordedPacket(voicePacket);
+            } break;
+            case Capture::RecordType::native:
+            {
+                Replay::CallNative(record.data);
+            } break;
+            case Capture::RecordType::playerPosition:
+            {
+                if (id >= MAX_PLAYERS || record.data.size() != sizeof(position)) break;
+
+                // Position may come before the player's connect is handled
+                walkers[id].position = position;
+                NetGame::SetPlayerPosition(id, position);
+            } break;
+            case Capture::RecordType::vehiclePosition:
+            {
+                if (id < MAX_VEHICLES && record.data.size() == sizeof(position) &&
+                    !NetGame::SetVehiclePosition(id, position)) NetGame::CreateVehicle(id, position);
+            } break;
+            case Capture::RecordType::objectPosition:
+            {
+                if (id < MAX_OBJECTS && record.data.size() == sizeof(position) &&
+                    !NetGame::SetObjectPosition(id, position)) NetGame::CreateObject(id, position);
+            } break;
+        }
+
+        ++replayedRecords;
+    }
+
+    // Applies records captured up to 'replayTime' microseconds,
+    // returns false when the capture is over
+    bool ReplayRecords(const uint64_t replayTime) noexcept
+    {
+        while (replayPendingStatus && replayRecord.time <= replayTime)
+        {
+            ApplyRecord(replayRecord);
+            replayPendingStatus = Replay::Read(replayRecord);
+        }
+
+        return replayPendingStatus;
+    }
+
+    // Report
+    // --------------------------------------------------------------------
+
+    struct Totals
+    {
+        uint64_t sentPackets { 0 };
+        uint64_t receivedPackets { 0 };
+        uint64_t receivedBytes { 0 };
+        uint64_t lostPackets { 0 };
+        uint64_t controlPackets { 0 };
+        uint32_t connectedCount { 0 };
+    };
+
+    Totals GetTotals() noexcept
+    {
+        Totals totals;
+
+        for (const auto& player : players)
+        {
+            if (player == nullptr) continue;
+
+            totals.sentPackets += player->GetSentPackets();
+            totals.receivedPackets += player->GetReceivedPackets();
+            totals.receivedBytes += player->GetReceivedBytes();
+            totals.lostPackets += player->GetLostPackets();
+            totals.connectedCount += player->GetState() == Player::State::connected;
+        }
+
+        for (const auto& player : retiredPlayers)
+        {
+            totals.sentPackets += player->GetSentPackets();
+            totals.receivedPackets += player->GetReceivedPackets();
+            totals.receivedBytes += player->GetReceivedBytes();
+            totals.lostPackets += player->GetLostPackets();
+        }
+
+        for (const auto controlCount : controlCounts)
+            totals.controlPackets += controlCount;
+
+        return totals;
+    }
+
+    void PrintReport(const Histogram& tickTime, const double testTime) noexcept
+    {
+        Histogram::Snapshot tickSnapshot;
+        tickTime.MergeTo(tickSnapshot);
+
+        const auto totals = GetTotals();
+
+        std::printf(
+            "\n"
+            "ticks:             %llu in %.1f s\n"
+            "tick time (us):    p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n"
+            "players:           %u in-process (%u connected), %llu initialized\n"
+            "control packets:   %llu\n"
+            "voice packets:     sent %llu, received %llu, lost %llu\n"
+            "voice bytes:       received %llu (%.1f per packet)\n",
+            static_cast<unsigned long long>(tickSnapshot.count), testTime,
+            tickSnapshot.GetPercentile(50.0) / 1000.0, tickSnapshot.GetPercentile(90.0) / 1000.0,
+            tickSnapshot.GetPercentile(99.0) / 1000.0, tickSnapshot.GetPercentile(99.9) / 1000.0,
+            tickSnapshot.max / 1000.0, options.players, totals.connectedCount,
+            static_cast<unsigned long long>(initCount),
+            static_cast<unsigned long long>(totals.controlPackets),
+            static_cast<unsigned long long>(totals.sentPackets),
+            static_cast<unsigned long long>(totals.receivedPackets),
+            static_cast<unsigned long long>(totals.lostPackets),
+            static_cast<unsigned long long>(totals.receivedBytes),
+            totals.receivedPackets != 0 ? static_cast<double>(totals.receivedBytes) / totals.receivedPackets : 0.0);
+
+        if (!options.replayFile.empty())
+        {
+            std::printf("replay:            %llu records, %llu script calls skipped\n",
+                static_cast<unsigned long long>(replayedRecords),
+                static_cast<unsigned long long>(Replay::GetSkippedNatives()));
+        }
+
+        if (options.trunkPort != 0)
+        {
+            const auto GetStat = [](const uint32_t statid) -> unsigned long long
+            {
+                return static_cast<uint32_t>(Amx::Call("SvGetStat", { static_cast<cell>(statid) }));
+            };
+
+            const auto GetLatency = [](const float percentile) -> double
+            {
+                return static_cast<uint32_t>(Amx::Call("SvGetLatency", { LatencyType::trunk,
+                    Amx::Float(percentile) })) / 1000.0;
+            };
+
+            std::printf(
+                "trunk sent:        %llu frames in %llu datagrams (%llu bytes), %llu errors\n"
+                "trunk received:    %llu frames in %llu datagrams, %llu datagrams lost, %llu frames dropped\n"
+                "trunk latency (us): p50 %.1f, p99 %.1f\n",
+                GetStat(StatType::trunkFramesSent), GetStat(StatType::trunkDatagramsSent),
+                GetStat(StatType::trunkBytesSent), GetStat(StatType::trunkSendErrors),
+                GetStat(StatType::trunkFramesReceived), GetStat(StatType::trunkDatagramsReceived),
+                GetStat(StatType::trunkDatagramsLost), GetStat(StatType::trunkFramesDropped),
+                GetLatency(50.f), GetLatency(99.f));
+        }
+    }
+
+    bool WriteJson(const Histogram& tickTime, const double testTime) noexcept
+    {
+        const auto file = std::fopen(options.jsonFile.c_str(), "w");
+        if (file == nullptr) return false;
+
+        Histogram::Snapshot tickSnapshot;
+        tickTime.MergeTo(tickSnapshot);
+
+        const auto totals = GetTotals();
+
+        std::fprintf(file, "{\"players\":%u,\"speakers\":%u,\"stream\":%hhu,\"ticks\":%llu,\"duration\":%.3f,"
+            "\"tick_ns\":{\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},"
+            "\"initialized\":%llu,\"sent\":%llu,\"received\":%llu,\"received_bytes\":%llu,\"lost\":%llu,\"control\":{",
+            options.players, options.speakers, options.streamType,
+            static_cast<unsigned long long>(tickSnapshot.count), testTime,
+            static_cast<unsigned long long>(tickSnapshot.GetPercentile(50.0)),
+            static_cast<unsigned long long>(tickSnapshot.GetPercentile(90.0)),
+            static_cast<unsigned long long>(tickSnapshot.GetPercentile(99.0)),
+            static_cast<unsigned long long>(tickSnapshot.GetPercentile(99.9)),
+            static_cast<unsigned long long>(tickSnapshot.max),
+            static_cast<unsigned long long>(initCount),
+            static_cast<unsigned long long>(totals.sentPackets),
+            static_cast<unsigned long long>(totals.receivedPackets),
+            static_cast<unsigned long long>(totals.receivedBytes),
+            static_cast<unsigned long long>(totals.lostPackets));
+
+        bool firstStatus { true };
+
+        for (std::size_t i = 0; i < controlCounts.size(); ++i)
+        {
+            if (controlCounts[i] == 0) continue;
+
+            std::fprintf(file, "%s\"%zu\":%llu", firstStatus ? "" : ",", i,
+                static_cast<unsigned long long>(controlCounts[i]));
+
+            firstStatus = false;
+        }
+
+        std::fputs("}}\n", file);
+        std::fclose(file);
+
+        return true;
+    }
+}
+
+int main(const int argc, char** const argv)
+{
+    if (!ParseOptions(argc, argv))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    genRandom.seed(options.seed);
+
+    // Every in-process player owns a voice socket
+    rlimit filesLimit {};
+
+    if (getrlimit(RLIMIT_NOFILE, &filesLimit) == 0 && filesLimit.rlim_cur < options.players + 64)
+    {
+        filesLimit.rlim_cur = std::min<rlim_t>(filesLimit.rlim_max, options.players + 64);
+        setrlimit(RLIMIT_NOFILE, &filesLimit);
+    }
+
+    if (!Host::Init(options.verbose))
+        return EXIT_FAILURE;
+
+    if (options.bridgePort != 0 && !Bridge::Init(options.bridgePort))
+    {
+        std::fprintf(stderr, "fakehost: failed to open raknet stand-in port %hu\n", options.bridgePort);
+        Host::Free();
+        return EXIT_FAILURE;
+    }
+
+    if (!options.replayFile.empty())
+    {
+        if (!Replay::Open(options.replayFile))
+        {
+            std::fprintf(stderr, "fakehost: failed to open capture '%s'\n", options.replayFile.c_str());
+            Bridge::Free();
+            Host::Free();
+            return EXIT_FAILURE;
+        }
+
+        players.resize(MAX_PLAYERS);
+        replayPendingStatus = Replay::Read(replayRecord);
+    }
+
+    if (!options.captureFile.empty())
+        Amx::Call("SvCaptureStart", { Amx::String(options.captureFile.c_str()) });
+
+    if (options.auth) Amx::Call("SvSetVoiceAuthMode", { 1 });
+    if (options.simulcast) Amx::Call("SvSetSimulcast", { 1 });
+    if (options.streamType == StreamType::global && options.replayFile.empty())
+        globalStream = Amx::Call("SvCreateGStream", { kStreamColor, Amx::String("fakehost") });
+
+    if (options.trunkPort != 0 && !Amx::Call("SvFederationOpen", { options.trunkPort, kTrunkFlushInterval }))
+        std::fprintf(stderr, "fakehost: failed to open trunk port %hu\n", options.trunkPort);
+
+    if (options.trunkPeerPort != 0)
+    {
+        const cell peer = Amx::Call("SvFederationAddPeer", { Amx::String("127.0.0.1"),
+            options.trunkPeerPort, static_cast<cell>(kTrunkKey) });
+
+        if (options.trunkExport) Amx::Call("SvFederationExportStream", { globalStream, peer, kTrunkChannel });
+        if (options.trunkImport) Amx::Call("SvFederationImportStream", { globalStream, peer, kTrunkChannel });
+    }
+
+    in_addr loopbackAddr {};
+    loopbackAddr.s_addr = htonl(INADDR_LOOPBACK);
+
+    Link::Init(loopbackAddr, StandIn::kDefaultPort);
+    Player::SetServerAddress(loopbackAddr);
+
+    players.reserve(options.players);
+
+    for (uint32_t i = 0; i < options.players; ++i)
+    {
+        players.emplace_back(std::make_unique<Player>(i, i < options.speakers));
+        players.back()->Connect(options.auth, options.compact, options.simulcast);
+    }
+
+    std::signal(SIGINT, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+
+    if (!options.replayFile.empty())
+    {
+        std::printf("fakehost: replaying '%s' at %s%s\n", options.replayFile.c_str(),
+            options.tickRate != 0 ? "real time" : "max speed",
+            Bridge::IsActive() ? ", stand-in bridge enabled" : "");
+    }
+    else
+    {
+        std::printf("fakehost: %u players (%u speakers), %u ticks at %u hz%s\n",
+            options.players, options.speakers, options.ticks, options.tickRate,
+            Bridge::IsActive() ? ", stand-in bridge enabled" : "");
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    // Simulated time advances by one tick interval per tick regardless of
+    // real pacing, so that unthrottled runs do the same work as real-time ones
+    const uint32_t tickInterval = options.tickRate != 0 ? std::max(1000u / options.tickRate, 1u) : 5;
+    const uint32_t voiceTicks = std::max(kVoiceInterval / tickInterval, 1u);
+    const uint32_t keepAliveTicks = std::max(kKeepAliveInterval / tickInterval, 1u);
+    const uint32_t streamingTicks = std::max(kStreamingInterval / tickInterval, 1u);
+    const uint32_t replayTailTicks = std::max(kReplayTailInterval / tickInterval, 1u);
+    const uint32_t payloadSize = options.bitrate * kVoiceInterval / 8000;
+
+    Histogram tickTime;
+
+    const auto beginTime = Clock::now();
+    auto nextTickTime = beginTime;
+
+    LocalLink::Message linkMessage;
+    std::vector<uint8_t> bridgeData;
+    std::vector<uint8_t> packet;
+
+    uint32_t tick { 0 };
+
+    for (; tick < options.ticks && runStatus.load(std::memory_order_relaxed); ++tick)
+    {
+        // Events captured during a tick are replayed at its beginning. Plugin keeps
+        // ticking for a while after the capture is over so that packets in flight
+        // reach their listeners.
+        if (!options.replayFile.empty() && !ReplayRecords(1000ull * tickInterval * (tick + 1)) &&
+            options.ticks - tick > replayTailTicks) options.ticks = tick + replayTailTicks;
+
+        while (LocalLink::PopMessage(linkMessage))
+            HandleMessage(linkMessage.type, linkMessage.playerId, loopbackAddr.s_addr, linkMessage.data);
+
+        {
+            uint8_t type; uint16_t playerId; uint32_t address;
+
+            while (Bridge::Receive(type, playerId, address, bridgeData))
+                HandleMessage(type, playerId, address, bridgeData);
+        }
+
+        if (options.replayFile.empty())
+            WalkPlayers(tickInterval / 1000.f);
+
+        if (tick % streamingTicks == 0)
+            NetGame::UpdateStreaming(kStreamingDistance);
+
+        const auto sendTime = Player::GetTime();
+
+        for (uint32_t i = 0; i < players.size(); ++i)
+        {
+            if (players[i] == nullptr) continue;
+
+            auto& player = *players[i];
+
+            // Players are spread evenly over the interval
+            if (player.IsSpeaker() && options.replayFile.empty() && (tick + i) % voiceTicks == 0)
+                player.SendVoicePacket(payloadSize, sendTime);
+            else if ((tick + i) % keepAliveTicks == 0)
+                player.SendKeepAlivePacket();
+        }
+
+        tickTime.Record(Host::Tick());
+
+        DispatchCaptures();
+
+        {
+            uint16_t playerId;
+
+            while (Link::ReceivePacket(playerId, packet, 0))
+            {
+                if (playerId < players.size() && players[playerId] != nullptr)
+                    players[playerId]->HandlePacket(packet.data(), packet.size());
+            }
+        }
+
+        for (const auto& player : players)
+        {
+            if (player != nullptr && player->GetState() >= Player::State::binding)
+                player->ReceiveVoicePackets();
+        }
+
+        if (options.tickRate != 0)
+        {
+            nextTickTime += std::chrono::milliseconds(tickInterval);
+            std::this_thread::sleep_until(nextTickTime);
+        }
+    }
+
+    const auto testTime = std::chrono::duration<double>(Clock::now() - beginTime).count();
+
+    if (!options.captureFile.empty())
+        Amx::Call("SvCaptureStop", {});
+
+    // Let in-flight packets arrive before counting them
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    for (const auto& player : players)
+    {
+        if (player != nullptr && player->GetState() >= Player::State::binding)
+            player->ReceiveVoicePackets();
+    }
+
+    PrintReport(tickTime, testTime);
+
+    if (!options.jsonFile.empty() && !WriteJson(tickTime, testTime))
+        std::fprintf(stderr, "fakehost: failed to write '%s'\n", options.jsonFile.c_str());
+
+    for (const auto& player : players)
+    {
+        if (player != nullptr) player->Disconnect();
+    }
+
+    players.clear();
+    retiredPlayers.clear();
+
+    Replay::Close();
+
+    Link::Free();
+    Bridge::Free();
+    Host::Free();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,454 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <JitterBuffer.h>
+
+namespace
+{
+    // Same timing as client channels
+    constexpr uint32_t kFrameTime = 100;
+    constexpr uint32_t kFeedTime = kFrameTime / 2;
+    constexpr uint32_t kMaxDelay = 3 * kFrameTime;
+
+    // Game frame, channels are fed on every one
+    constexpr uint32_t kStepTime = 10;
+
+    constexpr int32_t kNoSource = -1;
+
+    uint32_t failuresCount { 0 };
+
+    void Check(const bool status, const char* const scenario, const char* const expression, const int line) noexcept
+    {
+        if (status) return;
+
+        std::printf("  %s: check failed at line %d: %s\n", scenario, line, expression);
+        ++failuresCount;
+    }
+
+#define CHECK(expression) Check((expression), scenario, #expression, __LINE__)
+
+    struct Arrival
+    {
+        uint32_t time;
+        uint32_t sequence;
+    };
+
+    // Frame as it came out of the buffer, source is the sequence whose data
+    // was given to decoder (the frame itself or the following one for FEC)
+    struct Played
+    {
+        uint8_t type;
+        uint32_t sequence;
+        int32_t source;
+    };
+
+    // Stands in for BASS push stream: decoded frames queue up in output
+    // and are played out in real time, queued audio is what Channel reads
+    // with BASS_DATA_AVAILABLE before feeding
+    class FakeOutput {
+
+    public:
+
+        uint32_t GetQueuedTime() const noexcept
+        {
+            return this->queuedTime;
+        }
+
+        void Advance(const uint32_t time) noexcept
+        {
+            this->queuedTime = this->queuedTime > time ? this->queuedTime - time : 0;
+        }
+
+        // Mirrors Channel::Feed
+        void Feed(JitterBuffer& buffer, const uint32_t curTime)
+        {
+            JitterBuffer::Frame frame;
+
+            while (buffer.Pop(curTime, this->queuedTime, frame))
+            {
+                const int32_t source = frame.data != nullptr ? static_cast<int32_t>(frame.data[0]) : kNoSource;
+
+                this->played.push_back({ frame.type, this->playedCount++, source });
+                this->queuedTime += kFrameTime;
+            }
+        }
+
+        const std::vector<Played>& GetPlayed() const noexcept
+        {
+            return this->played;
+        }
+
+    private:
+
+        uint32_t queuedTime { 0 };
+        uint32_t playedCount { 0 };
+
+        std::vector<Played> played;
+
+    };
+
+    // Frames carry their sequence as payload, every step pushes frames that
+    // have come since the previous one (in the given order) and feeds output
+    struct Simulation
+    {
+        JitterBuffer buffer { kFrameTime, kFeedTime, kMaxDelay };
+        FakeOutput output;
+
+        uint32_t curTime { 0 };
+
+        void Run(const std::vector<Arrival>& arrivals, const uint32_t endTime)
+        {
+            for (; this->curTime <= endTime; this->curTime += kStepTime)
+            {
+                if (this->curTime != 0) this->output.Advance(kStepTime);
+
+                for (const auto& arrival : arrivals)
+                {
+                    if (arrival.time > this->curTime) continue;
+                    if (this->curTime != 0 && arrival.time <= this->curTime - kStepTime) continue;
+
+                    const auto payload = static_cast<uint8_t>(arrival.sequence);
+                    this->buffer.Push(arrival.sequence, this->curTime, &payload, sizeof(payload));
+                }
+
+                this->output.Feed(this->buffer, this->curTime);
+            }
+        }
+    };
+
+    std::vector<Arrival> MakeArrivals(const uint32_t count) noexcept
+    {
+        std::vector<Arrival> arrivals;
+
+        for (uint32_t i { 0 }; i < count; ++i)
+            arrivals.push_back({ i * kFrameTime, i });
+
+        return arrivals;
+    }
+
+    void Erase(std::vector<Arrival>& arrivals, const uint32_t sequence) noexcept
+    {
+        for (auto iter = arrivals.begin(); iter != arrivals.end(); ++iter)
+        {
+            if (iter->sequence == sequence)
+            {
+                arrivals.erase(iter);
+                return;
+            }
+        }
+    }
+
+    void Move(std::vector<Arrival>& arrivals, const uint32_t sequence, const uint32_t time)
+    {
+        Erase(arrivals, sequence);
+
+        auto iter = arrivals.begin();
+        while (iter != arrivals.end() && iter->time <= time) ++iter;
+
+        arrivals.insert(iter, { time, sequence });
+    }
+
+    // Normal frames from 'first' to 'last' in order
+    bool IsPlayedInOrder(const std::vector<Played>& played, const std::size_t begin,
+                         const uint32_t first, const uint32_t last) noexcept
+    {
+        if (played.size() < begin + (last - first + 1)) return false;
+
+        for (uint32_t sequence { first }; sequence <= last; ++sequence)
+        {
+            const auto& frame = played[begin + (sequence - first)];
+
+            if (frame.type != JitterBuffer::FrameType::normal ||
+                frame.source != static_cast<int32_t>(sequence))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Frames sent every frame time are played in order right after feed time
+    void TestInOrder()
+    {
+        const char* const scenario = "in order";
+
+        Simulation simulation;
+        simulation.Run(MakeArrivals(20), 2500);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 20);
+        CHECK(IsPlayedInOrder(played, 0, 0, 19));
+        CHECK(simulation.buffer.GetTargetDelay() == kFeedTime);
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 20);
+        CHECK(stats.lost == 0);
+        CHECK(stats.late == 0);
+        CHECK(stats.underruns == 0);
+        CHECK(stats.jitter == 0);
+        CHECK(stats.delay == kFeedTime);
+    }
+
+    // Frame that came after the following one is still played in its place
+    void TestReordered()
+    {
+        const char* const scenario = "reordered";
+
+        auto arrivals = MakeArrivals(10);
+        Move(arrivals, 6, 500);
+        Move(arrivals, 5, 510);
+
+        Simulation simulation;
+        simulation.Run(arrivals, 1500);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 10);
+        CHECK(IsPlayedInOrder(played, 0, 0, 9));
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 10);
+        CHECK(stats.lost == 0);
+        CHECK(stats.late == 0);
+        CHECK(stats.jitter != 0);
+    }
+
+    // Missing frame is decoded from FEC of the following one when that has
+    // come and concealed by decoder alone otherwise
+    void TestLost()
+    {
+        const char* const scenario = "lost";
+
+        auto arrivals = MakeArrivals(10);
+        Erase(arrivals, 3);
+        Erase(arrivals, 4);
+        Move(arrivals, 5, 300);
+
+        Simulation simulation;
+        simulation.Run(arrivals, 1500);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 10);
+        CHECK(IsPlayedInOrder(played, 0, 0, 2));
+
+        if (played.size() == 10)
+        {
+            CHECK(played[3].type == JitterBuffer::FrameType::concealed);
+            CHECK(played[3].source == kNoSource);
+            CHECK(played[4].type == JitterBuffer::FrameType::concealed);
+            CHECK(played[4].source == 5);
+        }
+
+        CHECK(IsPlayedInOrder(played, 5, 5, 9));
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 8);
+        CHECK(stats.lost == 2);
+        CHECK(stats.late == 0);
+        CHECK(stats.underruns == 0);
+    }
+
+    // Frame that comes after its place was concealed is dropped and raises
+    // target delay, which then wears off while frames are played
+    void TestLate()
+    {
+        const char* const scenario = "late";
+
+        auto arrivals = MakeArrivals(80);
+        Move(arrivals, 4, 300);
+        Move(arrivals, 3, 320);
+
+        Simulation simulation;
+        simulation.Run(arrivals, 330);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 4);
+
+        if (played.size() == 4)
+        {
+            CHECK(played[3].type == JitterBuffer::FrameType::concealed);
+            CHECK(played[3].source == 4);
+        }
+
+        const auto raisedDelay = simulation.buffer.GetTargetDelay();
+        CHECK(raisedDelay >= kFeedTime + kFrameTime / 2);
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 4);
+        CHECK(stats.lost == 1);
+        CHECK(stats.late == 1);
+        CHECK(stats.delay == raisedDelay);
+
+        simulation.Run(arrivals, 8500);
+
+        CHECK(played.size() == 80);
+        CHECK(IsPlayedInOrder(played, 4, 4, 79));
+        CHECK(simulation.buffer.GetTargetDelay() < raisedDelay);
+        CHECK(simulation.buffer.GetTargetDelay() <= kFeedTime + 5);
+
+        // Counters were taken already
+        simulation.buffer.PopStats(stats = {});
+
+        CHECK(stats.received == 75);
+        CHECK(stats.lost == 0);
+        CHECK(stats.late == 0);
+    }
+
+    // Output that runs dry in the middle of the talkspurt buffers anew
+    // with raised delay, frames that missed their time are skipped
+    void TestUnderrun()
+    {
+        const char* const scenario = "underrun";
+
+        auto arrivals = MakeArrivals(10);
+        for (uint32_t sequence { 5 }; sequence < 10; ++sequence)
+            Move(arrivals, sequence, sequence * kFrameTime + 400);
+
+        Simulation simulation;
+        simulation.Run(arrivals, 2000);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 10);
+        CHECK(IsPlayedInOrder(played, 0, 0, 9));
+        CHECK(simulation.buffer.GetTargetDelay() > kFeedTime);
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 10);
+        CHECK(stats.lost == 0);
+        CHECK(stats.underruns == 1);
+
+        // Talkspurt goes on after stalls, frames 11 and 12 are never sent
+        simulation.Run({ { 2500, 10 }, { 3400, 13 }, { 3500, 14 } }, 4000);
+
+        CHECK(played.size() == 13);
+        CHECK(IsPlayedInOrder(played, 10, 10, 10));
+        CHECK(IsPlayedInOrder(played, 11, 13, 14));
+
+        simulation.buffer.PopStats(stats = {});
+
+        CHECK(stats.lost == 2);
+        CHECK(stats.underruns == 2);
+    }
+
+    // Frames coming in bursts make delay grow up to its limit, after
+    // the first stall bursts are played out without gaps
+    void TestBursty()
+    {
+        const char* const scenario = "bursty";
+
+        constexpr uint32_t kBurstFrames = 4;
+
+        std::vector<Arrival> arrivals;
+
+        for (uint32_t sequence { 0 }; sequence < 60; ++sequence)
+            arrivals.push_back({ (sequence / kBurstFrames + 1) * kBurstFrames * kFrameTime, sequence });
+
+        Simulation simulation;
+        simulation.Run(arrivals, 8000);
+
+        const auto& played = simulation.output.GetPlayed();
+
+        CHECK(played.size() == 60);
+        CHECK(IsPlayedInOrder(played, 0, 0, 59));
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 60);
+        CHECK(stats.lost == 0);
+        CHECK(stats.jitter >= kFrameTime);
+        CHECK(stats.delay == kMaxDelay);
+        CHECK(stats.underruns <= 1);
+    }
+
+    // New talkspurt keeps what was measured, new speaker doesn't
+    void TestRestart()
+    {
+        const char* const scenario = "restart";
+
+        auto arrivals = MakeArrivals(10);
+        Move(arrivals, 4, 300);
+        Move(arrivals, 3, 320);
+
+        Simulation simulation;
+        simulation.Run(arrivals, 1500);
+
+        const auto measuredDelay = simulation.buffer.GetTargetDelay();
+        CHECK(measuredDelay > kFeedTime);
+
+        simulation.buffer.Restart();
+
+        CHECK(simulation.buffer.IsEmpty());
+        CHECK(!simulation.buffer.IsPlaying());
+        CHECK(simulation.buffer.GetTargetDelay() == measuredDelay);
+
+        // Talkspurt that starts with lower sequence is accepted
+        const uint8_t payload { 0 };
+        CHECK(simulation.buffer.Push(0, simulation.curTime, &payload, sizeof(payload)));
+        CHECK(!simulation.buffer.Push(0, simulation.curTime, &payload, sizeof(payload)));
+
+        simulation.buffer.Reset();
+
+        CHECK(simulation.buffer.IsEmpty());
+        CHECK(simulation.buffer.GetTargetDelay() == kFeedTime);
+
+        JitterBuffer::Stats stats;
+        simulation.buffer.PopStats(stats);
+
+        CHECK(stats.received == 0);
+        CHECK(stats.late == 0);
+    }
+}
+
+int main()
+{
+    const struct
+    {
+        const char* name;
+        void (*function)();
+    }
+    tests[] {
+        { "in order", TestInOrder },
+        { "reordered", TestReordered },
+        { "lost", TestLost },
+        { "late", TestLate },
+        { "underrun", TestUnderrun },
+        { "bursty", TestBursty },
+        { "restart", TestRestart },
+    };
+
+    for (const auto& test : tests)
+    {
+        const auto failuresBefore = failuresCount;
+
+        test.function();
+
+        std::printf("%-12s %s\n", test.name, failuresCount == failuresBefore ? "ok" : "FAILED");
+    }
+
+    return failuresCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
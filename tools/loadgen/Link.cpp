@@ -0,0 +1,106 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Link.h"
+
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool Link::Init(const in_addr& hostAddr, const uint16_t hostPort) noexcept
+{
+    if (Link::socketHandle != -1) return false;
+
+    if ((Link::socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) == -1)
+        return false;
+
+    Link::hostAddr.sin_family = AF_INET;
+    Link::hostAddr.sin_addr = hostAddr;
+    Link::hostAddr.sin_port = htons(hostPort);
+
+    if (connect(Link::socketHandle, reinterpret_cast<const sockaddr*>(&Link::hostAddr), sizeof(Link::hostAddr)) == -1)
+    {
+        close(Link::socketHandle);
+        Link::socketHandle = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void Link::Free() noexcept
+{
+    if (Link::socketHandle == -1) return;
+
+    close(Link::socketHandle);
+    Link::socketHandle = -1;
+}
+
+bool Link::SendConnect(const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    return Link::Send(StandIn::MessageType::connect, playerId, dataPtr, dataSize);
+}
+
+bool Link::SendDisconnect(const uint16_t playerId) noexcept
+{
+    return Link::Send(StandIn::MessageType::disconnect, playerId, nullptr, 0);
+}
+
+bool Link::SendPacket(const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    return Link::Send(StandIn::MessageType::packet, playerId, dataPtr, dataSize);
+}
+
+bool Link::ReceivePacket(uint16_t& playerId, std::vector<uint8_t>& packet, const uint32_t timeout) noexcept
+{
+    if (Link::socketHandle == -1) return false;
+
+    pollfd pollInfo { Link::socketHandle, POLLIN, 0 };
+    if (poll(&pollInfo, 1, static_cast<int>(timeout)) <= 0) return false;
+
+    uint8_t messageBuffer[StandIn::kMaxMessageSize];
+
+    const auto length = recv(Link::socketHandle, messageBuffer, sizeof(messageBuffer), MSG_DONTWAIT);
+    if (length < static_cast<decltype(length)>(sizeof(StandIn::Message))) return false;
+
+    const auto message = reinterpret_cast<const StandIn::Message*>(messageBuffer);
+
+    if (message->signature != StandIn::kSignature) return false;
+    if (message->type != StandIn::MessageType::packet) return false;
+
+    playerId = message->player;
+    packet.assign(messageBuffer + sizeof(StandIn::Message), messageBuffer + length);
+
+    return true;
+}
+
+bool Link::Send(const uint8_t type, const uint16_t playerId, const void* const dataPtr, const uint32_t dataSize) noexcept
+{
+    if (Link::socketHandle == -1) return false;
+    if (sizeof(StandIn::Message) + dataSize > StandIn::kMaxMessageSize) return false;
+
+    uint8_t messageBuffer[StandIn::kMaxMessageSize];
+
+    const auto message = reinterpret_cast<StandIn::Message*>(messageBuffer);
+
+    message->signature = StandIn::kSignature;
+    message->type = type;
+    message->player = playerId;
+
+    if (dataSize != 0) std::memcpy(message->data, dataPtr, dataSize);
+
+    const auto messageSize = sizeof(StandIn::Message) + dataSize;
+
+    return send(Link::socketHandle, messageBuffer, messageSize, 0) == static_cast<ssize_t>(messageSize);
+}
+
+int Link::socketHandle { -1 };
+sockaddr_in Link::hostAddr {};
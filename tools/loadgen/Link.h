@@ -0,0 +1,50 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include "StandIn.h"
+
+// Client side of the RakNet stand-in, single socket shared by all simulated players
+class Link {
+
+    Link() = delete;
+    ~Link() = delete;
+    Link(const Link&) = delete;
+    Link(Link&&) = delete;
+    Link& operator=(const Link&) = delete;
+    Link& operator=(Link&&) = delete;
+
+public:
+
+    static bool Init(const in_addr& hostAddr, uint16_t hostPort) noexcept;
+    static void Free() noexcept;
+
+    static bool SendConnect(uint16_t playerId, const void* dataPtr, uint32_t dataSize) noexcept;
+    static bool SendDisconnect(uint16_t playerId) noexcept;
+    static bool SendPacket(uint16_t playerId, const void* dataPtr, uint32_t dataSize) noexcept;
+
+    // Waits up to 'timeout' milliseconds for RakNet packet addressed to one of the players
+    static bool ReceivePacket(uint16_t& playerId, std::vector<uint8_t>& packet, uint32_t timeout) noexcept;
+
+private:
+
+    static bool Send(uint8_t type, uint16_t playerId, const void* dataPtr, uint32_t dataSize) noexcept;
+
+private:
+
+    static int socketHandle;
+    static sockaddr_in hostAddr;
+
+};
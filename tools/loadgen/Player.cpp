@@ -0,0 +1,474 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Player.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <ControlPacket.h>
+#include <util/siphash.h>
+
+#include "Link.h"
+
+namespace
+{
+    constexpr uint8_t kRaknetPacketId = 222;
+    constexpr uint32_t kMaxVoicePacketSize = 1400;
+    constexpr uint32_t kClientJoinVersion = 4057;
+
+    const uint8_t* ReadVarint(const uint8_t* buffer, const uint8_t* const end, uint32_t& value) noexcept
+    {
+        value = 0;
+
+        for (uint32_t shift = 0; buffer != end && shift < 32; shift += 7)
+        {
+            const uint8_t byte = *buffer++;
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return buffer;
+        }
+
+        return nullptr;
+    }
+}
+
+Player::Player(const uint16_t playerId, const bool speakerStatus) noexcept
+    : playerId(playerId), speakerStatus(speakerStatus)
+{}
+
+Player::~Player() noexcept
+{
+    if (this->socketHandle != -1) close(this->socketHandle);
+}
+
+bool Player::Connect(const bool authStatus, const bool compactStatus, const bool simulcastStatus) noexcept
+{
+    if (this->state.load(std::memory_order_relaxed) != State::idle)
+        return false;
+
+    // Mimics ClientJoin RPC, server finds connect struct by its signature
+    uint8_t joinBuffer[64] {};
+    uint32_t joinSize { 0 };
+
+    const auto nicknameLength = std::snprintf(reinterpret_cast<char*>(joinBuffer + sizeof(kClientJoinVersion) + 2),
+        24, "loadgen_%hu", this->playerId);
+
+    std::memcpy(joinBuffer, &kClientJoinVersion, sizeof(kClientJoinVersion));
+    joinBuffer[sizeof(kClientJoinVersion) + 1] = static_cast<uint8_t>(nicknameLength);
+    joinSize = sizeof(kClientJoinVersion) + 2 + nicknameLength;
+
+    const auto connectStruct = reinterpret_cast<SV::ConnectPacket*>(joinBuffer + joinSize);
+
+    connectStruct->signature = SV::kSignature;
+    connectStruct->version = SV::kVersion;
+    connectStruct->micro = this->speakerStatus;
+    joinSize += sizeof(SV::ConnectPacket);
+
+    const auto featuresStruct = reinterpret_cast<SV::ConnectFeaturesPacket*>(joinBuffer + joinSize);
+
+    featuresStruct->features = (authStatus ? SV::ConnectFeatureType::voiceAuth : NULL) |
+        (compactStatus ? SV::ConnectFeatureType::compactHeader : NULL) |
+        (simulcastStatus ? SV::ConnectFeatureType::simulcast : NULL);
+    joinSize += sizeof(SV::ConnectFeaturesPacket);
+
+    this->state.store(State::connecting, std::memory_order_release);
+
+    return Link::SendConnect(this->playerId, joinBuffer, joinSize);
+}
+
+void Player::Disconnect() noexcept
+{
+    if (this->state.exchange(State::idle, std::memory_order_acq_rel) == State::idle)
+        return;
+
+    Link::SendDisconnect(this->playerId);
+}
+
+bool Player::HandlePacket(const uint8_t* const packetPtr, const uint32_t packetSize) noexcept
+{
+    if (packetSize < sizeof(uint8_t) + sizeof(ControlPacket)) return false;
+    if (*packetPtr != kRaknetPacketId) return false;
+
+    const auto controlPacketPtr = reinterpret_cast<const ControlPacket*>(packetPtr + sizeof(uint8_t));
+    if (packetSize - sizeof(uint8_t) != controlPacketPtr->GetFullSize()) return false;
+
+    switch (controlPacketPtr->packet)
+    {
+        case SV::ControlPacketType::serverInfo:
+        {
+            uint32_t infoLength = controlPacketPtr->length;
+            uint8_t features { NULL };
+
+            if (infoLength == sizeof(SV::ServerInfoPacket) + sizeof(SV::ServerFeaturesPacket) ||
+                infoLength == sizeof(SV::ServerInfoAuthPacket) + sizeof(SV::ServerFeaturesPacket))
+            {
+                infoLength -= sizeof(SV::ServerFeaturesPacket);
+                features = controlPacketPtr->data[infoLength];
+            }
+
+            if (infoLength != sizeof(SV::ServerInfoPacket) &&
+                infoLength != sizeof(SV::ServerInfoAuthPacket)) return false;
+
+            if (this->state.load(std::memory_order_relaxed) != State::connecting) return false;
+
+            const auto& stData = *PackGetStruct(controlPacketPtr, const SV::ServerInfoPacket);
+
+            if (this->socketHandle == -1 && (this->socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)) == -1)
+                return false;
+
+            sockaddr_in serverAddress {};
+
+            serverAddress.sin_family = AF_INET;
+            serverAddress.sin_addr = Player::serverAddr;
+            serverAddress.sin_port = htons(stData.serverPort);
+
+            if (connect(this->socketHandle, reinterpret_cast<const sockaddr*>(&serverAddress), sizeof(serverAddress)) == -1)
+                return false;
+
+            fcntl(this->socketHandle, F_SETFL, fcntl(this->socketHandle, F_GETFL) | O_NONBLOCK);
+
+            this->serverKey = stData.serverKey;
+            this->authStatus = infoLength == sizeof(SV::ServerInfoAuthPacket);
+            this->compactStatus = features & SV::ConnectFeatureType::compactHeader;
+            this->simulcastStatus = features & SV::ConnectFeatureType::simulcast;
+
+            if (this->authStatus)
+            {
+                std::memcpy(this->authKey, PackGetStruct(controlPacketPtr,
+                    const SV::ServerInfoAuthPacket)->authKey, sizeof(this->authKey));
+            }
+
+            this->packetNumber = 0;
+            this->state.store(State::binding, std::memory_order_release);
+
+            // First datagram lets server learn player's address
+            this->SendKeepAlivePacket();
+
+            return true;
+        }
+        case SV::ControlPacketType::pluginInit:
+        {
+            if (controlPacketPtr->length != sizeof(SV::PluginInitPacket)) return false;
+
+            uint8_t bindingState { State::binding };
+            this->state.compare_exchange_strong(bindingState, State::connected, std::memory_order_acq_rel);
+        } break;
+    }
+
+    return false;
+}
+
+bool Player::SendVoicePacket(uint32_t payloadSize, const uint64_t sendTime) noexcept
+{
+    if (this->state.load(std::memory_order_acquire) != State::connected)
+        return false;
+
+    alignas(8) uint8_t packetBuffer[kMaxVoicePacketSize];
+
+    const uint32_t maxPayloadSize = sizeof(packetBuffer) - sizeof(VoicePacket) - SV::kVoiceAuthTagSize;
+
+    if (payloadSize < sizeof(Probe)) payloadSize = sizeof(Probe);
+    if (payloadSize > maxPayloadSize) payloadSize = maxPayloadSize;
+
+    auto& voicePacket = *reinterpret_cast<VoicePacket*>(packetBuffer);
+
+    voicePacket.packet = SV::VoicePacketType::voicePacket;
+    voicePacket.length = static_cast<uint16_t>(payloadSize);
+    voicePacket.packid = this->packetNumber++;
+
+    const Probe probe { kProbeSignature, this->playerId, sendTime };
+
+    // Filler is not compressible in the same way as Opus frames are not
+    const auto fillLayer = [&](uint8_t* const layerPtr, const uint32_t layerSize)
+    {
+        std::memcpy(layerPtr, &probe, sizeof(probe));
+
+        for (uint32_t i = sizeof(probe); i < layerSize; ++i)
+            layerPtr[i] = static_cast<uint8_t>((i * 131u) ^ voicePacket.packid);
+    };
+
+    // Low layer takes about a third of the main one as 12 kbps against 32 kbps
+    const uint32_t lowLayerSize = std::max<uint32_t>(payloadSize / 3, sizeof(Probe));
+
+    if (this->simulcastStatus && sizeof(SV::SimulcastPacket) + payloadSize + lowLayerSize <= maxPayloadSize)
+    {
+        const auto simulcastPacket = reinterpret_cast<SV::SimulcastPacket*>(voicePacket.data);
+
+        simulcastPacket->mainLength = static_cast<uint16_t>(payloadSize);
+
+        fillLayer(simulcastPacket->data, payloadSize);
+        fillLayer(simulcastPacket->data + payloadSize, lowLayerSize);
+
+        voicePacket.packet = SV::VoicePacketType::simulcastPacket;
+        voicePacket.length = static_cast<uint16_t>(sizeof(SV::SimulcastPacket) + payloadSize + lowLayerSize);
+    }
+    else
+    {
+        fillLayer(voicePacket.data, payloadSize);
+    }
+
+    return this->Send(voicePacket);
+}
+
+bool Player::SendKeepAlivePacket() noexcept
+{
+    if (this->state.load(std::memory_order_acquire) < State::binding)
+        return false;
+
+    alignas(8) uint8_t packetBuffer[sizeof(VoicePacket) + SV::kVoiceAuthTagSize];
+
+    auto& voicePacket = *reinterpret_cast<VoicePacket*>(packetBuffer);
+
+    voicePacket.packet = SV::VoicePacketType::keepAlive;
+    voicePacket.length = NULL;
+    voicePacket.packid = NULL;
+
+    return this->Send(voicePacket);
+}
+
+bool Player::SendRecordedPacket(const VoicePacket& recordedPacket) noexcept
+{
+    if (this->state.load(std::memory_order_acquire) != State::connected)
+        return false;
+
+    alignas(8) uint8_t packetBuffer[kMaxVoicePacketSize];
+
+    if (sizeof(VoicePacket) + recordedPacket.length + SV::kVoiceAuthTagSize > sizeof(packetBuffer))
+        return false;
+
+    auto& voicePacket = *reinterpret_cast<VoicePacket*>(packetBuffer);
+
+    std::memcpy(&voicePacket, &recordedPacket, recordedPacket.GetFullSize());
+    voicePacket.packid = this->packetNumber++;
+
+    return this->Send(voicePacket);
+}
+
+void Player::ReceiveVoicePackets() noexcept
+{
+    alignas(8) uint8_t packetBuffer[kMaxVoicePacketSize];
+    alignas(8) uint8_t restoredBuffer[sizeof(VoicePacket) + kMaxVoicePacketSize];
+
+    const auto& voicePacket = *reinterpret_cast<const VoicePacket*>
+        (this->compactStatus ? restoredBuffer : packetBuffer);
+
+    ssize_t length;
+
+    while ((length = recv(this->socketHandle, packetBuffer, sizeof(packetBuffer), MSG_DONTWAIT)) >= 0)
+    {
+        const auto receiveTime = Player::GetTime();
+
+        if (this->compactStatus)
+        {
+            if (!this->RestoreCompactPacket(packetBuffer, length, *reinterpret_cast<VoicePacket*>(restoredBuffer)))
+            {
+                this->invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+        }
+        else if (length < static_cast<ssize_t>(sizeof(VoicePacket)) || !voicePacket.CheckHeader() ||
+            length != static_cast<ssize_t>(voicePacket.GetFullSize()))
+        {
+            this->invalidPackets.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (voicePacket.packet == SV::VoicePacketType::keepAlive)
+            continue;
+
+        this->receivedPackets.fetch_add(1, std::memory_order_relaxed);
+        this->receivedBytes.fetch_add(length, std::memory_order_relaxed);
+
+        const auto iter = this->expectedPackets.find(voicePacket.sender);
+
+        if (iter == this->expectedPackets.end() || voicePacket.packid == NULL)
+        {
+            this->expectedPackets[voicePacket.sender] = voicePacket.packid + 1;
+        }
+        else if (voicePacket.packid < iter->second)
+        {
+            this->latePackets.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            this->lostPackets.fetch_add(voicePacket.packid - iter->second, std::memory_order_relaxed);
+            iter->second = voicePacket.packid + 1;
+        }
+
+        Probe probe;
+
+        if (voicePacket.length < sizeof(probe)) continue;
+
+        std::memcpy(&probe, voicePacket.data, sizeof(probe));
+
+        if (probe.signature == kProbeSignature && receiveTime >= probe.sendTime)
+            this->latency.Record((receiveTime - probe.sendTime) / 1000);
+    }
+}
+
+uint16_t Player::GetPlayerId() const noexcept
+{
+    return this->playerId;
+}
+
+bool Player::IsSpeaker() const noexcept
+{
+    return this->speakerStatus;
+}
+
+uint8_t Player::GetState() const noexcept
+{
+    return this->state.load(std::memory_order_acquire);
+}
+
+int Player::GetSocket() const noexcept
+{
+    return this->socketHandle;
+}
+
+uint64_t Player::GetSentPackets() const noexcept
+{
+    return this->sentPackets.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetSendErrors() const noexcept
+{
+    return this->sendErrors.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetReceivedPackets() const noexcept
+{
+    return this->receivedPackets.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetReceivedBytes() const noexcept
+{
+    return this->receivedBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetLostPackets() const noexcept
+{
+    return this->lostPackets.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetLatePackets() const noexcept
+{
+    return this->latePackets.load(std::memory_order_relaxed);
+}
+
+uint64_t Player::GetInvalidPackets() const noexcept
+{
+    return this->invalidPackets.load(std::memory_order_relaxed);
+}
+
+const Histogram& Player::GetLatency() const noexcept
+{
+    return this->latency;
+}
+
+void Player::SetServerAddress(const in_addr& serverAddr) noexcept
+{
+    Player::serverAddr = serverAddr;
+}
+
+uint64_t Player::GetTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Player::Send(VoicePacket& voicePacket) noexcept
+{
+    voicePacket.svrkey = this->serverKey;
+    voicePacket.stream = NULL;
+    voicePacket.sender = NULL;
+
+    uint8_t* packetPtr = reinterpret_cast<uint8_t*>(&voicePacket);
+    uint32_t packetSize { 0 };
+
+    if (this->compactStatus)
+    {
+        // Compact header is shorter, so it's built in place right before data
+        const uint8_t flags = voicePacket.packet | (voicePacket.packid == NULL ? SV::CompactFlagType::firstPacket : NULL);
+        const uint16_t packid = static_cast<uint16_t>(voicePacket.packid);
+        const uint32_t svrkey = voicePacket.svrkey;
+
+        packetPtr = voicePacket.data - VoicePacket::kCompactUpstreamHeaderSize;
+        packetSize = VoicePacket::kCompactUpstreamHeaderSize + voicePacket.length;
+
+        std::memcpy(packetPtr, &svrkey, sizeof(svrkey));
+        packetPtr[sizeof(svrkey)] = flags;
+        std::memcpy(packetPtr + sizeof(svrkey) + sizeof(flags), &packid, sizeof(packid));
+    }
+    else
+    {
+        voicePacket.CalcHash();
+        packetSize = voicePacket.GetFullSize();
+    }
+
+    if (this->authStatus)
+    {
+        const uint64_t tag = SipHash::Calc(this->authKey[0], this->authKey[1], packetPtr, packetSize);
+        std::memcpy(packetPtr + packetSize, &tag, sizeof(tag));
+        packetSize += sizeof(tag);
+    }
+
+    if (send(this->socketHandle, packetPtr, packetSize, 0) != static_cast<ssize_t>(packetSize))
+    {
+        this->sendErrors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (voicePacket.packet == SV::VoicePacketType::voicePacket ||
+        voicePacket.packet == SV::VoicePacketType::simulcastPacket)
+        this->sentPackets.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool Player::RestoreCompactPacket(const uint8_t* const packetPtr, const uint32_t packetSize, VoicePacket& voicePacket) const noexcept
+{
+    const auto packetEnd = packetPtr + packetSize;
+    if (packetSize < 1) return false;
+
+    voicePacket.packet = *packetPtr & SV::CompactFlagType::typeMask;
+
+    if (voicePacket.packet == SV::VoicePacketType::keepAlive)
+        return true;
+
+    uint32_t stream, sender;
+
+    auto pointer = ReadVarint(packetPtr + 1, packetEnd, stream);
+    if (pointer == nullptr) return false;
+    pointer = ReadVarint(pointer, packetEnd, sender);
+    if (pointer == nullptr || packetEnd - pointer < static_cast<ssize_t>(sizeof(uint16_t))) return false;
+
+    uint16_t packid; std::memcpy(&packid, pointer, sizeof(packid));
+    pointer += sizeof(packid);
+
+    const auto iter = this->expectedPackets.find(sender);
+    const uint32_t lastPackid = iter != this->expectedPackets.end() ? iter->second - 1 : 0;
+
+    voicePacket.stream = stream;
+    voicePacket.sender = sender;
+    voicePacket.length = packetEnd - pointer;
+    voicePacket.packid = *packetPtr & SV::CompactFlagType::firstPacket
+        ? NULL : VoicePacket::RestorePackid(lastPackid, packid);
+
+    std::memcpy(voicePacket.data, pointer, voicePacket.length);
+
+    return true;
+}
+
+in_addr Player::serverAddr {};
@@ -0,0 +1,151 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+#include <netinet/in.h>
+
+#include <Header.h>
+#include <Histogram.h>
+#include <VoicePacket.h>
+
+// Simulated sampvoice client: every player is a listener,
+// speakers additionally send voice stream at client's cadence
+class Player {
+
+    Player() = delete;
+    Player(const Player&) = delete;
+    Player(Player&&) = delete;
+    Player& operator=(const Player&) = delete;
+    Player& operator=(Player&&) = delete;
+
+public:
+
+    struct State
+    {
+        enum : uint8_t
+        {
+            idle,
+            connecting, // connect sent, waiting for server info
+            binding,    // voice socket opened, waiting for plugin init
+            connected
+        };
+    };
+
+    // Leads payload of every sent voice packet so that
+    // listeners can measure delivery latency
+#pragma pack(push, 1)
+    struct Probe
+    {
+        uint32_t signature;
+        uint16_t speaker;
+        uint64_t sendTime;
+    };
+#pragma pack(pop)
+
+    static constexpr uint32_t kProbeSignature = 0x424f5250; // "PROB"
+
+public:
+
+    explicit Player(uint16_t playerId, bool speakerStatus) noexcept;
+
+    ~Player() noexcept;
+
+public:
+
+    // Compact header and simulcast are used only if server accepts them
+    bool Connect(bool authStatus, bool compactStatus = false, bool simulcastStatus = false) noexcept;
+    void Disconnect() noexcept;
+
+    // Called from control thread for every RakNet packet addressed to the player,
+    // returns true when voice socket was opened and should be polled
+    bool HandlePacket(const uint8_t* packetPtr, uint32_t packetSize) noexcept;
+
+    // Called from sender thread
+    bool SendVoicePacket(uint32_t payloadSize, uint64_t sendTime) noexcept;
+    bool SendKeepAlivePacket() noexcept;
+
+    // Resends packet recorded by server capture, its type and payload
+    // are kept while key and numbering are replaced with the player's own
+    bool SendRecordedPacket(const VoicePacket& recordedPacket) noexcept;
+
+    // Called from receiver thread when voice socket is readable
+    void ReceiveVoicePackets() noexcept;
+
+public:
+
+    uint16_t GetPlayerId() const noexcept;
+    bool IsSpeaker() const noexcept;
+    uint8_t GetState() const noexcept;
+    int GetSocket() const noexcept;
+
+    uint64_t GetSentPackets() const noexcept;
+    uint64_t GetSendErrors() const noexcept;
+    uint64_t GetReceivedPackets() const noexcept;
+    uint64_t GetReceivedBytes() const noexcept;
+    uint64_t GetLostPackets() const noexcept;
+    uint64_t GetLatePackets() const noexcept;
+    uint64_t GetInvalidPackets() const noexcept;
+
+    // Latency of received packets in microseconds
+    const Histogram& GetLatency() const noexcept;
+
+public:
+
+    static void SetServerAddress(const in_addr& serverAddr) noexcept;
+
+    // Monotonic time in nanoseconds, shared by senders and receivers
+    static uint64_t GetTime() noexcept;
+
+private:
+
+    bool Send(VoicePacket& voicePacket) noexcept;
+
+    // Restores full header of compact packet, false for malformed one
+    bool RestoreCompactPacket(const uint8_t* packetPtr, uint32_t packetSize, VoicePacket& voicePacket) const noexcept;
+
+private:
+
+    const uint16_t playerId;
+    const bool speakerStatus;
+
+    std::atomic<uint8_t> state { State::idle };
+
+    int socketHandle { -1 };
+
+    uint32_t serverKey { NULL };
+    bool authStatus { false };
+    uint64_t authKey[2] {};
+    bool compactStatus { false };
+    bool simulcastStatus { false };
+
+    uint32_t packetNumber { 0 };
+
+    std::atomic<uint64_t> sentPackets { 0 };
+    std::atomic<uint64_t> sendErrors { 0 };
+    std::atomic<uint64_t> receivedPackets { 0 };
+    std::atomic<uint64_t> receivedBytes { 0 };
+    std::atomic<uint64_t> lostPackets { 0 };
+    std::atomic<uint64_t> latePackets { 0 };
+    std::atomic<uint64_t> invalidPackets { 0 };
+
+    Histogram latency;
+
+    // Next expected packet number of every heard speaker
+    std::unordered_map<uint16_t, uint32_t> expectedPackets;
+
+private:
+
+    static in_addr serverAddr;
+
+};
@@ -0,0 +1,47 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// RakNet stand-in: minimal datagram transport that carries sampvoice
+// control traffic between a simulated client and a test host in place
+// of the SA-MP RakNet connection. Host side is expected to pass 'connect'
+// payload to the connect RPC handler, 'packet' payloads both ways as raw
+// RakNet packets and 'disconnect' to the disconnect handler.
+
+namespace StandIn
+{
+    constexpr uint32_t kSignature  = 0x49535653; // "SVSI"
+    constexpr uint16_t kDefaultPort = 7778;
+    constexpr uint32_t kMaxMessageSize = 1400;
+
+    struct MessageType
+    {
+        enum : uint8_t
+        {
+            connect,
+            disconnect,
+            packet
+        };
+    };
+
+#pragma pack(push, 1)
+
+    struct Message
+    {
+        uint32_t signature;
+        uint8_t  type;
+        uint16_t player;
+        uint8_t  data[];
+    };
+
+#pragma pack(pop)
+}
@@ -0,0 +1,421 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+#include "Link.h"
+#include "Player.h"
+
+namespace
+{
+    constexpr uint32_t kVoiceInterval = 100;
+    constexpr uint32_t kKeepAliveInterval = 5000;
+    constexpr uint32_t kSenderTickInterval = 5;
+    constexpr uint32_t kReportInterval = 1000;
+    constexpr uint32_t kPollEventsCount = 256;
+
+    struct Options
+    {
+        std::string host { "127.0.0.1" };
+        uint16_t controlPort { StandIn::kDefaultPort };
+        uint32_t players { 100 };
+        uint32_t speakers { 10 };
+        uint32_t firstId { 0 };
+        uint32_t duration { 60 };
+        uint32_t bitrate { 24000 };
+        uint32_t rampRate { 200 };
+        uint32_t threads { 4 };
+        bool auth { false };
+        bool compact { false };
+        bool simulcast { false };
+        std::string jsonFile;
+    };
+
+    std::atomic_bool runStatus { true };
+
+    void Usage(const char* const program) noexcept
+    {
+        std::printf(
+            "usage: %s [options]\n"
+            "  --host <addr>        voice server address (default 127.0.0.1)\n"
+            "  --control <port>     raknet stand-in port of test host (default %hu)\n"
+            "  --players <n>        simulated players (default 100)\n"
+            "  --speakers <n>       players that talk, taken from the first ids (default 10)\n"
+            "  --first-id <n>       id of the first simulated player (default 0)\n"
+            "  --duration <sec>     test duration after ramp-up (default 60)\n"
+            "  --bitrate <bps>      opus bitrate that sets voice payload size (default 24000)\n"
+            "  --ramp <n>           players connected per second (default 200)\n"
+            "  --threads <n>        receiver threads (default 4)\n"
+            "  --auth               negotiate voice packet authentication\n"
+            "  --compact            negotiate compact voice packet header\n"
+            "  --simulcast          send low voice layer along with the main one\n"
+            "  --json <file>        write per-listener results as json\n",
+            program, StandIn::kDefaultPort);
+    }
+
+    bool ParseOptions(const int argc, char** const argv, Options& options) noexcept
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option { argv[i] };
+            const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (option == "--auth") { options.auth = true; continue; }
+            if (option == "--compact") { options.compact = true; continue; }
+            if (option == "--simulcast") { options.simulcast = true; continue; }
+            if (value == nullptr) return false;
+
+            if (option == "--host") options.host = value;
+            else if (option == "--control") options.controlPort = static_cast<uint16_t>(std::atoi(value));
+            else if (option == "--players") options.players = std::atoi(value);
+            else if (option == "--speakers") options.speakers = std::atoi(value);
+            else if (option == "--first-id") options.firstId = std::atoi(value);
+            else if (option == "--duration") options.duration = std::atoi(value);
+            else if (option == "--bitrate") options.bitrate = std::atoi(value);
+            else if (option == "--ramp") options.rampRate = std::atoi(value);
+            else if (option == "--threads") options.threads = std::atoi(value);
+            else if (option == "--json") options.jsonFile = value;
+            else return false;
+
+            ++i;
+        }
+
+        options.speakers = std::min(options.speakers, options.players);
+        options.threads = std::max(options.threads, 1u);
+        options.rampRate = std::max(options.rampRate, 1u);
+
+        return options.players != 0 && options.firstId + options.players <= SV::kNonePlayer;
+    }
+
+    void ControlThread(const std::vector<std::unique_ptr<Player>>& players,
+                       const std::vector<int>& pollHandles, const uint32_t firstId) noexcept
+    {
+        std::vector<uint8_t> packet;
+        uint16_t playerId;
+
+        while (runStatus.load(std::memory_order_relaxed))
+        {
+            if (!Link::ReceivePacket(playerId, packet, 100)) continue;
+            if (playerId < firstId || playerId - firstId >= players.size()) continue;
+
+            const auto index = playerId - firstId;
+            auto& player = *players[index];
+
+            if (player.HandlePacket(packet.data(), packet.size()))
+            {
+                epoll_event event {};
+
+                event.events = EPOLLIN;
+                event.data.u32 = index;
+
+                epoll_ctl(pollHandles[index % pollHandles.size()], EPOLL_CTL_ADD, player.GetSocket(), &event);
+            }
+        }
+    }
+
+    void ReceiverThread(const std::vector<std::unique_ptr<Player>>& players, const int pollHandle) noexcept
+    {
+        epoll_event events[kPollEventsCount];
+
+        while (runStatus.load(std::memory_order_relaxed))
+        {
+            const auto eventsCount = epoll_wait(pollHandle, events, kPollEventsCount, 100);
+
+            for (int i = 0; i < eventsCount; ++i)
+                players[events[i].data.u32]->ReceiveVoicePackets();
+        }
+    }
+
+    void PrintProgress(const std::vector<std::unique_ptr<Player>>& players, const double elapsedTime) noexcept
+    {
+        uint32_t connectedCount { 0 };
+        uint64_t sentPackets { 0 };
+        uint64_t receivedPackets { 0 };
+        uint64_t lostPackets { 0 };
+
+        for (const auto& player : players)
+        {
+            connectedCount += player->GetState() == Player::State::connected;
+            sentPackets += player->GetSentPackets();
+            receivedPackets += player->GetReceivedPackets();
+            lostPackets += player->GetLostPackets();
+        }
+
+        std::printf("[%7.1fs] connected %u/%zu, sent %llu, received %llu, lost %llu\n",
+            elapsedTime, connectedCount, players.size(),
+            static_cast<unsigned long long>(sentPackets),
+            static_cast<unsigned long long>(receivedPackets),
+            static_cast<unsigned long long>(lostPackets));
+
+        std::fflush(stdout);
+    }
+
+    void PrintReport(const std::vector<std::unique_ptr<Player>>& players,
+                     const Options& options, const double testTime) noexcept
+    {
+        Histogram::Snapshot latency;
+
+        uint64_t sentPackets { 0 };
+        uint64_t sendErrors { 0 };
+        uint64_t receivedPackets { 0 };
+        uint64_t receivedBytes { 0 };
+        uint64_t lostPackets { 0 };
+        uint64_t latePackets { 0 };
+        uint64_t invalidPackets { 0 };
+        uint32_t connectedCount { 0 };
+        uint32_t silentCount { 0 };
+
+        for (const auto& player : players)
+        {
+            player->GetLatency().MergeTo(latency);
+
+            sentPackets += player->GetSentPackets();
+            sendErrors += player->GetSendErrors();
+            receivedPackets += player->GetReceivedPackets();
+            receivedBytes += player->GetReceivedBytes();
+            lostPackets += player->GetLostPackets();
+            latePackets += player->GetLatePackets();
+            invalidPackets += player->GetInvalidPackets();
+            connectedCount += player->GetState() == Player::State::connected;
+            silentCount += player->GetReceivedPackets() == 0;
+        }
+
+        const auto lossRatio = receivedPackets + lostPackets != 0 ?
+            100.0 * lostPackets / (receivedPackets + lostPackets) : 0.0;
+
+        std::printf(
+            "\n"
+            "players:           %u (%u connected, %u speakers)\n"
+            "duration:          %.1f s\n"
+            "sent packets:      %llu (%llu errors)\n"
+            "received packets:  %llu (%.1f pps, %.1f kbit/s)\n"
+            "lost packets:      %llu (%.3f%%)\n"
+            "late packets:      %llu\n"
+            "invalid packets:   %llu\n"
+            "silent listeners:  %u\n"
+            "latency (us):      p50 %llu, p90 %llu, p99 %llu, p99.9 %llu, max %llu\n",
+            options.players, connectedCount, options.speakers, testTime,
+            static_cast<unsigned long long>(sentPackets), static_cast<unsigned long long>(sendErrors),
+            static_cast<unsigned long long>(receivedPackets), receivedPackets / testTime,
+            8.0 * receivedBytes / testTime / 1000.0,
+            static_cast<unsigned long long>(lostPackets), lossRatio,
+            static_cast<unsigned long long>(latePackets),
+            static_cast<unsigned long long>(invalidPackets), silentCount,
+            static_cast<unsigned long long>(latency.GetPercentile(50.0)),
+            static_cast<unsigned long long>(latency.GetPercentile(90.0)),
+            static_cast<unsigned long long>(latency.GetPercentile(99.0)),
+            static_cast<unsigned long long>(latency.GetPercentile(99.9)),
+            static_cast<unsigned long long>(latency.max));
+    }
+
+    bool WriteJson(const std::vector<std::unique_ptr<Player>>& players,
+                   const Options& options, const double testTime) noexcept
+    {
+        const auto file = std::fopen(options.jsonFile.c_str(), "w");
+        if (file == nullptr) return false;
+
+        std::fprintf(file, "{\"players\":%u,\"speakers\":%u,\"bitrate\":%u,\"duration\":%.3f,\"listeners\":[",
+            options.players, options.speakers, options.bitrate, testTime);
+
+        for (std::size_t i = 0; i < players.size(); ++i)
+        {
+            const auto& player = *players[i];
+
+            Histogram::Snapshot latency;
+            player.GetLatency().MergeTo(latency);
+
+            std::fprintf(file, "%s{\"id\":%hu,\"speaker\":%s,\"connected\":%s,\"sent\":%llu,\"received\":%llu,"
+                "\"bytes\":%llu,\"lost\":%llu,\"late\":%llu,\"invalid\":%llu,"
+                "\"latency\":{\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"max\":%llu}}",
+                i != 0 ? "," : "", player.GetPlayerId(), player.IsSpeaker() ? "true" : "false",
+                player.GetState() == Player::State::connected ? "true" : "false",
+                static_cast<unsigned long long>(player.GetSentPackets()),
+                static_cast<unsigned long long>(player.GetReceivedPackets()),
+                static_cast<unsigned long long>(player.GetReceivedBytes()),
+                static_cast<unsigned long long>(player.GetLostPackets()),
+                static_cast<unsigned long long>(player.GetLatePackets()),
+                static_cast<unsigned long long>(player.GetInvalidPackets()),
+                static_cast<unsigned long long>(latency.GetPercentile(50.0)),
+                static_cast<unsigned long long>(latency.GetPercentile(90.0)),
+                static_cast<unsigned long long>(latency.GetPercentile(99.0)),
+                static_cast<unsigned long long>(latency.max));
+        }
+
+        std::fputs("]}\n", file);
+        std::fclose(file);
+
+        return true;
+    }
+}
+
+int main(const int argc, char** const argv)
+{
+    Options options;
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    in_addr hostAddr {};
+
+    if (inet_pton(AF_INET, options.host.c_str(), &hostAddr) != 1)
+    {
+        std::fprintf(stderr, "invalid host address '%s'\n", options.host.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Every simulated player owns a voice socket
+    rlimit filesLimit {};
+
+    if (getrlimit(RLIMIT_NOFILE, &filesLimit) == 0 && filesLimit.rlim_cur < options.players + 64)
+    {
+        filesLimit.rlim_cur = std::min<rlim_t>(filesLimit.rlim_max, options.players + 64);
+        setrlimit(RLIMIT_NOFILE, &filesLimit);
+    }
+
+    if (!Link::Init(hostAddr, options.controlPort))
+    {
+        std::fprintf(stderr, "failed to open raknet stand-in link\n");
+        return EXIT_FAILURE;
+    }
+
+    Player::SetServerAddress(hostAddr);
+
+    std::vector<std::unique_ptr<Player>> players;
+    players.reserve(options.players);
+
+    for (uint32_t i = 0; i < options.players; ++i)
+        players.emplace_back(std::make_unique<Player>(options.firstId + i, i < options.speakers));
+
+    std::vector<int> pollHandles;
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < options.threads; ++i)
+        pollHandles.emplace_back(epoll_create1(0));
+
+    std::signal(SIGINT, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+
+    threads.emplace_back(ControlThread, std::cref(players), std::cref(pollHandles), options.firstId);
+
+    for (const auto pollHandle : pollHandles)
+        threads.emplace_back(ReceiverThread, std::cref(players), pollHandle);
+
+    std::printf("loadgen: %u players (%u speakers), %u bps, stand-in %s:%hu\n",
+        options.players, options.speakers, options.bitrate, options.host.c_str(), options.controlPort);
+
+    using Clock = std::chrono::steady_clock;
+
+    std::mt19937 genRandom { std::random_device {}() };
+    std::uniform_int_distribution<int32_t> genJitter { -15, 15 };
+
+    const uint32_t payloadSize = options.bitrate * kVoiceInterval / 8000;
+    const auto voiceInterval = std::chrono::milliseconds(kVoiceInterval);
+    const auto keepAliveInterval = std::chrono::milliseconds(kKeepAliveInterval);
+    const auto rampTime = std::chrono::milliseconds(1000ull * options.players / options.rampRate);
+
+    const auto beginTime = Clock::now();
+    const auto endTime = beginTime + rampTime + std::chrono::seconds(options.duration);
+
+    // Players are spread evenly over the interval so that
+    // the server sees steady flow instead of bursts
+    std::vector<Clock::time_point> voiceTimes(options.players);
+    std::vector<Clock::time_point> keepAliveTimes(options.players);
+
+    for (uint32_t i = 0; i < options.players; ++i)
+    {
+        voiceTimes[i] = beginTime + voiceInterval * i / options.players;
+        keepAliveTimes[i] = beginTime + keepAliveInterval * i / options.players;
+    }
+
+    uint32_t connectedCount { 0 };
+    auto reportTime = beginTime;
+    auto testBeginTime = beginTime + rampTime;
+
+    while (runStatus.load(std::memory_order_relaxed))
+    {
+        const auto curTime = Clock::now();
+        if (curTime >= endTime) break;
+
+        const auto connectTarget = std::min<uint64_t>(options.players,
+            1 + options.rampRate * std::chrono::duration_cast<std::chrono::milliseconds>(curTime - beginTime).count() / 1000);
+
+        for (; connectedCount < connectTarget; ++connectedCount)
+            players[connectedCount]->Connect(options.auth, options.compact, options.simulcast);
+
+        const auto sendTime = Player::GetTime();
+
+        for (uint32_t i = 0; i < options.players; ++i)
+        {
+            auto& player = *players[i];
+
+            if (player.IsSpeaker() && curTime >= voiceTimes[i])
+            {
+                const auto jitteredSize = static_cast<int32_t>(payloadSize) * (100 + genJitter(genRandom)) / 100;
+                if (player.SendVoicePacket(jitteredSize, sendTime)) keepAliveTimes[i] = curTime + keepAliveInterval;
+                voiceTimes[i] += voiceInterval;
+            }
+
+            if (curTime >= keepAliveTimes[i])
+            {
+                player.SendKeepAlivePacket();
+                keepAliveTimes[i] += keepAliveInterval;
+            }
+        }
+
+        if (curTime - reportTime >= std::chrono::milliseconds(kReportInterval))
+        {
+            PrintProgress(players, std::chrono::duration<double>(curTime - beginTime).count());
+            reportTime = curTime;
+        }
+
+        std::this_thread::sleep_until(curTime + std::chrono::milliseconds(kSenderTickInterval));
+    }
+
+    // Let in-flight packets arrive before counting them
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    const auto testTime = std::chrono::duration<double>(std::min(Clock::now(), endTime) - testBeginTime).count();
+
+    runStatus.store(false, std::memory_order_relaxed);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    PrintReport(players, options, testTime > 0 ? testTime : 1.0);
+
+    if (!options.jsonFile.empty() && !WriteJson(players, options, testTime))
+        std::fprintf(stderr, "failed to write '%s'\n", options.jsonFile.c_str());
+
+    for (const auto& player : players)
+        player->Disconnect();
+
+    for (const auto pollHandle : pollHandles)
+        close(pollHandle);
+
+    Link::Free();
+
+    return EXIT_SUCCESS;
+}
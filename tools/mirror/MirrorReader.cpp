@@ -0,0 +1,116 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "MirrorReader.h"
+
+#include <chrono>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MirrorReader::~MirrorReader() noexcept
+{
+    this->Detach();
+}
+
+bool MirrorReader::Attach(const std::string& shmName) noexcept
+{
+    this->Detach();
+
+    const int shmHandle = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (shmHandle == -1) return false;
+
+    struct stat shmInfo {};
+    void* shared { MAP_FAILED };
+
+    if (fstat(shmHandle, &shmInfo) == 0 && shmInfo.st_size >= static_cast<off_t>(sizeof(Mirror::Shared)))
+        shared = mmap(nullptr, sizeof(Mirror::Shared), PROT_READ, MAP_SHARED, shmHandle, 0);
+
+    close(shmHandle);
+
+    if (shared == MAP_FAILED) return false;
+
+    const auto sharedPtr = static_cast<const Mirror::Shared*>(shared);
+
+    // Signature is written last, segment of the plugin being loaded may have none yet
+    if (sharedPtr->signature != Mirror::kSignature || sharedPtr->version != Mirror::kVersion ||
+        sharedPtr->maxPlayers != Mirror::kMaxPlayers || sharedPtr->maxStreams != Mirror::kMaxStreams)
+    {
+        munmap(shared, sizeof(Mirror::Shared));
+        return false;
+    }
+
+    this->shared = sharedPtr;
+
+    return true;
+}
+
+void MirrorReader::Detach() noexcept
+{
+    if (this->shared == nullptr) return;
+
+    munmap(const_cast<Mirror::Shared*>(this->shared), sizeof(Mirror::Shared));
+    this->shared = nullptr;
+}
+
+bool MirrorReader::IsAttached() const noexcept
+{
+    return this->shared != nullptr;
+}
+
+bool MirrorReader::IsAlive() const noexcept
+{
+    return this->shared != nullptr && !this->shared->pluginClosed.load(std::memory_order_acquire) &&
+        MirrorReader::GetTime() - this->shared->pluginHeartbeat.load(std::memory_order_acquire) < Mirror::kHeartbeatTimeout;
+}
+
+uint64_t MirrorReader::GetChanges() const noexcept
+{
+    return this->shared != nullptr ? this->shared->changes.load(std::memory_order_acquire) : 0;
+}
+
+uint32_t MirrorReader::GetStreamsLimit() const noexcept
+{
+    return this->shared != nullptr ? this->shared->streamsLimit.load(std::memory_order_acquire) : 0;
+}
+
+bool MirrorReader::ReadPlayer(const uint16_t playerId, Mirror::PlayerRecord& record) const noexcept
+{
+    if (this->shared == nullptr || playerId >= Mirror::kMaxPlayers) return false;
+
+    return this->shared->players[playerId].Load(record) && record.status;
+}
+
+bool MirrorReader::ReadStream(const uint32_t stream, Mirror::StreamRecord& record) const noexcept
+{
+    // Slot may already hold the stream that reused it
+    return stream != 0 && this->ReadStreamSlot(Mirror::GetStreamSlot(stream), record) && record.handle == stream;
+}
+
+bool MirrorReader::ReadStreamSlot(const uint32_t slot, Mirror::StreamRecord& record, uint32_t* const sequence) const noexcept
+{
+    if (this->shared == nullptr || slot >= Mirror::kMaxStreams) return false;
+
+    return this->shared->streams[slot].Load(record, sequence) && record.handle != 0;
+}
+
+uint32_t MirrorReader::GetStreamSlotSequence(const uint32_t slot) const noexcept
+{
+    if (this->shared == nullptr || slot >= Mirror::kMaxStreams) return 0;
+
+    return this->shared->streams[slot].GetSequence();
+}
+
+int64_t MirrorReader::GetTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
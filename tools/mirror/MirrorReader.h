@@ -0,0 +1,66 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <MirrorProtocol.h>
+
+// Reader of the state mirror that plugin keeps in shared memory. Once attached
+// nothing here makes syscalls, every read copies one record under its sequence
+// lock. Segment is mapped read-only, any number of readers may attach to it.
+// Reader should re-attach when IsAlive() turns false, plugin that is loaded
+// again creates a new segment under the same name.
+class MirrorReader {
+
+    MirrorReader(const MirrorReader&) = delete;
+    MirrorReader(MirrorReader&&) = delete;
+    MirrorReader& operator=(const MirrorReader&) = delete;
+    MirrorReader& operator=(MirrorReader&&) = delete;
+
+public:
+
+    MirrorReader() noexcept = default;
+    ~MirrorReader() noexcept;
+
+public:
+
+    bool Attach(const std::string& shmName) noexcept;
+    void Detach() noexcept;
+
+    bool IsAttached() const noexcept;
+
+    // Plugin is neither unloaded nor hung
+    bool IsAlive() const noexcept;
+
+    // Same value means nothing has been changed since the previous call
+    uint64_t GetChanges() const noexcept;
+
+    // Streams occupy slots below this one
+    uint32_t GetStreamsLimit() const noexcept;
+
+    // Return false for players and streams that are gone or
+    // if the record kept changing for all attempts to copy it
+    bool ReadPlayer(uint16_t playerId, Mirror::PlayerRecord& record) const noexcept;
+    bool ReadStream(uint32_t stream, Mirror::StreamRecord& record) const noexcept;
+
+    // Slot-wise access for walking all streams, 'sequence' lets caller
+    // skip the records that haven't changed since it read them last time
+    bool ReadStreamSlot(uint32_t slot, Mirror::StreamRecord& record, uint32_t* sequence = nullptr) const noexcept;
+    uint32_t GetStreamSlotSequence(uint32_t slot) const noexcept;
+
+    static int64_t GetTime() noexcept;
+
+private:
+
+    const Mirror::Shared* shared { nullptr };
+
+};
@@ -0,0 +1,326 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+
+#include <Header.h>
+#include <Histogram.h>
+
+#include "MirrorReader.h"
+
+namespace
+{
+    constexpr uint32_t kAttachInterval = 500;
+
+    struct Options
+    {
+        std::string shmName { SV::kMirrorShmName };
+        uint32_t watchInterval { 0 };
+        uint32_t benchTime { 0 };
+    };
+
+    std::atomic_bool runStatus { true };
+
+    void Usage(const char* const program) noexcept
+    {
+        std::printf(
+            "usage: %s [options]\n"
+            "  --shm <name>         shared memory created by plugin (default %s)\n"
+            "  --watch <ms>         print changed records every interval until interrupted\n"
+            "  --bench <sec>        read whole state over and over and print read latency\n"
+            "without --watch and --bench current state is printed once\n",
+            program, SV::kMirrorShmName);
+    }
+
+    bool ParseOptions(const int argc, char** const argv, Options& options) noexcept
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option { argv[i] };
+            const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (value == nullptr) return false;
+
+            if (option == "--shm") options.shmName = value;
+            else if (option == "--watch") options.watchInterval = std::atoi(value);
+            else if (option == "--bench") options.benchTime = std::atoi(value);
+            else return false;
+
+            ++i;
+        }
+
+        return true;
+    }
+
+    const char* GetStreamTypeName(const uint16_t type) noexcept
+    {
+        switch (type)
+        {
+            case SV::ControlPacketType::createGStream: return "global";
+            case SV::ControlPacketType::createLPStream: return "point";
+            case SV::ControlPacketType::createLStreamAtVehicle: return "vehicle";
+            case SV::ControlPacketType::createLStreamAtPlayer: return "player";
+            case SV::ControlPacketType::createLStreamAtObject: return "object";
+        }
+
+        return "unknown";
+    }
+
+    void PrintPlayer(const uint16_t playerId, const Mirror::PlayerRecord& record) noexcept
+    {
+        in_addr address {};
+        address.s_addr = record.address;
+
+        uint32_t keysCount { 0 };
+        for (const auto keysWord : record.keys)
+            keysCount += __builtin_popcountll(keysWord);
+
+        std::printf("player %hu: version %u, micro %u, mute %u, record %u, keys %u, address %s:%hu\n",
+            playerId, record.pluginVersion, record.microStatus, record.muteStatus, record.recordStatus,
+            keysCount, record.address != 0 ? inet_ntoa(address) : "-", ntohs(record.port));
+    }
+
+    void PrintStream(const Mirror::StreamRecord& record) noexcept
+    {
+        std::printf("stream %08x: %s, listeners %u, speakers %u, mix %u, record %u",
+            record.handle, GetStreamTypeName(record.type), record.listenersCount,
+            record.speakersCount, record.mixMode, record.recordStatus);
+
+        if (record.type != SV::ControlPacketType::createGStream)
+            std::printf(", distance %.1f", record.distance);
+
+        if (record.type == SV::ControlPacketType::createLPStream)
+            std::printf(", position %.1f %.1f %.1f", record.position[0], record.position[1], record.position[2]);
+        else if (record.target != Mirror::kNoneTarget)
+            std::printf(", target %u", record.target);
+
+        std::putchar('\n');
+    }
+
+    void PrintState(const MirrorReader& reader) noexcept
+    {
+        Mirror::PlayerRecord playerRecord;
+        Mirror::StreamRecord streamRecord;
+
+        for (uint16_t playerId = 0; playerId < Mirror::kMaxPlayers; ++playerId)
+        {
+            if (reader.ReadPlayer(playerId, playerRecord))
+                PrintPlayer(playerId, playerRecord);
+        }
+
+        const auto streamsLimit = reader.GetStreamsLimit();
+
+        for (uint32_t slot = 0; slot < streamsLimit; ++slot)
+        {
+            if (reader.ReadStreamSlot(slot, streamRecord))
+                PrintStream(streamRecord);
+        }
+    }
+
+    // Records are compared to the copies of the previous pass,
+    // stream slots are skipped while their sequence stays the same
+    void Watch(MirrorReader& reader, const std::string& shmName, const uint32_t interval) noexcept
+    {
+        std::array<Mirror::PlayerRecord, Mirror::kMaxPlayers> players {};
+        std::array<uint32_t, Mirror::kMaxStreams> sequences {};
+        std::array<uint32_t, Mirror::kMaxStreams> handles {};
+
+        uint64_t changes { UINT64_MAX };
+
+        while (runStatus.load(std::memory_order_relaxed))
+        {
+            if (!reader.IsAlive())
+            {
+                if (reader.IsAttached()) std::printf("plugin is gone\n");
+
+                reader.Detach();
+
+                if (!reader.Attach(shmName))
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(kAttachInterval));
+                    continue;
+                }
+
+                std::printf("attached to %s\n", shmName.c_str());
+
+                players.fill({});
+                sequences.fill(0);
+                handles.fill(0);
+                changes = UINT64_MAX;
+            }
+
+            if (const auto curChanges = reader.GetChanges(); curChanges != changes)
+            {
+                changes = curChanges;
+
+                Mirror::PlayerRecord playerRecord;
+                Mirror::StreamRecord streamRecord;
+
+                for (uint16_t playerId = 0; playerId < Mirror::kMaxPlayers; ++playerId)
+                {
+                    if (!reader.ReadPlayer(playerId, playerRecord)) playerRecord = {};
+                    if (std::memcmp(&playerRecord, &players[playerId], sizeof(playerRecord)) == 0) continue;
+
+                    if (playerRecord.status) PrintPlayer(playerId, playerRecord);
+                    else std::printf("player %hu: gone\n", playerId);
+
+                    players[playerId] = playerRecord;
+                }
+
+                const auto streamsLimit = reader.GetStreamsLimit();
+
+                for (uint32_t slot = 0; slot < streamsLimit; ++slot)
+                {
+                    if (reader.GetStreamSlotSequence(slot) == sequences[slot]) continue;
+
+                    // Sequence stays the same if the record kept changing, it's read next time
+                    auto sequence = sequences[slot];
+                    const bool streamStatus = reader.ReadStreamSlot(slot, streamRecord, &sequence);
+
+                    if (sequence == sequences[slot]) continue;
+
+                    sequences[slot] = sequence;
+
+                    if (streamStatus)
+                    {
+                        if (handles[slot] != 0 && handles[slot] != streamRecord.handle)
+                            std::printf("stream %08x: deleted\n", handles[slot]);
+
+                        PrintStream(streamRecord);
+                        handles[slot] = streamRecord.handle;
+                    }
+                    else if (handles[slot] != 0)
+                    {
+                        std::printf("stream %08x: deleted\n", handles[slot]);
+                        handles[slot] = 0;
+                    }
+                }
+
+                std::fflush(stdout);
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+        }
+    }
+
+    // Every pass copies all players and all streams as a consumer
+    // that needs a consistent view of each record would do
+    void RunBench(const MirrorReader& reader, const uint32_t benchTime) noexcept
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Histogram passTimes;
+        Histogram recordTimes;
+
+        uint64_t passesCount { 0 };
+        uint64_t recordsCount { 0 };
+        uint64_t failedLoads { 0 };
+
+        const auto beginChanges = reader.GetChanges();
+        const auto beginTime = Clock::now();
+        const auto endTime = beginTime + std::chrono::seconds(benchTime);
+
+        Mirror::PlayerRecord playerRecord;
+        Mirror::StreamRecord streamRecord;
+
+        while (runStatus.load(std::memory_order_relaxed) && Clock::now() < endTime)
+        {
+            const auto passBeginTime = Clock::now();
+            uint32_t passRecords { 0 };
+
+            for (uint16_t playerId = 0; playerId < Mirror::kMaxPlayers; ++playerId)
+            {
+                reader.ReadPlayer(playerId, playerRecord);
+                ++passRecords;
+            }
+
+            const auto streamsLimit = reader.GetStreamsLimit();
+
+            for (uint32_t slot = 0; slot < streamsLimit; ++slot)
+            {
+                // Failure to copy is told apart from empty slot by its sequence
+                if (!reader.ReadStreamSlot(slot, streamRecord) && reader.GetStreamSlotSequence(slot) & 1)
+                    ++failedLoads;
+
+                ++passRecords;
+            }
+
+            const auto passTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - passBeginTime).count();
+
+            passTimes.Record(passTime);
+            recordTimes.Record(passTime / passRecords);
+
+            ++passesCount;
+            recordsCount += passRecords;
+        }
+
+        Histogram::Snapshot passSnapshot;
+        Histogram::Snapshot recordSnapshot;
+
+        passTimes.MergeTo(passSnapshot);
+        recordTimes.MergeTo(recordSnapshot);
+
+        const auto elapsedTime = std::chrono::duration<double>(Clock::now() - beginTime).count();
+
+        std::printf("passes %llu (%llu records), state changes %llu, failed stream loads %llu\n",
+            static_cast<unsigned long long>(passesCount), static_cast<unsigned long long>(recordsCount),
+            static_cast<unsigned long long>(reader.GetChanges() - beginChanges),
+            static_cast<unsigned long long>(failedLoads));
+        std::printf("whole state: p50 %.1f us, p99 %.1f us, max %.1f us\n",
+            passSnapshot.GetPercentile(50.0) / 1000.0, passSnapshot.GetPercentile(99.0) / 1000.0,
+            passSnapshot.max / 1000.0);
+        std::printf("per record: p50 %llu ns, p99 %llu ns, %.1f M records/s\n",
+            static_cast<unsigned long long>(recordSnapshot.GetPercentile(50.0)),
+            static_cast<unsigned long long>(recordSnapshot.GetPercentile(99.0)),
+            recordsCount / elapsedTime / 1e6);
+    }
+}
+
+int main(const int argc, char** const argv)
+{
+    Options options;
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+    std::signal(SIGTERM, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+
+    MirrorReader reader;
+
+    if (options.watchInterval != 0)
+    {
+        Watch(reader, options.shmName, options.watchInterval);
+        return EXIT_SUCCESS;
+    }
+
+    if (!reader.Attach(options.shmName) || !reader.IsAlive())
+    {
+        std::fprintf(stderr, "no plugin mirrors its state to '%s'\n", options.shmName.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (options.benchTime != 0) RunBench(reader, options.benchTime);
+    else PrintState(reader);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,292 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Link.h"
+
+#include <chrono>
+#include <cstring>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <util/logger.h>
+
+namespace
+{
+    constexpr int64_t kRetryInterval = 500;
+    constexpr int kSocketBufferSize = 4 * 1024 * 1024;
+}
+
+bool Link::Init(const uint16_t port, const std::string& shmName, const std::string& socketPath) noexcept
+{
+    if (shmName.empty() && socketPath.empty())
+        return false;
+
+    Link::port = port;
+    Link::shmName = shmName;
+    Link::socketPath = socketPath;
+    Link::attachTime = Link::GetTime() - kRetryInterval;
+
+    Logger::Log("[sv:dbg:link:init] : waiting for plugin (shm:%s, socket:%s)",
+        shmName.c_str(), socketPath.c_str());
+
+    return true;
+}
+
+void Link::Free() noexcept
+{
+    Link::Detach();
+}
+
+bool Link::Process() noexcept
+{
+    const auto curTime = Link::GetTime();
+
+    if (Link::attachStatus.load(std::memory_order_relaxed))
+    {
+        if (Link::shared != nullptr)
+        {
+            Link::shared->relayHeartbeat.store(curTime, std::memory_order_release);
+
+            if (Link::shared->pluginClosed.load(std::memory_order_acquire) || curTime -
+                Link::shared->pluginHeartbeat.load(std::memory_order_acquire) >= Relay::kHeartbeatTimeout)
+            {
+                Logger::Log("[sv:err:link:process] : plugin is gone, waiting for it to come back");
+                Link::Detach();
+            }
+        }
+        else if (Link::lostStatus.load(std::memory_order_relaxed))
+        {
+            Logger::Log("[sv:err:link:process] : plugin closed connection, waiting for it to come back");
+            Link::Detach();
+        }
+
+        if (Link::attachStatus.load(std::memory_order_relaxed))
+            return false;
+    }
+
+    if (curTime - Link::attachTime < kRetryInterval)
+        return false;
+
+    Link::attachTime = curTime;
+
+    if (!Link::AttachShared() && !Link::AttachSocket())
+        return false;
+
+    const Relay::HelloRecord helloRecord { Relay::kVersion, Link::port };
+    Link::Write(Relay::RecordType::hello, &helloRecord, sizeof(helloRecord));
+
+    return true;
+}
+
+bool Link::Read(uint8_t& type, void* const buffer, uint32_t& size) noexcept
+{
+    if (!Link::attachStatus.load(std::memory_order_relaxed))
+        return false;
+
+    if (Link::shared != nullptr)
+        return Link::shared->downstream.Read(type, buffer, size);
+
+    Relay::RecordHeader recordHeader;
+
+    iovec buffers[2] {
+        { &recordHeader, sizeof(recordHeader) },
+        { buffer, Relay::kMaxRecordSize }
+    };
+
+    msghdr message {};
+
+    message.msg_iov = buffers;
+    message.msg_iovlen = 2;
+
+    const auto result = recvmsg(Link::socketHandle, &message, MSG_DONTWAIT);
+
+    if (result == 0 || (result == -1 && errno != EAGAIN && errno != EWOULDBLOCK))
+        Link::lostStatus.store(true, std::memory_order_relaxed);
+
+    if (result < static_cast<decltype(result)>(sizeof(recordHeader)) ||
+        recordHeader.size != result - sizeof(recordHeader))
+        return false;
+
+    type = recordHeader.type;
+    size = recordHeader.size;
+
+    return true;
+}
+
+bool Link::Write(const uint8_t type, const void* const header, const uint32_t headerSize,
+    const void* const payload, const uint32_t payloadSize) noexcept
+{
+    if (!Link::attachStatus.load(std::memory_order_acquire))
+        return false;
+
+    const std::lock_guard<std::mutex> lock { Link::writeMutex };
+
+    if (Link::shared != nullptr)
+        return Link::shared->upstream.Write(type, header, headerSize, payload, payloadSize);
+
+    if (Link::socketHandle == -1 || sizeof(Relay::RecordHeader) +
+        headerSize + payloadSize > Relay::kMaxRecordSize)
+        return false;
+
+    const Relay::RecordHeader recordHeader { static_cast<uint16_t>(headerSize + payloadSize), type, 0 };
+
+    iovec buffers[3] {
+        { const_cast<Relay::RecordHeader*>(&recordHeader), sizeof(recordHeader) },
+        { const_cast<void*>(header), headerSize },
+        { const_cast<void*>(payload), payloadSize }
+    };
+
+    msghdr message {};
+
+    message.msg_iov = buffers;
+    message.msg_iovlen = 3;
+
+    const auto result = sendmsg(Link::socketHandle, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (result == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+        Link::lostStatus.store(true, std::memory_order_relaxed);
+
+    return result == static_cast<decltype(result)>(sizeof(recordHeader) + headerSize + payloadSize);
+}
+
+bool Link::AttachShared() noexcept
+{
+    if (Link::shmName.empty()) return false;
+
+    const int shmHandle = shm_open(Link::shmName.c_str(), O_RDWR, 0);
+    if (shmHandle == -1) return false;
+
+    struct stat shmInfo {};
+    void* shared { MAP_FAILED };
+
+    if (fstat(shmHandle, &shmInfo) == 0 && shmInfo.st_size >= static_cast<off_t>(sizeof(Relay::Shared)))
+        shared = mmap(nullptr, sizeof(Relay::Shared), PROT_READ | PROT_WRITE, MAP_SHARED, shmHandle, 0);
+
+    close(shmHandle);
+
+    if (shared == MAP_FAILED) return false;
+
+    const auto sharedPtr = static_cast<Relay::Shared*>(shared);
+    const auto curTime = Link::GetTime();
+
+    if (sharedPtr->signature != Relay::kSignature || sharedPtr->version != Relay::kVersion)
+    {
+        static Logger::Limiter versionLimiter { 1, 60 };
+
+        Logger::Log(versionLimiter, "[sv:err:link:attach] : shared memory (%s) has unknown format (version:%u)",
+            Link::shmName.c_str(), sharedPtr->version);
+
+        munmap(shared, sizeof(Relay::Shared));
+        return false;
+    }
+
+    // Segment of the plugin that crashed stays until the next one replaces it
+    if (sharedPtr->pluginClosed.load(std::memory_order_acquire) || curTime -
+        sharedPtr->pluginHeartbeat.load(std::memory_order_acquire) >= Relay::kHeartbeatTimeout)
+    {
+        munmap(shared, sizeof(Relay::Shared));
+        return false;
+    }
+
+    // Records written for the previous relay are dropped,
+    // plugin answers the new epoch with full state
+    sharedPtr->downstream.Skip();
+    sharedPtr->relayHeartbeat.store(curTime, std::memory_order_release);
+    const auto relayEpoch = sharedPtr->relayEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    Link::shared = sharedPtr;
+    Link::lostStatus.store(false, std::memory_order_relaxed);
+    Link::attachStatus.store(true, std::memory_order_release);
+
+    Logger::Log("[sv:dbg:link:attach] : attached to plugin on shared memory (%s, epoch:%u)",
+        Link::shmName.c_str(), relayEpoch);
+
+    return true;
+}
+
+bool Link::AttachSocket() noexcept
+{
+    sockaddr_un connectAddr {};
+
+    if (Link::socketPath.empty() || Link::socketPath.size() >= sizeof(connectAddr.sun_path))
+        return false;
+
+    const int socketHandle = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socketHandle == -1) return false;
+
+    connectAddr.sun_family = AF_UNIX;
+    std::memcpy(connectAddr.sun_path, Link::socketPath.c_str(), Link::socketPath.size());
+
+    if (connect(socketHandle, reinterpret_cast<sockaddr*>(&connectAddr), sizeof(connectAddr)) == -1)
+    {
+        close(socketHandle);
+        return false;
+    }
+
+    fcntl(socketHandle, F_SETFL, fcntl(socketHandle, F_GETFL) | O_NONBLOCK);
+
+    setsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, &kSocketBufferSize, sizeof(kSocketBufferSize));
+    setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, &kSocketBufferSize, sizeof(kSocketBufferSize));
+
+    {
+        const std::lock_guard<std::mutex> lock { Link::writeMutex };
+        Link::socketHandle = socketHandle;
+    }
+
+    Link::lostStatus.store(false, std::memory_order_relaxed);
+    Link::attachStatus.store(true, std::memory_order_release);
+
+    Logger::Log("[sv:dbg:link:attach] : connected to plugin on socket (%s)", Link::socketPath.c_str());
+
+    return true;
+}
+
+void Link::Detach() noexcept
+{
+    Link::attachStatus.store(false, std::memory_order_release);
+
+    const std::lock_guard<std::mutex> lock { Link::writeMutex };
+
+    if (Link::shared != nullptr)
+    {
+        munmap(Link::shared, sizeof(Relay::Shared));
+        Link::shared = nullptr;
+    }
+
+    if (Link::socketHandle != -1)
+    {
+        close(Link::socketHandle);
+        Link::socketHandle = -1;
+    }
+}
+
+int64_t Link::GetTime() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint16_t Link::port { 0 };
+std::string Link::shmName;
+std::string Link::socketPath;
+
+Relay::Shared* Link::shared { nullptr };
+int Link::socketHandle { -1 };
+
+std::atomic_bool Link::attachStatus { false };
+std::atomic_bool Link::lostStatus { false };
+int64_t Link::attachTime { 0 };
+
+std::mutex Link::writeMutex;
@@ -0,0 +1,75 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <RelayProtocol.h>
+
+// Relay side of the link to plugin. Shared memory created by plugin is
+// tried first, unix socket is the fallback. Plugin that went away (closed,
+// restarted or stopped updating its heartbeat) is looked for anew.
+class Link {
+
+    Link() = delete;
+    ~Link() = delete;
+    Link(const Link&) = delete;
+    Link(Link&&) = delete;
+    Link& operator=(const Link&) = delete;
+    Link& operator=(Link&&) = delete;
+
+public:
+
+    static bool Init(uint16_t port, const std::string& shmName, const std::string& socketPath) noexcept;
+    static void Free() noexcept;
+
+    // Called by control thread, returns true when plugin has been (re)attached
+    // and relay has to drop its state, plugin sends it anew
+    static bool Process() noexcept;
+
+    static inline bool IsAttached() noexcept
+    {
+        return Link::attachStatus.load(std::memory_order_acquire);
+    }
+
+    // Plugin records are read by control thread only
+    static bool Read(uint8_t& type, void* buffer, uint32_t& size) noexcept;
+
+    // Callable from any thread
+    static bool Write(uint8_t type, const void* header, uint32_t headerSize,
+        const void* payload = nullptr, uint32_t payloadSize = 0) noexcept;
+
+private:
+
+    static bool AttachShared() noexcept;
+    static bool AttachSocket() noexcept;
+    static void Detach() noexcept;
+
+    static int64_t GetTime() noexcept;
+
+private:
+
+    static uint16_t port;
+    static std::string shmName;
+    static std::string socketPath;
+
+    static Relay::Shared* shared;
+    static int socketHandle;
+
+    static std::atomic_bool attachStatus;
+    static std::atomic_bool lostStatus;
+    static int64_t attachTime;
+
+    static std::mutex writeMutex;
+
+};
@@ -0,0 +1,801 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include "Router.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <util/logger.h>
+#include <util/siphash.h>
+
+#include <RateLimiter.h>
+#include <Metrics.h>
+#include <Latency.h>
+
+#include "Link.h"
+
+namespace
+{
+    constexpr uint32_t kReceiveBatchSize = 32;
+
+    inline uint64_t MakeKey(const uint32_t address, const uint32_t svrkey) noexcept
+    {
+        return static_cast<uint64_t>(address) << 32 | static_cast<uint64_t>(svrkey);
+    }
+}
+
+bool Router::Init(const uint16_t port) noexcept
+{
+    if (Router::socketHandle != -1) return false;
+
+    if ((Router::socketHandle = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP)) == -1)
+    {
+        Logger::Log("[sv:err:router:init] : socket error (code:%d)", errno);
+        return false;
+    }
+
+    setsockopt(Router::socketHandle, SOL_SOCKET, SO_SNDBUF, &kSocketBufferSize, sizeof(kSocketBufferSize));
+    setsockopt(Router::socketHandle, SOL_SOCKET, SO_RCVBUF, &kSocketBufferSize, sizeof(kSocketBufferSize));
+
+    sockaddr_in bindAddr {};
+
+    bindAddr.sin_family = AF_INET;
+    bindAddr.sin_addr.s_addr = INADDR_ANY;
+    bindAddr.sin_port = htons(port);
+
+    if (bind(Router::socketHandle, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) == -1)
+    {
+        Logger::Log("[sv:err:router:init] : bind error (port:%hu, code:%d)", port, errno);
+        close(Router::socketHandle);
+        Router::socketHandle = -1;
+        return false;
+    }
+
+    Logger::Log("[sv:dbg:router:init] : voice socket bound to port %hu", port);
+
+    return true;
+}
+
+void Router::Free() noexcept
+{
+    if (Router::socketHandle == -1) return;
+
+    close(Router::socketHandle);
+    Router::socketHandle = -1;
+
+    Router::Reset();
+}
+
+void Router::Reset() noexcept
+{
+    const std::unique_lock<std::shared_mutex> lock { Router::stateMutex };
+
+    for (auto& player : Router::players)
+    {
+        player.status = false;
+        player.speakStatus = false;
+        player.speakerStreams.clear();
+        player.endpoint.store(0, std::memory_order_relaxed);
+    }
+
+    Router::playerKeyTable.clear();
+    Router::streamTable.clear();
+}
+
+void Router::ApplyRecord(const uint8_t type, const uint8_t* const buffer, const uint32_t size) noexcept
+{
+    // Packets from mixers, sources and players of plugin's own streams
+    if (type == Relay::RecordType::voicePacket)
+    {
+        if (size < sizeof(Relay::PlayerRecord) + sizeof(VoicePacket)) return;
+
+        Relay::PlayerRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+        alignas(VoicePacket) uint8_t packetBuffer[Relay::kMaxRecordSize];
+        std::memcpy(packetBuffer, buffer + sizeof(record), size - sizeof(record));
+
+        const auto voicePacket = reinterpret_cast<const VoicePacket*>(packetBuffer);
+        if (voicePacket->GetFullSize() != size - sizeof(record)) return;
+        if (record.player >= MAX_PLAYERS) return;
+
+        const std::shared_lock<std::shared_mutex> lock { Router::stateMutex };
+
+        auto& player = Router::players[record.player];
+        if (!player.status) return;
+
+        const auto endpoint = player.endpoint.load(std::memory_order_acquire);
+        if (endpoint == 0) return;
+
+        auto playerAddr = Router::GetEndpointAddr(endpoint);
+
+        uint8_t compactHeader[VoicePacket::kMaxCompactHeaderSize];
+
+        iovec buffers[2] {};
+
+        if (player.compact)
+        {
+            buffers[0] = { compactHeader, voicePacket->WriteCompactHeader(compactHeader) };
+            buffers[1] = { const_cast<uint8_t*>(voicePacket->data), voicePacket->length };
+        }
+        else
+        {
+            buffers[0] = { const_cast<VoicePacket*>(voicePacket), voicePacket->GetFullSize() };
+        }
+
+        msghdr message {};
+
+        message.msg_name = &playerAddr;
+        message.msg_namelen = sizeof(playerAddr);
+        message.msg_iov = buffers;
+        message.msg_iovlen = player.compact ? 2 : 1;
+
+        const auto packetSize = buffers[0].iov_len + buffers[1].iov_len;
+
+        if (sendmsg(Router::socketHandle, &message, MSG_DONTWAIT) == static_cast<ssize_t>(packetSize))
+        {
+            player.activityTime.store(Timer::Get(), std::memory_order_relaxed);
+
+            Metrics::Add(StatType::voicePacketsForwarded);
+            Metrics::Add(StatType::voiceBytesForwarded, packetSize);
+        }
+        else Metrics::Add(StatType::voicePacketsSendErrors);
+
+        return;
+    }
+
+    if (type == Relay::RecordType::reset)
+    {
+        Router::Reset();
+        return;
+    }
+
+    const std::unique_lock<std::shared_mutex> lock { Router::stateMutex };
+
+    switch (type)
+    {
+        case Relay::RecordType::voiceAuthMode:
+        {
+            if (size < sizeof(Relay::VoiceAuthModeRecord)) break;
+
+            Relay::VoiceAuthModeRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            Router::voiceAuthMode.store(record.mode, std::memory_order_relaxed);
+        } break;
+        case Relay::RecordType::rateLimit:
+        {
+            if (size < sizeof(Relay::RateLimitRecord)) break;
+
+            Relay::RateLimitRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            RateLimiter::SetLimits(record.packetsPerSecond, record.bytesPerSecond, record.burstTime);
+        } break;
+        case Relay::RecordType::playerConnect:
+        {
+            if (size < sizeof(Relay::PlayerConnectRecord)) break;
+
+            Relay::PlayerConnectRecord record; std::memcpy(&record, buffer, sizeof(record));
+            if (record.player >= MAX_PLAYERS) break;
+
+            Router::RemovePlayer(record.player);
+
+            auto& player = Router::players[record.player];
+
+            player.status = true;
+            player.svrkey = record.svrkey;
+            player.address = record.address;
+            player.compact = record.compact != 0;
+            player.authStatus = record.auth != 0;
+            player.k0 = record.k0;
+            player.k1 = record.k1;
+            player.speakStatus = false;
+
+            sockaddr_in endpointAddr {};
+
+            endpointAddr.sin_addr.s_addr = record.endpointAddress;
+            endpointAddr.sin_port = record.endpointPort;
+
+            player.endpoint.store(record.endpointAddress != NULL ? Router::MakeEndpoint(endpointAddr) : 0, std::memory_order_relaxed);
+            player.lastPackid.store(0, std::memory_order_relaxed);
+            player.activityTime.store(Timer::Get(), std::memory_order_relaxed);
+
+            Router::playerKeyTable[MakeKey(record.address, record.svrkey)] = record.player;
+
+            RateLimiter::ResetPlayer(record.player);
+        } break;
+        case Relay::RecordType::playerDisconnect:
+        {
+            if (size < sizeof(Relay::PlayerRecord)) break;
+
+            Relay::PlayerRecord record; std::memcpy(&record, buffer, sizeof(record));
+            if (record.player >= MAX_PLAYERS) break;
+
+            Router::RemovePlayer(record.player);
+        } break;
+        case Relay::RecordType::playerSpeak:
+        {
+            if (size < sizeof(Relay::PlayerStatusRecord)) break;
+
+            Relay::PlayerStatusRecord record; std::memcpy(&record, buffer, sizeof(record));
+            if (record.player >= MAX_PLAYERS) break;
+
+            Router::players[record.player].speakStatus = record.status != 0;
+        } break;
+        case Relay::RecordType::streamRelay:
+        {
+            if (size < sizeof(Relay::StreamStatusRecord)) break;
+
+            Relay::StreamStatusRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            Router::streamTable[record.stream].relayStatus = record.status != 0;
+        } break;
+        case Relay::RecordType::streamDelete:
+        {
+            if (size < sizeof(Relay::StreamRecord)) break;
+
+            Relay::StreamRecord record; std::memcpy(&record, buffer, sizeof(record));
+
+            if (Router::streamTable.erase(record.stream) == 0) break;
+
+            for (auto& player : Router::players)
+            {
+                const auto iter = std::find(player.speakerStreams.begin(), player.speakerStreams.end(), record.stream);
+                if (iter != player.speakerStreams.end()) player.speakerStreams.erase(iter);
+            }
+        } break;
+        case Relay::RecordType::listener:
+        {
+            if (size < sizeof(Relay::MemberRecord)) break;
+
+            Relay::MemberRecord record; std::memcpy(&record, buffer, sizeof(record));
+            if (record.player >= MAX_PLAYERS) break;
+
+            const auto iter = Router::streamTable.find(record.stream);
+            if (iter == Router::streamTable.end()) break;
+
+            auto& stream = iter->second;
+            auto& layer = stream.layers[record.player];
+
+            if (record.status == Relay::LayerStatus::detached)
+            {
+                if (layer == Relay::LayerStatus::detached) break;
+
+                const auto listenerIter = std::find(stream.listeners.begin(), stream.listeners.end(), record.player);
+                if (listenerIter != stream.listeners.end())
+                {
+                    *listenerIter = stream.listeners.back();
+                    stream.listeners.pop_back();
+                }
+            }
+            else if (layer == Relay::LayerStatus::detached)
+            {
+                stream.listeners.emplace_back(record.player);
+            }
+
+            layer = record.status;
+        } break;
+        case Relay::RecordType::speaker:
+        {
+            if (size < sizeof(Relay::MemberRecord)) break;
+
+            Relay::MemberRecord record; std::memcpy(&record, buffer, sizeof(record));
+            if (record.player >= MAX_PLAYERS) break;
+
+            auto& speakerStreams = Router::players[record.player].speakerStreams;
+            const auto iter = std::find(speakerStreams.begin(), speakerStreams.end(), record.stream);
+
+            if (record.status != 0 && iter == speakerStreams.end())
+                speakerStreams.emplace_back(record.stream);
+            else if (record.status == 0 && iter != speakerStreams.end())
+                speakerStreams.erase(iter);
+        } break;
+    }
+}
+
+void Router::ReceivePackets(const uint32_t timeout) noexcept
+{
+    pollfd pollInfo { Router::socketHandle, POLLIN, 0 };
+    if (poll(&pollInfo, 1, static_cast<int>(timeout)) <= 0) return;
+
+    struct alignas(8) PacketBuffer { uint8_t data[kMaxVoicePacketSize]; };
+
+    static thread_local std::array<PacketBuffer, kReceiveBatchSize> packetBuffers;
+    static thread_local std::array<sockaddr_in, kReceiveBatchSize> packetAddrs;
+    static thread_local std::array<iovec, kReceiveBatchSize> packetIovecs;
+    static thread_local std::array<mmsghdr, kReceiveBatchSize> packetMessages;
+
+    for (uint32_t i { 0 }; i < kReceiveBatchSize; ++i)
+    {
+        packetIovecs[i] = { packetBuffers[i].data, sizeof(packetBuffers[i].data) };
+
+        packetMessages[i].msg_hdr = {};
+        packetMessages[i].msg_hdr.msg_name = &packetAddrs[i];
+        packetMessages[i].msg_hdr.msg_namelen = sizeof(packetAddrs[i]);
+        packetMessages[i].msg_hdr.msg_iov = &packetIovecs[i];
+        packetMessages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int packetsCount = recvmmsg(Router::socketHandle, packetMessages.data(),
+        kReceiveBatchSize, MSG_DONTWAIT, nullptr);
+    if (packetsCount <= 0) return;
+
+    const auto receiveTime = Latency::Now();
+
+    for (int i { 0 }; i < packetsCount; ++i)
+    {
+        Router::HandlePacket(packetBuffers[i].data, packetMessages[i].msg_len, packetAddrs[i], receiveTime);
+    }
+}
+
+void Router::SendKeepAlives() noexcept
+{
+    VoicePacket keepAlivePacket;
+
+    keepAlivePacket.packet = SV::VoicePacketType::keepAlive;
+    keepAlivePacket.length = NULL;
+    keepAlivePacket.packid = NULL;
+    keepAlivePacket.sender = NULL;
+    keepAlivePacket.stream = NULL;
+    keepAlivePacket.svrkey = NULL;
+    keepAlivePacket.CalcHash();
+
+    // Compact keep-alive is a single flags byte
+    const uint8_t compactKeepAlivePacket { SV::VoicePacketType::keepAlive };
+
+    const auto curTime = Timer::Get();
+
+    uint32_t sendedPackets { 0 };
+
+    {
+        const std::shared_lock<std::shared_mutex> lock { Router::stateMutex };
+
+        for (uint32_t iPlayerId { Router::keepAliveSlot }; iPlayerId < MAX_PLAYERS; iPlayerId += kKeepAliveWheelSize)
+        {
+            auto& player = Router::players[iPlayerId];
+            if (!player.status) continue;
+
+            const auto endpoint = player.endpoint.load(std::memory_order_acquire);
+            if (endpoint == 0) continue;
+
+            if (curTime - player.activityTime.load(std::memory_order_relaxed) < kKeepAliveInterval)
+                continue;
+
+            const auto playerAddr = Router::GetEndpointAddr(endpoint);
+
+            if (player.compact)
+            {
+                sendto(Router::socketHandle, &compactKeepAlivePacket, sizeof(compactKeepAlivePacket), MSG_DONTWAIT,
+                    reinterpret_cast<const sockaddr*>(&playerAddr), sizeof(playerAddr));
+            }
+            else
+            {
+                sendto(Router::socketHandle, &keepAlivePacket, sizeof(keepAlivePacket), MSG_DONTWAIT,
+                    reinterpret_cast<const sockaddr*>(&playerAddr), sizeof(playerAddr));
+            }
+
+            player.activityTime.store(curTime, std::memory_order_relaxed);
+
+            ++sendedPackets;
+        }
+    }
+
+    if (sendedPackets != 0)
+        Metrics::Add(StatType::keepAlivePacketsSent, sendedPackets);
+
+    Router::keepAliveSlot = (Router::keepAliveSlot + 1) % kKeepAliveWheelSize;
+}
+
+uint32_t Router::GetPlayersCount() noexcept
+{
+    const std::shared_lock<std::shared_mutex> lock { Router::stateMutex };
+    return Router::playerKeyTable.size();
+}
+
+uint32_t Router::GetStreamsCount() noexcept
+{
+    const std::shared_lock<std::shared_mutex> lock { Router::stateMutex };
+    return Router::streamTable.size();
+}
+
+uint64_t Router::GetPassedPackets() noexcept
+{
+    return Router::passedPackets.load(std::memory_order_relaxed);
+}
+
+void Router::HandlePacket(uint8_t* const packetBuffer, const uint32_t length,
+    const sockaddr_in& playerAddr, const uint64_t receiveTime) noexcept
+{
+    Metrics::Add(StatType::voicePacketsReceived);
+    Metrics::Add(StatType::voiceBytesReceived, length);
+
+    const std::shared_lock<std::shared_mutex> lock { Router::stateMutex };
+
+    uint16_t playerId { SV::kNonePlayer };
+
+    // Same checks as plugin does for packets of its own socket
+    bool compactStatus { false };
+
+    if (length >= VoicePacket::kCompactUpstreamHeaderSize)
+    {
+        uint32_t svrkey; std::memcpy(&svrkey, packetBuffer, sizeof(svrkey));
+
+        const auto iter = Router::playerKeyTable.find(MakeKey(playerAddr.sin_addr.s_addr, svrkey));
+
+        if (iter != Router::playerKeyTable.end() && Router::players[iter->second].compact)
+        {
+            playerId = iter->second;
+            compactStatus = true;
+        }
+    }
+
+    const auto voicePacketPtr = reinterpret_cast<VoicePacket*>(packetBuffer);
+
+    uint32_t voicePacketSize { NULL };
+    bool authStatus { false };
+
+    if (compactStatus)
+    {
+        const auto& player = Router::players[playerId];
+
+        voicePacketSize = player.authStatus ? length - SV::kVoiceAuthTagSize : length;
+
+        if (player.authStatus)
+        {
+            if (length < VoicePacket::kCompactUpstreamHeaderSize + SV::kVoiceAuthTagSize)
+            {
+                Metrics::Add(StatType::voicePacketsDroppedSize);
+                return;
+            }
+
+            uint64_t tag; std::memcpy(&tag, packetBuffer + voicePacketSize, sizeof(tag));
+
+            authStatus = tag == SipHash::Calc(player.k0, player.k1, packetBuffer, voicePacketSize);
+        }
+        else
+        {
+            authStatus = Router::voiceAuthMode.load(std::memory_order_relaxed) != kVoiceAuthRequired;
+        }
+    }
+    else
+    {
+        if (length < sizeof(VoicePacket))
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return;
+        }
+
+        if (!voicePacketPtr->CheckHeader())
+        {
+            Metrics::Add(StatType::voicePacketsDroppedHash);
+            return;
+        }
+
+        voicePacketSize = voicePacketPtr->GetFullSize();
+
+        if (length != voicePacketSize && length != voicePacketSize + SV::kVoiceAuthTagSize)
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return;
+        }
+
+        const auto iter = Router::playerKeyTable.find(MakeKey(playerAddr.sin_addr.s_addr, voicePacketPtr->svrkey));
+
+        if (iter == Router::playerKeyTable.end())
+        {
+            Metrics::Add(StatType::voicePacketsDroppedKey);
+            return;
+        }
+
+        playerId = iter->second;
+
+        const auto& player = Router::players[playerId];
+
+        authStatus = player.authStatus
+            ? length == voicePacketSize + SV::kVoiceAuthTagSize && voicePacketPtr->CheckAuthTag(player.k0, player.k1)
+            : length == voicePacketSize && Router::voiceAuthMode.load(std::memory_order_relaxed) != kVoiceAuthRequired;
+    }
+
+    if (!authStatus)
+    {
+        Metrics::Add(StatType::voicePacketsDroppedAuth);
+        return;
+    }
+
+    if (!RateLimiter::CheckPacket(playerId, voicePacketSize))
+    {
+        Metrics::Add(StatType::voicePacketsDroppedThrottle);
+        return;
+    }
+
+    auto& player = Router::players[playerId];
+
+    // Plugin sends player the init packet once it learns the address
+    if (player.endpoint.load(std::memory_order_relaxed) == 0)
+    {
+        uint64_t expEndpoint { 0 };
+
+        if (player.endpoint.compare_exchange_strong(expEndpoint, Router::MakeEndpoint(playerAddr)))
+        {
+            const Relay::PlayerAddressRecord record { playerId, playerAddr.sin_addr.s_addr, playerAddr.sin_port };
+
+            // Tried again with the next packet
+            if (!Link::Write(Relay::RecordType::playerIdentified, &record, sizeof(record)))
+                player.endpoint.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    alignas(VoicePacket) static thread_local uint8_t restoredBuffer[sizeof(VoicePacket) + kMaxVoicePacketSize];
+
+    VoicePacket* voicePacket { voicePacketPtr };
+
+    if (compactStatus)
+    {
+        if ((packetBuffer[sizeof(uint32_t)] & SV::CompactFlagType::typeMask) == SV::VoicePacketType::keepAlive)
+        {
+            Metrics::Add(StatType::keepAlivePacketsReceived);
+            return;
+        }
+
+        voicePacket = reinterpret_cast<VoicePacket*>(restoredBuffer);
+
+        const auto lastPackidValue = player.lastPackid.load(std::memory_order_relaxed);
+
+        if (!voicePacket->ReadCompactUpstream(packetBuffer, voicePacketSize, lastPackidValue))
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return;
+        }
+
+        // Late packets don't move sequence back
+        if (voicePacket->packid == NULL || static_cast<int32_t>(voicePacket->packid - lastPackidValue) > 0)
+            player.lastPackid.store(voicePacket->packid, std::memory_order_relaxed);
+    }
+    else if (voicePacket->packet == SV::VoicePacketType::keepAlive)
+    {
+        Metrics::Add(StatType::keepAlivePacketsReceived);
+        return;
+    }
+
+    Metrics::Add(StatType::voicePacketsAccepted);
+
+    voicePacket->sender = playerId;
+    voicePacket->svrkey = NULL;
+
+    if (!player.speakStatus) return;
+
+    bool relayStatus { false };
+    bool passStatus { false };
+
+    for (const auto stream : player.speakerStreams)
+    {
+        const auto iter = Router::streamTable.find(stream);
+        if (iter == Router::streamTable.end()) continue;
+
+        if (iter->second.relayStatus) relayStatus = true;
+        else passStatus = true;
+    }
+
+    // Plugin gets the packet as it came, workers split layers themselves
+    if (passStatus)
+    {
+        const Relay::FrameRecord record { receiveTime };
+
+        if (Link::Write(Relay::RecordType::voiceFrame, &record, sizeof(record), voicePacket, voicePacket->GetFullSize()))
+            Router::passedPackets.fetch_add(1, std::memory_order_relaxed);
+        else
+            Metrics::Add(StatType::voicePacketsSendErrors);
+    }
+
+    if (!relayStatus) return;
+
+    alignas(VoicePacket) static thread_local uint8_t lowPacketBuffer[sizeof(VoicePacket) + kMaxVoicePacketSize];
+
+    VoicePacket* lowPacket { nullptr };
+
+    if (voicePacket->packet == SV::VoicePacketType::simulcastPacket)
+    {
+        lowPacket = reinterpret_cast<VoicePacket*>(lowPacketBuffer);
+
+        if (!voicePacket->SplitSimulcast(*lowPacket))
+        {
+            Metrics::Add(StatType::voicePacketsDroppedSize);
+            return;
+        }
+    }
+
+    uint32_t sendedPackets { 0 };
+    uint32_t sendedBytes { 0 };
+    uint32_t lowLayerPackets { 0 };
+    uint32_t failedPackets { 0 };
+
+    for (const auto stream : player.speakerStreams)
+    {
+        const auto iter = Router::streamTable.find(stream);
+        if (iter == Router::streamTable.end() || !iter->second.relayStatus) continue;
+
+        voicePacket->stream = stream;
+        voicePacket->CalcHash();
+
+        if (lowPacket != nullptr)
+        {
+            lowPacket->stream = stream;
+            lowPacket->CalcHash();
+        }
+
+        Router::SendToListeners(iter->second, *voicePacket, lowPacket,
+            sendedPackets, sendedBytes, lowLayerPackets, failedPackets);
+    }
+
+    if (sendedPackets != 0)
+    {
+        Metrics::Add(StatType::voicePacketsForwarded, sendedPackets);
+        Metrics::Add(StatType::voiceBytesForwarded, sendedBytes);
+    }
+
+    if (lowLayerPackets != 0)
+        Metrics::Add(StatType::lowLayerPacketsForwarded, lowLayerPackets);
+
+    if (failedPackets != 0)
+        Metrics::Add(StatType::voicePacketsSendErrors, failedPackets);
+
+    Latency::Record(LatencyType::forward, Latency::Now() - receiveTime);
+}
+
+void Router::SendToListeners(const StreamInfo& stream, const VoicePacket& voicePacket, const VoicePacket* const lowPacket,
+    uint32_t& sendedPackets, uint32_t& sendedBytes, uint32_t& lowLayerPackets, uint32_t& failedPackets) noexcept
+{
+    static thread_local std::array<mmsghdr, kSendBatchSize> batchMessages;
+    static thread_local std::array<sockaddr_in, kSendBatchSize> batchAddrs;
+    static thread_local std::array<std::array<iovec, 2>, kSendBatchSize> batchIovecs;
+    static thread_local std::array<bool, kSendBatchSize> batchLowLayers;
+
+    // Compact header doesn't depend on listener, so it's built once for every layer
+    uint8_t compactHeader[VoicePacket::kMaxCompactHeaderSize];
+    uint8_t lowCompactHeader[VoicePacket::kMaxCompactHeaderSize];
+
+    const uint32_t compactHeaderSize = voicePacket.WriteCompactHeader(compactHeader);
+    const uint32_t lowCompactHeaderSize = lowPacket != nullptr ? lowPacket->WriteCompactHeader(lowCompactHeader) : 0;
+
+    const auto curTime = Timer::Get();
+
+    uint32_t batchSize { 0 };
+
+    const auto flushBatch = [&]() noexcept
+    {
+        for (uint32_t sended { 0 }; sended < batchSize;)
+        {
+            const int result = sendmmsg(Router::socketHandle, batchMessages.data() + sended, batchSize - sended, MSG_DONTWAIT);
+            if (result <= 0) { failedPackets += batchSize - sended; break; }
+
+            for (int i { 0 }; i < result; ++i)
+            {
+                const auto& message = batchMessages[sended + i];
+
+                ++sendedPackets;
+                sendedBytes += message.msg_len;
+                lowLayerPackets += batchLowLayers[sended + i];
+            }
+
+            sended += result;
+        }
+
+        batchSize = 0;
+    };
+
+    for (const auto listener : stream.listeners)
+    {
+        if (listener == voicePacket.sender) continue;
+
+        auto& player = Router::players[listener];
+        if (!player.status) continue;
+
+        const auto endpoint = player.endpoint.load(std::memory_order_acquire);
+        if (endpoint == 0) continue;
+
+        const bool lowLayerStatus = lowPacket != nullptr && stream.layers[listener] == Relay::LayerStatus::low;
+        const auto& packet = lowLayerStatus ? *lowPacket : voicePacket;
+
+        auto& message = batchMessages[batchSize];
+        auto& buffers = batchIovecs[batchSize];
+
+        batchAddrs[batchSize] = Router::GetEndpointAddr(endpoint);
+        batchLowLayers[batchSize] = lowLayerStatus;
+
+        if (player.compact)
+        {
+            buffers[0] = { lowLayerStatus ? lowCompactHeader : compactHeader,
+                lowLayerStatus ? lowCompactHeaderSize : compactHeaderSize };
+            buffers[1] = { const_cast<uint8_t*>(packet.data), packet.length };
+        }
+        else
+        {
+            buffers[0] = { const_cast<VoicePacket*>(&packet), packet.GetFullSize() };
+            buffers[1] = { nullptr, 0 };
+        }
+
+        message.msg_hdr = {};
+        message.msg_hdr.msg_name = &batchAddrs[batchSize];
+        message.msg_hdr.msg_namelen = sizeof(batchAddrs[batchSize]);
+        message.msg_hdr.msg_iov = buffers.data();
+        message.msg_hdr.msg_iovlen = player.compact ? 2 : 1;
+        message.msg_len = 0;
+
+        // Outgoing voice keeps player's NAT mapping alive as well as keep-alive does
+        player.activityTime.store(curTime, std::memory_order_relaxed);
+
+        if (++batchSize == kSendBatchSize) flushBatch();
+    }
+
+    if (batchSize != 0) flushBatch();
+}
+
+void Router::RemovePlayer(const uint16_t playerId) noexcept
+{
+    auto& player = Router::players[playerId];
+
+    if (player.status)
+    {
+        const auto iter = Router::playerKeyTable.find(MakeKey(player.address, player.svrkey));
+        if (iter != Router::playerKeyTable.end() && iter->second == playerId)
+            Router::playerKeyTable.erase(iter);
+    }
+
+    player.status = false;
+    player.speakStatus = false;
+    player.speakerStreams.clear();
+    player.endpoint.store(0, std::memory_order_relaxed);
+
+    for (auto& [handle, stream] : Router::streamTable)
+    {
+        if (stream.layers[playerId] == Relay::LayerStatus::detached)
+            continue;
+
+        const auto listenerIter = std::find(stream.listeners.begin(), stream.listeners.end(), playerId);
+        if (listenerIter != stream.listeners.end())
+        {
+            *listenerIter = stream.listeners.back();
+            stream.listeners.pop_back();
+        }
+
+        stream.layers[playerId] = Relay::LayerStatus::detached;
+    }
+}
+
+uint64_t Router::MakeEndpoint(const sockaddr_in& playerAddr) noexcept
+{
+    return static_cast<uint64_t>(playerAddr.sin_addr.s_addr) << 16 | playerAddr.sin_port;
+}
+
+sockaddr_in Router::GetEndpointAddr(const uint64_t endpoint) noexcept
+{
+    sockaddr_in playerAddr {};
+
+    playerAddr.sin_family = AF_INET;
+    playerAddr.sin_addr.s_addr = static_cast<uint32_t>(endpoint >> 16);
+    playerAddr.sin_port = static_cast<uint16_t>(endpoint);
+
+    return playerAddr;
+}
+
+int Router::socketHandle { -1 };
+
+std::shared_mutex Router::stateMutex;
+
+std::atomic<uint8_t> Router::voiceAuthMode { 0 };
+std::array<Router::PlayerInfo, MAX_PLAYERS> Router::players;
+std::unordered_map<uint64_t, uint16_t> Router::playerKeyTable;
+std::unordered_map<uint32_t, Router::StreamInfo> Router::streamTable;
+
+std::atomic<uint64_t> Router::passedPackets { 0 };
+uint32_t Router::keepAliveSlot { 0 };
@@ -0,0 +1,135 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include <ysf/structs.h>
+#include <util/timer.h>
+
+#include <RelayProtocol.h>
+#include <VoicePacket.h>
+#include <Header.h>
+
+// Voice socket and the state plugin publishes to relay. Receiver threads
+// check and forward packets under shared lock, control thread applies
+// plugin records under exclusive one.
+class Router {
+
+    Router() = delete;
+    ~Router() = delete;
+    Router(const Router&) = delete;
+    Router(Router&&) = delete;
+    Router& operator=(const Router&) = delete;
+    Router& operator=(Router&&) = delete;
+
+private:
+
+    static constexpr uint32_t kMaxVoicePacketSize = 1400;
+    static constexpr uint32_t kSendBatchSize = 64;
+    static constexpr int kSocketBufferSize = 4 * 1024 * 1024;
+
+    // Same as plugin uses for its own socket
+    static constexpr Timer::time_t kKeepAliveInterval = 10000;
+    static constexpr uint32_t kKeepAliveWheelSize = 100;
+
+    // Network::VoiceAuthMode::required, untagged packets are dropped
+    static constexpr uint8_t kVoiceAuthRequired = 2;
+
+public:
+
+    static bool Init(uint16_t port) noexcept;
+    static void Free() noexcept;
+
+    // Drops everything plugin has published, done before it sends new snapshot
+    static void Reset() noexcept;
+
+    static void ApplyRecord(uint8_t type, const uint8_t* buffer, uint32_t size) noexcept;
+
+    // Body of receiver thread, waits up to 'timeout' milliseconds for packets
+    static void ReceivePackets(uint32_t timeout) noexcept;
+
+    // Called by control thread every 1/kKeepAliveWheelSize of interval
+    static void SendKeepAlives() noexcept;
+
+    static uint32_t GetPlayersCount() noexcept;
+    static uint32_t GetStreamsCount() noexcept;
+
+    // Packets of speakers of plugin's own streams
+    static uint64_t GetPassedPackets() noexcept;
+
+private:
+
+    struct PlayerInfo
+    {
+        bool status { false };
+
+        uint32_t svrkey { NULL };
+        uint32_t address { NULL };
+        bool compact { false };
+
+        bool authStatus { false };
+        uint64_t k0 { NULL };
+        uint64_t k1 { NULL };
+
+        // Player isn't muted and has a key or is recorded
+        bool speakStatus { false };
+        std::vector<uint32_t> speakerStreams;
+
+        // Address and port learnt from the first packet, zero until then
+        std::atomic<uint64_t> endpoint { 0 };
+        std::atomic<uint32_t> lastPackid { 0 };
+        std::atomic<Timer::time_t> activityTime { 0 };
+    };
+
+    struct StreamInfo
+    {
+        bool relayStatus { false };
+
+        std::vector<uint16_t> listeners;
+        std::array<uint8_t, MAX_PLAYERS> layers {};
+    };
+
+private:
+
+    static void HandlePacket(uint8_t* packetBuffer, uint32_t length,
+        const sockaddr_in& playerAddr, uint64_t receiveTime) noexcept;
+
+    // Listeners that chose low layer get 'lowPacket' if speaker sent one
+    static void SendToListeners(const StreamInfo& stream, const VoicePacket& voicePacket, const VoicePacket* lowPacket,
+        uint32_t& sendedPackets, uint32_t& sendedBytes, uint32_t& lowLayerPackets, uint32_t& failedPackets) noexcept;
+
+    static void RemovePlayer(uint16_t playerId) noexcept;
+
+    static uint64_t MakeEndpoint(const sockaddr_in& playerAddr) noexcept;
+    static sockaddr_in GetEndpointAddr(uint64_t endpoint) noexcept;
+
+private:
+
+    static int socketHandle;
+
+    static std::shared_mutex stateMutex;
+
+    static std::atomic<uint8_t> voiceAuthMode;
+    static std::array<PlayerInfo, MAX_PLAYERS> players;
+    static std::unordered_map<uint64_t, uint16_t> playerKeyTable;
+    static std::unordered_map<uint32_t, StreamInfo> streamTable;
+
+    static std::atomic<uint64_t> passedPackets;
+    static uint32_t keepAliveSlot;
+
+};
@@ -0,0 +1,232 @@
+/*
+    This is a SampVoice project file
+    Developer: CyberMor <cyber.mor.2020@gmail.ru>
+
+    See more here https://github.com/CyberMor/sampvoice
+
+    Copyright (c) Daniel (CyberMor) 2020 All rights reserved
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <util/logger.h>
+#include <util/timer.h>
+
+#include <Metrics.h>
+#include <Latency.h>
+
+#include "Link.h"
+#include "Router.h"
+
+namespace
+{
+    constexpr uint32_t kReceiveTimeout = 100;
+    constexpr uint32_t kControlIdleTime = 200;
+    constexpr uint32_t kControlRecordsLimit = 4096;
+    constexpr uint32_t kKeepAliveTickInterval = 100;
+
+    struct Options
+    {
+        uint16_t port { 0 };
+        std::string shmName { SV::kRelayShmName };
+        std::string socketPath { SV::kRelaySocketName };
+        uint32_t threads { 2 };
+        std::string logFile { "sampvoice-relay.log" };
+        std::string statsFile;
+        uint32_t statsInterval { 1000 };
+        uint32_t reportInterval { 10 };
+    };
+
+    std::atomic_bool runStatus { true };
+
+    void Usage(const char* const program) noexcept
+    {
+        std::printf(
+            "usage: %s --port <port> [options]\n"
+            "  --port <port>        voice port, must match relay_port of plugin config\n"
+            "  --shm <name>         shared memory created by plugin (default %s)\n"
+            "  --socket <path>      unix socket of plugin, used without shared memory (default %s)\n"
+            "  --threads <n>        receiver threads (default 2)\n"
+            "  --log <file>         log file (default sampvoice-relay.log)\n"
+            "  --stats-file <file>  file that metrics are dumped to\n"
+            "  --stats-interval <ms> metrics dump interval (default 1000)\n"
+            "  --report <sec>       console report interval, 0 disables it (default 10)\n",
+            program, SV::kRelayShmName, SV::kRelaySocketName);
+    }
+
+    bool ParseOptions(const int argc, char** const argv, Options& options) noexcept
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option { argv[i] };
+            const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (value == nullptr) return false;
+
+            if (option == "--port") options.port = static_cast<uint16_t>(std::atoi(value));
+            else if (option == "--shm") options.shmName = value;
+            else if (option == "--socket") options.socketPath = value;
+            else if (option == "--threads") options.threads = std::atoi(value);
+            else if (option == "--log") options.logFile = value;
+            else if (option == "--stats-file") options.statsFile = value;
+            else if (option == "--stats-interval") options.statsInterval = std::atoi(value);
+            else if (option == "--report") options.reportInterval = std::atoi(value);
+            else return false;
+
+            ++i;
+        }
+
+        options.threads = std::max(options.threads, 1u);
+
+        return options.port != 0;
+    }
+
+    void PrintLog(const char* const format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        std::vprintf(format, args);
+        va_end(args);
+
+        std::putchar('\n');
+        std::fflush(stdout);
+    }
+
+    void ReceiverThread() noexcept
+    {
+        while (runStatus.load(std::memory_order_relaxed))
+            Router::ReceivePackets(kReceiveTimeout);
+    }
+
+    // Applies plugin records, keeps link alive and sends keep-alives
+    void ControlThread() noexcept
+    {
+        alignas(8) uint8_t recordBuffer[Relay::kMaxRecordSize];
+
+        auto keepAliveTime = std::chrono::steady_clock::now();
+
+        while (runStatus.load(std::memory_order_relaxed))
+        {
+            Timer::Tick();
+
+            if (Link::Process())
+                Router::Reset();
+
+            uint8_t type; uint32_t size;
+            uint32_t recordsCount { 0 };
+
+            while (recordsCount < kControlRecordsLimit && Link::Read(type, recordBuffer, size))
+            {
+                Router::ApplyRecord(type, recordBuffer, size);
+                ++recordsCount;
+            }
+
+            if (const auto curTime = std::chrono::steady_clock::now(); curTime >= keepAliveTime)
+            {
+                Router::SendKeepAlives();
+                keepAliveTime = curTime + std::chrono::milliseconds(kKeepAliveTickInterval);
+            }
+
+            if (recordsCount == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(kControlIdleTime));
+        }
+    }
+
+    void PrintReport(const double elapsedTime) noexcept
+    {
+        std::printf("[%7.1fs] %s, players %u, streams %u, received %lld, forwarded %lld, passed %llu, "
+            "dropped %lld, send errors %lld, forward p99 %.1f us\n", elapsedTime,
+            Link::IsAttached() ? "attached" : "detached", Router::GetPlayersCount(), Router::GetStreamsCount(),
+            static_cast<long long>(Metrics::Get(StatType::voicePacketsReceived)),
+            static_cast<long long>(Metrics::Get(StatType::voicePacketsForwarded)),
+            static_cast<unsigned long long>(Router::GetPassedPackets()),
+            static_cast<long long>(Metrics::Get(StatType::voicePacketsDroppedSize) +
+                Metrics::Get(StatType::voicePacketsDroppedHash) + Metrics::Get(StatType::voicePacketsDroppedKey) +
+                Metrics::Get(StatType::voicePacketsDroppedAuth) + Metrics::Get(StatType::voicePacketsDroppedThrottle)),
+            static_cast<long long>(Metrics::Get(StatType::voicePacketsSendErrors)),
+            Latency::GetPercentile(LatencyType::forward, 99.0) / 1000.0);
+
+        std::fflush(stdout);
+    }
+}
+
+int main(const int argc, char** const argv)
+{
+    Options options;
+
+    if (!ParseOptions(argc, argv, options))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!Logger::Init(options.logFile.c_str(), PrintLog))
+    {
+        std::fprintf(stderr, "failed to open log file '%s'\n", options.logFile.c_str());
+        return EXIT_FAILURE;
+    }
+
+    Timer::Tick();
+
+    if (!Router::Init(options.port))
+    {
+        Logger::Free();
+        return EXIT_FAILURE;
+    }
+
+    if (!Link::Init(options.port, options.shmName, options.socketPath))
+    {
+        Logger::Log("[sv:err:main] : neither shared memory nor socket is set");
+        Router::Free();
+        Logger::Free();
+        return EXIT_FAILURE;
+    }
+
+    if (!options.statsFile.empty())
+        Metrics::Init(options.statsFile, options.statsInterval);
+
+    std::signal(SIGINT, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+    std::signal(SIGTERM, [](int) { runStatus.store(false, std::memory_order_relaxed); });
+
+    std::vector<std::thread> threads;
+
+    threads.emplace_back(ControlThread);
+
+    for (uint32_t i = 0; i < options.threads; ++i)
+        threads.emplace_back(ReceiverThread);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    auto reportTime = beginTime;
+
+    while (runStatus.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        const auto curTime = std::chrono::steady_clock::now();
+
+        if (options.reportInterval != 0 && curTime - reportTime >= std::chrono::seconds(options.reportInterval))
+        {
+            PrintReport(std::chrono::duration<double>(curTime - beginTime).count());
+            reportTime = curTime;
+        }
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    Metrics::Free();
+    Link::Free();
+    Router::Free();
+    Logger::Free();
+
+    return EXIT_SUCCESS;
+}